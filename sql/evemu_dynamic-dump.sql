@@ -649,7 +649,7 @@ CREATE TABLE `market_orders` (
   `charID` int(10) unsigned NOT NULL default '0',
   `regionID` int(10) unsigned NOT NULL default '0',
   `stationID` int(10) unsigned NOT NULL default '0',
-  `range` int(10) unsigned NOT NULL default '0',
+  `range` int(10) NOT NULL default '0',
   `bid` tinyint(3) unsigned NOT NULL default '0',
   `price` double NOT NULL default '0',
   `volEntered` int(10) unsigned NOT NULL default '0',
@@ -0,0 +1,190 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-bench.h"
+
+#include "Benchmark.h"
+
+/*************************************************************************/
+/* Allocation counting                                                   */
+/*************************************************************************/
+static uint64 sAllocCount = 0;
+static uint64 sAllocBytes = 0;
+
+uint64 GetAllocCount() { return sAllocCount; }
+uint64 GetAllocBytes() { return sAllocBytes; }
+
+#ifdef __GLIBC__
+/*
+ * With glibc, hook malloc itself, so that Buffer (which
+ * uses realloc) is accounted for as well as operator new.
+ */
+extern "C" void* __libc_malloc( size_t size );
+extern "C" void* __libc_calloc( size_t count, size_t size );
+extern "C" void* __libc_realloc( void* ptr, size_t size );
+
+extern "C" void* malloc( size_t size ) __THROW
+{
+    ++sAllocCount;
+    sAllocBytes += size;
+
+    return __libc_malloc( size );
+}
+
+extern "C" void* calloc( size_t count, size_t size ) __THROW
+{
+    ++sAllocCount;
+    sAllocBytes += count * size;
+
+    return __libc_calloc( count, size );
+}
+
+extern "C" void* realloc( void* ptr, size_t size ) __THROW
+{
+    ++sAllocCount;
+    sAllocBytes += size;
+
+    return __libc_realloc( ptr, size );
+}
+#else /* !__GLIBC__ */
+/*
+ * Elsewhere only operator new is hooked; reallocations
+ * done by Buffer are not counted.
+ */
+void* operator new( size_t size ) throw( std::bad_alloc )
+{
+    ++sAllocCount;
+    sAllocBytes += size;
+
+    void* ptr = ::malloc( 0 < size ? size : 1 );
+    if( NULL == ptr )
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void* operator new[]( size_t size ) throw( std::bad_alloc )
+{
+    return operator new( size );
+}
+
+void operator delete( void* ptr ) throw()
+{
+    ::free( ptr );
+}
+
+void operator delete[]( void* ptr ) throw()
+{
+    ::free( ptr );
+}
+#endif /* !__GLIBC__ */
+
+/*************************************************************************/
+/* Benchmark                                                             */
+/*************************************************************************/
+Benchmark::Benchmark( const char* name )
+: mName( name ),
+  mOutputSize( 0 )
+{
+}
+
+/*************************************************************************/
+/* BenchmarkRunner                                                       */
+/*************************************************************************/
+BenchmarkRunner::BenchmarkRunner( uint64 minTimeUSec )
+: mMinTimeUSec( minTimeUSec )
+{
+}
+
+bool BenchmarkRunner::Run( Benchmark& bench, BenchmarkResult& result )
+{
+    if( !bench.Setup() )
+    {
+        sLog.Error( "Benchmark", "%s: Setup failed.", bench.name().c_str() );
+        return false;
+    }
+
+    uint64 ops = 1;
+    uint64 elapsed = 0;
+
+    // the first batch warms up caches and pools
+    bool success = _RunBatch( bench, ops, elapsed, result );
+    while( success && elapsed < mMinTimeUSec )
+    {
+        // aim 20% past the target, but grow by 2x-100x at a time
+        uint64 next = mMinTimeUSec * ops * 6 / 5 / ( 0 < elapsed ? elapsed : 1 );
+        next = std::max( next, 2 * ops );
+        next = std::min( next, 100 * ops );
+        ops = next;
+
+        success = _RunBatch( bench, ops, elapsed, result );
+    }
+
+    bench.Teardown();
+
+    if( !success )
+        sLog.Error( "Benchmark", "%s: Operation failed.", bench.name().c_str() );
+
+    return success;
+}
+
+void BenchmarkRunner::PrintHeader( FILE* into )
+{
+    fprintf( into, "%-28s %10s %14s %12s %10s %12s\n",
+             "benchmark", "ops", "ns/op", "B/op", "allocs/op", "output [B]" );
+}
+
+void BenchmarkRunner::PrintResult( FILE* into, const std::string& name, const BenchmarkResult& result )
+{
+    fprintf( into, "%-28s %10" PRIu64 " %14.0f %12.0f %10.1f",
+             name.c_str(), result.ops, result.nsPerOp, result.bytesPerOp, result.allocsPerOp );
+
+    if( 0 < result.outputSize )
+        fprintf( into, " %12lu\n", (unsigned long)result.outputSize );
+    else
+        fprintf( into, " %12s\n", "-" );
+}
+
+bool BenchmarkRunner::_RunBatch( Benchmark& bench, uint64 ops, uint64& elapsed, BenchmarkResult& result )
+{
+    const uint64 allocCount = GetAllocCount();
+    const uint64 allocBytes = GetAllocBytes();
+    const uint64 start = GetTimeUSec();
+
+    for( uint64 i = 0; i < ops; ++i )
+    {
+        if( !bench.Run() )
+            return false;
+    }
+
+    elapsed = GetTimeUSec() - start;
+
+    result.ops = ops;
+    result.nsPerOp = elapsed * 1000.0 / ops;
+    result.bytesPerOp = double( GetAllocBytes() - allocBytes ) / ops;
+    result.allocsPerOp = double( GetAllocCount() - allocCount ) / ops;
+    result.outputSize = bench.outputSize();
+
+    return true;
+}
@@ -0,0 +1,160 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __BENCHMARK_H__INCL__
+#define __BENCHMARK_H__INCL__
+
+/**
+ * @return Number of heap allocations made so far.
+ */
+extern uint64 GetAllocCount();
+/**
+ * @return Number of bytes allocated from heap so far.
+ */
+extern uint64 GetAllocBytes();
+
+/**
+ * @brief A single benchmark.
+ *
+ * Run() performs one operation; it is called repeatedly
+ * by BenchmarkRunner, so it must leave the benchmark in
+ * the same state it found it in.
+ */
+class Benchmark
+{
+public:
+    /**
+     * @param[in] name Name of benchmark.
+     */
+    Benchmark( const char* name );
+    virtual ~Benchmark() {}
+
+    /** @return Name of benchmark. */
+    const std::string& name() const { return mName; }
+    /** @return Size of the operation's output in bytes, 0 if none. */
+    size_t outputSize() const { return mOutputSize; }
+
+    /**
+     * @brief Prepares benchmark; not measured.
+     *
+     * @retval true  Setup succeeded.
+     * @retval false Setup failed, skip benchmark.
+     */
+    virtual bool Setup() { return true; }
+    /**
+     * @brief Performs one operation.
+     *
+     * @retval true  Operation succeeded.
+     * @retval false Operation failed.
+     */
+    virtual bool Run() = 0;
+    /**
+     * @brief Releases everything Setup() acquired; not measured.
+     */
+    virtual void Teardown() {}
+
+protected:
+    /// Name of benchmark.
+    const std::string mName;
+    /// Size of the operation's output.
+    size_t mOutputSize;
+};
+
+/**
+ * @brief Result of a benchmark run.
+ */
+struct BenchmarkResult
+{
+    /// Number of operations measured.
+    uint64 ops;
+    /// Wall time per operation, in nanoseconds.
+    double nsPerOp;
+    /// Bytes allocated per operation.
+    double bytesPerOp;
+    /// Heap allocations per operation.
+    double allocsPerOp;
+    /// Size of the operation's output in bytes.
+    size_t outputSize;
+};
+
+/**
+ * @brief Runs benchmarks and reports results.
+ *
+ * The number of operations is increased until a batch
+ * takes at least the requested time; only the last batch
+ * is reported.
+ */
+class BenchmarkRunner
+{
+public:
+    /**
+     * @param[in] minTimeUSec Minimal duration of measured batch, in microseconds.
+     */
+    BenchmarkRunner( uint64 minTimeUSec );
+
+    /**
+     * @brief Runs benchmark.
+     *
+     * @param[in]  bench  Benchmark to run.
+     * @param[out] result Where to store the result.
+     *
+     * @retval true  Benchmark succeeded.
+     * @retval false Benchmark failed.
+     */
+    bool Run( Benchmark& bench, BenchmarkResult& result );
+
+    /**
+     * @brief Prints header of result table.
+     *
+     * @param[in] into File to print to.
+     */
+    static void PrintHeader( FILE* into );
+    /**
+     * @brief Prints one row of result table.
+     *
+     * @param[in] into   File to print to.
+     * @param[in] name   Name of benchmark.
+     * @param[in] result Result to print.
+     */
+    static void PrintResult( FILE* into, const std::string& name, const BenchmarkResult& result );
+
+protected:
+    /**
+     * @brief Performs given number of operations.
+     *
+     * @param[in]  bench   Benchmark to run.
+     * @param[in]  ops     Number of operations to perform.
+     * @param[out] elapsed Elapsed time in microseconds.
+     * @param[out] result  Where to store the measurements.
+     *
+     * @retval true  All operations succeeded.
+     * @retval false An operation failed.
+     */
+    bool _RunBatch( Benchmark& bench, uint64 ops, uint64& elapsed, BenchmarkResult& result );
+
+    /// Minimal duration of measured batch.
+    const uint64 mMinTimeUSec;
+};
+
+#endif /* !__BENCHMARK_H__INCL__ */
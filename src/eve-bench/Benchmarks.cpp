@@ -0,0 +1,410 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-bench.h"
+
+#include "Benchmarks.h"
+#include "Payloads.h"
+
+/*************************************************************************/
+/* BuildBenchmark                                                        */
+/*************************************************************************/
+BuildBenchmark::BuildBenchmark( const char* name, PayloadBuilder builder )
+: Benchmark( name ),
+  mBuilder( builder )
+{
+}
+
+bool BuildBenchmark::Run()
+{
+    PyRep* rep = ( *mBuilder )();
+    if( NULL == rep )
+        return false;
+
+    PyDecRef( rep );
+    return true;
+}
+
+/*************************************************************************/
+/* PayloadBenchmark                                                      */
+/*************************************************************************/
+PayloadBenchmark::PayloadBenchmark( const char* name, PayloadBuilder builder )
+: Benchmark( name ),
+  mBuilder( builder ),
+  mPayload( NULL )
+{
+}
+
+bool PayloadBenchmark::Setup()
+{
+    mPayload = ( *mBuilder )();
+    if( NULL == mPayload )
+        return false;
+
+    return Marshal( mPayload, mMarshaled );
+}
+
+void PayloadBenchmark::Teardown()
+{
+    PySafeDecRef( mPayload );
+    mPayload = NULL;
+}
+
+/*************************************************************************/
+/* MarshalBenchmark                                                      */
+/*************************************************************************/
+MarshalBenchmark::MarshalBenchmark( const char* name, PayloadBuilder builder, bool deflate )
+: PayloadBenchmark( name, builder ),
+  mDeflate( deflate )
+{
+}
+
+bool MarshalBenchmark::Run()
+{
+    Buffer into;
+    if( mDeflate ? !MarshalDeflate( mPayload, into ) : !Marshal( mPayload, into ) )
+        return false;
+
+    mOutputSize = into.size();
+    return true;
+}
+
+/*************************************************************************/
+/* UnmarshalBenchmark                                                    */
+/*************************************************************************/
+UnmarshalBenchmark::UnmarshalBenchmark( const char* name, PayloadBuilder builder, bool inflate )
+: PayloadBenchmark( name, builder ),
+  mInflate( inflate )
+{
+}
+
+bool UnmarshalBenchmark::Setup()
+{
+    if( !PayloadBenchmark::Setup() )
+        return false;
+
+    mInput = mMarshaled;
+    return ( !mInflate || DeflateData( mInput ) );
+}
+
+bool UnmarshalBenchmark::Run()
+{
+    PyRep* rep = ( mInflate ? InflateUnmarshal( mInput ) : Unmarshal( mInput ) );
+    if( NULL == rep )
+        return false;
+
+    PyDecRef( rep );
+    return true;
+}
+
+/*************************************************************************/
+/* DeflateBenchmark                                                      */
+/*************************************************************************/
+DeflateBenchmark::DeflateBenchmark( const char* name, PayloadBuilder builder )
+: PayloadBenchmark( name, builder )
+{
+}
+
+bool DeflateBenchmark::Run()
+{
+    Buffer into;
+    if( !DeflateData( mMarshaled, into ) )
+        return false;
+
+    mOutputSize = into.size();
+    return true;
+}
+
+/*************************************************************************/
+/* InflateBenchmark                                                      */
+/*************************************************************************/
+InflateBenchmark::InflateBenchmark( const char* name, PayloadBuilder builder )
+: PayloadBenchmark( name, builder )
+{
+}
+
+bool InflateBenchmark::Setup()
+{
+    if( !PayloadBenchmark::Setup() )
+        return false;
+
+    return DeflateData( mMarshaled, mDeflated );
+}
+
+bool InflateBenchmark::Run()
+{
+    Buffer into;
+    if( !InflateData( mDeflated, into ) )
+        return false;
+
+    mOutputSize = into.size();
+    return true;
+}
+
+/*************************************************************************/
+/* CachedObjectBenchmark                                                 */
+/*************************************************************************/
+CachedObjectBenchmark::CachedObjectBenchmark( const char* name, PayloadBuilder builder, bool encoded )
+: Benchmark( name ),
+  mBuilder( builder ),
+  mEncoded( encoded ),
+  mCache( NULL ),
+  mObjectID( NULL )
+{
+}
+
+bool CachedObjectBenchmark::Setup()
+{
+    PyRep* payload = ( *mBuilder )();
+    if( NULL == payload )
+        return false;
+
+    mCache = new CachedObjectMgr;
+    mObjectID = new PyString( "config.BulkData.benchmark" );
+
+    mCache->UpdateCache( mObjectID, &payload );
+    return mCache->HaveCached( mObjectID );
+}
+
+bool CachedObjectBenchmark::Run()
+{
+    PyRep* obj;
+    if( mEncoded )
+        obj = mCache->GetEncodedCachedObject( mObjectID );
+    else
+        obj = mCache->GetCachedObject( mObjectID );
+
+    if( NULL == obj )
+        return false;
+
+    // what goes out to the client; encoded object is deflated already
+    Buffer into;
+    const bool res = ( mEncoded ? Marshal( obj, into ) : MarshalDeflate( obj, into ) );
+    PyDecRef( obj );
+
+    mOutputSize = into.size();
+    return res;
+}
+
+void CachedObjectBenchmark::Teardown()
+{
+    PySafeDecRef( mObjectID );
+    mObjectID = NULL;
+
+    SafeDelete( mCache );
+}
+
+/*************************************************************************/
+/* DestinyTickBenchmark                                                  */
+/*************************************************************************/
+DestinyTickBenchmark::DestinyTickBenchmark( const char* name, bool shared )
+: Benchmark( name ),
+  mShared( shared )
+{
+}
+
+bool DestinyTickBenchmark::Setup()
+{
+    MakeMovementUpdates( mUpdates );
+
+    for( size_t i = 0; i < mUpdates.size(); ++i )
+        mQueues.push_back( new PyList );
+
+    return !mUpdates.empty();
+}
+
+bool DestinyTickBenchmark::Run()
+{
+    const int32 stamp = 1000;
+    PyInt* stampRep = ( mShared ? new PyInt( stamp ) : NULL );
+
+    std::vector<PyTuple*>::const_iterator cur, end;
+    cur = mUpdates.begin();
+    end = mUpdates.end();
+    for(; cur != end; ++cur)
+    {
+        for( size_t i = 0; i < mQueues.size(); ++i )
+        {
+            if( mShared )
+            {
+                PyTuple* act = new PyTuple( 2 );
+                PyIncRef( stampRep );
+                act->SetItem( 0, stampRep );
+                PyIncRef( *cur );
+                act->SetItem( 1, *cur );
+
+                mQueues[ i ]->AddItem( act );
+            }
+            else
+            {
+                DoDestinyAction act;
+                act.update_id = stamp;
+                act.update = new PyTuple( **cur );
+
+                mQueues[ i ]->AddItem( act.Encode() );
+            }
+        }
+    }
+
+    PySafeDecRef( stampRep );
+
+    for( size_t i = 0; i < mQueues.size(); ++i )
+    {
+        DoDestinyUpdateMain dum;
+        dum.updates = mQueues[ i ];
+        PyIncRef( mQueues[ i ] );
+        dum.events = new PyList;
+        dum.waitForBubble = false;
+
+        PyTuple* t = dum.Encode();
+        PyDecRef( t );
+
+        mQueues[ i ]->clear();
+    }
+
+    return true;
+}
+
+void DestinyTickBenchmark::Teardown()
+{
+    for( size_t i = 0; i < mUpdates.size(); ++i )
+        PyDecRef( mUpdates[ i ] );
+    mUpdates.clear();
+
+    for( size_t i = 0; i < mQueues.size(); ++i )
+        PyDecRef( mQueues[ i ] );
+    mQueues.clear();
+}
+
+/*************************************************************************/
+/* DestinyReplayBenchmark                                                */
+/*************************************************************************/
+DestinyReplayBenchmark::DestinyReplayBenchmark( const char* name, size_t ballCount )
+: Benchmark( name ),
+  mBallCount( ballCount ),
+  mReplay( NULL )
+{
+}
+
+bool DestinyReplayBenchmark::Setup()
+{
+    // deterministic, so that runs are comparable
+    uint32 seed = 0x2545F491;
+    mScenario.Clear();
+    mScenario.SetTics( 600 );
+
+    for( size_t i = 0; i < mBallCount; ++i )
+    {
+        double r[ 6 ];
+        for( size_t j = 0; j < 6; ++j )
+        {
+            seed = seed * 1103515245 + 12345;
+            r[ j ] = ( seed >> 8 ) / double( 1 << 24 );
+        }
+
+        Destiny::ScenarioBall ball;
+        ball.id = 1000 + i;
+        ball.mass = 1.0e6 + r[ 0 ] * 1.0e8;
+        ball.agility = 0.3 + r[ 1 ] * 2.7;
+        ball.maxVelocity = 100.0 + r[ 2 ] * 900.0;
+        ball.radius = 50.0;
+        ball.position = GPoint( ( r[ 3 ] - 0.5 ) * 1.0e5, ( r[ 4 ] - 0.5 ) * 1.0e5, ( r[ 5 ] - 0.5 ) * 1.0e5 );
+        ball.velocity = GVector( 0, 0, 0 );
+        mScenario.AddBall( ball );
+
+        Destiny::ScenarioCommand cmd;
+        cmd.stamp = 0;
+        cmd.ballID = ball.id;
+        cmd.targetID = 1000 + ( i * 7 ) % mBallCount;
+        cmd.point = GPoint( -ball.position.x, -ball.position.y, -ball.position.z );
+        cmd.value = 2500.0;
+
+        if( 0 == i % 3 || cmd.targetID == ball.id )
+            cmd.type = Destiny::ScenarioCommand::CMD_GOTO;
+        else if( 1 == i % 3 )
+        {
+            // orbits keep the speed fraction, so set it first
+            cmd.type = Destiny::ScenarioCommand::CMD_SPEED;
+            cmd.value = 1.0;
+            mScenario.AddCommand( cmd );
+
+            cmd.type = Destiny::ScenarioCommand::CMD_ORBIT;
+            cmd.value = 2500.0;
+        }
+        else
+            cmd.type = Destiny::ScenarioCommand::CMD_FOLLOW;
+
+        mScenario.AddCommand( cmd );
+    }
+
+    mReplay = new Destiny::Replay( mScenario );
+    return 0 < mBallCount;
+}
+
+bool DestinyReplayBenchmark::Run()
+{
+    if( mReplay->IsDone() )
+        mReplay->Rewind();
+
+    mReplay->Tic();
+    return true;
+}
+
+void DestinyReplayBenchmark::Teardown()
+{
+    SafeDelete( mReplay );
+    mScenario.Clear();
+}
+
+/*************************************************************************/
+/* Benchmark list                                                        */
+/*************************************************************************/
+void GetBenchmarks( std::vector<Benchmark*>& into )
+{
+    into.push_back( new BuildBenchmark(        "rowset/build",               &MakeMarketOrders ) );
+    into.push_back( new MarshalBenchmark(      "rowset/marshal",             &MakeMarketOrders, false ) );
+    into.push_back( new MarshalBenchmark(      "rowset/marshal+deflate",     &MakeMarketOrders, true ) );
+    into.push_back( new UnmarshalBenchmark(    "rowset/unmarshal",           &MakeMarketOrders, false ) );
+    into.push_back( new UnmarshalBenchmark(    "rowset/inflate+unmarshal",   &MakeMarketOrders, true ) );
+    into.push_back( new DeflateBenchmark(      "rowset/deflate",             &MakeMarketOrders ) );
+    into.push_back( new InflateBenchmark(      "rowset/inflate",             &MakeMarketOrders ) );
+
+    into.push_back( new BuildBenchmark(        "destiny/update/build",       &MakeDestinyUpdate ) );
+    into.push_back( new MarshalBenchmark(      "destiny/update/marshal",     &MakeDestinyUpdate, true ) );
+    into.push_back( new UnmarshalBenchmark(    "destiny/update/unmarshal",   &MakeDestinyUpdate, false ) );
+
+    into.push_back( new DestinyTickBenchmark(  "destiny/tick/copied",        false ) );
+    into.push_back( new DestinyTickBenchmark(  "destiny/tick/shared",        true ) );
+
+    into.push_back( new DestinyReplayBenchmark( "destiny/replay/100",        100 ) );
+    into.push_back( new DestinyReplayBenchmark( "destiny/replay/1000",       1000 ) );
+
+    into.push_back( new BuildBenchmark(        "destiny/setstate/build",     &MakeSetState ) );
+    into.push_back( new MarshalBenchmark(      "destiny/setstate/marshal",   &MakeSetState, true ) );
+    into.push_back( new UnmarshalBenchmark(    "destiny/setstate/unmarshal", &MakeSetState, true ) );
+
+    into.push_back( new CachedObjectBenchmark( "cache/object/serve",         &MakeMarketOrders, false ) );
+    into.push_back( new CachedObjectBenchmark( "cache/object/serve-encoded", &MakeMarketOrders, true ) );
+    into.push_back( new UnmarshalBenchmark(    "cache/object/unmarshal",     &MakeCachedObject, false ) );
+}
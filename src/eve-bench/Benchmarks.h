@@ -0,0 +1,233 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __BENCHMARKS_H__INCL__
+#define __BENCHMARKS_H__INCL__
+
+#include "Benchmark.h"
+
+/// Function which builds a payload.
+typedef PyRep* ( *PayloadBuilder )();
+
+/**
+ * @brief Measures building of a payload.
+ */
+class BuildBenchmark
+: public Benchmark
+{
+public:
+    BuildBenchmark( const char* name, PayloadBuilder builder );
+
+    bool Run();
+
+protected:
+    /// Builder of payload.
+    const PayloadBuilder mBuilder;
+};
+
+/**
+ * @brief Benchmark which operates on a prebuilt payload.
+ */
+class PayloadBenchmark
+: public Benchmark
+{
+public:
+    PayloadBenchmark( const char* name, PayloadBuilder builder );
+
+    bool Setup();
+    void Teardown();
+
+protected:
+    /// Builder of payload.
+    const PayloadBuilder mBuilder;
+    /// The payload.
+    PyRep* mPayload;
+    /// The payload, marshaled.
+    Buffer mMarshaled;
+};
+
+/**
+ * @brief Measures marshaling (and optionally deflating) of a payload.
+ */
+class MarshalBenchmark
+: public PayloadBenchmark
+{
+public:
+    MarshalBenchmark( const char* name, PayloadBuilder builder, bool deflate );
+
+    bool Run();
+
+protected:
+    /// Whether to deflate too.
+    const bool mDeflate;
+};
+
+/**
+ * @brief Measures unmarshaling (and optionally inflating) of a payload.
+ */
+class UnmarshalBenchmark
+: public PayloadBenchmark
+{
+public:
+    UnmarshalBenchmark( const char* name, PayloadBuilder builder, bool inflate );
+
+    bool Setup();
+    bool Run();
+
+protected:
+    /// Whether to inflate too.
+    const bool mInflate;
+    /// The input.
+    Buffer mInput;
+};
+
+/**
+ * @brief Measures deflating of a marshaled payload.
+ */
+class DeflateBenchmark
+: public PayloadBenchmark
+{
+public:
+    DeflateBenchmark( const char* name, PayloadBuilder builder );
+
+    bool Run();
+};
+
+/**
+ * @brief Measures inflating of a marshaled and deflated payload.
+ */
+class InflateBenchmark
+: public PayloadBenchmark
+{
+public:
+    InflateBenchmark( const char* name, PayloadBuilder builder );
+
+    bool Setup();
+    bool Run();
+
+protected:
+    /// The deflated payload.
+    Buffer mDeflated;
+};
+
+/**
+ * @brief Measures serving a cached object, as ObjCacheService does.
+ */
+class CachedObjectBenchmark
+: public Benchmark
+{
+public:
+    /**
+     * @param[in] name    Name of benchmark.
+     * @param[in] builder Builder of the cached payload.
+     * @param[in] encoded Whether to serve it pre-marshaled.
+     */
+    CachedObjectBenchmark( const char* name, PayloadBuilder builder, bool encoded );
+
+    bool Setup();
+    bool Run();
+    void Teardown();
+
+protected:
+    /// Builder of payload.
+    const PayloadBuilder mBuilder;
+    /// Whether to serve pre-marshaled object.
+    const bool mEncoded;
+    /// The cache.
+    CachedObjectMgr* mCache;
+    /// ID of the object.
+    PyString* mObjectID;
+};
+
+/**
+ * @brief Measures queuing one destiny tick of a bubble, as Client does.
+ *
+ * Every one of MOVING_SHIP_COUNT ships sends a movement update
+ * to all the others, which queue it and send their queues
+ * as DoDestinyUpdateMain at the end of the tick. Marshaling
+ * is not included.
+ */
+class DestinyTickBenchmark
+: public Benchmark
+{
+public:
+    /**
+     * @param[in] name   Name of benchmark.
+     * @param[in] shared Whether to share updates and stamp between receivers
+     *                   rather than copying them for each of them.
+     */
+    DestinyTickBenchmark( const char* name, bool shared );
+
+    bool Setup();
+    bool Run();
+    void Teardown();
+
+protected:
+    /// Whether to share updates.
+    const bool mShared;
+    /// Updates of the tick.
+    std::vector<PyTuple*> mUpdates;
+    /// Update queues of receivers.
+    std::vector<PyList*> mQueues;
+};
+
+/**
+ * @brief Measures one destiny tic of a busy solar system.
+ *
+ * Balls are spread over a 100 km cube; a third of them
+ * heads to a point, a third orbits and a third follows
+ * other balls. Each operation replays one tic, rewinding
+ * the scenario when it runs out.
+ */
+class DestinyReplayBenchmark
+: public Benchmark
+{
+public:
+    /**
+     * @param[in] name      Name of benchmark.
+     * @param[in] ballCount Number of balls in the system.
+     */
+    DestinyReplayBenchmark( const char* name, size_t ballCount );
+
+    bool Setup();
+    bool Run();
+    void Teardown();
+
+protected:
+    /// Number of balls.
+    const size_t mBallCount;
+    /// The scenario.
+    Destiny::Scenario mScenario;
+    /// Replay of the scenario.
+    Destiny::Replay* mReplay;
+};
+
+/**
+ * @brief Obtains all benchmarks.
+ *
+ * @param[out] into Where to store the benchmarks; caller takes ownership.
+ */
+extern void GetBenchmarks( std::vector<Benchmark*>& into );
+
+#endif /* !__BENCHMARKS_H__INCL__ */
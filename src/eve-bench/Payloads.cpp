@@ -0,0 +1,299 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-bench.h"
+
+#include "Payloads.h"
+
+const uint32 MARKET_ORDER_COUNT = 5000;
+const uint32 DESTINY_ACTION_COUNT = 50;
+const uint32 BUBBLE_BALL_COUNT = 300;
+const uint32 MOVING_SHIP_COUNT = 100;
+
+/// First entity ID of generated balls.
+static const uint32 FIRST_ENTITY_ID = 140000000;
+
+/**
+ * @brief Simple deterministic pseudo-random generator.
+ */
+class PayloadRandom
+{
+public:
+    PayloadRandom( uint32 seed ) : mState( seed ) {}
+
+    /** @return Next pseudo-random number. */
+    uint32 Next()
+    {
+        mState = mState * 1103515245 + 12345;
+        return ( mState >> 16 ) & 0x7FFF;
+    }
+    /** @return Pseudo-random number in range [first, last). */
+    uint32 Next( uint32 first, uint32 last ) { return first + Next() % ( last - first ); }
+    /** @return Pseudo-random number in range [0, 1). */
+    double NextReal() { return Next() / 32768.0; }
+
+protected:
+    /// Current state.
+    uint32 mState;
+};
+
+PyRep* MakeMarketOrders()
+{
+    // columns and types as they come out of MarketDB::GetOrders
+    DBRowDescriptor* header = new DBRowDescriptor;
+    header->AddColumn( "price",         DBTYPE_R8 );
+    header->AddColumn( "volRemaining",  DBTYPE_R8 );
+    header->AddColumn( "typeID",        DBTYPE_I4 );
+    header->AddColumn( "range",         DBTYPE_I4 );
+    header->AddColumn( "orderID",       DBTYPE_I4 );
+    header->AddColumn( "volEntered",    DBTYPE_I4 );
+    header->AddColumn( "minVolume",     DBTYPE_I4 );
+    header->AddColumn( "bid",           DBTYPE_BOOL );
+    header->AddColumn( "issueDate",     DBTYPE_I8 );
+    header->AddColumn( "duration",      DBTYPE_I4 );
+    header->AddColumn( "stationID",     DBTYPE_I4 );
+    header->AddColumn( "regionID",      DBTYPE_I4 );
+    header->AddColumn( "solarSystemID", DBTYPE_I4 );
+    header->AddColumn( "jumps",         DBTYPE_I4 );
+
+    CRowSet* rowset = new CRowSet( &header );
+
+    PayloadRandom rand( 1 );
+    const uint64 now = 129000000000000000LL;
+
+    for( uint32 i = 0; i < MARKET_ORDER_COUNT; ++i )
+    {
+        const uint32 volEntered = rand.Next( 1, 10000 );
+
+        PyPackedRow* row = rowset->NewRow();
+        row->SetField( (uint32)0,  new PyFloat( rand.Next( 100, 20000 ) / 100.0 ) );
+        row->SetField( 1,  new PyFloat( rand.Next( 1, volEntered + 1 ) ) );
+        row->SetField( 2,  new PyInt( 34 ) );
+        row->SetField( 3,  new PyInt( 0 == rand.Next( 0, 4 ) ? 32767 : -1 ) );
+        row->SetField( 4,  new PyInt( 1000000 + i ) );
+        row->SetField( 5,  new PyInt( volEntered ) );
+        row->SetField( 6,  new PyInt( 1 ) );
+        row->SetField( 7,  new PyBool( 0 == rand.Next( 0, 2 ) ) );
+        row->SetField( 8,  new PyLong( now - (int64)rand.Next() * Win32Time_Minute ) );
+        row->SetField( 9,  new PyInt( 90 ) );
+        row->SetField( 10, new PyInt( 60000000 + rand.Next( 0, 5000 ) ) );
+        row->SetField( 11, new PyInt( 10000002 ) );
+        row->SetField( 12, new PyInt( 30000000 + rand.Next( 0, 8000 ) ) );
+        row->SetField( 13, new PyInt( 0 ) );
+    }
+
+    return rowset;
+}
+
+PyRep* MakeDestinyUpdate()
+{
+    PayloadRandom rand( 2 );
+    const int32 stamp = 1000;
+
+    DoDestinyUpdateMain dum;
+    dum.updates = new PyList;
+    dum.events = new PyList;
+    dum.waitForBubble = false;
+
+    for( uint32 i = 0; i < DESTINY_ACTION_COUNT; ++i )
+    {
+        const int32 entityID = FIRST_ENTITY_ID + rand.Next( 0, BUBBLE_BALL_COUNT );
+
+        DoDestinyAction act;
+        act.update_id = stamp;
+
+        // the usual mix of movement and damage updates
+        switch( i % 4 )
+        {
+            case 0:
+            {
+                DoDestiny_CmdGotoDirection gd;
+                gd.entityID = entityID;
+                gd.x = rand.NextReal() - 0.5;
+                gd.y = rand.NextReal() - 0.5;
+                gd.z = rand.NextReal() - 0.5;
+                act.update = gd.Encode();
+            } break;
+
+            case 1:
+            {
+                DoDestiny_CmdSetSpeedFraction sf;
+                sf.entityID = entityID;
+                sf.fraction = rand.NextReal();
+                act.update = sf.Encode();
+            } break;
+
+            case 2:
+            {
+                DoDestiny_SetBallVelocity bv;
+                bv.entityID = entityID;
+                bv.x = rand.Next( 0, 300 );
+                bv.y = rand.Next( 0, 300 );
+                bv.z = rand.Next( 0, 300 );
+                act.update = bv.Encode();
+            } break;
+
+            case 3:
+            {
+                DoDestinyDamageState ds;
+                ds.shield = rand.NextReal();
+                ds.tau = 100000;
+                ds.timestamp = Win32TimeNow();
+                ds.armor = rand.NextReal();
+                ds.structure = 1.0;
+
+                DoDestiny_OnDamageStateChange dsc;
+                dsc.entityID = entityID;
+                dsc.state = ds.Encode();
+                act.update = dsc.Encode();
+            } break;
+        }
+
+        dum.updates->AddItem( act.Encode() );
+    }
+
+    return dum.Encode();
+}
+
+void MakeMovementUpdates( std::vector<PyTuple*>& into )
+{
+    PayloadRandom rand( 4 );
+
+    for( uint32 i = 0; i < MOVING_SHIP_COUNT; ++i )
+    {
+        DoDestiny_CmdGotoDirection gd;
+        gd.entityID = FIRST_ENTITY_ID + i;
+        gd.x = rand.NextReal() - 0.5;
+        gd.y = rand.NextReal() - 0.5;
+        gd.z = rand.NextReal() - 0.5;
+
+        into.push_back( gd.Encode() );
+    }
+}
+
+PyRep* MakeSetState()
+{
+    PayloadRandom rand( 3 );
+
+    DoDestiny_SetState ss;
+    ss.stamp = 1000;
+    ss.ego = FIRST_ENTITY_ID;
+
+    Buffer* stateBuffer = new Buffer;
+
+    Destiny::AddBall_header head;
+    head.packet_type = 0;
+    head.sequence = ss.stamp;
+    stateBuffer->Append( head );
+
+    ss.slims = new PyList;
+
+    for( uint32 i = 0; i < BUBBLE_BALL_COUNT; ++i )
+    {
+        const uint32 entityID = FIRST_ENTITY_ID + i;
+        const uint32 typeID = 580 + rand.Next( 0, 100 );
+        const uint32 corpID = 1000000 + rand.Next( 0, 50 );
+
+        // same layout as ShipEntity::EncodeDestiny
+        Destiny::BallHeader ball;
+        ball.entityID = entityID;
+        ball.mode = Destiny::DSTBALL_STOP;
+        ball.radius = 50.0f + rand.Next( 0, 300 );
+        ball.x = -1.0e11 + rand.Next() * 100.0;
+        ball.y = 2.0e10 + rand.Next() * 100.0;
+        ball.z = 3.0e11 + rand.Next() * 100.0;
+        ball.sub_type = Destiny::IsMassive | Destiny::IsFree;
+        stateBuffer->Append( ball );
+
+        Destiny::MassSector mass;
+        mass.mass = 1.0e6 + rand.Next() * 100.0;
+        mass.cloak = 0;
+        mass.Harmonic = -1.0f;
+        mass.corpID = corpID;
+        mass.allianceID = 0;
+        stateBuffer->Append( mass );
+
+        Destiny::ShipSector ship;
+        ship.max_speed = 150.0f + rand.Next( 0, 300 );
+        ship.velocity_x = 0.0;
+        ship.velocity_y = 0.0;
+        ship.velocity_z = 0.0;
+        ship.agility = 0.5f;
+        ship.speed_fraction = 0.0f;
+        stateBuffer->Append( ship );
+
+        Destiny::DSTBALL_STOP_Struct main;
+        main.formationID = 0xFF;
+        stateBuffer->Append( main );
+
+        DoDestinyDamageState ds;
+        ds.shield = 1.0;
+        ds.tau = 100000;
+        ds.timestamp = Win32TimeNow();
+        ds.armor = 1.0;
+        ds.structure = 1.0;
+        ss.damageState[ entityID ] = ds.Encode();
+
+        // same content as Client::MakeSlimItem
+        PyDict* slim = new PyDict;
+        slim->SetItemString( "itemID", new PyInt( entityID ) );
+        slim->SetItemString( "typeID", new PyInt( typeID ) );
+        slim->SetItemString( "ownerID", new PyInt( 90000000 + i ) );
+        slim->SetItemString( "charID", new PyInt( 90000000 + i ) );
+        slim->SetItemString( "corpID", new PyInt( corpID ) );
+        slim->SetItemString( "allianceID", new PyNone );
+        slim->SetItemString( "warFactionID", new PyNone );
+
+        PyList* modules = new PyList;
+        for( uint32 j = 0; j < 8; ++j )
+            modules->AddItem( new_tuple( entityID + 1000000 + j, 2000 + rand.Next( 0, 1000 ) ) );
+        slim->SetItemString( "modules", modules );
+
+        slim->SetItemString( "color", new PyFloat( 0.0 ) );
+        slim->SetItemString( "bounty", new PyFloat( 0.0 ) );
+        slim->SetItemString( "securityStatus", new PyFloat( rand.NextReal() * 10.0 - 5.0 ) );
+
+        ss.slims->AddItem( new PyObject( "foo.SlimItem", slim ) );
+    }
+
+    ss.destiny_state = new PyBuffer( &stateBuffer );
+    SafeDelete( stateBuffer );
+
+    ss.droneState = new PyNone;
+    ss.solItem = new PyNone;
+    ss.effectStates = new PyList;
+    ss.allianceBridges = new PyList;
+
+    return ss.Encode();
+}
+
+PyRep* MakeCachedObject()
+{
+    PyRep* payload = MakeMarketOrders();
+
+    CachedObjectMgr cache;
+    cache.UpdateCache( "config.BulkData.benchmark", &payload );
+
+    return cache.GetCachedObject( "config.BulkData.benchmark" );
+}
@@ -0,0 +1,74 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __PAYLOADS_H__INCL__
+#define __PAYLOADS_H__INCL__
+
+/*
+ * Representative payloads for benchmarks. All of them are
+ * built from fixed pseudo-random data, so results are
+ * comparable between runs.
+ */
+
+/// Number of rows in market order rowset.
+extern const uint32 MARKET_ORDER_COUNT;
+/// Number of actions in destiny update.
+extern const uint32 DESTINY_ACTION_COUNT;
+/// Number of balls in bubble of SetState.
+extern const uint32 BUBBLE_BALL_COUNT;
+/// Number of moving ships in destiny tick.
+extern const uint32 MOVING_SHIP_COUNT;
+
+/**
+ * @brief Builds market order rowset, as returned by MarketDB::GetOrders.
+ *
+ * @return New rowset with MARKET_ORDER_COUNT rows.
+ */
+extern PyRep* MakeMarketOrders();
+/**
+ * @brief Builds a batch of destiny updates, as sent each tick.
+ *
+ * @return New DoDestinyUpdateMain with DESTINY_ACTION_COUNT actions.
+ */
+extern PyRep* MakeDestinyUpdate();
+/**
+ * @brief Builds movement updates of one tick, one per moving ship.
+ *
+ * @param[out] into Where to store MOVING_SHIP_COUNT new updates.
+ */
+extern void MakeMovementUpdates( std::vector<PyTuple*>& into );
+/**
+ * @brief Builds SetState of a busy bubble, as sent on entering space.
+ *
+ * @return New DoDestiny_SetState with BUBBLE_BALL_COUNT ships.
+ */
+extern PyRep* MakeSetState();
+/**
+ * @brief Builds cached object, as returned by GetCachableObject.
+ *
+ * @return New objectCaching.CachedObject holding market order rowset.
+ */
+extern PyRep* MakeCachedObject();
+
+#endif /* !__PAYLOADS_H__INCL__ */
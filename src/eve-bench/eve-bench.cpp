@@ -0,0 +1,99 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-bench.h"
+
+#include "Benchmarks.h"
+
+/**
+ * @brief Prints usage.
+ */
+static void PrintUsage()
+{
+    fprintf( stderr,
+        "Usage: eve-bench [-t <milliseconds>] [<filter> ...]\n"
+        "\n"
+        "Runs benchmarks whose names contain any of <filter>s (all by default)\n"
+        "and prints time, bytes allocated and allocations per operation.\n"
+        "\n"
+        "Options:\n"
+        "  -t <milliseconds>  Minimal measuring time per benchmark (default 1000).\n" );
+}
+
+int main( int argc, char* argv[] )
+{
+#if defined( HAVE_CRTDBG_H ) && !defined( NDEBUG )
+    // Under Visual Studio setup memory leak detection
+    _CrtSetDbgFlag( _CRTDBG_LEAK_CHECK_DF | _CrtSetDbgFlag( _CRTDBG_REPORT_FLAG ) );
+#endif /* defined( HAVE_CRTDBG_H ) && !defined( NDEBUG ) */
+
+    uint64 minTimeMs = 1000;
+    std::vector<std::string> filters;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg( argv[ i ] );
+
+        if( "-t" == arg && i + 1 < argc )
+            minTimeMs = str2<uint64>( argv[ ++i ] );
+        else if( '-' != arg[0] )
+            filters.push_back( arg );
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::vector<Benchmark*> benchmarks;
+    GetBenchmarks( benchmarks );
+
+    BenchmarkRunner runner( minTimeMs * 1000 );
+    BenchmarkRunner::PrintHeader( stdout );
+
+    int ret = 0;
+    for( size_t i = 0; i < benchmarks.size(); ++i )
+    {
+        Benchmark* bench = benchmarks[ i ];
+
+        bool selected = filters.empty();
+        for( size_t j = 0; !selected && j < filters.size(); ++j )
+            selected = ( std::string::npos != bench->name().find( filters[ j ] ) );
+
+        if( selected )
+        {
+            BenchmarkResult result;
+            if( runner.Run( *bench, result ) )
+                BenchmarkRunner::PrintResult( stdout, bench->name(), result );
+            else
+                ret = 2;
+
+            fflush( stdout );
+        }
+
+        SafeDelete( bench );
+    }
+
+    return ret;
+}
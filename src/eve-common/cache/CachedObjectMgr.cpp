@@ -51,11 +51,12 @@ CachedObjectMgr::~CachedObjectMgr()
 /************************************************************************/
 /* CacheRecord                                                          */
 /************************************************************************/
-CachedObjectMgr::CacheRecord::CacheRecord() : objectID(NULL), timestamp(0), version(0), cache(NULL) {}
+CachedObjectMgr::CacheRecord::CacheRecord() : objectID(NULL), timestamp(0), version(0), cache(NULL), encoded(NULL) {}
 CachedObjectMgr::CacheRecord::~CacheRecord()
 {
     PyDecRef( objectID );
     PyDecRef( cache );
+    PySafeDecRef( encoded );
 }
 
 PyObject *CachedObjectMgr::CacheRecord::EncodeHint() const
@@ -142,6 +143,21 @@ void CachedObjectMgr::UpdateCache(const std::string &objectID, PyRep **in_cached
 }
 
 void CachedObjectMgr::UpdateCache(const PyRep *objectID, PyRep **in_cached_data)
+{
+    // deflated once and served many times, so spend the extra time
+    PyBuffer* buf = _Deflate( in_cached_data, Z_BEST_COMPRESSION );
+    if( buf != NULL )
+        _UpdateCache( objectID, &buf );
+}
+
+void CachedObjectMgr::UpdateCache(const PyRep *objectID, PyRep **in_cached_data, uint32 version)
+{
+    PyBuffer* buf = _Deflate( in_cached_data, Z_DEFAULT_COMPRESSION );
+    if( buf != NULL )
+        _UpdateCache( objectID, &buf, version );
+}
+
+PyBuffer *CachedObjectMgr::_Deflate(PyRep **in_cached_data, int level)
 {
     PyRep *cached_data = *in_cached_data;
     *in_cached_data = NULL;
@@ -152,20 +168,27 @@ void CachedObjectMgr::UpdateCache(const PyRep *objectID, PyRep **in_cached_data)
     //}
 
     Buffer* data = new Buffer;
-    bool res = MarshalDeflate( cached_data, *data );
+    bool res = MarshalDeflate( cached_data, *data, 0x2000, level );
     PyDecRef( cached_data );
 
+    PyBuffer* buf = NULL;
     if( res ) {
-        PyBuffer* buf = new PyBuffer( &data );
-        _UpdateCache( objectID, &buf );
+        buf = new PyBuffer( &data );
     } else {
         sLog.Error( "Cached Obj Mgr", "Failed to marshal or deflate new cache object." );
     }
 
     SafeDelete( data );
+    return buf;
 }
 
 void CachedObjectMgr::_UpdateCache(const PyRep *objectID, PyBuffer **buffer)
+{
+    const uint32 version = CRC32::Generate( &(*buffer)->content()[0], (*buffer)->content().size() );
+    _UpdateCache( objectID, buffer, version );
+}
+
+void CachedObjectMgr::_UpdateCache(const PyRep *objectID, PyBuffer **buffer, uint32 version)
 {
     //this is the hard one..
     CacheRecord *r = new CacheRecord;
@@ -176,7 +199,7 @@ void CachedObjectMgr::_UpdateCache(const PyRep *objectID, PyBuffer **buffer)
     r->cache = *buffer;
     *buffer = NULL;
 
-    r->version = CRC32::Generate( &r->cache->content()[0], r->cache->content().size() );
+    r->version = version;
 
     const std::string str = OIDToString(objectID);
 
@@ -252,6 +275,37 @@ PyObject *CachedObjectMgr::GetCachedObject(const PyRep *objectID)
     return result;
 }
 
+PySubStream *CachedObjectMgr::GetEncodedCachedObject(const PyRep *objectID)
+{
+    const std::string str = OIDToString(objectID);
+
+    CachedObjMapItr res = m_cachedObjects.find(str);
+    if(res == m_cachedObjects.end())
+        return NULL;
+
+    CacheRecord *r = res->second;
+    if(r->encoded == NULL) {
+        PyObject *obj = GetCachedObject(objectID);
+
+        Buffer *data = new Buffer;
+        bool ok = Marshal( obj, *data );
+        PyDecRef( obj );
+
+        if( !ok ) {
+            sLog.Error( "Cached Obj Mgr", "Failed to marshal cached object '%s'.", str.c_str() );
+            SafeDelete( data );
+            return NULL;
+        }
+
+        sLog.Debug("CachedObjMgr","Encoded cached object '%s' with checksum 0x%x to length %u", str.c_str(), r->version, data->size());
+
+        r->encoded = new PySubStream( new PyBuffer( &data ) );
+    }
+
+    PyIncRef( r->encoded );
+    return r->encoded;
+}
+
 bool CachedObjectMgr::IsCacheUpToDate(const PyRep *objectID, uint32 version, uint64 timestamp)
 {
     const std::string str = OIDToString(objectID);
@@ -73,6 +73,19 @@ public:
     void UpdateCacheFromSS(const std::string &objectID, PySubStream **in_cached_data);
     void UpdateCache(const std::string &objectID, PyRep **in_cached_data);
     void UpdateCache(const PyRep *objectID, PyRep **in_cached_data);
+    /**
+     * @brief Updates cached object with a version stamp maintained by the caller.
+     *
+     * For objects which change often and keep their own stamp
+     * (see MarketOrderBook); skips checksumming the marshaled contents
+     * and deflates with the default level, as the result is
+     * unlikely to be served many times.
+     *
+     * @param[in] objectID       ID of object to update.
+     * @param[in] in_cached_data New contents; consumed.
+     * @param[in] version        Version stamp of the contents.
+     */
+    void UpdateCache(const PyRep *objectID, PyRep **in_cached_data, uint32 version);
 
     PyObject *MakeCacheHint(const PyRep *objectID);
     PyObject *MakeCacheHint(const std::string &objectID);
@@ -80,6 +93,19 @@ public:
     PyObject *GetCachedObject(const PyRep *objectID);
     PyObject *GetCachedObject(const std::string &objectID);
 
+    /**
+     * @brief Obtains marshaled cached object.
+     *
+     * The object is marshaled once per version and kept, so it can be
+     * put into call responses without encoding it again; since its
+     * contents are deflated already, the response needs no deflation.
+     *
+     * @param[in] objectID ID of object to obtain.
+     *
+     * @return Substream with marshaled object (new reference); NULL if not cached.
+     */
+    PySubStream *GetEncodedCachedObject(const PyRep *objectID);
+
 //OLD CCP FILE BASED ACCESS:
     //PyRep *_MakeCacheHint(const char *oname);
     //void AddCacheHint(const char *oname, const char *key, PyDict *into);
@@ -101,6 +127,8 @@ protected:
     void GetCacheFileName(PyRep *key, std::string &into);
 
     void _UpdateCache(const PyRep *objectID, PyBuffer **buffer);
+    void _UpdateCache(const PyRep *objectID, PyBuffer **buffer, uint32 version);
+    static PyBuffer *_Deflate(PyRep **in_cached_data, int level);
 
     class CacheRecord {
     public:
@@ -113,6 +141,7 @@ protected:
         uint64 timestamp;
         uint32 version;
         PyBuffer *cache; //we own this.
+        PySubStream *encoded; //we own this; marshaled CachedObject, built on demand.
     };
     typedef std::map<std::string, CacheRecord *>    CachedObjMap;
     typedef CachedObjMap::iterator                  CachedObjMapItr;
@@ -0,0 +1,378 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-common.h"
+
+#include "cache/StaticDataSnapshot.h"
+
+namespace
+{
+    const char SNAPSHOT_MAGIC[ 8 ] = { 'E', 'V', 'E', 'M', 'U', 'S', 'D', 0 };
+
+    /// Element sizes of the sections.
+    const size_t SECTION_ELEMENT_SIZE[ StaticDataSnapshot::SECTION_COUNT ] =
+    {
+        sizeof( char ),
+        sizeof( uint32 ),
+        sizeof( StaticDataSnapshot::CategoryRecord ),
+        sizeof( uint32 ),
+        sizeof( StaticDataSnapshot::GroupRecord ),
+        sizeof( uint32 ),
+        sizeof( StaticDataSnapshot::TypeRecord ),
+        sizeof( StaticDataSnapshot::AttributeRecord ),
+        sizeof( uint32 )
+    };
+
+    /**
+     * @brief Appends a section to the file image.
+     */
+    void AppendSection( std::vector<uint8>& image, StaticDataSnapshot::Section section, const void* data, uint32 count )
+    {
+        // align the section for its doubles
+        image.resize( ( image.size() + 7 ) & ~7 );
+
+        StaticDataSnapshot::Header& header = *reinterpret_cast<StaticDataSnapshot::Header*>( &image[ 0 ] );
+        header.sections[ section ].offset = image.size();
+        header.sections[ section ].count = count;
+
+        const uint8* bytes = static_cast<const uint8*>( data );
+        image.insert( image.end(), bytes, bytes + count * SECTION_ELEMENT_SIZE[ section ] );
+    }
+
+    /**
+     * @brief Builds a dense index of the records.
+     */
+    template<typename T>
+    void BuildIndex( const std::map<uint32, T>& records, std::vector<uint32>& index, std::vector<T>& packed )
+    {
+        index.assign( records.empty() ? 0 : records.rbegin()->first + 1, StaticDataSnapshot::NO_RECORD );
+        packed.reserve( records.size() );
+
+        typename std::map<uint32, T>::const_iterator cur, end;
+        cur = records.begin();
+        end = records.end();
+        for(; cur != end; ++cur )
+        {
+            index[ cur->first ] = packed.size();
+            packed.push_back( cur->second );
+        }
+    }
+
+    /** @return Pointer to the first element; NULL if empty. */
+    template<typename T>
+    const T* Data( const std::vector<T>& v )
+    {
+        return v.empty() ? NULL : &v[ 0 ];
+    }
+}
+
+/*************************************************************************/
+/* StaticDataSnapshot                                                    */
+/*************************************************************************/
+const uint32 StaticDataSnapshot::VERSION;
+const uint32 StaticDataSnapshot::NO_RECORD;
+
+StaticDataSnapshot::StaticDataSnapshot()
+{
+}
+
+bool StaticDataSnapshot::Open( const char* path, uint32 stamp )
+{
+    if( !mFile.Open( path ) )
+        return false;
+
+    if( !_Validate( stamp ) )
+    {
+        mFile.Close();
+        return false;
+    }
+
+    return true;
+}
+
+void StaticDataSnapshot::Close()
+{
+    mFile.Close();
+}
+
+const StaticDataSnapshot::CategoryRecord* StaticDataSnapshot::GetCategory( uint32 categoryID ) const
+{
+    return _Lookup<CategoryRecord>( SECTION_CATEGORY_INDEX, SECTION_CATEGORIES, categoryID );
+}
+
+const StaticDataSnapshot::GroupRecord* StaticDataSnapshot::GetGroup( uint32 groupID ) const
+{
+    return _Lookup<GroupRecord>( SECTION_GROUP_INDEX, SECTION_GROUPS, groupID );
+}
+
+const StaticDataSnapshot::TypeRecord* StaticDataSnapshot::GetType( uint32 typeID ) const
+{
+    return _Lookup<TypeRecord>( SECTION_TYPE_INDEX, SECTION_TYPES, typeID );
+}
+
+bool StaticDataSnapshot::_Validate( uint32 stamp ) const
+{
+    if( mFile.size() < sizeof( Header ) )
+        return false;
+
+    const Header& header = _GetHeader();
+    if( 0 != memcmp( header.magic, SNAPSHOT_MAGIC, sizeof( SNAPSHOT_MAGIC ) )
+        || VERSION != header.version || stamp != header.stamp )
+        return false;
+
+    // all sections within the file
+    for( uint32 i = 0; i < SECTION_COUNT; ++i )
+    {
+        const SectionEntry& section = header.sections[ i ];
+        if( 0 != section.offset % 8
+            || (uint64)section.offset + (uint64)section.count * SECTION_ELEMENT_SIZE[ i ] > mFile.size() )
+            return false;
+    }
+
+    // strings terminated
+    const uint32 stringCount = _GetCount( SECTION_STRINGS );
+    if( 0 == stringCount || '\0' != _GetSection<char>( SECTION_STRINGS )[ stringCount - 1 ] )
+        return false;
+
+    // indexes point to records
+    const Section indexes[] = { SECTION_CATEGORY_INDEX, SECTION_GROUP_INDEX, SECTION_TYPE_INDEX };
+    for( uint32 i = 0; i < sizeof( indexes ) / sizeof( indexes[ 0 ] ); ++i )
+    {
+        const uint32* index = _GetSection<uint32>( indexes[ i ] );
+        const uint32 count = _GetCount( indexes[ i ] );
+        const uint32 records = _GetCount( Section( indexes[ i ] + 1 ) );
+
+        for( uint32 id = 0; id < count; ++id )
+            if( NO_RECORD != index[ id ] && index[ id ] >= records )
+                return false;
+    }
+
+    // records point to strings, attributes and effects
+    const CategoryRecord* categories = _GetSection<CategoryRecord>( SECTION_CATEGORIES );
+    for( uint32 i = 0; i < _GetCount( SECTION_CATEGORIES ); ++i )
+        if( categories[ i ].name >= stringCount || categories[ i ].description >= stringCount )
+            return false;
+
+    const GroupRecord* groups = _GetSection<GroupRecord>( SECTION_GROUPS );
+    for( uint32 i = 0; i < _GetCount( SECTION_GROUPS ); ++i )
+        if( groups[ i ].name >= stringCount || groups[ i ].description >= stringCount )
+            return false;
+
+    const uint32 attributeCount = _GetCount( SECTION_ATTRIBUTES );
+    const uint32 effectCount = _GetCount( SECTION_EFFECTS );
+
+    const TypeRecord* types = _GetSection<TypeRecord>( SECTION_TYPES );
+    for( uint32 i = 0; i < _GetCount( SECTION_TYPES ); ++i )
+    {
+        const TypeRecord& type = types[ i ];
+        if( type.name >= stringCount || type.description >= stringCount
+            || (uint64)type.firstAttribute + type.attributeCount > attributeCount
+            || (uint64)type.firstEffect + type.effectCount > effectCount )
+            return false;
+    }
+
+    return true;
+}
+
+/*************************************************************************/
+/* StaticDataBuilder                                                     */
+/*************************************************************************/
+StaticDataBuilder::StaticDataBuilder()
+: mStrings( 1, '\0' )
+{
+}
+
+void StaticDataBuilder::AddCategory( uint32 categoryID, const std::string& name, const std::string& description, bool published )
+{
+    CategoryRecord category;
+    memset( &category, 0, sizeof( category ) );
+
+    category.name = _AddString( name );
+    category.description = _AddString( description );
+    category.published = published ? 1 : 0;
+
+    mCategories[ categoryID ] = category;
+}
+
+void StaticDataBuilder::AddGroup( uint32 groupID, uint32 categoryID, const std::string& name, const std::string& description, uint8 flags )
+{
+    GroupRecord group;
+    memset( &group, 0, sizeof( group ) );
+
+    group.categoryID = categoryID;
+    group.name = _AddString( name );
+    group.description = _AddString( description );
+    group.flags = flags;
+
+    mGroups[ groupID ] = group;
+}
+
+void StaticDataBuilder::AddType( uint32 typeID, const TypeRecord& type, const std::string& name, const std::string& description )
+{
+    TypeRecord& record = mTypes[ typeID ];
+    record = type;
+
+    memset( record.pad, 0, sizeof( record.pad ) );
+    record.name = _AddString( name );
+    record.description = _AddString( description );
+}
+
+void StaticDataBuilder::AddTypeAttribute( uint32 typeID, uint16 attributeID, int32 value )
+{
+    AttributeRecord attribute;
+    memset( &attribute, 0, sizeof( attribute ) );
+
+    attribute.attributeID = attributeID;
+    attribute.isInt = 1;
+    attribute.valueInt = value;
+    attribute.valueFloat = value;
+
+    mAttributes[ typeID ].push_back( attribute );
+}
+
+void StaticDataBuilder::AddTypeAttribute( uint32 typeID, uint16 attributeID, double value )
+{
+    AttributeRecord attribute;
+    memset( &attribute, 0, sizeof( attribute ) );
+
+    attribute.attributeID = attributeID;
+    attribute.isInt = 0;
+    attribute.valueInt = 0;
+    attribute.valueFloat = value;
+
+    mAttributes[ typeID ].push_back( attribute );
+}
+
+void StaticDataBuilder::AddTypeEffect( uint32 typeID, uint32 effectID )
+{
+    mEffects[ typeID ].push_back( effectID );
+}
+
+void StaticDataBuilder::SetWreckType( uint32 typeID, uint32 wreckTypeID )
+{
+    mWrecks[ typeID ] = wreckTypeID;
+}
+
+bool StaticDataBuilder::Write( const char* path, uint32 stamp ) const
+{
+    // lay out types along with their attributes and effects
+    std::map<uint32, TypeRecord> types( mTypes );
+    std::vector<AttributeRecord> attributes;
+    std::vector<uint32> effects;
+
+    std::map<uint32, TypeRecord>::iterator cur, end;
+    cur = types.begin();
+    end = types.end();
+    for(; cur != end; ++cur )
+    {
+        TypeRecord& type = cur->second;
+
+        std::map<uint32, uint32>::const_iterator wreck = mWrecks.find( cur->first );
+        type.wreckTypeID = mWrecks.end() == wreck ? 0 : wreck->second;
+
+        type.firstAttribute = attributes.size();
+        type.attributeCount = 0;
+        std::map<uint32, std::vector<AttributeRecord> >::const_iterator attrs = mAttributes.find( cur->first );
+        if( mAttributes.end() != attrs )
+        {
+            attributes.insert( attributes.end(), attrs->second.begin(), attrs->second.end() );
+            type.attributeCount = attrs->second.size();
+        }
+
+        type.firstEffect = effects.size();
+        type.effectCount = 0;
+        std::map<uint32, std::vector<uint32> >::const_iterator effs = mEffects.find( cur->first );
+        if( mEffects.end() != effs )
+        {
+            effects.insert( effects.end(), effs->second.begin(), effs->second.end() );
+            type.effectCount = effs->second.size();
+        }
+    }
+
+    std::vector<uint32> categoryIndex, groupIndex, typeIndex;
+    std::vector<CategoryRecord> categoryRecords;
+    std::vector<GroupRecord> groupRecords;
+    std::vector<TypeRecord> typeRecords;
+
+    BuildIndex( mCategories, categoryIndex, categoryRecords );
+    BuildIndex( mGroups, groupIndex, groupRecords );
+    BuildIndex( types, typeIndex, typeRecords );
+
+    // assemble the image
+    std::vector<uint8> image( sizeof( StaticDataSnapshot::Header ), 0 );
+
+    StaticDataSnapshot::Header& header = *reinterpret_cast<StaticDataSnapshot::Header*>( &image[ 0 ] );
+    memcpy( header.magic, SNAPSHOT_MAGIC, sizeof( SNAPSHOT_MAGIC ) );
+    header.version = StaticDataSnapshot::VERSION;
+    header.stamp = stamp;
+
+    AppendSection( image, StaticDataSnapshot::SECTION_STRINGS, Data( mStrings ), mStrings.size() );
+    AppendSection( image, StaticDataSnapshot::SECTION_CATEGORY_INDEX, Data( categoryIndex ), categoryIndex.size() );
+    AppendSection( image, StaticDataSnapshot::SECTION_CATEGORIES, Data( categoryRecords ), categoryRecords.size() );
+    AppendSection( image, StaticDataSnapshot::SECTION_GROUP_INDEX, Data( groupIndex ), groupIndex.size() );
+    AppendSection( image, StaticDataSnapshot::SECTION_GROUPS, Data( groupRecords ), groupRecords.size() );
+    AppendSection( image, StaticDataSnapshot::SECTION_TYPE_INDEX, Data( typeIndex ), typeIndex.size() );
+    AppendSection( image, StaticDataSnapshot::SECTION_TYPES, Data( typeRecords ), typeRecords.size() );
+    AppendSection( image, StaticDataSnapshot::SECTION_ATTRIBUTES, Data( attributes ), attributes.size() );
+    AppendSection( image, StaticDataSnapshot::SECTION_EFFECTS, Data( effects ), effects.size() );
+
+    // write aside, then replace
+    const std::string tmpPath = std::string( path ) + ".tmp";
+
+    FILE* file = fopen( tmpPath.c_str(), "wb" );
+    if( NULL == file )
+        return false;
+
+    const bool written = ( 1 == fwrite( &image[ 0 ], image.size(), 1, file ) );
+    if( 0 != fclose( file ) || !written )
+    {
+        remove( tmpPath.c_str() );
+        return false;
+    }
+
+#ifdef HAVE_WINDOWS_H
+    // rename does not replace on Windows
+    remove( path );
+#endif /* HAVE_WINDOWS_H */
+
+    if( 0 != rename( tmpPath.c_str(), path ) )
+    {
+        remove( tmpPath.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+uint32 StaticDataBuilder::_AddString( const std::string& str )
+{
+    if( str.empty() )
+        return 0;
+
+    const uint32 offset = mStrings.size();
+    mStrings.insert( mStrings.end(), str.begin(), str.end() );
+    mStrings.push_back( '\0' );
+
+    return offset;
+}
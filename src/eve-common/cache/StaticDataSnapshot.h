@@ -0,0 +1,308 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __CACHE__STATIC_DATA_SNAPSHOT_H__INCL__
+#define __CACHE__STATIC_DATA_SNAPSHOT_H__INCL__
+
+#include "utils/MappedFile.h"
+
+/**
+ * @brief Binary snapshot of item static data.
+ *
+ * Holds categories, groups, types, type attributes, type effects
+ * and wreck types in dense ID-indexed tables: for each kind there
+ * is an array indexed by ID holding position of the record in
+ * a packed record array (or NO_RECORD).
+ *
+ * The file is mapped read-only, so all lookups are plain array
+ * accesses and the data is shared between threads without locking.
+ * It uses native byte order; it is a local cache, not an exchange
+ * format.
+ *
+ * Layout:
+ *   Header
+ *   sections, each aligned to 8 bytes, in the order of Section.
+ */
+class StaticDataSnapshot
+{
+public:
+    /// Format version; bump on any layout change.
+    static const uint32 VERSION = 1;
+    /// Value of an index slot with no record.
+    static const uint32 NO_RECORD = 0xFFFFFFFF;
+
+    /// Sections of the file.
+    enum Section
+    {
+        SECTION_STRINGS,        ///< char; NUL-terminated strings, "" at 0.
+        SECTION_CATEGORY_INDEX, ///< uint32; categoryID to record.
+        SECTION_CATEGORIES,     ///< CategoryRecord.
+        SECTION_GROUP_INDEX,    ///< uint32; groupID to record.
+        SECTION_GROUPS,         ///< GroupRecord.
+        SECTION_TYPE_INDEX,     ///< uint32; typeID to record.
+        SECTION_TYPES,          ///< TypeRecord.
+        SECTION_ATTRIBUTES,     ///< AttributeRecord; grouped by type.
+        SECTION_EFFECTS,        ///< uint32 effectID; grouped by type.
+
+        SECTION_COUNT
+    };
+
+    /// Group flags.
+    enum GroupFlag
+    {
+        GROUP_USE_BASE_PRICE           = 0x01,
+        GROUP_ALLOW_MANUFACTURE        = 0x02,
+        GROUP_ALLOW_RECYCLER           = 0x04,
+        GROUP_ANCHORED                 = 0x08,
+        GROUP_ANCHORABLE               = 0x10,
+        GROUP_FITTABLE_NON_SINGLETON   = 0x20,
+        GROUP_PUBLISHED                = 0x40
+    };
+
+    struct SectionEntry
+    {
+        /// Offset from the start of the file.
+        uint32 offset;
+        /// Number of elements.
+        uint32 count;
+    };
+
+    struct Header
+    {
+        char magic[ 8 ];
+        uint32 version;
+        /// Fingerprint of the source data.
+        uint32 stamp;
+        SectionEntry sections[ SECTION_COUNT ];
+    };
+
+    struct CategoryRecord
+    {
+        uint32 name;
+        uint32 description;
+        uint8 published;
+        uint8 pad[ 7 ];
+    };
+
+    struct GroupRecord
+    {
+        uint32 categoryID;
+        uint32 name;
+        uint32 description;
+        /// Combination of GroupFlag.
+        uint8 flags;
+        uint8 pad[ 3 ];
+    };
+
+    struct TypeRecord
+    {
+        double radius;
+        double mass;
+        double volume;
+        double capacity;
+        double basePrice;
+        double chanceOfDuplicating;
+
+        uint32 groupID;
+        uint32 name;
+        uint32 description;
+        uint32 portionSize;
+        uint32 raceID;
+        uint32 marketGroupID;
+        /// Type of wreck left by the type; 0 if none.
+        uint32 wreckTypeID;
+        uint8 published;
+        uint8 pad[ 3 ];
+
+        uint32 firstAttribute;
+        uint32 attributeCount;
+        uint32 firstEffect;
+        uint32 effectCount;
+    };
+
+    struct AttributeRecord
+    {
+        uint16 attributeID;
+        /// Whether valueInt (rather than valueFloat) holds the value.
+        uint8 isInt;
+        uint8 pad;
+        int32 valueInt;
+        double valueFloat;
+    };
+
+    StaticDataSnapshot();
+
+    /**
+     * @brief Maps and validates a snapshot file.
+     *
+     * @param[in] path  Path to the file.
+     * @param[in] stamp Expected fingerprint of the source data.
+     *
+     * @retval true  The snapshot is ready.
+     * @retval false The file is missing, corrupted, of other
+     *               version or made from other data.
+     */
+    bool Open( const char* path, uint32 stamp );
+    /** @brief Unmaps the snapshot. */
+    void Close();
+    /** @return True if a snapshot is open. */
+    bool IsOpen() const { return mFile.isOpen(); }
+
+    /** @return The category; NULL if not present. */
+    const CategoryRecord* GetCategory( uint32 categoryID ) const;
+    /** @return The group; NULL if not present. */
+    const GroupRecord* GetGroup( uint32 groupID ) const;
+    /** @return The type; NULL if not present. */
+    const TypeRecord* GetType( uint32 typeID ) const;
+    /** @return Upper bound of present type IDs. */
+    uint32 GetTypeIDLimit() const { return _GetCount( SECTION_TYPE_INDEX ); }
+
+    /** @return The string at the offset. */
+    const char* GetString( uint32 offset ) const { return _GetSection<char>( SECTION_STRINGS ) + offset; }
+    /** @return The first of type.attributeCount attributes. */
+    const AttributeRecord* GetAttributes( const TypeRecord& type ) const
+    {
+        return _GetSection<AttributeRecord>( SECTION_ATTRIBUTES ) + type.firstAttribute;
+    }
+    /** @return The first of type.effectCount effect IDs. */
+    const uint32* GetEffects( const TypeRecord& type ) const
+    {
+        return _GetSection<uint32>( SECTION_EFFECTS ) + type.firstEffect;
+    }
+
+protected:
+    /** @return Number of elements of the section. */
+    uint32 _GetCount( Section section ) const
+    {
+        return IsOpen() ? _GetHeader().sections[ section ].count : 0;
+    }
+    /** @return First element of the section. */
+    template<typename T>
+    const T* _GetSection( Section section ) const
+    {
+        return reinterpret_cast<const T*>( mFile.data() + _GetHeader().sections[ section ].offset );
+    }
+    /** @return The header. */
+    const Header& _GetHeader() const { return *reinterpret_cast<const Header*>( mFile.data() ); }
+
+    /**
+     * @brief Looks up a record through an index section.
+     *
+     * @return The record; NULL if not present.
+     */
+    template<typename T>
+    const T* _Lookup( Section index, Section records, uint32 id ) const
+    {
+        if( id >= _GetCount( index ) )
+            return NULL;
+
+        const uint32 pos = _GetSection<uint32>( index )[ id ];
+        return NO_RECORD == pos ? NULL : _GetSection<T>( records ) + pos;
+    }
+
+    /** @return True if the mapped file is consistent. */
+    bool _Validate( uint32 stamp ) const;
+
+    /// The mapped file.
+    MappedFile mFile;
+};
+
+/**
+ * @brief Compiles a StaticDataSnapshot file.
+ */
+class StaticDataBuilder
+{
+public:
+    typedef StaticDataSnapshot::TypeRecord TypeRecord;
+
+    StaticDataBuilder();
+
+    /**
+     * @brief Adds a category.
+     */
+    void AddCategory( uint32 categoryID, const std::string& name, const std::string& description, bool published );
+    /**
+     * @brief Adds a group.
+     *
+     * @param[in] flags Combination of StaticDataSnapshot::GroupFlag.
+     */
+    void AddGroup( uint32 groupID, uint32 categoryID, const std::string& name, const std::string& description, uint8 flags );
+    /**
+     * @brief Adds a type.
+     *
+     * Strings, wreck type and attribute/effect ranges of the record
+     * are filled in by the builder.
+     */
+    void AddType( uint32 typeID, const TypeRecord& type, const std::string& name, const std::string& description );
+    /**
+     * @brief Adds an integer attribute of a type.
+     */
+    void AddTypeAttribute( uint32 typeID, uint16 attributeID, int32 value );
+    /**
+     * @brief Adds a float attribute of a type.
+     */
+    void AddTypeAttribute( uint32 typeID, uint16 attributeID, double value );
+    /**
+     * @brief Adds an effect of a type.
+     */
+    void AddTypeEffect( uint32 typeID, uint32 effectID );
+    /**
+     * @brief Sets type of wreck left by a type.
+     */
+    void SetWreckType( uint32 typeID, uint32 wreckTypeID );
+
+    /**
+     * @brief Writes the snapshot.
+     *
+     * The file is written aside and renamed over the target,
+     * so a concurrently running reader never sees a partial file.
+     *
+     * @param[in] path  Path of the file.
+     * @param[in] stamp Fingerprint of the source data.
+     *
+     * @retval true  The snapshot has been written.
+     * @retval false Failed to write the file.
+     */
+    bool Write( const char* path, uint32 stamp ) const;
+
+protected:
+    typedef StaticDataSnapshot::CategoryRecord CategoryRecord;
+    typedef StaticDataSnapshot::GroupRecord GroupRecord;
+    typedef StaticDataSnapshot::AttributeRecord AttributeRecord;
+
+    /** @return Offset of a copy of the string. */
+    uint32 _AddString( const std::string& str );
+
+    /// The string pool.
+    std::vector<char> mStrings;
+
+    std::map<uint32, CategoryRecord> mCategories;
+    std::map<uint32, GroupRecord> mGroups;
+    std::map<uint32, TypeRecord> mTypes;
+    std::map<uint32, std::vector<AttributeRecord> > mAttributes;
+    std::map<uint32, std::vector<uint32> > mEffects;
+    std::map<uint32, uint32> mWrecks;
+};
+
+#endif /* !__CACHE__STATIC_DATA_SNAPSHOT_H__INCL__ */
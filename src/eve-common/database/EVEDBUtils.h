@@ -36,6 +36,7 @@ class PyList;
 class PyDict;
 class PyObjectEx;
 class PyPackedRow;
+class DBRowDescriptor;
 
 /*typedef enum {
     StringContentsInteger,
@@ -72,6 +73,7 @@ PyObjectEx *DBResultToCIndexedRowset(DBQueryResult &result, uint32 key_index);
 PyObject *DBRowToKeyVal(DBResultRow &row);
 PyObject *DBRowToRow(DBResultRow &row, const char *type = "util.Row");
 PyPackedRow *DBRowToPackedRow(DBResultRow &row);
+PyPackedRow *CreatePackedRow(const DBResultRow &row, DBRowDescriptor *header); //consumes header
 
 
 #endif
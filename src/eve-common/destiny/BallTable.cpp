@@ -0,0 +1,265 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-common.h"
+
+#include "destiny/BallTable.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#   define BALL_TABLE_SSE2
+#   include <emmintrin.h>
+#endif /* SSE2 */
+
+namespace Destiny {
+
+void BallTable::Clear()
+{
+    mMode.clear();
+
+    mPosX.clear(); mPosY.clear(); mPosZ.clear();
+    mVelX.clear(); mVelY.clear(); mVelZ.clear();
+    mTargetX.clear(); mTargetY.clear(); mTargetZ.clear();
+    mAccelX.clear(); mAccelY.clear(); mAccelZ.clear();
+
+    mAccelerationFactor.clear();
+    mMassAgilityFriction.clear();
+    mVelocityAdjuster.clear();
+
+    mOrbits.clear();
+    mOrbitDistance.clear();
+    mOrbitMaxVelocity.clear();
+    mOrbitTics.clear();
+}
+
+size_t BallTable::AddGoto( const GPoint& position, const GVector& velocity, const GPoint& target,
+                           double accelerationFactor, double massAgilityFriction, double velocityAdjuster )
+{
+    return _Add( position, velocity, target, DSTBALL_GOTO,
+                 accelerationFactor, massAgilityFriction, velocityAdjuster );
+}
+
+size_t BallTable::AddOrbit( const GPoint& position, const GVector& velocity, const GPoint& orbitPoint,
+                            double desiredDistance, double maxVelocity, double orbitTics,
+                            double accelerationFactor, double massAgilityFriction, double velocityAdjuster )
+{
+    const size_t index = _Add( position, velocity, orbitPoint, DSTBALL_ORBIT,
+                               accelerationFactor, massAgilityFriction, velocityAdjuster );
+
+    mOrbits.push_back( index );
+    mOrbitDistance.push_back( desiredDistance );
+    mOrbitMaxVelocity.push_back( maxVelocity );
+    mOrbitTics.push_back( orbitTics );
+
+    return index;
+}
+
+bool BallTable::AddBall( const BallMotion& motion, size_t& index )
+{
+    switch( motion.mode )
+    {
+    case DSTBALL_GOTO:
+        index = AddGoto( motion.position, motion.velocity, motion.targetPoint,
+                         motion.accelerationFactor, motion.massAgilityFriction, motion.velocityAdjuster );
+        return true;
+
+    case DSTBALL_STOP: {
+        if( !motion.velocity.isNotZero() )
+            return false;
+
+        //then stopping ... deaccelerate is faster than normal.
+        GVector velocity( motion.velocity );
+        velocity.y *= 0.93 / 1.07;
+
+        index = AddGoto( motion.position, velocity, motion.targetPoint,
+                         motion.accelerationFactor, motion.massAgilityFriction, motion.velocityAdjuster );
+        } return true;
+
+    case DSTBALL_FOLLOW:
+        index = AddGoto( motion.position, motion.velocity,
+                         FollowPoint( motion.position, motion.targetPosition, motion.desiredDistance ),
+                         motion.accelerationFactor, motion.massAgilityFriction, motion.velocityAdjuster );
+        return true;
+
+    case DSTBALL_ORBIT:
+        index = AddOrbit( motion.position, motion.velocity, motion.targetPosition,
+                          motion.desiredDistance, motion.maxVelocity, motion.orbitTics,
+                          motion.accelerationFactor, motion.massAgilityFriction, motion.velocityAdjuster );
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void BallTable::Integrate()
+{
+    _GotoAccelerations();
+    _OrbitAccelerations();
+    _MoveAccel();
+}
+
+size_t BallTable::_Add( const GPoint& position, const GVector& velocity, const GPoint& target, BallMode mode,
+                        double accelerationFactor, double massAgilityFriction, double velocityAdjuster )
+{
+    const size_t index = size();
+
+    mMode.push_back( mode );
+
+    mPosX.push_back( position.x );
+    mPosY.push_back( position.y );
+    mPosZ.push_back( position.z );
+
+    mVelX.push_back( velocity.x );
+    mVelY.push_back( velocity.y );
+    mVelZ.push_back( velocity.z );
+
+    mTargetX.push_back( target.x );
+    mTargetY.push_back( target.y );
+    mTargetZ.push_back( target.z );
+
+    mAccelX.push_back( 0.0 );
+    mAccelY.push_back( 0.0 );
+    mAccelZ.push_back( 0.0 );
+
+    mAccelerationFactor.push_back( accelerationFactor );
+    mMassAgilityFriction.push_back( massAgilityFriction );
+    mVelocityAdjuster.push_back( velocityAdjuster );
+
+    return index;
+}
+
+void BallTable::_GotoAccelerations()
+{
+    // Computed for every row; orbit rows are overwritten afterwards,
+    // which is cheaper than branching inside the batch.
+    const size_t count = size();
+    size_t i = 0;
+
+#ifdef BALL_TABLE_SSE2
+    const __m128d zero = _mm_setzero_pd();
+
+    for(; i + 2 <= count; i += 2 )
+    {
+        const __m128d dx = _mm_sub_pd( _mm_loadu_pd( &mTargetX[ i ] ), _mm_loadu_pd( &mPosX[ i ] ) );
+        const __m128d dy = _mm_sub_pd( _mm_loadu_pd( &mTargetY[ i ] ), _mm_loadu_pd( &mPosY[ i ] ) );
+        const __m128d dz = _mm_sub_pd( _mm_loadu_pd( &mTargetZ[ i ] ), _mm_loadu_pd( &mPosZ[ i ] ) );
+
+        const __m128d d2 = _mm_add_pd( _mm_add_pd( _mm_mul_pd( dx, dx ), _mm_mul_pd( dy, dy ) ), _mm_mul_pd( dz, dz ) );
+        const __m128d d = _mm_sqrt_pd( d2 );
+        // lanes already at their goal get no acceleration
+        const __m128d moving = _mm_cmpneq_pd( d2, zero );
+        const __m128d f = _mm_and_pd( moving, _mm_loadu_pd( &mAccelerationFactor[ i ] ) );
+
+        _mm_storeu_pd( &mAccelX[ i ], _mm_and_pd( moving, _mm_mul_pd( _mm_div_pd( dx, d ), f ) ) );
+        _mm_storeu_pd( &mAccelY[ i ], _mm_and_pd( moving, _mm_mul_pd( _mm_div_pd( dy, d ), f ) ) );
+        _mm_storeu_pd( &mAccelZ[ i ], _mm_and_pd( moving, _mm_mul_pd( _mm_div_pd( dz, d ), f ) ) );
+    }
+#endif /* BALL_TABLE_SSE2 */
+
+    for(; i < count; ++i )
+    {
+        const GVector accel = GotoAcceleration( GetPosition( i ), GetTarget( i ), mAccelerationFactor[ i ] );
+
+        mAccelX[ i ] = accel.x;
+        mAccelY[ i ] = accel.y;
+        mAccelZ[ i ] = accel.z;
+    }
+}
+
+void BallTable::_OrbitAccelerations()
+{
+    // Orbit steering is dominated by sin/cos/exp which have
+    // no vector counterpart here, so it runs lane by lane
+    // over the table rows.
+    for( size_t k = 0; k < mOrbits.size(); ++k )
+    {
+        const size_t i = mOrbits[ k ];
+
+        GPoint target;
+        const GVector accel = OrbitAcceleration( GetPosition( i ), GetTarget( i ), mOrbitDistance[ k ],
+                                                 mOrbitMaxVelocity[ k ], mAccelerationFactor[ i ],
+                                                 mOrbitTics[ k ], target );
+
+        mAccelX[ i ] = accel.x;
+        mAccelY[ i ] = accel.y;
+        mAccelZ[ i ] = accel.z;
+
+        mTargetX[ i ] = target.x;
+        mTargetY[ i ] = target.y;
+        mTargetZ[ i ] = target.z;
+    }
+}
+
+void BallTable::_MoveAccel()
+{
+    const size_t count = size();
+    size_t i = 0;
+
+#ifdef BALL_TABLE_SSE2
+    const __m128d one = _mm_set1_pd( 1.0 );
+    const __m128d tic = _mm_set1_pd( TIC_DURATION_IN_SECONDS );
+
+    for(; i + 2 <= count; i += 2 )
+    {
+        const __m128d maf = _mm_loadu_pd( &mMassAgilityFriction[ i ] );
+        const __m128d adj = _mm_loadu_pd( &mVelocityAdjuster[ i ] );
+        const __m128d rem = _mm_sub_pd( one, adj );
+
+        double* pos[ 3 ] = { &mPosX[ i ], &mPosY[ i ], &mPosZ[ i ] };
+        double* vel[ 3 ] = { &mVelX[ i ], &mVelY[ i ], &mVelZ[ i ] };
+        const double* acc[ 3 ] = { &mAccelX[ i ], &mAccelY[ i ], &mAccelZ[ i ] };
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            const __m128d v = _mm_loadu_pd( vel[ axis ] );
+            const __m128d mv = _mm_mul_pd( _mm_loadu_pd( acc[ axis ] ), maf );
+            const __m128d dv = _mm_sub_pd( mv, v );
+
+            // same operation order as MoveAccel()
+            const __m128d step = _mm_sub_pd( _mm_mul_pd( mv, tic ), _mm_mul_pd( _mm_mul_pd( dv, rem ), maf ) );
+            _mm_storeu_pd( pos[ axis ], _mm_add_pd( _mm_loadu_pd( pos[ axis ] ), step ) );
+            _mm_storeu_pd( vel[ axis ], _mm_sub_pd( mv, _mm_mul_pd( dv, adj ) ) );
+        }
+    }
+#endif /* BALL_TABLE_SSE2 */
+
+    for(; i < count; ++i )
+    {
+        GPoint position = GetPosition( i );
+        GVector velocity = GetVelocity( i );
+        const GVector accel( mAccelX[ i ], mAccelY[ i ], mAccelZ[ i ] );
+
+        MoveAccel( position, velocity, accel, mMassAgilityFriction[ i ], mVelocityAdjuster[ i ] );
+
+        mPosX[ i ] = position.x;
+        mPosY[ i ] = position.y;
+        mPosZ[ i ] = position.z;
+
+        mVelX[ i ] = velocity.x;
+        mVelY[ i ] = velocity.y;
+        mVelZ[ i ] = velocity.z;
+    }
+}
+
+}
@@ -0,0 +1,182 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __BALL_TABLE_H__INCL__
+#define __BALL_TABLE_H__INCL__
+
+#include "destiny/DestinyPhysics.h"
+#include "destiny/DestinyStructs.h"
+
+namespace Destiny {
+
+/**
+ * @brief Motion state of a ball, as gathered into BallTable.
+ *
+ * Filled by DestinyManager and the replay harness alike,
+ * so that both go through the same per-mode gather.
+ */
+struct BallMotion
+{
+    /// Mode of the ball.
+    BallMode mode;
+    /// Position of the ball.
+    GPoint position;
+    /// Velocity of the ball.
+    GVector velocity;
+    /// Point the ball heads to (GOTO, STOP).
+    GPoint targetPoint;
+    /// Position of the target entity (ORBIT, FOLLOW).
+    GPoint targetPosition;
+    /// Both radii plus the requested distance (ORBIT, FOLLOW).
+    double desiredDistance;
+    /// Number of tics since the orbit started (ORBIT).
+    double orbitTics;
+
+    /// Current maximal velocity of the ball.
+    double maxVelocity;
+    /// Acceleration magnitude.
+    double accelerationFactor;
+    /// Mass * agility / SPACE_FRICTION.
+    double massAgilityFriction;
+    /// Velocity adjuster of the ball.
+    double velocityAdjuster;
+};
+
+/**
+ * @brief Contiguous table of balls integrated together.
+ *
+ * Balls in GOTO (and STOP, FOLLOW) or ORBIT mode are gathered into
+ * the table each tic, integrated in one batch and scattered
+ * back to their owners. Positions, velocities and per-ball
+ * factors are kept as separate arrays so that the common
+ * cases can be processed two balls at once with SSE2.
+ *
+ * Results match running DestinyPhysics kernels ball by ball
+ * up to floating point rounding.
+ */
+class BallTable
+{
+public:
+    /**
+     * @brief Removes all balls from the table.
+     *
+     * Memory is kept so that the table may be refilled
+     * each tic without reallocation.
+     */
+    void Clear();
+
+    /** @return Number of balls in the table. */
+    size_t size() const { return mMode.size(); }
+
+    /**
+     * @brief Adds ball heading to a point.
+     *
+     * @param[in] position            Position of ball.
+     * @param[in] velocity            Velocity of ball.
+     * @param[in] target              Point the ball heads to.
+     * @param[in] accelerationFactor  Acceleration magnitude.
+     * @param[in] massAgilityFriction Mass * agility / SPACE_FRICTION.
+     * @param[in] velocityAdjuster    Velocity adjuster of ball.
+     *
+     * @return Index of the ball in the table.
+     */
+    size_t AddGoto( const GPoint& position, const GVector& velocity, const GPoint& target,
+                    double accelerationFactor, double massAgilityFriction, double velocityAdjuster );
+    /**
+     * @brief Adds ball orbiting a point.
+     *
+     * @param[in] position            Position of ball.
+     * @param[in] velocity            Velocity of ball.
+     * @param[in] orbitPoint          Center of orbit.
+     * @param[in] desiredDistance     Distance to keep from the center.
+     * @param[in] maxVelocity         Current maximal velocity of ball.
+     * @param[in] orbitTics           Number of tics since the orbit started.
+     * @param[in] accelerationFactor  Acceleration magnitude.
+     * @param[in] massAgilityFriction Mass * agility / SPACE_FRICTION.
+     * @param[in] velocityAdjuster    Velocity adjuster of ball.
+     *
+     * @return Index of the ball in the table.
+     */
+    size_t AddOrbit( const GPoint& position, const GVector& velocity, const GPoint& orbitPoint,
+                     double desiredDistance, double maxVelocity, double orbitTics,
+                     double accelerationFactor, double massAgilityFriction, double velocityAdjuster );
+
+    /**
+     * @brief Adds ball according to its mode.
+     *
+     * STOP is a GOTO with damped velocity, FOLLOW a GOTO to a point
+     * desiredDistance away from the target on the line towards us.
+     *
+     * @param[in]  motion Motion state of ball.
+     * @param[out] index  Index of the ball in the table.
+     *
+     * @retval true  Ball has been added.
+     * @retval false Ball does not move in this mode.
+     */
+    bool AddBall( const BallMotion& motion, size_t& index );
+
+    /**
+     * @brief Integrates all balls for one tic.
+     */
+    void Integrate();
+
+    /** @return Mode of ball at given index. */
+    BallMode GetMode( size_t index ) const { return static_cast<BallMode>( mMode[ index ] ); }
+    /** @return Position of ball at given index. */
+    GPoint GetPosition( size_t index ) const { return GPoint( mPosX[ index ], mPosY[ index ], mPosZ[ index ] ); }
+    /** @return Velocity of ball at given index. */
+    GVector GetVelocity( size_t index ) const { return GVector( mVelX[ index ], mVelY[ index ], mVelZ[ index ] ); }
+    /** @return Point the ball heads to; for orbits valid after Integrate(). */
+    GPoint GetTarget( size_t index ) const { return GPoint( mTargetX[ index ], mTargetY[ index ], mTargetZ[ index ] ); }
+
+protected:
+    size_t _Add( const GPoint& position, const GVector& velocity, const GPoint& target, BallMode mode,
+                 double accelerationFactor, double massAgilityFriction, double velocityAdjuster );
+
+    void _GotoAccelerations();
+    void _OrbitAccelerations();
+    void _MoveAccel();
+
+    std::vector<uint8> mMode;
+
+    std::vector<double> mPosX, mPosY, mPosZ;
+    std::vector<double> mVelX, mVelY, mVelZ;
+    // orbit center for orbiting balls until integrated
+    std::vector<double> mTargetX, mTargetY, mTargetZ;
+    std::vector<double> mAccelX, mAccelY, mAccelZ;
+
+    std::vector<double> mAccelerationFactor;
+    std::vector<double> mMassAgilityFriction;
+    std::vector<double> mVelocityAdjuster;
+
+    // orbit-only inputs, indexed in parallel with mOrbits
+    std::vector<size_t> mOrbits;
+    std::vector<double> mOrbitDistance;
+    std::vector<double> mOrbitMaxVelocity;
+    std::vector<double> mOrbitTics;
+};
+
+}
+
+#endif /* !__BALL_TABLE_H__INCL__ */
@@ -0,0 +1,145 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-common.h"
+
+#include "destiny/DestinyPhysics.h"
+
+const double SPACE_FRICTION = 1.0e+6;        //straight from client. Do not change.
+const double SPACE_FRICTION_SQUARED = SPACE_FRICTION*SPACE_FRICTION;
+const double TIC_DURATION_IN_SECONDS = 1.0;    //straight from client. Do not change.
+
+namespace Destiny {
+
+void DeriveMotion( double maxShipVelocity, double speedFraction, double mass, double agility,
+                   double& maxVelocity, double& velocityAdjuster, double& accelerationFactor )
+{
+    maxVelocity = maxShipVelocity * speedFraction;
+    velocityAdjuster = exp( -( SPACE_FRICTION * TIC_DURATION_IN_SECONDS ) / ( mass * agility ) );
+    accelerationFactor = ( SPACE_FRICTION * maxVelocity ) / ( mass * agility );
+}
+
+GVector GotoAcceleration( const GPoint& position, const GPoint& target, double accelerationFactor )
+{
+    GVector vector_to_goal( position, target ); //m
+    const double distance_to_goal2 = vector_to_goal.lengthSquared(); //m^2
+
+    // already there; no direction to go
+    if( 0 == distance_to_goal2 )
+        return GVector( 0, 0, 0 );
+
+    vector_to_goal /= sqrt( distance_to_goal2 ); //normalize, yields unitless
+
+    return vector_to_goal * accelerationFactor; //fric*m/(s*agi*kg) = m/s^2
+}
+
+GPoint FollowPoint( const GPoint& position, const GPoint& targetPosition, double desiredDistance )
+{
+    GVector them_to_us( targetPosition, position );
+    them_to_us.normalize();
+
+    return targetPosition + ( them_to_us * desiredDistance );
+}
+
+GVector OrbitAcceleration( const GPoint& position, const GPoint& orbitPoint, double desiredDistance,
+                           double maxVelocity, double accelerationFactor, double orbitTics, GPoint& targetPoint )
+{
+    GVector delta( position, orbitPoint );
+    double current_distance = delta.normalize();
+
+    double something = 0;
+    if( desiredDistance != 0 )
+        something = ( maxVelocity * TIC_DURATION_IN_SECONDS * .01 ) / desiredDistance;
+
+    //this seems to be correct, without rounding error.
+    double v488 = orbitTics * something;
+
+    //this is not quite right... some sort of rounding I think.
+    double coef = ( v488 * 0.7f ) + 130001409/*entityID*/;
+
+    //all of these are wrong due to rounding
+    double cos_coef = cos( coef );
+    double sin_coef = sin( coef );
+    double cos_v488 = cos( v488 );
+    double sin_v488 = sin( v488 );
+    double v438 = cos_coef * sin_v488;
+    double v3C0 = cos_v488 * cos_coef;
+
+    GPoint pt( v3C0, sin_coef, v438 );    //this is a unit vector naturally
+
+    GVector tan_vector = pt.crossProduct( delta );
+    tan_vector.normalize();
+
+    double delta_d2 = current_distance*current_distance - desiredDistance*desiredDistance;
+    if( delta_d2 >= 0 )
+    {
+        double mag = sqrt( delta_d2 ) * desiredDistance / current_distance;
+        GVector s = tan_vector * mag;
+        GVector d = delta * ( delta_d2 / current_distance );
+        delta = s + d;
+        delta.normalize();
+    }
+
+    double d = desiredDistance - current_distance;
+    d = exp( d*d / ( -40000.0f ) );
+
+    GVector negative_delta = delta * -1;
+
+    double tdn = tan_vector.dotProduct( negative_delta );
+    double jjj = ( ( tdn*tdn - 1.0f ) * d * d ) + 1;
+    double iii;
+    if( jjj < 0 )    //not sure on this condition at all.
+        iii = d * tdn;    //not positive
+    else
+        iii = sqrt( jjj ) + ( d * tdn );
+
+    if( ( current_distance - desiredDistance ) < 0 )
+        iii *= -1;
+
+    GPoint bliii = delta * iii;
+    GPoint vliii = tan_vector * d;
+
+    GVector accel_vector = bliii + vliii;
+    accel_vector *= accelerationFactor;
+
+    static const double ten_au = 1.495978707e12;
+    targetPoint = orbitPoint + ( accel_vector * ten_au );
+
+    return accel_vector;
+}
+
+void MoveAccel( GPoint& position, GVector& velocity, const GVector& acceleration,
+                double massAgilityFriction, double velocityAdjuster )
+{
+    GVector max_velocity = acceleration * massAgilityFriction;
+
+    position +=
+        max_velocity * TIC_DURATION_IN_SECONDS
+        - ( max_velocity - velocity ) * ( 1 - velocityAdjuster ) * massAgilityFriction;
+
+    velocity =
+        max_velocity - ( max_velocity - velocity ) * velocityAdjuster;
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __DESTINY_PHYSICS_H__INCL__
+#define __DESTINY_PHYSICS_H__INCL__
+
+#include "utils/gpoint.h"
+
+extern const double SPACE_FRICTION;
+extern const double SPACE_FRICTION_SQUARED;
+extern const double TIC_DURATION_IN_SECONDS;
+
+namespace Destiny {
+
+    /**
+     * @brief Calculates per-ball factors which depend on speed and ship.
+     *
+     * @param[in]  maxShipVelocity    Maximal velocity of ship.
+     * @param[in]  speedFraction      Active speed fraction.
+     * @param[in]  mass               Mass of ship.
+     * @param[in]  agility            Agility of ship.
+     * @param[out] maxVelocity        Current maximal velocity of ball.
+     * @param[out] velocityAdjuster   exp( -SPACE_FRICTION * TIC_DURATION_IN_SECONDS / ( mass * agility ) ).
+     * @param[out] accelerationFactor Acceleration magnitude.
+     */
+    extern void DeriveMotion( double maxShipVelocity, double speedFraction, double mass, double agility,
+                              double& maxVelocity, double& velocityAdjuster, double& accelerationFactor );
+
+    /**
+     * @brief Calculates acceleration of ball heading to a point.
+     *
+     * Used by GOTO, STOP and FOLLOW modes.
+     *
+     * @param[in] position           Position of ball.
+     * @param[in] target             Point the ball heads to.
+     * @param[in] accelerationFactor Acceleration magnitude.
+     *
+     * @return Acceleration of ball.
+     */
+    extern GVector GotoAcceleration( const GPoint& position, const GPoint& target, double accelerationFactor );
+
+    /**
+     * @brief Calculates point a following ball heads to.
+     *
+     * @param[in] position        Position of ball.
+     * @param[in] targetPosition  Position of followed entity.
+     * @param[in] desiredDistance Distance to keep from the followed entity.
+     *
+     * @return Point desiredDistance away from the followed entity, on the line towards the ball.
+     */
+    extern GPoint FollowPoint( const GPoint& position, const GPoint& targetPosition, double desiredDistance );
+
+    /**
+     * @brief Calculates acceleration of ball orbiting a point.
+     *
+     * @param[in]  position           Position of ball.
+     * @param[in]  orbitPoint         Center of orbit.
+     * @param[in]  desiredDistance    Distance to keep from the center.
+     * @param[in]  maxVelocity        Current maximal velocity of ball.
+     * @param[in]  accelerationFactor Acceleration magnitude.
+     * @param[in]  orbitTics          Number of tics since the orbit started.
+     * @param[out] targetPoint        Point the ball heads to.
+     *
+     * @return Acceleration of ball.
+     */
+    extern GVector OrbitAcceleration( const GPoint& position, const GPoint& orbitPoint, double desiredDistance,
+                                      double maxVelocity, double accelerationFactor, double orbitTics, GPoint& targetPoint );
+
+    /**
+     * @brief Moves ball under given acceleration for one tic.
+     *
+     * @param[in,out] position            Position of ball.
+     * @param[in,out] velocity            Velocity of ball.
+     * @param[in]     acceleration        Acceleration of ball.
+     * @param[in]     massAgilityFriction Mass * agility / SPACE_FRICTION.
+     * @param[in]     velocityAdjuster    exp( -SPACE_FRICTION * TIC_DURATION_IN_SECONDS / ( mass * agility ) ).
+     */
+    extern void MoveAccel( GPoint& position, GVector& velocity, const GVector& acceleration,
+                           double massAgilityFriction, double velocityAdjuster );
+}
+
+#endif /* !__DESTINY_PHYSICS_H__INCL__ */
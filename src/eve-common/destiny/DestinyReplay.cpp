@@ -0,0 +1,393 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-common.h"
+
+#include "destiny/DestinyBinDump.h"
+#include "destiny/DestinyReplay.h"
+
+namespace Destiny {
+
+/*************************************************************************/
+/* Destiny::Scenario                                                     */
+/*************************************************************************/
+Scenario::Scenario()
+: mTics( 0 )
+{
+}
+
+bool Scenario::Load( const char* filename )
+{
+    FILE* file = fopen( filename, "r" );
+    if( NULL == file )
+    {
+        sLog.Error( "Scenario", "Unable to open scenario '%s'.", filename );
+        return false;
+    }
+
+    Clear();
+
+    bool result = true;
+    uint32 lineNo = 0;
+    char line[ 1024 ];
+    while( NULL != fgets( line, sizeof( line ), file ) )
+    {
+        ++lineNo;
+
+        std::string text( line );
+        std::string::size_type pos = text.find_first_not_of( " \t\r\n" );
+        if( std::string::npos == pos || '#' == text[ pos ] )
+            continue;
+
+        std::istringstream str( text );
+        std::string word;
+        str >> word;
+
+        if( "tics" == word )
+        {
+            str >> mTics;
+            if( str.fail() )
+            {
+                sLog.Error( "Scenario", "%s:%u: Missing arguments of command '%s'.", filename, lineNo, word.c_str() );
+                result = false;
+            }
+            continue;
+        }
+        else if( "ball" == word )
+        {
+            ScenarioBall ball;
+            str >> ball.id >> ball.mass >> ball.agility >> ball.maxVelocity >> ball.radius
+                >> ball.position.x >> ball.position.y >> ball.position.z;
+            if( str.fail() )
+            {
+                sLog.Error( "Scenario", "%s:%u: Missing arguments of command '%s'.", filename, lineNo, word.c_str() );
+                result = false;
+                continue;
+            }
+
+            // velocity is optional
+            str >> ball.velocity.x >> ball.velocity.y >> ball.velocity.z;
+            if( str.fail() )
+                ball.velocity = GVector( 0, 0, 0 );
+
+            if( 0 >= ball.mass || 0 >= ball.agility )
+            {
+                sLog.Error( "Scenario", "%s:%u: Ball %u must have positive mass and agility.", filename, lineNo, ball.id );
+                result = false;
+            }
+            else if( !AddBall( ball ) )
+            {
+                sLog.Error( "Scenario", "%s:%u: Duplicate ball %u.", filename, lineNo, ball.id );
+                result = false;
+            }
+            continue;
+        }
+
+        ScenarioCommand cmd;
+        cmd.targetID = 0;
+        cmd.value = 0;
+
+        if( "goto" == word || "align" == word )
+        {
+            cmd.type = ( "goto" == word ? ScenarioCommand::CMD_GOTO : ScenarioCommand::CMD_ALIGN );
+            str >> cmd.stamp >> cmd.ballID >> cmd.point.x >> cmd.point.y >> cmd.point.z;
+        }
+        else if( "stop" == word )
+        {
+            cmd.type = ScenarioCommand::CMD_STOP;
+            str >> cmd.stamp >> cmd.ballID;
+        }
+        else if( "orbit" == word || "follow" == word )
+        {
+            cmd.type = ( "orbit" == word ? ScenarioCommand::CMD_ORBIT : ScenarioCommand::CMD_FOLLOW );
+            str >> cmd.stamp >> cmd.ballID >> cmd.targetID >> cmd.value;
+        }
+        else if( "speed" == word )
+        {
+            cmd.type = ScenarioCommand::CMD_SPEED;
+            str >> cmd.stamp >> cmd.ballID >> cmd.value;
+        }
+        else
+        {
+            sLog.Error( "Scenario", "%s:%u: Unknown command '%s'.", filename, lineNo, word.c_str() );
+            result = false;
+            continue;
+        }
+
+        if( str.fail() )
+        {
+            sLog.Error( "Scenario", "%s:%u: Missing arguments of command '%s'.", filename, lineNo, word.c_str() );
+            result = false;
+        }
+        else if( !AddCommand( cmd ) )
+        {
+            sLog.Error( "Scenario", "%s:%u: Command '%s' refers to an unknown ball.", filename, lineNo, word.c_str() );
+            result = false;
+        }
+    }
+
+    fclose( file );
+    return result;
+}
+
+void Scenario::Clear()
+{
+    mTics = 0;
+    mBalls.clear();
+    mBallIndex.clear();
+    mCommands.clear();
+}
+
+bool Scenario::AddBall( const ScenarioBall& ball )
+{
+    if( !mBallIndex.insert( std::make_pair( ball.id, mBalls.size() ) ).second )
+        return false;
+
+    mBalls.push_back( ball );
+    return true;
+}
+
+bool Scenario::AddCommand( const ScenarioCommand& command )
+{
+    if( 0 == mBallIndex.count( command.ballID ) )
+        return false;
+    if( ( ScenarioCommand::CMD_ORBIT == command.type || ScenarioCommand::CMD_FOLLOW == command.type )
+        && 0 == mBallIndex.count( command.targetID ) )
+        return false;
+
+    // keep order of commands with the same stamp
+    std::vector<ScenarioCommand>::iterator cur, end;
+    cur = mCommands.begin();
+    end = mCommands.end();
+    for(; cur != end; ++cur)
+    {
+        if( cur->stamp > command.stamp )
+            break;
+    }
+
+    mCommands.insert( cur, command );
+    return true;
+}
+
+/*************************************************************************/
+/* Destiny::Replay                                                       */
+/*************************************************************************/
+Replay::Replay( const Scenario& scenario )
+: mScenario( scenario )
+{
+    for( size_t i = 0; i < mScenario.balls().size(); ++i )
+        mBallIndex[ mScenario.balls()[ i ].id ] = i;
+
+    Rewind();
+}
+
+void Replay::Rewind()
+{
+    const std::vector<ScenarioBall>& balls = mScenario.balls();
+
+    mBalls.resize( balls.size() );
+    for( size_t i = 0; i < balls.size(); ++i )
+    {
+        const ScenarioBall& ball = balls[ i ];
+        BallState& state = mBalls[ i ];
+
+        state.mode = DSTBALL_STOP;
+        state.position = ball.position;
+        state.velocity = ball.velocity;
+        state.targetPoint = ball.position;
+        state.target = 0;
+        state.targetDistance = 0;
+        state.stateStamp = 0;
+
+        state.userSpeedFraction = 0;
+        state.activeSpeedFraction = 0;
+        state.massAgilityFriction = ball.mass * ball.agility / SPACE_FRICTION;
+        _UpdateDerived( i );
+    }
+
+    mNextCommand = 0;
+    mStamp = 0;
+
+    mLastTicUSec = 0;
+    mTotalUSec = 0;
+    mPeakUSec = 0;
+}
+
+void Replay::Tic()
+{
+    const uint64 start = GetTimeUSec();
+
+    const std::vector<ScenarioCommand>& commands = mScenario.commands();
+    for(; mNextCommand < commands.size() && commands[ mNextCommand ].stamp <= mStamp; ++mNextCommand )
+        _Issue( commands[ mNextCommand ] );
+
+    // gather first, so that everybody sees positions from the start of the tic
+    mTable.Clear();
+    mTableBalls.clear();
+    for( size_t i = 0; i < mBalls.size(); ++i )
+    {
+        size_t tableIndex;
+        if( _Gather( i, tableIndex ) )
+            mTableBalls.push_back( std::make_pair( i, tableIndex ) );
+    }
+
+    mTable.Integrate();
+
+    for( size_t i = 0; i < mTableBalls.size(); ++i )
+    {
+        BallState& state = mBalls[ mTableBalls[ i ].first ];
+        const size_t tableIndex = mTableBalls[ i ].second;
+
+        state.position = mTable.GetPosition( tableIndex );
+        state.velocity = mTable.GetVelocity( tableIndex );
+        state.targetPoint = mTable.GetTarget( tableIndex );
+    }
+
+    ++mStamp;
+
+    mLastTicUSec = GetTimeUSec() - start;
+    mTotalUSec += mLastTicUSec;
+    mPeakUSec = std::max( mPeakUSec, mLastTicUSec );
+}
+
+void Replay::WriteState( FILE* into ) const
+{
+    for( size_t i = 0; i < mBalls.size(); ++i )
+    {
+        const BallState& state = mBalls[ i ];
+
+        fprintf( into, "%u,%u,%s,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+                 mStamp, GetBallID( i ), DSTBALL_modeNames[ state.mode ],
+                 state.position.x, state.position.y, state.position.z,
+                 state.velocity.x, state.velocity.y, state.velocity.z );
+    }
+}
+
+void Replay::WriteHeader( FILE* into )
+{
+    fprintf( into, "stamp,ball,mode,x,y,z,vx,vy,vz\n" );
+}
+
+void Replay::_Issue( const ScenarioCommand& command )
+{
+    const size_t index = mBallIndex[ command.ballID ];
+    BallState& state = mBalls[ index ];
+
+    switch( command.type )
+    {
+    case ScenarioCommand::CMD_GOTO:
+    case ScenarioCommand::CMD_ALIGN:
+        state.mode = DSTBALL_GOTO;
+        if( ScenarioCommand::CMD_GOTO == command.type )
+            state.targetPoint = command.point;
+        else
+            state.targetPoint = state.position + ( command.point * 1.0e16 );
+
+        if( 0 == state.userSpeedFraction )
+            state.userSpeedFraction = 1.0;
+        _SetActiveSpeed( index, state.userSpeedFraction );
+        break;
+
+    case ScenarioCommand::CMD_STOP:
+        if( DSTBALL_STOP == state.mode )
+            break;
+
+        state.mode = DSTBALL_STOP;
+        _SetActiveSpeed( index, 0 );
+        break;
+
+    case ScenarioCommand::CMD_ORBIT:
+    case ScenarioCommand::CMD_FOLLOW: {
+        const BallMode mode = ( ScenarioCommand::CMD_ORBIT == command.type ? DSTBALL_ORBIT : DSTBALL_FOLLOW );
+        const size_t target = mBallIndex[ command.targetID ];
+        if( mode == state.mode && target == state.target && command.value == state.targetDistance )
+            break;
+
+        state.mode = mode;
+        state.target = target;
+        state.targetDistance = command.value;
+
+        // as DestinyManager: orbit keeps a zero speed fraction, follow does not
+        if( DSTBALL_ORBIT == mode )
+            state.stateStamp = mStamp + 1;
+        else if( 0 == state.userSpeedFraction )
+            state.userSpeedFraction = 1.0;
+        _SetActiveSpeed( index, state.userSpeedFraction );
+        } break;
+
+    case ScenarioCommand::CMD_SPEED:
+        state.userSpeedFraction = command.value;
+        state.activeSpeedFraction = command.value;
+        _UpdateDerived( index );
+        break;
+    }
+}
+
+void Replay::_SetActiveSpeed( size_t index, double fraction )
+{
+    BallState& state = mBalls[ index ];
+    if( state.activeSpeedFraction != fraction )
+    {
+        state.activeSpeedFraction = fraction;
+        _UpdateDerived( index );
+    }
+}
+
+void Replay::_UpdateDerived( size_t index )
+{
+    const ScenarioBall& ball = mScenario.balls()[ index ];
+    BallState& state = mBalls[ index ];
+
+    DeriveMotion( ball.maxVelocity, state.activeSpeedFraction, ball.mass, ball.agility,
+                  state.maxVelocity, state.velocityAdjuster, state.accelerationFactor );
+}
+
+bool Replay::_Gather( size_t index, size_t& tableIndex )
+{
+    const BallState& state = mBalls[ index ];
+
+    // same gather as DestinyManager::BeginBatchedTic()
+    BallMotion motion;
+    motion.mode = state.mode;
+    motion.position = state.position;
+    motion.velocity = state.velocity;
+    motion.targetPoint = state.targetPoint;
+    motion.orbitTics = double( int64( mStamp ) - int64( state.stateStamp ) );
+
+    motion.maxVelocity = state.maxVelocity;
+    motion.accelerationFactor = state.accelerationFactor;
+    motion.massAgilityFriction = state.massAgilityFriction;
+    motion.velocityAdjuster = state.velocityAdjuster;
+
+    if( DSTBALL_ORBIT == state.mode || DSTBALL_FOLLOW == state.mode )
+    {
+        motion.targetPosition = mBalls[ state.target ].position;
+        motion.desiredDistance =
+            mScenario.balls()[ index ].radius + mScenario.balls()[ state.target ].radius + state.targetDistance;
+    }
+
+    return mTable.AddBall( motion, tableIndex );
+}
+
+}
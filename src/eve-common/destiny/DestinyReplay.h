@@ -0,0 +1,279 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __DESTINY_REPLAY_H__INCL__
+#define __DESTINY_REPLAY_H__INCL__
+
+#include "destiny/BallTable.h"
+
+namespace Destiny {
+
+/**
+ * @brief Ship ball of a replay scenario.
+ */
+struct ScenarioBall
+{
+    /// ID of ball; commands refer to it.
+    uint32 id;
+    /// Mass of ball, kg.
+    double mass;
+    /// Agility of ball.
+    double agility;
+    /// Maximal velocity at full speed, m/s.
+    double maxVelocity;
+    /// Radius of ball, m.
+    double radius;
+    /// Initial position.
+    GPoint position;
+    /// Initial velocity.
+    GVector velocity;
+};
+
+/**
+ * @brief Movement command issued at given stamp.
+ */
+struct ScenarioCommand
+{
+    enum Type
+    {
+        CMD_GOTO,   ///< Head to @a point.
+        CMD_ALIGN,  ///< Head in direction @a point.
+        CMD_STOP,   ///< Stop.
+        CMD_ORBIT,  ///< Orbit ball @a targetID at distance @a value.
+        CMD_FOLLOW, ///< Follow ball @a targetID at distance @a value.
+        CMD_SPEED   ///< Set speed fraction to @a value.
+    };
+
+    /// Type of command.
+    Type type;
+    /// Stamp at which the command is issued.
+    uint32 stamp;
+    /// Ball the command is issued to.
+    uint32 ballID;
+    /// Target ball (CMD_ORBIT, CMD_FOLLOW).
+    uint32 targetID;
+    /// Point or direction (CMD_GOTO, CMD_ALIGN).
+    GPoint point;
+    /// Distance (CMD_ORBIT, CMD_FOLLOW) or speed fraction (CMD_SPEED).
+    double value;
+};
+
+/**
+ * @brief Balls and the commands issued to them.
+ *
+ * The scenario is a text file with one statement per line:
+ * @code
+ * # comment
+ * tics   <count>
+ * ball   <id> <mass> <agility> <maxVelocity> <radius> <x> <y> <z> [<vx> <vy> <vz>]
+ * goto   <stamp> <id> <x> <y> <z>
+ * align  <stamp> <id> <dx> <dy> <dz>
+ * stop   <stamp> <id>
+ * orbit  <stamp> <id> <target> <distance>
+ * follow <stamp> <id> <target> <distance>
+ * speed  <stamp> <id> <fraction>
+ * @endcode
+ * Stamps count tics from the start of the replay; a command
+ * takes effect in the tic of its stamp.
+ */
+class Scenario
+{
+public:
+    Scenario();
+
+    /**
+     * @brief Loads scenario from file.
+     *
+     * @param[in] filename Name of scenario file.
+     *
+     * @retval true  Load succeeded.
+     * @retval false Load failed; errors have been logged.
+     */
+    bool Load( const char* filename );
+
+    /** @brief Removes all balls and commands. */
+    void Clear();
+
+    /**
+     * @brief Adds a ball.
+     *
+     * @param[in] ball The ball.
+     *
+     * @retval true  Ball added.
+     * @retval false Ball with the same ID already exists.
+     */
+    bool AddBall( const ScenarioBall& ball );
+    /**
+     * @brief Adds a command.
+     *
+     * Commands of the same stamp are issued in the order
+     * they were added.
+     *
+     * @param[in] command The command.
+     *
+     * @retval true  Command added.
+     * @retval false Command refers to an unknown ball.
+     */
+    bool AddCommand( const ScenarioCommand& command );
+
+    /** @return Number of tics to replay. */
+    uint32 tics() const { return mTics; }
+    /** @param[in] tics Number of tics to replay. */
+    void SetTics( uint32 tics ) { mTics = tics; }
+
+    /** @return The balls. */
+    const std::vector<ScenarioBall>& balls() const { return mBalls; }
+    /** @return The commands, ordered by stamp. */
+    const std::vector<ScenarioCommand>& commands() const { return mCommands; }
+
+protected:
+    /// Number of tics to replay.
+    uint32 mTics;
+    /// The balls.
+    std::vector<ScenarioBall> mBalls;
+    /// Index of ball by its ID.
+    std::map<uint32, size_t> mBallIndex;
+    /// The commands.
+    std::vector<ScenarioCommand> mCommands;
+};
+
+/**
+ * @brief Replays a scenario tic by tic.
+ *
+ * Commands and tics follow DestinyManager: commands set the
+ * same state (speed fractions, orbit stamps), derived factors
+ * come from DeriveMotion() and all moving balls are gathered
+ * through BallTable::AddBall() and integrated in one batch per
+ * tic, as SystemManager does. Warps, docking and bubbles are
+ * not simulated.
+ *
+ * Replays of the same scenario by the same build are
+ * deterministic, so stored trajectories can be compared to
+ * catch physics regressions.
+ */
+class Replay
+{
+public:
+    /**
+     * @param[in] scenario Scenario to replay; must outlive the replay.
+     */
+    Replay( const Scenario& scenario );
+
+    /** @brief Puts all balls back to their initial state. */
+    void Rewind();
+    /**
+     * @brief Issues due commands and integrates one tic.
+     */
+    void Tic();
+
+    /** @return Stamp of the next tic. */
+    uint32 GetStamp() const { return mStamp; }
+    /** @return Whether all tics of the scenario have been replayed. */
+    bool IsDone() const { return mStamp >= mScenario.tics(); }
+
+    /** @return Number of balls. */
+    size_t GetBallCount() const { return mBalls.size(); }
+    /** @return ID of ball at given index. */
+    uint32 GetBallID( size_t index ) const { return mScenario.balls()[ index ].id; }
+    /** @return Mode of ball at given index. */
+    BallMode GetMode( size_t index ) const { return mBalls[ index ].mode; }
+    /** @return Position of ball at given index. */
+    const GPoint& GetPosition( size_t index ) const { return mBalls[ index ].position; }
+    /** @return Velocity of ball at given index. */
+    const GVector& GetVelocity( size_t index ) const { return mBalls[ index ].velocity; }
+
+    /** @return Duration of the last tic in microseconds. */
+    uint64 GetLastTicUSec() const { return mLastTicUSec; }
+    /** @return Duration of all tics since rewind in microseconds. */
+    uint64 GetTotalUSec() const { return mTotalUSec; }
+    /** @return Duration of the slowest tic since rewind in microseconds. */
+    uint64 GetPeakUSec() const { return mPeakUSec; }
+
+    /**
+     * @brief Writes state of all balls as CSV lines.
+     *
+     * Each line holds stamp, ball ID, mode, position and velocity.
+     *
+     * @param[in] into File to write into.
+     */
+    void WriteState( FILE* into ) const;
+    /**
+     * @brief Writes header matching WriteState().
+     *
+     * @param[in] into File to write into.
+     */
+    static void WriteHeader( FILE* into );
+
+protected:
+    /** Movement state of a ball, as kept by DestinyManager. */
+    struct BallState
+    {
+        BallMode mode;
+        GPoint position;
+        GVector velocity;
+        GPoint targetPoint;
+        size_t target;
+        double targetDistance;
+        uint32 stateStamp;
+
+        double userSpeedFraction;
+        double activeSpeedFraction;
+        double maxVelocity;
+        double accelerationFactor;
+        double velocityAdjuster;
+        double massAgilityFriction;
+    };
+
+    void _Issue( const ScenarioCommand& command );
+    void _SetActiveSpeed( size_t index, double fraction );
+    void _UpdateDerived( size_t index );
+    bool _Gather( size_t index, size_t& tableIndex );
+
+    /// Scenario being replayed.
+    const Scenario& mScenario;
+    /// Index of ball by its ID.
+    std::map<uint32, size_t> mBallIndex;
+    /// State of balls, in scenario order.
+    std::vector<BallState> mBalls;
+    /// Next command to issue.
+    size_t mNextCommand;
+    /// Stamp of the next tic.
+    uint32 mStamp;
+
+    /// Balls integrated this tic.
+    BallTable mTable;
+    /// Ball index and table index of each gathered ball.
+    std::vector< std::pair<size_t, size_t> > mTableBalls;
+
+    /// Duration of the last tic.
+    uint64 mLastTicUSec;
+    /// Duration of all tics.
+    uint64 mTotalUSec;
+    /// Duration of the slowest tic.
+    uint64 mPeakUSec;
+};
+
+}
+
+#endif /* !__DESTINY_REPLAY_H__INCL__ */
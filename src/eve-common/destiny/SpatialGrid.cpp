@@ -0,0 +1,135 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-common.h"
+
+#include "destiny/SpatialGrid.h"
+
+namespace Destiny {
+
+/* Cell coordinates are packed 21 bits per axis; distant cells
+   may share a key, which only costs extra distance checks. */
+static const uint32 CELL_BITS = 21;
+static const uint64 CELL_MASK = ( static_cast<uint64>( 1 ) << CELL_BITS ) - 1;
+/* Queries spanning more cells than this per axis scan all points. */
+static const int64 MAX_QUERY_SPAN = 16;
+
+SpatialGrid::SpatialGrid( double cellSize )
+: mCellSize( cellSize )
+{
+}
+
+void SpatialGrid::Clear()
+{
+    mEntries.clear();
+}
+
+void SpatialGrid::Insert( uint32 id, const GPoint& position )
+{
+    Entry e;
+    e.cell = _CellKey( _CellCoord( position.x ), _CellCoord( position.y ), _CellCoord( position.z ) );
+    e.id = id;
+    e.x = position.x;
+    e.y = position.y;
+    e.z = position.z;
+
+    mEntries.push_back( e );
+}
+
+void SpatialGrid::Build()
+{
+    std::stable_sort( mEntries.begin(), mEntries.end() );
+}
+
+size_t SpatialGrid::Query( const GPoint& center, double radius, std::vector<Neighbor>& into ) const
+{
+    const size_t first = into.size();
+    const double radius2 = radius * radius;
+
+    const int64 loX = _CellCoord( center.x - radius ), hiX = _CellCoord( center.x + radius );
+    const int64 loY = _CellCoord( center.y - radius ), hiY = _CellCoord( center.y + radius );
+    const int64 loZ = _CellCoord( center.z - radius ), hiZ = _CellCoord( center.z + radius );
+
+    if( MAX_QUERY_SPAN < hiX - loX || MAX_QUERY_SPAN < hiY - loY || MAX_QUERY_SPAN < hiZ - loZ )
+    {
+        std::vector<Entry>::const_iterator cur, end;
+        cur = mEntries.begin();
+        end = mEntries.end();
+        for(; cur != end; cur++)
+            _Visit( *cur, center, radius2, into );
+    }
+    else
+    {
+        Entry key;
+        for( int64 x = loX; x <= hiX; x++ )
+        {
+            for( int64 y = loY; y <= hiY; y++ )
+            {
+                for( int64 z = loZ; z <= hiZ; z++ )
+                {
+                    key.cell = _CellKey( x, y, z );
+
+                    std::pair<std::vector<Entry>::const_iterator, std::vector<Entry>::const_iterator> range =
+                        std::equal_range( mEntries.begin(), mEntries.end(), key );
+                    for(; range.first != range.second; range.first++)
+                        _Visit( *range.first, center, radius2, into );
+                }
+            }
+        }
+    }
+
+    std::sort( into.begin() + first, into.end() );
+    return into.size() - first;
+}
+
+int64 SpatialGrid::_CellCoord( double v ) const
+{
+    return static_cast<int64>( floor( v / mCellSize ) );
+}
+
+uint64 SpatialGrid::_CellKey( int64 x, int64 y, int64 z )
+{
+    return ( ( static_cast<uint64>( x ) & CELL_MASK ) << ( 2 * CELL_BITS ) )
+         | ( ( static_cast<uint64>( y ) & CELL_MASK ) << CELL_BITS )
+         | ( static_cast<uint64>( z ) & CELL_MASK );
+}
+
+void SpatialGrid::_Visit( const Entry& e, const GPoint& center, double radius2, std::vector<Neighbor>& into )
+{
+    const double dx = e.x - center.x;
+    const double dy = e.y - center.y;
+    const double dz = e.z - center.z;
+
+    const double distance2 = dx * dx + dy * dy + dz * dz;
+    if( distance2 <= radius2 )
+    {
+        Neighbor n;
+        n.id = e.id;
+        n.distance2 = distance2;
+
+        into.push_back( n );
+    }
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __SPATIAL_GRID_H__INCL__
+#define __SPATIAL_GRID_H__INCL__
+
+#include "utils/gpoint.h"
+
+namespace Destiny {
+
+/**
+ * @brief Uniform grid over points in a solar system.
+ *
+ * Points are inserted, the grid is built once and then
+ * queried for everything within a radius of a point. Only
+ * cells overlapping the query sphere are visited, so the
+ * cost of a query depends on what is nearby rather than
+ * on everything in the system.
+ *
+ * The grid is meant to be rebuilt each tic; memory is kept
+ * between Clear() calls.
+ */
+class SpatialGrid
+{
+public:
+    /**
+     * @brief Point found by a query.
+     */
+    struct Neighbor
+    {
+        /** ID the point was inserted with. */
+        uint32 id;
+        /** Squared distance from the query center. */
+        double distance2;
+
+        bool operator<( const Neighbor& oth ) const { return distance2 < oth.distance2; }
+    };
+
+    /**
+     * @param[in] cellSize Edge length of a grid cell, in meters.
+     */
+    explicit SpatialGrid( double cellSize );
+
+    /** @return Edge length of a grid cell. */
+    double cellSize() const { return mCellSize; }
+    /** @return Number of points in the grid. */
+    size_t size() const { return mEntries.size(); }
+
+    /**
+     * @brief Removes all points from the grid.
+     */
+    void Clear();
+    /**
+     * @brief Adds a point to the grid.
+     *
+     * The point is not visible to queries until Build().
+     *
+     * @param[in] id       ID to report the point with.
+     * @param[in] position Position of the point.
+     */
+    void Insert( uint32 id, const GPoint& position );
+    /**
+     * @brief Prepares inserted points for queries.
+     */
+    void Build();
+
+    /**
+     * @brief Finds all points within a radius.
+     *
+     * @param[in]  center Center of the query.
+     * @param[in]  radius Radius of the query.
+     * @param[out] into   Vector the points are appended to, nearest first.
+     *
+     * @return Number of points appended.
+     */
+    size_t Query( const GPoint& center, double radius, std::vector<Neighbor>& into ) const;
+
+protected:
+    struct Entry
+    {
+        uint64 cell;
+        uint32 id;
+        double x, y, z;
+
+        bool operator<( const Entry& oth ) const { return cell < oth.cell; }
+    };
+
+    int64 _CellCoord( double v ) const;
+    static uint64 _CellKey( int64 x, int64 y, int64 z );
+
+    static void _Visit( const Entry& e, const GPoint& center, double radius2, std::vector<Neighbor>& into );
+
+    const double mCellSize;
+    std::vector<Entry> mEntries;
+};
+
+}
+
+#endif /* !__SPATIAL_GRID_H__INCL__ */
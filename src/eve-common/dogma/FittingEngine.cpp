@@ -0,0 +1,406 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-common.h"
+
+#include "dogma/FittingEngine.h"
+
+/// Calculation types in the order they are applied.
+enum
+{
+    ORDER_ASSIGN,
+    ORDER_ADD,
+    ORDER_MULTIPLY,
+    ORDER_PERCENT,
+    ORDER_CLAMP,
+    ORDER_OTHER
+};
+
+/// Controls how fast stacking penalty grows; see http://wiki.eveuniversity.org/Eve_math
+static const double STACKING_PENALTY_DIVISOR = 7.1289;
+
+bool FittingEngine::AppliedValue::operator<(const AppliedValue &oth) const
+{
+    if( order != oth.order )
+        return order < oth.order;
+    if( type != oth.type )
+        return type < oth.type;
+    if( penalized != oth.penalized )
+        return !penalized;
+
+    // bonuses first, strongest first; then maluses, strongest first
+    const bool bonus = ( strength >= 0 ), othBonus = ( oth.strength >= 0 );
+    if( bonus != othBonus )
+        return bonus;
+    return bonus ? ( strength > oth.strength ) : ( strength < oth.strength );
+}
+
+FittingEngine::FittingEngine()
+: m_ModifierCount( 0 )
+{
+}
+
+bool FittingEngine::HasAttribute(uint32 itemID, uint32 attributeID) const
+{
+    return m_NodeIndex.find( NodeKey( itemID, attributeID ) ) != m_NodeIndex.end();
+}
+
+bool FittingEngine::GetValue(uint32 itemID, uint32 attributeID, EvilNumber &into) const
+{
+    std::map<NodeKey, uint32>::const_iterator res = m_NodeIndex.find( NodeKey( itemID, attributeID ) );
+    if( res == m_NodeIndex.end() )
+        return false;
+
+    into = m_Nodes[ res->second ].value;
+    return true;
+}
+
+void FittingEngine::SetBaseValue(uint32 itemID, uint32 attributeID, const EvilNumber &value)
+{
+    std::map<NodeKey, uint32>::iterator res = m_NodeIndex.find( NodeKey( itemID, attributeID ) );
+    if( res != m_NodeIndex.end() )
+    {
+        Node &node = m_Nodes[ res->second ];
+        if( EvilNumber( node.baseValue ) != value )
+        {
+            node.baseValue = value;
+            _MarkDirty( res->second );
+        }
+
+        return;
+    }
+
+    uint32 index;
+    if( m_FreeNodes.empty() )
+    {
+        index = m_Nodes.size();
+        m_Nodes.push_back( Node() );
+    }
+    else
+    {
+        index = m_FreeNodes.back();
+        m_FreeNodes.pop_back();
+    }
+
+    Node &node = m_Nodes[ index ];
+    node.itemID = itemID;
+    node.attributeID = attributeID;
+    node.baseValue = value;
+    node.value = value;
+    node.modifiers.clear();
+    node.dependents.clear();
+    node.used = true;
+    node.dirty = false;
+    node.calculated = false;
+    node.mark = 0;
+
+    m_NodeIndex.insert( std::make_pair( NodeKey( itemID, attributeID ), index ) );
+    m_Items[ itemID ].push_back( index );
+}
+
+bool FittingEngine::AddModifier(uint32 originatorID, uint32 sourceItemID, uint32 sourceAttributeID,
+                                uint32 targetItemID, uint32 targetAttributeID,
+                                EVECalculationType type, bool penalized, double scale)
+{
+    std::map<NodeKey, uint32>::const_iterator source = m_NodeIndex.find( NodeKey( sourceItemID, sourceAttributeID ) );
+    std::map<NodeKey, uint32>::const_iterator target = m_NodeIndex.find( NodeKey( targetItemID, targetAttributeID ) );
+    if( source == m_NodeIndex.end() || target == m_NodeIndex.end() )
+        return false;
+
+    uint32 index;
+    if( m_FreeModifiers.empty() )
+    {
+        index = m_Modifiers.size();
+        m_Modifiers.push_back( Modifier() );
+    }
+    else
+    {
+        index = m_FreeModifiers.back();
+        m_FreeModifiers.pop_back();
+    }
+
+    Modifier &mod = m_Modifiers[ index ];
+    mod.originatorID = originatorID;
+    mod.source = source->second;
+    mod.target = target->second;
+    mod.type = type;
+    mod.penalized = penalized;
+    mod.scale = scale;
+    mod.used = true;
+
+    m_Nodes[ mod.source ].dependents.push_back( index );
+    m_Nodes[ mod.target ].modifiers.push_back( index );
+    m_Originators[ originatorID ].push_back( index );
+    ++m_ModifierCount;
+
+    _MarkDirty( mod.target );
+    return true;
+}
+
+void FittingEngine::RemoveModifiers(uint32 originatorID)
+{
+    std::map<uint32, std::vector<uint32> >::iterator res = m_Originators.find( originatorID );
+    if( res == m_Originators.end() )
+        return;
+
+    // _RemoveModifier() updates the list
+    const std::vector<uint32> modifiers( res->second );
+
+    std::vector<uint32>::const_iterator cur, end;
+    cur = modifiers.begin();
+    end = modifiers.end();
+    for(; cur != end; cur++)
+        _RemoveModifier( *cur );
+}
+
+void FittingEngine::RemoveItem(uint32 itemID)
+{
+    RemoveModifiers( itemID );
+
+    std::map<uint32, std::vector<uint32> >::iterator res = m_Items.find( itemID );
+    if( res == m_Items.end() )
+        return;
+
+    std::vector<uint32>::const_iterator cur, end;
+    cur = res->second.begin();
+    end = res->second.end();
+    for(; cur != end; cur++)
+    {
+        Node &node = m_Nodes[ *cur ];
+
+        while( !node.modifiers.empty() )
+            _RemoveModifier( node.modifiers.back() );
+        while( !node.dependents.empty() )
+            _RemoveModifier( node.dependents.back() );
+
+        m_NodeIndex.erase( NodeKey( node.itemID, node.attributeID ) );
+        node.used = false;
+        m_FreeNodes.push_back( *cur );
+    }
+
+    m_Items.erase( res );
+}
+
+void FittingEngine::Recalculate(std::vector<Change> &changes)
+{
+    // depth-first search yields every affected node after its dependents
+    std::vector<uint32> order;
+
+    std::vector<uint32>::const_iterator cur, end;
+    cur = m_Dirty.begin();
+    end = m_Dirty.end();
+    for(; cur != end; cur++)
+    {
+        if( m_Nodes[ *cur ].used && m_Nodes[ *cur ].mark == 0 )
+            _Visit( *cur, order );
+    }
+
+    std::vector<uint32>::const_reverse_iterator rcur, rend;
+    rcur = order.rbegin();
+    rend = order.rend();
+    for(; rcur != rend; rcur++)
+    {
+        Node &node = m_Nodes[ *rcur ];
+        if( _Calculate( *rcur ) )
+        {
+            Change change;
+            change.itemID = node.itemID;
+            change.attributeID = node.attributeID;
+            change.value = node.value;
+
+            changes.push_back( change );
+        }
+
+        node.dirty = false;
+        node.mark = 0;
+    }
+
+    cur = m_Dirty.begin();
+    end = m_Dirty.end();
+    for(; cur != end; cur++)
+        m_Nodes[ *cur ].dirty = false;
+    m_Dirty.clear();
+}
+
+void FittingEngine::_RemoveModifier(uint32 index)
+{
+    Modifier &mod = m_Modifiers[ index ];
+    if( !mod.used )
+        return;
+
+    std::vector<uint32> &dependents = m_Nodes[ mod.source ].dependents;
+    dependents.erase( std::find( dependents.begin(), dependents.end(), index ) );
+
+    std::vector<uint32> &modifiers = m_Nodes[ mod.target ].modifiers;
+    modifiers.erase( std::find( modifiers.begin(), modifiers.end(), index ) );
+
+    std::map<uint32, std::vector<uint32> >::iterator res = m_Originators.find( mod.originatorID );
+    res->second.erase( std::find( res->second.begin(), res->second.end(), index ) );
+    if( res->second.empty() )
+        m_Originators.erase( res );
+
+    _MarkDirty( mod.target );
+
+    mod.used = false;
+    m_FreeModifiers.push_back( index );
+    --m_ModifierCount;
+}
+
+void FittingEngine::_MarkDirty(uint32 node)
+{
+    if( !m_Nodes[ node ].dirty )
+    {
+        m_Nodes[ node ].dirty = true;
+        m_Dirty.push_back( node );
+    }
+}
+
+void FittingEngine::_Visit(uint32 node, std::vector<uint32> &order)
+{
+    m_Nodes[ node ].mark = 1;    // in progress
+
+    // copy, the vector may move while we recurse
+    const std::vector<uint32> dependents( m_Nodes[ node ].dependents );
+
+    std::vector<uint32>::const_iterator cur, end;
+    cur = dependents.begin();
+    end = dependents.end();
+    for(; cur != end; cur++)
+    {
+        const uint32 target = m_Modifiers[ *cur ].target;
+        if( m_Nodes[ target ].mark == 0 )
+            _Visit( target, order );
+        else if( m_Nodes[ target ].mark == 1 )
+        {
+            _log( ITEM__ERROR, "FittingEngine: attribute %u of item %u depends on itself; the cycle is cut.",
+                  m_Nodes[ target ].attributeID, m_Nodes[ target ].itemID );
+        }
+    }
+
+    m_Nodes[ node ].mark = 2;    // done
+    order.push_back( node );
+}
+
+bool FittingEngine::_Calculate(uint32 index)
+{
+    Node &node = m_Nodes[ index ];
+
+    m_Scratch.clear();
+
+    std::vector<uint32>::const_iterator cur, end;
+    cur = node.modifiers.begin();
+    end = node.modifiers.end();
+    for(; cur != end; cur++)
+    {
+        const Modifier &mod = m_Modifiers[ *cur ];
+        EvilNumber source( m_Nodes[ mod.source ].value );
+
+        AppliedValue val;
+        val.order = _GetCalculationOrder( mod.type );
+        val.penalized = mod.penalized;
+        val.type = mod.type;
+        val.value = source.get_float() * mod.scale;
+        val.strength = _GetStrength( mod.type, val.value );
+
+        m_Scratch.push_back( val );
+    }
+
+    std::sort( m_Scratch.begin(), m_Scratch.end() );
+
+    EvilNumber value( node.baseValue );
+
+    // position of modifier within its penalty group
+    uint32 bonuses = 0, maluses = 0;
+    for( size_t i = 0; i < m_Scratch.size(); i++ )
+    {
+        const AppliedValue &val = m_Scratch[ i ];
+        if( i > 0 && ( val.type != m_Scratch[ i - 1 ].type || val.penalized != m_Scratch[ i - 1 ].penalized ) )
+            bonuses = maluses = 0;
+
+        double applied = val.value;
+        if( val.penalized )
+        {
+            if( val.strength >= 0 )
+                applied = _Penalize( val.type, applied, bonuses++ );
+            else
+                applied = _Penalize( val.type, applied, maluses++ );
+        }
+
+        value = CalculateNewAttributeValue( value, EvilNumber( applied ), val.type );
+    }
+
+    const bool changed = ( !node.calculated || node.value != value );
+    node.value = value;
+    node.calculated = true;
+
+    return changed;
+}
+
+uint32 FittingEngine::_GetCalculationOrder(EVECalculationType type)
+{
+    switch( type )
+    {
+        case CALC_ABSOLUTE:
+            return ORDER_ASSIGN;
+
+        case CALC_ADDITION:
+        case CALC_ADD_POSITIVE:
+        case CALC_ADD_NEGATIVE:
+        case CALC_SUBTRACTION:
+            return ORDER_ADD;
+
+        case CALC_MULTIPLIER:
+            return ORDER_MULTIPLY;
+
+        case CALC_PERCENTAGE:
+        case CALC_DIFFERENCE:
+        case CALC_VELOCITY:
+        case CALC_CLOAKED_VELOCITY:
+        case CALC_CAP_BOOSTERS:
+            return ORDER_PERCENT;
+
+        case CALC_ABSOLUTE_MAX:
+        case CALC_ABSOLUTE_MIN:
+            return ORDER_CLAMP;
+
+        default:
+            return ORDER_OTHER;
+    }
+}
+
+double FittingEngine::_GetStrength(EVECalculationType type, double value)
+{
+    // multipliers are neutral at 1, everything else at 0
+    return ( type == CALC_MULTIPLIER ) ? value - 1.0 : value;
+}
+
+double FittingEngine::_Penalize(EVECalculationType type, double value, uint32 position)
+{
+    const double effectiveness = exp( -(double)( position * position ) / STACKING_PENALTY_DIVISOR );
+
+    if( type == CALC_MULTIPLIER )
+        return 1.0 + ( value - 1.0 ) * effectiveness;
+    else
+        return value * effectiveness;
+}
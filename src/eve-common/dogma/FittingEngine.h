@@ -0,0 +1,198 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __DOGMA__FITTING_ENGINE_H__INCL__
+#define __DOGMA__FITTING_ENGINE_H__INCL__
+
+#include "dogma/DogmaCalculation.h"
+
+/**
+ * @brief Dependency graph of the attribute modifiers of a ship.
+ *
+ * Every modified attribute (and every attribute a modifier takes
+ * its value from) is a node, identified by itemID and attributeID.
+ * Modifiers are edges from their source node to their target node.
+ *
+ * Adding or removing modifiers and changing base values only marks
+ * nodes dirty; Recalculate() then recomputes the dirty nodes and
+ * everything depending on them, in topological order, and reports
+ * the attributes whose value changed. Nothing else is touched.
+ *
+ * Stacking penalized modifiers of the same calculation type form
+ * a penalty group, which is sorted by strength and penalized
+ * in a flat array at recalculation.
+ */
+class FittingEngine
+{
+public:
+    /**
+     * @brief Attribute whose value has been changed by Recalculate().
+     */
+    struct Change
+    {
+        uint32 itemID;
+        uint32 attributeID;
+        EvilNumber value;
+    };
+
+    FittingEngine();
+
+    /**
+     * @param[in] itemID      ID of item.
+     * @param[in] attributeID ID of attribute.
+     *
+     * @retval true  The attribute is in the graph.
+     * @retval false The attribute is not in the graph.
+     */
+    bool HasAttribute(uint32 itemID, uint32 attributeID) const;
+    /**
+     * @brief Obtains calculated value of an attribute.
+     *
+     * @param[in]  itemID      ID of item.
+     * @param[in]  attributeID ID of attribute.
+     * @param[out] into        Where to store the value.
+     *
+     * @retval true  Value obtained.
+     * @retval false The attribute is not in the graph.
+     */
+    bool GetValue(uint32 itemID, uint32 attributeID, EvilNumber &into) const;
+    /**
+     * @brief Sets unmodified value of an attribute, adding it to the graph if needed.
+     *
+     * @param[in] itemID      ID of item.
+     * @param[in] attributeID ID of attribute.
+     * @param[in] value       The unmodified value.
+     */
+    void SetBaseValue(uint32 itemID, uint32 attributeID, const EvilNumber &value);
+
+    /**
+     * @brief Adds a modifier.
+     *
+     * Both attributes must have been added by SetBaseValue() before.
+     *
+     * @param[in] originatorID      ID of module, skill etc. which applies the modifier.
+     * @param[in] sourceItemID      ID of item which holds the modifier value.
+     * @param[in] sourceAttributeID ID of attribute which holds the modifier value.
+     * @param[in] targetItemID      ID of modified item.
+     * @param[in] targetAttributeID ID of modified attribute.
+     * @param[in] type              How the value is applied.
+     * @param[in] penalized         Whether stacking penalty applies.
+     * @param[in] scale             Multiplier of the modifier value (e.g. skill level).
+     *
+     * @retval true  Modifier added.
+     * @retval false One of the attributes is not in the graph.
+     */
+    bool AddModifier(uint32 originatorID, uint32 sourceItemID, uint32 sourceAttributeID,
+                     uint32 targetItemID, uint32 targetAttributeID,
+                     EVECalculationType type, bool penalized, double scale = 1.0);
+    /**
+     * @brief Removes all modifiers applied by originator.
+     *
+     * @param[in] originatorID ID of originator.
+     */
+    void RemoveModifiers(uint32 originatorID);
+    /**
+     * @brief Removes all attributes of an item and all modifiers applied by or to it.
+     *
+     * @param[in] itemID ID of item.
+     */
+    void RemoveItem(uint32 itemID);
+
+    /**
+     * @brief Recalculates every attribute affected by changes since last call.
+     *
+     * @param[out] changes Where to append attributes whose value has changed.
+     */
+    void Recalculate(std::vector<Change> &changes);
+
+    /** @return Number of attributes in the graph. */
+    size_t GetAttributeCount() const { return m_NodeIndex.size(); }
+    /** @return Number of modifiers in the graph. */
+    size_t GetModifierCount() const { return m_ModifierCount; }
+
+protected:
+    typedef std::pair<uint32, uint32> NodeKey;    // itemID, attributeID
+
+    struct Node
+    {
+        uint32 itemID;
+        uint32 attributeID;
+        EvilNumber baseValue;
+        EvilNumber value;
+        std::vector<uint32> modifiers;     // incoming, index into m_Modifiers
+        std::vector<uint32> dependents;    // outgoing, index into m_Modifiers
+        bool used;
+        bool dirty;
+        bool calculated;                   // whether value has been reported yet
+        uint8 mark;                        // used by Recalculate()
+    };
+
+    struct Modifier
+    {
+        uint32 originatorID;
+        uint32 source;                     // index into m_Nodes
+        uint32 target;                     // index into m_Nodes
+        EVECalculationType type;
+        bool penalized;
+        double scale;
+        bool used;
+    };
+
+    // a modifier value prepared for application; sorted into penalty groups
+    struct AppliedValue
+    {
+        uint32 order;
+        bool penalized;
+        double strength;
+        double value;
+        EVECalculationType type;
+
+        bool operator<(const AppliedValue &oth) const;
+    };
+
+    void _RemoveModifier(uint32 index);
+    void _MarkDirty(uint32 node);
+    void _Visit(uint32 node, std::vector<uint32> &order);
+    bool _Calculate(uint32 node);
+
+    static uint32 _GetCalculationOrder(EVECalculationType type);
+    static double _GetStrength(EVECalculationType type, double value);
+    static double _Penalize(EVECalculationType type, double value, uint32 position);
+
+    std::map<NodeKey, uint32> m_NodeIndex;
+    std::vector<Node> m_Nodes;
+    std::vector<uint32> m_FreeNodes;
+
+    std::vector<Modifier> m_Modifiers;
+    std::vector<uint32> m_FreeModifiers;
+    size_t m_ModifierCount;
+
+    std::map<uint32, std::vector<uint32> > m_Originators;    // originatorID -> index into m_Modifiers
+    std::map<uint32, std::vector<uint32> > m_Items;          // itemID -> index into m_Nodes
+
+    std::vector<uint32> m_Dirty;
+    std::vector<AppliedValue> m_Scratch;    // reused by _Calculate()
+};
+
+#endif /* !__DOGMA__FITTING_ENGINE_H__INCL__ */
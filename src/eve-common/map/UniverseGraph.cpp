@@ -0,0 +1,364 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-common.h"
+
+#include "map/UniverseGraph.h"
+
+/*************************************************************************/
+/* UniverseGraph                                                         */
+/*************************************************************************/
+const int32 UniverseGraph::NO_ROUTE;
+const double UniverseGraph::HIGH_SECURITY = 0.45;
+const uint32 UniverseGraph::NO_INDEX;
+const uint16 UniverseGraph::UNREACHABLE;
+const uint32 UniverseGraph::UNSAFE_COST;
+
+UniverseGraph::UniverseGraph( size_t cacheSize )
+: mCacheSize( 0 < cacheSize ? cacheSize : 1 )
+{
+}
+
+void UniverseGraph::Clear()
+{
+    mSystems.clear();
+    mIndexes.clear();
+
+    mPendingJumps.clear();
+    mJumpOffsets.clear();
+    mJumps.clear();
+    mReverseOffsets.clear();
+    mReverseJumps.clear();
+
+    mStargates.clear();
+
+    mCache.clear();
+    mCacheIndex.clear();
+}
+
+void UniverseGraph::AddSystem( uint32 systemID, uint32 constellationID, uint32 regionID, double security )
+{
+    if( NO_INDEX != _GetIndex( systemID ) )
+        return;
+
+    System system;
+    system.systemID = systemID;
+    system.constellationID = constellationID;
+    system.regionID = regionID;
+    system.security = security;
+
+    mIndexes[ systemID ] = mSystems.size();
+    mSystems.push_back( system );
+}
+
+void UniverseGraph::AddJump( uint32 fromSystemID, uint32 toSystemID )
+{
+    mPendingJumps.push_back( std::make_pair( fromSystemID, toSystemID ) );
+}
+
+void UniverseGraph::AddStargate( uint32 stargateID, uint32 toStargateID, uint32 toSystemID )
+{
+    Stargate& stargate = mStargates[ stargateID ];
+    stargate.toStargateID = toStargateID;
+    stargate.toSystemID = toSystemID;
+}
+
+size_t UniverseGraph::Build()
+{
+    const size_t count = mSystems.size();
+
+    // resolve the pending jumps, keeping the already built ones
+    std::vector< std::pair<uint32, uint32> > edges;
+    edges.reserve( mJumps.size() + mPendingJumps.size() );
+
+    for( uint32 from = 0; from + 1 < mJumpOffsets.size(); ++from )
+        for( uint32 j = mJumpOffsets[ from ]; j < mJumpOffsets[ from + 1 ]; ++j )
+            edges.push_back( std::make_pair( from, mJumps[ j ] ) );
+
+    std::vector< std::pair<uint32, uint32> >::const_iterator cur, end;
+    cur = mPendingJumps.begin();
+    end = mPendingJumps.end();
+    for(; cur != end; ++cur )
+    {
+        const uint32 from = _GetIndex( cur->first );
+        const uint32 to = _GetIndex( cur->second );
+        if( NO_INDEX == from || NO_INDEX == to || from == to )
+            continue;
+
+        edges.push_back( std::make_pair( from, to ) );
+    }
+    mPendingJumps.clear();
+
+    // sort by source so each system's jumps are contiguous; drop duplicates
+    std::sort( edges.begin(), edges.end() );
+    edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+    mJumpOffsets.assign( count + 1, 0 );
+    mJumps.resize( edges.size() );
+
+    for( size_t i = 0; i < edges.size(); ++i )
+    {
+        ++mJumpOffsets[ edges[ i ].first + 1 ];
+        mJumps[ i ] = edges[ i ].second;
+    }
+    for( size_t i = 0; i < count; ++i )
+        mJumpOffsets[ i + 1 ] += mJumpOffsets[ i ];
+
+    // the same for jumps into each system, used to walk routes back
+    mReverseOffsets.assign( count + 1, 0 );
+    mReverseJumps.resize( edges.size() );
+
+    for( size_t i = 0; i < edges.size(); ++i )
+        ++mReverseOffsets[ edges[ i ].second + 1 ];
+    for( size_t i = 0; i < count; ++i )
+        mReverseOffsets[ i + 1 ] += mReverseOffsets[ i ];
+
+    std::vector<uint32> fill( mReverseOffsets.begin(), mReverseOffsets.end() - 1 );
+    for( size_t i = 0; i < edges.size(); ++i )
+        mReverseJumps[ fill[ edges[ i ].second ]++ ] = edges[ i ].first;
+
+    // the tables are stale now
+    mCache.clear();
+    mCacheIndex.clear();
+
+    return mJumps.size();
+}
+
+uint32 UniverseGraph::GetConstellationID( uint32 systemID ) const
+{
+    const uint32 index = _GetIndex( systemID );
+    return NO_INDEX == index ? 0 : mSystems[ index ].constellationID;
+}
+
+uint32 UniverseGraph::GetRegionID( uint32 systemID ) const
+{
+    const uint32 index = _GetIndex( systemID );
+    return NO_INDEX == index ? 0 : mSystems[ index ].regionID;
+}
+
+double UniverseGraph::GetSecurity( uint32 systemID ) const
+{
+    const uint32 index = _GetIndex( systemID );
+    return NO_INDEX == index ? 0.0 : mSystems[ index ].security;
+}
+
+bool UniverseGraph::GetStargateJump( uint32 stargateID, uint32& toStargateID, uint32& toSystemID ) const
+{
+    std::tr1::unordered_map<uint32, Stargate>::const_iterator res = mStargates.find( stargateID );
+    if( mStargates.end() == res )
+        return false;
+
+    toStargateID = res->second.toStargateID;
+    toSystemID = res->second.toSystemID;
+    return true;
+}
+
+int32 UniverseGraph::GetJumps( uint32 fromSystemID, uint32 toSystemID )
+{
+    const uint32 from = _GetIndex( fromSystemID );
+    const uint32 to = _GetIndex( toSystemID );
+    if( NO_INDEX == from || NO_INDEX == to )
+        return NO_ROUTE;
+    if( from == to )
+        return 0;
+
+    const uint16 distance = _GetDistances( from )[ to ];
+    return UNREACHABLE == distance ? NO_ROUTE : distance;
+}
+
+bool UniverseGraph::IsWithinJumps( uint32 fromSystemID, uint32 toSystemID, uint32 maxJumps )
+{
+    const int32 jumps = GetJumps( fromSystemID, toSystemID );
+    return NO_ROUTE != jumps && (uint32)jumps <= maxJumps;
+}
+
+bool UniverseGraph::IsInOrderRange( int32 orderRange, uint32 orderStationID, uint32 orderSystemID, uint32 stationID, uint32 systemID )
+{
+    switch( orderRange )
+    {
+    case ORDER_RANGE_STATION:
+        return orderStationID == stationID;
+    case ORDER_RANGE_SYSTEM:
+        return orderSystemID == systemID;
+    case ORDER_RANGE_REGION:
+        return true;
+    default:
+        return 0 < orderRange && IsWithinJumps( orderSystemID, systemID, orderRange );
+    }
+}
+
+void UniverseGraph::GetSystemsWithinJumps( uint32 systemID, uint32 maxJumps, std::vector<uint32>& into )
+{
+    const uint32 from = _GetIndex( systemID );
+    if( NO_INDEX == from )
+        return;
+
+    const DistanceTable& distances = _GetDistances( from );
+    for( uint32 i = 0; i < distances.size(); ++i )
+        if( distances[ i ] <= maxJumps )
+            into.push_back( mSystems[ i ].systemID );
+}
+
+bool UniverseGraph::GetRoute( uint32 fromSystemID, uint32 toSystemID, RouteType type, std::vector<uint32>& into )
+{
+    const uint32 from = _GetIndex( fromSystemID );
+    const uint32 to = _GetIndex( toSystemID );
+    if( NO_INDEX == from || NO_INDEX == to )
+        return false;
+
+    if( ROUTE_SAFEST == type )
+        return _GetSafestRoute( from, to, into );
+
+    // walk back from the destination through systems
+    // one jump closer to the source
+    const DistanceTable& distances = _GetDistances( from );
+    if( UNREACHABLE == distances[ to ] )
+        return false;
+
+    std::vector<uint32> route( distances[ to ] + 1 );
+    uint32 cur = to;
+    route[ distances[ to ] ] = cur;
+
+    for( uint16 d = distances[ to ]; 0 < d; --d )
+    {
+        uint32 j = mReverseOffsets[ cur ];
+        while( distances[ mReverseJumps[ j ] ] != d - 1 )
+            ++j;
+
+        cur = mReverseJumps[ j ];
+        route[ d - 1 ] = cur;
+    }
+
+    into.reserve( into.size() + route.size() );
+    for( size_t i = 0; i < route.size(); ++i )
+        into.push_back( mSystems[ route[ i ] ].systemID );
+
+    return true;
+}
+
+uint32 UniverseGraph::_GetIndex( uint32 systemID ) const
+{
+    std::tr1::unordered_map<uint32, uint32>::const_iterator res = mIndexes.find( systemID );
+    return mIndexes.end() == res ? NO_INDEX : res->second;
+}
+
+const UniverseGraph::DistanceTable& UniverseGraph::_GetDistances( uint32 index )
+{
+    std::tr1::unordered_map<uint32, CacheList::iterator>::iterator res = mCacheIndex.find( index );
+    if( mCacheIndex.end() != res )
+    {
+        // move to front
+        mCache.splice( mCache.begin(), mCache, res->second );
+        return res->second->second;
+    }
+
+    // reuse the least recently used table if the cache is full
+    if( mCache.size() < mCacheSize )
+        mCache.push_front( std::make_pair( index, DistanceTable() ) );
+    else
+    {
+        mCacheIndex.erase( mCache.back().first );
+        mCache.splice( mCache.begin(), mCache, --mCache.end() );
+        mCache.front().first = index;
+    }
+    mCacheIndex[ index ] = mCache.begin();
+
+    DistanceTable& distances = mCache.front().second;
+    distances.assign( mSystems.size(), UNREACHABLE );
+
+    // breadth-first search
+    std::vector<uint32> queue;
+    queue.reserve( mSystems.size() );
+
+    distances[ index ] = 0;
+    queue.push_back( index );
+
+    for( size_t head = 0; head < queue.size(); ++head )
+    {
+        const uint32 cur = queue[ head ];
+        const uint16 next = distances[ cur ] + 1;
+
+        for( uint32 j = mJumpOffsets[ cur ]; j < mJumpOffsets[ cur + 1 ]; ++j )
+        {
+            const uint32 to = mJumps[ j ];
+            if( UNREACHABLE != distances[ to ] )
+                continue;
+
+            distances[ to ] = next;
+            queue.push_back( to );
+        }
+    }
+
+    return distances;
+}
+
+bool UniverseGraph::_GetSafestRoute( uint32 from, uint32 to, std::vector<uint32>& into ) const
+{
+    const uint32 INFINITE_COST = 0xFFFFFFFF;
+
+    std::vector<uint32> cost( mSystems.size(), INFINITE_COST );
+    std::vector<uint32> prev( mSystems.size(), NO_INDEX );
+
+    // min-heap of (cost, index)
+    typedef std::pair<uint32, uint32> Node;
+    std::priority_queue< Node, std::vector<Node>, std::greater<Node> > open;
+
+    cost[ from ] = 0;
+    open.push( Node( 0, from ) );
+
+    while( !open.empty() )
+    {
+        const Node node = open.top();
+        open.pop();
+
+        const uint32 cur = node.second;
+        if( node.first != cost[ cur ] )
+            continue; // stale entry
+        if( cur == to )
+            break;
+
+        for( uint32 j = mJumpOffsets[ cur ]; j < mJumpOffsets[ cur + 1 ]; ++j )
+        {
+            const uint32 next = mJumps[ j ];
+            const uint32 step = mSystems[ next ].security < HIGH_SECURITY ? UNSAFE_COST : 1;
+
+            if( cost[ cur ] + step < cost[ next ] )
+            {
+                cost[ next ] = cost[ cur ] + step;
+                prev[ next ] = cur;
+                open.push( Node( cost[ next ], next ) );
+            }
+        }
+    }
+
+    if( INFINITE_COST == cost[ to ] )
+        return false;
+
+    std::vector<uint32> route;
+    for( uint32 cur = to; NO_INDEX != cur; cur = prev[ cur ] )
+        route.push_back( mSystems[ cur ].systemID );
+
+    into.insert( into.end(), route.rbegin(), route.rend() );
+    return true;
+}
@@ -0,0 +1,261 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __MAP__UNIVERSE_GRAPH_H__INCL__
+#define __MAP__UNIVERSE_GRAPH_H__INCL__
+
+/**
+ * @brief Stargate connectivity of solar systems.
+ *
+ * Systems and jumps are added once and packed into compact
+ * adjacency arrays by Build(). Jump distances are computed by
+ * breadth-first search from the source system; the resulting
+ * distance tables of recently used sources are kept in an LRU
+ * cache, so repeated queries from the same system (a station,
+ * a client's location) are a table lookup.
+ *
+ * Not thread-safe; queries update the cache.
+ */
+class UniverseGraph
+{
+public:
+    /// Route preference.
+    enum RouteType
+    {
+        ROUTE_SHORTEST, ///< The fewest jumps.
+        ROUTE_SAFEST    ///< Avoid low and null security systems where possible.
+    };
+
+    /// Range of a market order; any positive value is a number of jumps.
+    enum OrderRange
+    {
+        ORDER_RANGE_STATION = -1,    ///< The order's station only.
+        ORDER_RANGE_SYSTEM = 0,      ///< The order's solar system.
+        ORDER_RANGE_REGION = 32767   ///< The order's region.
+    };
+
+    /// Returned by GetJumps() if there is no route.
+    static const int32 NO_ROUTE = -1;
+    /// Lowest security of a high-security system.
+    static const double HIGH_SECURITY;
+
+    /**
+     * @param[in] cacheSize Number of distance tables to keep.
+     */
+    UniverseGraph( size_t cacheSize = 256 );
+
+    /** @brief Removes all systems and jumps. */
+    void Clear();
+
+    /**
+     * @brief Adds a solar system.
+     *
+     * @param[in] systemID        ID of the system.
+     * @param[in] constellationID ID of its constellation.
+     * @param[in] regionID        ID of its region.
+     * @param[in] security        Security status of the system.
+     */
+    void AddSystem( uint32 systemID, uint32 constellationID, uint32 regionID, double security );
+    /**
+     * @brief Adds a one-way stargate jump.
+     *
+     * @param[in] fromSystemID System the jump starts in.
+     * @param[in] toSystemID   System the jump leads to.
+     */
+    void AddJump( uint32 fromSystemID, uint32 toSystemID );
+    /**
+     * @brief Adds a stargate link.
+     *
+     * @param[in] stargateID   The stargate.
+     * @param[in] toStargateID Stargate it leads to.
+     * @param[in] toSystemID   System of the destination stargate.
+     */
+    void AddStargate( uint32 stargateID, uint32 toStargateID, uint32 toSystemID );
+    /**
+     * @brief Packs the added jumps into adjacency arrays.
+     *
+     * Must be called after all systems and jumps are added
+     * and before any queries. Jumps between unknown systems
+     * are ignored.
+     *
+     * @return Number of jumps in the graph.
+     */
+    size_t Build();
+
+    /** @return Number of systems. */
+    size_t GetSystemCount() const { return mSystems.size(); }
+    /** @return Number of one-way jumps. */
+    size_t GetJumpCount() const { return mJumps.size(); }
+    /** @return Number of stargates. */
+    size_t GetStargateCount() const { return mStargates.size(); }
+
+    /** @return True if the system is known. */
+    bool HasSystem( uint32 systemID ) const { return NO_INDEX != _GetIndex( systemID ); }
+    /** @return Constellation of the system; 0 if unknown. */
+    uint32 GetConstellationID( uint32 systemID ) const;
+    /** @return Region of the system; 0 if unknown. */
+    uint32 GetRegionID( uint32 systemID ) const;
+    /** @return Security status of the system; 0 if unknown. */
+    double GetSecurity( uint32 systemID ) const;
+
+    /**
+     * @brief Obtains destination of a stargate.
+     *
+     * @param[in]  stargateID   The stargate.
+     * @param[out] toStargateID Stargate it leads to.
+     * @param[out] toSystemID   System of the destination stargate.
+     *
+     * @retval true  The stargate is known.
+     * @retval false Unknown stargate.
+     */
+    bool GetStargateJump( uint32 stargateID, uint32& toStargateID, uint32& toSystemID ) const;
+
+    /**
+     * @brief Obtains the jump distance of two systems.
+     *
+     * @param[in] fromSystemID The source system.
+     * @param[in] toSystemID   The destination system.
+     *
+     * @return Number of jumps; NO_ROUTE if unreachable or unknown.
+     */
+    int32 GetJumps( uint32 fromSystemID, uint32 toSystemID );
+    /**
+     * @brief Checks if a system is at most a number of jumps away.
+     *
+     * @param[in] fromSystemID The source system.
+     * @param[in] toSystemID   The destination system.
+     * @param[in] maxJumps     Maximal number of jumps.
+     */
+    bool IsWithinJumps( uint32 fromSystemID, uint32 toSystemID, uint32 maxJumps );
+    /**
+     * @brief Checks if a station is covered by the range of a market order.
+     *
+     * Both stations are expected to be in the same region.
+     *
+     * @param[in] orderRange     Range of the order; see OrderRange.
+     * @param[in] orderStationID Station of the order.
+     * @param[in] orderSystemID  Solar system of the order.
+     * @param[in] stationID      The station to check.
+     * @param[in] systemID       Solar system of the station to check.
+     */
+    bool IsInOrderRange( int32 orderRange, uint32 orderStationID, uint32 orderSystemID, uint32 stationID, uint32 systemID );
+    /**
+     * @brief Lists systems at most a number of jumps away.
+     *
+     * @param[in]  systemID The source system; included.
+     * @param[in]  maxJumps Maximal number of jumps.
+     * @param[out] into     Vector to append system IDs to.
+     */
+    void GetSystemsWithinJumps( uint32 systemID, uint32 maxJumps, std::vector<uint32>& into );
+    /**
+     * @brief Finds a route between two systems.
+     *
+     * @param[in]  fromSystemID The source system.
+     * @param[in]  toSystemID   The destination system.
+     * @param[in]  type         Route preference.
+     * @param[out] into         Systems along the route, including both ends.
+     *
+     * @retval true  The route has been found.
+     * @retval false There is no route.
+     */
+    bool GetRoute( uint32 fromSystemID, uint32 toSystemID, RouteType type, std::vector<uint32>& into );
+
+protected:
+    /// Jump distances from a single system, by index; UNREACHABLE if none.
+    typedef std::vector<uint16> DistanceTable;
+
+    /// Index of unknown system.
+    static const uint32 NO_INDEX = 0xFFFFFFFF;
+    /// Distance of unreachable system.
+    static const uint16 UNREACHABLE = 0xFFFF;
+    /// Cost of entering a low or null security system on the safest route.
+    static const uint32 UNSAFE_COST = 1000;
+
+    /// A solar system.
+    struct System
+    {
+        uint32 systemID;
+        uint32 constellationID;
+        uint32 regionID;
+        double security;
+    };
+
+    /// Destination of a stargate.
+    struct Stargate
+    {
+        uint32 toStargateID;
+        uint32 toSystemID;
+    };
+
+    /** @return Index of the system; NO_INDEX if unknown. */
+    uint32 _GetIndex( uint32 systemID ) const;
+    /**
+     * @brief Obtains distances from a system, from the cache or by BFS.
+     *
+     * @param[in] index Index of the source system.
+     *
+     * @return The distance table; valid until the next query.
+     */
+    const DistanceTable& _GetDistances( uint32 index );
+    /**
+     * @brief Finds the safest route by Dijkstra's algorithm.
+     *
+     * @param[in]  from Index of the source system.
+     * @param[in]  to   Index of the destination system.
+     * @param[out] into Systems along the route.
+     *
+     * @retval true  The route has been found.
+     * @retval false There is no route.
+     */
+    bool _GetSafestRoute( uint32 from, uint32 to, std::vector<uint32>& into ) const;
+
+    /// The systems.
+    std::vector<System> mSystems;
+    /// System ID to index.
+    std::tr1::unordered_map<uint32, uint32> mIndexes;
+
+    /// Jumps added since the last Build(), by system IDs.
+    std::vector< std::pair<uint32, uint32> > mPendingJumps;
+    /// Jumps of system i are mJumps[ mJumpOffsets[ i ] ] up to mJumps[ mJumpOffsets[ i + 1 ] ].
+    std::vector<uint32> mJumpOffsets;
+    /// Destination system indexes.
+    std::vector<uint32> mJumps;
+    /// Jumps into system i, laid out as mJumpOffsets/mJumps.
+    std::vector<uint32> mReverseOffsets;
+    /// Source system indexes.
+    std::vector<uint32> mReverseJumps;
+
+    /// Stargates by ID.
+    std::tr1::unordered_map<uint32, Stargate> mStargates;
+
+    /// Cached distance tables, most recently used first.
+    typedef std::list< std::pair<uint32, DistanceTable> > CacheList;
+    CacheList mCache;
+    /// Source index to its cache entry.
+    std::tr1::unordered_map<uint32, CacheList::iterator> mCacheIndex;
+    /// Maximal number of cached tables.
+    const size_t mCacheSize;
+};
+
+#endif /* !__MAP__UNIVERSE_GRAPH_H__INCL__ */
@@ -39,14 +39,14 @@ bool Marshal( const PyRep* rep, Buffer& into )
     return v.Save( rep, into );
 }
 
-bool MarshalDeflate( const PyRep* rep, Buffer& into, const uint32 deflationLimit )
+bool MarshalDeflate( const PyRep* rep, Buffer& into, const uint32 deflationLimit, const int deflationLevel )
 {
     Buffer data;
     if( !Marshal( rep, data ) )
         return false;
 
     if( data.size() >= deflationLimit )
-        return DeflateData( data, into );
+        return DeflateData( data, into, deflationLevel );
     else
     {
         into.AppendSeq( data.begin<uint8>(), data.end<uint8>() );
@@ -87,9 +87,30 @@ bool MarshalStream::SaveStream( const PyRep* rep )
     return rep->visit( *this );
 }
 
+void MarshalStream::BeginStream( Buffer& into )
+{
+    mBuffer = &into;
+
+    Put<uint8>( MarshalHeaderByte );
+    Put<uint32>( 0 ); // Mapcount, see SaveStream
+}
+
+bool MarshalStream::SaveRep( const PyRep* rep )
+{
+    if( rep == NULL )
+        return false;
+
+    return rep->visit( *this );
+}
+
 bool MarshalStream::VisitInteger( const PyInt* rep )
 {
-    const int32 val = rep->value();
+    SaveInt( rep->value() );
+    return true;
+}
+
+void MarshalStream::SaveInt( int32 val )
+{
 
     if( val == -1 )
     {
@@ -118,13 +139,16 @@ bool MarshalStream::VisitInteger( const PyInt* rep )
         Put<uint8>( Op_PyByte );
         Put<int8>( val );
     }
+}
 
+bool MarshalStream::VisitLong( const PyLong* rep )
+{
+    SaveLong( rep->value() );
     return true;
 }
 
-bool MarshalStream::VisitLong( const PyLong* rep )
+void MarshalStream::SaveLong( int64 val )
 {
-    const int64 val = rep->value();
 
     if( val == -1 )
     {
@@ -140,7 +164,7 @@ bool MarshalStream::VisitLong( const PyLong* rep )
     }
     else if( val + 0x800000u > 0xFFFFFFFF )
     {
-        SaveVarInteger( rep );
+        SaveVarInteger( val );
     }
     else if( val + 0x8000u > 0xFFFF )
     {
@@ -157,57 +181,61 @@ bool MarshalStream::VisitLong( const PyLong* rep )
         Put<uint8>( Op_PyByte );
         Put<int8>(static_cast<int8>(val));
     }
-
-    return true;
 }
 
 bool MarshalStream::VisitBoolean( const PyBool* rep )
 {
-    if( rep->value() == true )
-        Put<uint8>( Op_PyTrue );
-    else
-        Put<uint8>( Op_PyFalse );
-
+    SaveBool( rep->value() );
     return true;
 }
 
 bool MarshalStream::VisitReal( const PyFloat* rep )
 {
-    if( rep->value() == 0.0 )
+    SaveReal( rep->value() );
+    return true;
+}
+
+void MarshalStream::SaveReal( double value )
+{
+    if( value == 0.0 )
     {
         Put<uint8>( Op_PyZeroReal );
     }
     else
     {
         Put<uint8>( Op_PyReal );
-        Put<double>( rep->value() );
+        Put<double>( value );
     }
-
-    return true;
 }
 
 bool MarshalStream::VisitNone( const PyNone* rep )
 {
-    Put<uint8>( Op_PyNone );
+    SaveNone();
     return true;
 }
 
 bool MarshalStream::VisitBuffer( const PyBuffer* rep )
 {
-    Put<uint8>( Op_PyBuffer );
+    SaveBuffer( rep->content() );
+    return true;
+}
 
-    const Buffer& buf = rep->content();
+void MarshalStream::SaveBuffer( const Buffer& buf )
+{
+    Put<uint8>( Op_PyBuffer );
 
     PutSizeEx( buf.size() );
     Put( buf.begin<uint8>(), buf.end<uint8>() );
-
-    return true;
 }
 
 bool MarshalStream::VisitString( const PyString* rep )
 {
-    size_t len = rep->content().size();
+    SaveString( rep->content() );
+    return true;
+}
 
+void MarshalStream::SaveString( const char* str, size_t len )
+{
     if( len == 0 )
     {
         Put<uint8>( Op_PyEmptyString );
@@ -215,12 +243,12 @@ bool MarshalStream::VisitString( const PyString* rep )
     else if( len == 1 )
     {
         Put<uint8>( Op_PyCharString );
-        Put<uint8>( rep->content()[0] );
+        Put<uint8>( str[0] );
     }
     else
     {
         //string is long enough for a string table entry, check it.
-        const uint8 index = sMarshalStringTable.LookupIndex( rep->content() );
+        const uint8 index = sMarshalStringTable.LookupIndex( str );
         if( STRING_TABLE_ERROR != index )
         {
             Put<uint8>( Op_PyStringTableItem );
@@ -231,17 +259,19 @@ bool MarshalStream::VisitString( const PyString* rep )
         {
             Put<uint8>( Op_PyLongString );
             PutSizeEx( len );
-            Put( rep->content().begin(), rep->content().end() );
+            Put( &str[0], &str[len] );
         }
     }
-
-    return true;
 }
 
 bool MarshalStream::VisitWString( const PyWString* rep )
 {
-    size_t len = rep->content().size();
+    SaveWString( rep->content() );
+    return true;
+}
 
+void MarshalStream::SaveWString( const char* str, size_t len )
+{
     if( 0 == len )
     {
         Put<uint8>( Op_PyEmptyWString );
@@ -253,27 +283,34 @@ bool MarshalStream::VisitWString( const PyWString* rep )
 
         Put<uint8>( Op_PyWStringUTF8 );
         PutSizeEx( len );
-        Put( rep->content().begin(), rep->content().end() );
+        Put( &str[0], &str[len] );
     }
-
-    return true;
 }
 
 bool MarshalStream::VisitToken( const PyToken* rep )
 {
-    Put<uint8>( Op_PyToken );
-
     const std::string& str = rep->content();
 
-    PutSizeEx( str.size() );
-    Put( str.begin(), str.end() );
-
+    SaveToken( str.c_str(), str.size() );
     return true;
 }
 
+void MarshalStream::SaveToken( const char* str, size_t len )
+{
+    Put<uint8>( Op_PyToken );
+
+    PutSizeEx( len );
+    Put( &str[0], &str[len] );
+}
+
 bool MarshalStream::VisitTuple( const PyTuple* rep )
 {
-    uint32 size = rep->size();
+    SaveTupleHeader( rep->size() );
+    return PyVisitor::VisitTuple( rep );
+}
+
+void MarshalStream::SaveTupleHeader( uint32 size )
+{
     if( size == 0 )
     {
         Put<uint8>( Op_PyEmptyTuple );
@@ -291,13 +328,16 @@ bool MarshalStream::VisitTuple( const PyTuple* rep )
         Put<uint8>( Op_PyTuple );
         PutSizeEx( size );
     }
-
-    return PyVisitor::VisitTuple( rep );
 }
 
 bool MarshalStream::VisitList( const PyList* rep )
 {
-    uint32 size = rep->size();
+    SaveListHeader( rep->size() );
+    return PyVisitor::VisitList( rep );
+}
+
+void MarshalStream::SaveListHeader( uint32 size )
+{
     if( size == 0 )
     {
         Put<uint8>( Op_PyEmptyList );
@@ -311,16 +351,17 @@ bool MarshalStream::VisitList( const PyList* rep )
         Put<uint8>( Op_PyList );
         PutSizeEx( size );
     }
-
-    return PyVisitor::VisitList( rep );
 }
 
-bool MarshalStream::VisitDict( const PyDict* rep )
+void MarshalStream::SaveDictHeader( uint32 size )
 {
-    uint32 size = rep->size();
-
     Put<uint8>( Op_PyDict );
     PutSizeEx( size );
+}
+
+bool MarshalStream::VisitDict( const PyDict* rep )
+{
+    SaveDictHeader( rep->size() );
 
     //we have to reverse the order of key/value to be value/key, so do not call base class.
     PyDict::const_iterator cur, end;
@@ -339,7 +380,7 @@ bool MarshalStream::VisitDict( const PyDict* rep )
 
 bool MarshalStream::VisitObject( const PyObject* rep )
 {
-    Put<uint8>( Op_PyObject );
+    SaveObjectHeader();
     return PyVisitor::VisitObject( rep );
 }
 
@@ -506,7 +547,7 @@ bool MarshalStream::VisitPackedRow( const PyPackedRow* rep )
 
 bool MarshalStream::VisitSubStruct( const PySubStruct* rep )
 {
-    Put<uint8>(Op_PySubStruct);
+    SaveSubStructHeader();
     return PyVisitor::VisitSubStruct( rep );
 }
 
@@ -541,6 +582,14 @@ bool MarshalStream::VisitSubStream( const PySubStream* rep )
     return true;
 }
 
+void MarshalStream::SaveSubStream( const Buffer& data )
+{
+    Put<uint8>(Op_PySubStream);
+
+    PutSizeEx( data.size() );
+    Put( data.begin<uint8>(), data.end<uint8>() );
+}
+
 //! TODO: check the implementation of this...
 // we should never visit a checksummed stream... NEVER...
 bool MarshalStream::VisitChecksumedStream( const PyChecksumedStream* rep )
@@ -553,9 +602,9 @@ bool MarshalStream::VisitChecksumedStream( const PyChecksumedStream* rep )
     return PyVisitor::VisitChecksumedStream( rep );
 }
 
-void MarshalStream::SaveVarInteger( const PyLong* v )
+void MarshalStream::SaveVarInteger( int64 v )
 {
-    const uint64 value = v->value();
+    const uint64 value = v;
     uint8 integerSize = 0;
 
 #define DoIntegerSizeCheck(x) if( ( (uint8*)&value )[x] != 0 ) integerSize = x + 1;
@@ -45,11 +45,26 @@ extern bool Marshal( const PyRep* rep, Buffer& into );
  * @param[in]  rep            Python object to marshal.
  * @param[out] into           Buffer which receives deflated marshaled stream.
  * @param[in]  deflationLimit The least size of buffer which gets deflated.
+ * @param[in]  deflationLevel Compression level used for deflation.
  *
  * @retval true  Marshaling ran successfully.
  * @retval false Error occured during marshaling.
  */
-extern bool MarshalDeflate( const PyRep* rep, Buffer& into, const uint32 deflationLimit = 0x2000 );
+extern bool MarshalDeflate( const PyRep* rep, Buffer& into, const uint32 deflationLimit = 0x2000, const int deflationLevel = Z_DEFAULT_COMPRESSION );
+/**
+ * @brief Marshal Stream builder for packets with direct encoding.
+ *
+ * Produces the same stream as Marshal( packet.Encode(), into )
+ * without building the intermediate PyRep tree.
+ *
+ * @param[in]  packet Packet to marshal; must have EncodeTo (encode="direct").
+ * @param[out] into   Buffer which receives marshaled stream.
+ *
+ * @retval true  Marshaling ran successfully.
+ * @retval false Error occured during marshaling.
+ */
+template<typename T>
+bool MarshalDirect( const T& packet, Buffer& into );
 
 /**
  * @brief Turns Python objects into marshal bytecode.
@@ -66,6 +81,49 @@ public:
     /** saves given rep to given buffer */
     bool Save( const PyRep* rep, Buffer& into );
 
+    /**
+     * @name Direct encoding
+     *
+     * Writes stream content piece by piece; used by generated
+     * EncodeTo methods. The output is identical to visiting
+     * the equivalent PyRep tree.
+     */
+    /*@{*/
+    /** starts a new stream in given buffer */
+    void BeginStream( Buffer& into );
+    /** finishes stream started by BeginStream */
+    void EndStream() { mBuffer = NULL; }
+
+    /** adds given rep (may be a whole tree) */
+    bool SaveRep( const PyRep* rep );
+
+    void SaveInt( int32 value );
+    void SaveLong( int64 value );
+    void SaveReal( double value );
+    void SaveBool( bool value ) { Put<uint8>( value ? Op_PyTrue : Op_PyFalse ); }
+    void SaveNone() { Put<uint8>( Op_PyNone ); }
+    void SaveBuffer( const Buffer& data );
+    /** @note @a str must be NUL-terminated, as for string table lookup */
+    void SaveString( const char* str, size_t len );
+    void SaveString( const std::string& str ) { SaveString( str.c_str(), str.size() ); }
+    void SaveWString( const char* str, size_t len );
+    void SaveWString( const std::string& str ) { SaveWString( str.c_str(), str.size() ); }
+    void SaveToken( const char* str, size_t len );
+
+    /** adds tuple opcode; @a size items must follow */
+    void SaveTupleHeader( uint32 size );
+    /** adds list opcode; @a size items must follow */
+    void SaveListHeader( uint32 size );
+    /** adds dict opcode; @a size value/key pairs must follow */
+    void SaveDictHeader( uint32 size );
+    /** adds object opcode; type and arguments must follow */
+    void SaveObjectHeader() { Put<uint8>( Op_PyObject ); }
+    /** adds substruct opcode; the substruct content must follow */
+    void SaveSubStructHeader() { Put<uint8>( Op_PySubStruct ); }
+    /** adds substream containing given marshaled stream */
+    void SaveSubStream( const Buffer& data );
+    /*@}*/
+
 protected:
     /** saves new stream with given rep. */
     bool SaveStream( const PyRep* rep );
@@ -139,12 +197,23 @@ protected:
 
 private:
     // utility to handle Op_PyVarInteger (a bit hacky......)
-    void SaveVarInteger( const PyLong* v );
+    void SaveVarInteger( int64 v );
     // zero-compresses given buffer and adds it to the stream
     bool SaveZeroCompressed( const Buffer& data );
 
     Buffer* mBuffer;
 };
 
+template<typename T>
+bool MarshalDirect( const T& packet, Buffer& into )
+{
+    MarshalStream v;
+    v.BeginStream( into );
+    const bool res = packet.EncodeTo( v );
+    v.EndStream();
+
+    return res;
+}
+
 #endif
 
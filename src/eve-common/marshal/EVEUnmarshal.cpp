@@ -41,6 +41,12 @@ PyRep* Unmarshal( const Buffer& data )
     return v.Load( data );
 }
 
+PyRep* Unmarshal( Buffer::const_iterator<uint8> first, Buffer::const_iterator<uint8> last )
+{
+    UnmarshalStream v;
+    return v.Load( first, last );
+}
+
 PyRep* InflateUnmarshal( const Buffer& data )
 {
     if( IsDeflated( data ) )
@@ -128,13 +134,491 @@ PyRep* ( UnmarshalStream::* const UnmarshalStream::s_mLoadMap[ PyRepOpcodeMask +
 
 PyRep* UnmarshalStream::Load( const Buffer& data )
 {
-    mInItr = data.begin<uint8>();
-    PyRep* res = LoadStream( data.size() );
+    return Load( data.begin<uint8>(), data.end<uint8>() );
+}
+
+PyRep* UnmarshalStream::Load( Buffer::const_iterator<uint8> first, Buffer::const_iterator<uint8> last )
+{
+    mInItr = first;
+    PyRep* res = LoadStream( last - first );
     mInItr = Buffer::const_iterator<uint8>();
 
     return res;
 }
 
+bool UnmarshalStream::BeginStream( const Buffer& data )
+{
+    EndStream();
+
+    if( sizeof( uint8 ) + sizeof( uint32 ) > data.size() )
+    {
+        sLog.Error( "Unmarshal", "Stream too short (%lu bytes).", data.size() );
+        return false;
+    }
+
+    mInItr = data.begin<uint8>();
+
+    const uint8 header = Read<uint8>();
+    if( MarshalHeaderByte != header )
+    {
+        sLog.Error( "Unmarshal", "Invalid stream received (header byte 0x%X).", header );
+        mInItr = Buffer::const_iterator<uint8>();
+        return false;
+    }
+
+    const uint32 saveCount = Read<uint32>();
+    CreateObjectStore( data.size() - sizeof( uint8 ) - sizeof( uint32 ), saveCount );
+
+    return true;
+}
+
+void UnmarshalStream::EndStream()
+{
+    std::vector<PyRep*>::iterator cur, end;
+    cur = mPulledReps.begin();
+    end = mPulledReps.end();
+    for(; cur != end; cur++ )
+        PyDecRef( *cur );
+    mPulledReps.clear();
+
+    DestroyObjectStore();
+    mInItr = Buffer::const_iterator<uint8>();
+}
+
+bool UnmarshalStream::PullNone()
+{
+    //saved Nones are left for PullRep
+    if( Op_PyNone != ( Peek<uint8>() & ~PyRepUnknownMask ) )
+        return false;
+
+    Read<uint8>();
+    return true;
+}
+
+bool UnmarshalStream::PullInt( int32& into )
+{
+    const Buffer::const_iterator<uint8> inItr = mInItr;
+    const Buffer::const_iterator<uint32> storeIndexItr = mStoreIndexItr;
+
+    int64 value;
+    bool isLong;
+    if( !PullInteger( value, isLong ) || isLong )
+    {
+        mInItr = inItr;
+        mStoreIndexItr = storeIndexItr;
+        return false;
+    }
+
+    into = static_cast<int32>( value );
+    return true;
+}
+
+bool UnmarshalStream::PullLong( int64& into )
+{
+    bool isLong;
+    return PullInteger( into, isLong );
+}
+
+bool UnmarshalStream::PullReal( double& into )
+{
+    if( IsSavedNext() )
+    {
+        const Buffer::const_iterator<uint8> inItr = mInItr;
+        const Buffer::const_iterator<uint32> storeIndexItr = mStoreIndexItr;
+
+        PyRep* rep = LoadRep();
+        const bool res = ( NULL != rep && rep->IsFloat() );
+        if( res )
+            into = rep->AsFloat()->value();
+        else
+        {
+            mInItr = inItr;
+            mStoreIndexItr = storeIndexItr;
+        }
+
+        PySafeDecRef( rep );
+        return res;
+    }
+
+    switch( Peek<uint8>() & PyRepOpcodeMask )
+    {
+        case Op_PyReal:
+            Read<uint8>();
+            into = Read<double>();
+            return true;
+        case Op_PyZeroReal:
+            Read<uint8>();
+            into = 0.0;
+            return true;
+    }
+
+    return false;
+}
+
+bool UnmarshalStream::PullBool( bool& into )
+{
+    if( IsSavedNext() )
+    {
+        const Buffer::const_iterator<uint8> inItr = mInItr;
+        const Buffer::const_iterator<uint32> storeIndexItr = mStoreIndexItr;
+
+        PyRep* rep = LoadRep();
+        const bool res = ( NULL != rep && rep->IsBool() );
+        if( res )
+            into = rep->AsBool()->value();
+        else
+        {
+            mInItr = inItr;
+            mStoreIndexItr = storeIndexItr;
+        }
+
+        PySafeDecRef( rep );
+        return res;
+    }
+
+    switch( Peek<uint8>() & PyRepOpcodeMask )
+    {
+        case Op_PyTrue:
+            Read<uint8>();
+            into = true;
+            return true;
+        case Op_PyFalse:
+            Read<uint8>();
+            into = false;
+            return true;
+    }
+
+    return false;
+}
+
+bool UnmarshalStream::PullString( std::string& into )
+{
+    if( IsSavedNext() )
+    {
+        const Buffer::const_iterator<uint8> inItr = mInItr;
+        const Buffer::const_iterator<uint32> storeIndexItr = mStoreIndexItr;
+
+        PyRep* rep = LoadRep();
+        const bool res = ( NULL != rep && rep->IsString() );
+        if( res )
+            into = rep->AsString()->content();
+        else
+        {
+            mInItr = inItr;
+            mStoreIndexItr = storeIndexItr;
+        }
+
+        PySafeDecRef( rep );
+        return res;
+    }
+
+    switch( Peek<uint8>() & PyRepOpcodeMask )
+    {
+        case Op_PyEmptyString:
+        {
+            Read<uint8>();
+            into.clear();
+        } return true;
+        case Op_PyCharString:
+        {
+            Read<uint8>();
+            const Buffer::const_iterator<char> str = Read<char>( 1 );
+            into.assign( str, str + 1 );
+        } return true;
+        case Op_PyShortString:
+        {
+            Read<uint8>();
+            const uint8 len = Read<uint8>();
+            const Buffer::const_iterator<char> str = Read<char>( len );
+            into.assign( str, str + len );
+        } return true;
+        case Op_PyStringTableItem:
+        {
+            const char* str = sMarshalStringTable.LookupString( Peek<uint8>( 2 )[ 1 ] );
+            if( NULL == str )
+                return false;
+
+            Read<uint8>( 2 );
+            into = str;
+        } return true;
+        case Op_PyLongString:
+        {
+            Read<uint8>();
+            const uint32 len = ReadSizeEx();
+            const Buffer::const_iterator<char> str = Read<char>( len );
+            into.assign( str, str + len );
+        } return true;
+    }
+
+    return false;
+}
+
+bool UnmarshalStream::PullWString( std::string& into )
+{
+    if( IsSavedNext() )
+    {
+        const Buffer::const_iterator<uint8> inItr = mInItr;
+        const Buffer::const_iterator<uint32> storeIndexItr = mStoreIndexItr;
+
+        PyRep* rep = LoadRep();
+        const bool res = ( NULL != rep && rep->IsWString() );
+        if( res )
+            into = rep->AsWString()->content();
+        else
+        {
+            mInItr = inItr;
+            mStoreIndexItr = storeIndexItr;
+        }
+
+        PySafeDecRef( rep );
+        return res;
+    }
+
+    switch( Peek<uint8>() & PyRepOpcodeMask )
+    {
+        case Op_PyEmptyWString:
+        {
+            Read<uint8>();
+            into.clear();
+        } return true;
+        case Op_PyWStringUCS2Char:
+        {
+            Read<uint8>();
+            const Buffer::const_iterator<uint16> wstr = Read<uint16>( 1 );
+
+            into.clear();
+            utf8::utf16to8( wstr, wstr + 1, std::back_inserter( into ) );
+        } return true;
+        case Op_PyWStringUCS2:
+        {
+            Read<uint8>();
+            const uint32 len = ReadSizeEx();
+            const Buffer::const_iterator<uint16> wstr = Read<uint16>( len );
+
+            into.clear();
+            utf8::utf16to8( wstr, wstr + len, std::back_inserter( into ) );
+        } return true;
+        case Op_PyWStringUTF8:
+        {
+            Read<uint8>();
+            const uint32 len = ReadSizeEx();
+            const Buffer::const_iterator<char> wstr = Read<char>( len );
+            into.assign( wstr, wstr + len );
+        } return true;
+    }
+
+    return false;
+}
+
+bool UnmarshalStream::PullToken( std::string& into )
+{
+    if( IsSavedNext() )
+    {
+        const Buffer::const_iterator<uint8> inItr = mInItr;
+        const Buffer::const_iterator<uint32> storeIndexItr = mStoreIndexItr;
+
+        PyRep* rep = LoadRep();
+        const bool res = ( NULL != rep && rep->IsToken() );
+        if( res )
+            into = rep->AsToken()->content();
+        else
+        {
+            mInItr = inItr;
+            mStoreIndexItr = storeIndexItr;
+        }
+
+        PySafeDecRef( rep );
+        return res;
+    }
+
+    if( Op_PyToken != ( Peek<uint8>() & PyRepOpcodeMask ) )
+        return false;
+
+    Read<uint8>();
+    const uint8 len = Read<uint8>();
+    const Buffer::const_iterator<char> str = Read<char>( len );
+    into.assign( str, str + len );
+
+    return true;
+}
+
+bool UnmarshalStream::PullTupleHeader( uint32& count )
+{
+    //saved containers would have to be built as a whole
+    if( IsSavedNext() )
+        return false;
+
+    switch( Peek<uint8>() & PyRepOpcodeMask )
+    {
+        case Op_PyEmptyTuple:
+            Read<uint8>();
+            count = 0;
+            return true;
+        case Op_PyOneTuple:
+            Read<uint8>();
+            count = 1;
+            return true;
+        case Op_PyTwoTuple:
+            Read<uint8>();
+            count = 2;
+            return true;
+        case Op_PyTuple:
+            Read<uint8>();
+            count = ReadSizeEx();
+            return true;
+    }
+
+    return false;
+}
+
+bool UnmarshalStream::PullListHeader( uint32& count )
+{
+    if( IsSavedNext() )
+        return false;
+
+    switch( Peek<uint8>() & PyRepOpcodeMask )
+    {
+        case Op_PyEmptyList:
+            Read<uint8>();
+            count = 0;
+            return true;
+        case Op_PyOneList:
+            Read<uint8>();
+            count = 1;
+            return true;
+        case Op_PyList:
+            Read<uint8>();
+            count = ReadSizeEx();
+            return true;
+    }
+
+    return false;
+}
+
+bool UnmarshalStream::PullObjectHeader()
+{
+    if( IsSavedNext() )
+        return false;
+
+    if( Op_PyObject != ( Peek<uint8>() & PyRepOpcodeMask ) )
+        return false;
+
+    Read<uint8>();
+    return true;
+}
+
+PyRep* UnmarshalStream::PullRep()
+{
+    PyRep* rep = LoadRep();
+    if( NULL != rep )
+        mPulledReps.push_back( rep );
+
+    return rep;
+}
+
+bool UnmarshalStream::IsSavedNext() const
+{
+    const uint8 header = Peek<uint8>();
+
+    return ( 0 != ( header & PyRepSaveMask ) )
+        || ( Op_PySavedStreamElement == ( header & PyRepOpcodeMask ) );
+}
+
+bool UnmarshalStream::PullInteger( int64& into, bool& isLong )
+{
+    if( IsSavedNext() )
+    {
+        const Buffer::const_iterator<uint8> inItr = mInItr;
+        const Buffer::const_iterator<uint32> storeIndexItr = mStoreIndexItr;
+
+        PyRep* rep = LoadRep();
+        bool res = true;
+        if( NULL != rep && rep->IsInt() )
+        {
+            into = rep->AsInt()->value();
+            isLong = false;
+        }
+        else if( NULL != rep && rep->IsLong() )
+        {
+            into = rep->AsLong()->value();
+            isLong = true;
+        }
+        else
+        {
+            mInItr = inItr;
+            mStoreIndexItr = storeIndexItr;
+            res = false;
+        }
+
+        PySafeDecRef( rep );
+        return res;
+    }
+
+    isLong = false;
+    switch( Peek<uint8>() & PyRepOpcodeMask )
+    {
+        case Op_PyLongLong:
+            Read<uint8>();
+            into = Read<int64>();
+            isLong = true;
+            return true;
+        case Op_PyLong:
+            Read<uint8>();
+            into = Read<int32>();
+            return true;
+        case Op_PySignedShort:
+            Read<uint8>();
+            into = Read<int16>();
+            return true;
+        case Op_PyByte:
+            Read<uint8>();
+            into = Read<int8>();
+            return true;
+        case Op_PyMinusOne:
+            Read<uint8>();
+            into = -1;
+            return true;
+        case Op_PyZeroInteger:
+            Read<uint8>();
+            into = 0;
+            return true;
+        case Op_PyOneInteger:
+            Read<uint8>();
+            into = 1;
+            return true;
+        case Op_PyVarInteger:
+        {
+            const Buffer::const_iterator<uint8> inItr = mInItr;
+
+            Read<uint8>();
+            const uint32 len = ReadSizeEx();
+            if( sizeof( int64 ) < len )
+            {
+                //loaded as PyBuffer by the tree
+                mInItr = inItr;
+                return false;
+            }
+
+            const Buffer::const_iterator<uint8> data = Read<uint8>( len );
+            if( sizeof( int32 ) >= len )
+            {
+                int32 intval = 0;
+                memcpy( &intval, &*data, len );
+                into = intval;
+            }
+            else
+            {
+                int64 intval = 0;
+                memcpy( &intval, &*data, len );
+                into = intval;
+                isLong = true;
+            }
+        } return true;
+    }
+
+    return false;
+}
+
 PyRep* UnmarshalStream::LoadStream( size_t streamLength )
 {
     const uint8 header = Read<uint8>();
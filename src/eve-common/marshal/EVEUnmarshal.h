@@ -36,6 +36,17 @@
  * @return Ownership of Python object.
  */
 extern PyRep* Unmarshal( const Buffer& data );
+/**
+ * @brief Turns marshal stream into Python object.
+ *
+ * Allows unmarshaling a part of buffer in place.
+ *
+ * @param[in] first Iterator pointing to first byte of marshal stream.
+ * @param[in] last  Iterator pointing to byte after the marshal stream.
+ *
+ * @return Ownership of Python object.
+ */
+extern PyRep* Unmarshal( Buffer::const_iterator<uint8> first, Buffer::const_iterator<uint8> last );
 /**
  * @brief Turns possibly inflated marshal stream into Python object.
  *
@@ -44,6 +55,22 @@ extern PyRep* Unmarshal( const Buffer& data );
  * @return Ownership of Python object.
 */
 extern PyRep* InflateUnmarshal( const Buffer& data );
+/**
+ * @brief Decodes packet straight from marshal stream.
+ *
+ * Uses DecodeFrom() of the packet, which reads the stream
+ * without building Python objects for the typed fields. If
+ * that fails (e.g. because the stream references saved
+ * objects), the stream is unmarshaled and decoded the usual way.
+ *
+ * @param[in]  data   Marshal stream.
+ * @param[out] packet The packet to be filled.
+ *
+ * @retval true  Packet decoded successfully.
+ * @retval false Stream is invalid or doesn't match the packet.
+ */
+template<typename T>
+bool UnmarshalDirect( const Buffer& data, T& packet );
 
 /**
  * @brief Class which turns marshal bytecode into Python object.
@@ -57,6 +84,7 @@ public:
     : mStoredObjects( NULL )
     {
     }
+    ~UnmarshalStream() { EndStream(); }
 
     /**
      * @brief Loads Python object from given bytecode.
@@ -66,6 +94,69 @@ public:
      * @return Loaded Python object.
      */
     PyRep* Load( const Buffer& data );
+    /**
+     * @brief Loads Python object from given bytecode.
+     *
+     * @param[in] first Iterator pointing to first byte of marshal bytecode.
+     * @param[in] last  Iterator pointing to byte after the marshal bytecode.
+     *
+     * @return Loaded Python object.
+     */
+    PyRep* Load( Buffer::const_iterator<uint8> first, Buffer::const_iterator<uint8> last );
+
+    /*
+     * Pull interface, used by generated DecodeFrom() methods.
+     *
+     * Each Pull* reads the next element if it is of the requested
+     * type; otherwise it returns false and leaves the stream as it
+     * was, so the caller may try another type.
+     */
+    /**
+     * @brief Starts pulling elements from given bytecode.
+     *
+     * @param[in] data Buffer containing marshal bytecode; must outlive the pulling.
+     *
+     * @retval true  Stream header is valid.
+     * @retval false Not a marshal stream.
+     */
+    bool BeginStream( const Buffer& data );
+    /**
+     * @brief Finishes pulling, releasing all objects obtained by PullRep.
+     */
+    void EndStream();
+
+    /** Pulls none. */
+    bool PullNone();
+    /** Pulls integer which fits into int32 (PyInt). */
+    bool PullInt( int32& into );
+    /** Pulls integer of any size up to int64 (PyInt or PyLong). */
+    bool PullLong( int64& into );
+    /** Pulls real. */
+    bool PullReal( double& into );
+    /** Pulls boolean. */
+    bool PullBool( bool& into );
+    /** Pulls string. */
+    bool PullString( std::string& into );
+    /** Pulls wide string, converted to UTF-8. */
+    bool PullWString( std::string& into );
+    /** Pulls token. */
+    bool PullToken( std::string& into );
+
+    /** Pulls tuple header; its @a count items follow. */
+    bool PullTupleHeader( uint32& count );
+    /** Pulls list header; its @a count items follow. */
+    bool PullListHeader( uint32& count );
+    /** Pulls object header; type and arguments follow. */
+    bool PullObjectHeader();
+
+    /**
+     * @brief Pulls next element as Python object.
+     *
+     * Fallback for members which are not typed.
+     *
+     * @return The object, which stays owned by the stream until EndStream; NULL on error.
+     */
+    PyRep* PullRep();
 
 protected:
     /** Peeks element from stream. */
@@ -97,6 +188,11 @@ protected:
         return size;
     }
 
+    /** Checks whether next element is saved or a reference to saved element. */
+    bool IsSavedNext() const;
+    /** Helper; pulls integer, flagging ones which don't fit into PyInt. */
+    bool PullInteger( int64& into, bool& isLong );
+
     /** Initializes loading and loads rep from stream. */
     PyRep* LoadStream( size_t streamLength );
 
@@ -247,10 +343,32 @@ private:
     Buffer::const_iterator<uint32> mStoreIndexItr;
     /** Referenced objects within the buffer. */
     PyList* mStoredObjects;
+    /** Objects handed out by PullRep. */
+    std::vector<PyRep*> mPulledReps;
 
     /** Load function map. */
     static PyRep* ( UnmarshalStream::* const s_mLoadMap[] )();
 };
 
+template<typename T>
+bool UnmarshalDirect( const Buffer& data, T& packet )
+{
+    UnmarshalStream v;
+    if( v.BeginStream( data ) )
+    {
+        const bool res = packet.DecodeFrom( v );
+        v.EndStream();
+
+        if( res )
+            return true;
+    }
+
+    PyRep* rep = Unmarshal( data );
+    if( NULL == rep )
+        return false;
+
+    return packet.Decode( &rep );
+}
+
 #endif
 
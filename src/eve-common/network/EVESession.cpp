@@ -81,7 +81,7 @@ void EVEClientSession::QueuePacket( const PyPacket* p )
     FastQueuePacket( &packet );
 }
 
-void EVEClientSession::FastQueuePacket( PyPacket** p )
+void EVEClientSession::FastQueuePacket( PyPacket** p, bool deflate )
 {
     if(p == NULL || *p == NULL)
         return;
@@ -95,7 +95,7 @@ void EVEClientSession::FastQueuePacket( PyPacket** p )
         return;
     }
 
-    mNet->QueueRep( r );
+    mNet->QueueRep( r, deflate );
     PyDecRef( r );
 }
 
@@ -114,6 +114,11 @@ PyPacket* EVEClientSession::PopPacket()
     return ( this->*mPacketHandler )( r );
 }
 
+void EVEClientSession::_ExpectLogin()
+{
+    mPacketHandler = &EVEClientSession::_HandleAuthentication;
+}
+
 PyPacket* EVEClientSession::_HandleVersion( PyRep* rep )
 {
     //we are waiting for their version information...
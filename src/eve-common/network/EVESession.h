@@ -82,9 +82,10 @@ public:
     /**
      * @brief Queues new packet, retaking ownership.
      *
-     * @param[in] p Packed to be queued.
+     * @param[in] p       Packed to be queued.
+     * @param[in] deflate Whether the packet may be deflated.
      */
-    void FastQueuePacket( PyPacket** p );
+    void FastQueuePacket( PyPacket** p, bool deflate = true );
 
     /**
      * @brief Pops new packet from queue.
@@ -141,9 +142,12 @@ protected:
     /**
      * @brief Verifies login.
      *
+     * Verification may finish later; if it fails then,
+     * _ExpectLogin() should be called.
+     *
      * @param[in] ccp Login data sent by client.
      *
-     * @retval true  Verification succeeded; proceeds to next state.
+     * @retval true  Verification succeeded or has been started; proceeds to next state.
      * @retval false Verification failed; stays in current state.
      */
     virtual bool _VerifyLogin( CryptoChallengePacket& ccp ) = 0;
@@ -157,6 +161,14 @@ protected:
      */
     virtual bool _VerifyFuncResult( CryptoHandshakeResult& result ) = 0;
 
+    /**
+     * @brief Makes session wait for login data again.
+     *
+     * For logins which have been verified later than
+     * _VerifyLogin() returned and failed.
+     */
+    void _ExpectLogin();
+
     /** Connection of this session. */
     EVETCPConnection* const mNet;
 
@@ -34,20 +34,35 @@
 /*************************************************************************/
 const uint32 EVETCPConnection::TIMEOUT_MS = 10 * 60 * 1000; // 10 minutes
 const uint32 EVETCPConnection::PACKET_SIZE_LIMIT = 10 * 1024 * 1024; // 10 megabytes
+const int EVETCPConnection::DEFLATE_LEVEL = Z_BEST_SPEED;
 
 EVETCPConnection::EVETCPConnection()
 : TCPConnection(),
-  mTimeoutTimer( TIMEOUT_MS )
+  mTimeoutTimer( TIMEOUT_MS ),
+  mDeflateLevel( DEFLATE_LEVEL )
 {
 }
 
 EVETCPConnection::EVETCPConnection( Socket* sock, uint32 rIP, uint16 rPort )
 : TCPConnection( sock, rIP, rPort ),
-  mTimeoutTimer( TIMEOUT_MS )
+  mTimeoutTimer( TIMEOUT_MS ),
+  mDeflateLevel( DEFLATE_LEVEL )
 {
 }
 
-void EVETCPConnection::QueueRep( const PyRep* rep )
+void EVETCPConnection::SetDeflateLevel( int level )
+{
+    if( Z_DEFAULT_COMPRESSION != level
+        && ( Z_NO_COMPRESSION > level || Z_BEST_COMPRESSION < level ) )
+    {
+        sLog.Error( "Network", "Invalid deflate level %d, using %d.", level, DEFLATE_LEVEL );
+        level = DEFLATE_LEVEL;
+    }
+
+    mDeflateLevel = level;
+}
+
+void EVETCPConnection::QueueRep( const PyRep* rep, bool deflate )
 {
     Buffer* buf = new Buffer;
 
@@ -55,7 +70,11 @@ void EVETCPConnection::QueueRep( const PyRep* rep )
     const Buffer::iterator<uint32> bufLen = buf->end<uint32>();
     buf->ResizeAt( bufLen, 1 );
 
-    if( !MarshalDeflate( rep, *buf ) )
+    const bool res = ( deflate
+                       ? MarshalDeflate( rep, *buf, 0x2000, mDeflateLevel )
+                       : Marshal( rep, *buf ) );
+
+    if( !res )
         sLog.Error( "Network", "Failed to marshal new packet." );
     else if( PACKET_SIZE_LIMIT < buf->size() )
         sLog.Error( "Network", "Packet length %u exceeds hardcoded packet length limit %lu.", buf->size(), PACKET_SIZE_LIMIT );
@@ -74,30 +93,36 @@ void EVETCPConnection::QueueRep( const PyRep* rep )
 
 PyRep* EVETCPConnection::PopRep()
 {
-    Buffer* packet = NULL;
     PyRep* res = NULL;
 
-    {
-        MutexLock lock( mMInQueue );
-        packet = mInQueue.PopPacket();
-    }
+    // the packet is a view into the receive buffer; keep it locked
+    MutexLock lock( mMInQueue );
+
+    Buffer::const_iterator<uint8> first, last;
+    if( !mInQueue.PeekPacket( first, last ) )
+        return NULL;
 
-    if( NULL != packet )
+    const size_t len = ( last - first );
+    if( PACKET_SIZE_LIMIT < len )
+        sLog.Error( "Network", "Packet length %lu exceeds hardcoded packet length limit %u.", len, PACKET_SIZE_LIMIT );
+    else if( 0 == len )
+        sLog.Error( "Network", "Received empty packet." );
+    else if( DeflateHeaderByte == *first )
     {
-        if( PACKET_SIZE_LIMIT < packet->size() )
-            sLog.Error( "Network", "Packet length %lu exceeds hardcoded packet length limit %u.", packet->size(), PACKET_SIZE_LIMIT );
+        size_t inflatedLen = 0;
+        if( !InflateData( &*first, len, mInflateBuf, inflatedLen ) )
+            sLog.Error( "Network", "Failed to inflate packet of length %lu.", len );
         else
-        {
-            //DumpBuffer( packet, PACKET_INBOUND );
-            res = InflateUnmarshal( *packet );
-        }
+            res = Unmarshal( mInflateBuf.begin<uint8>(), mInflateBuf.begin<uint8>() + inflatedLen );
     }
+    else
+        res = Unmarshal( first, last );
 
-    SafeDelete( packet );
+    mInQueue.PopPacket();
     return res;
 }
 
-bool EVETCPConnection::ProcessReceivedData( char* errbuf )
+bool EVETCPConnection::ProcessReceivedData( const uint8* data, size_t len, char* errbuf )
 {
     if( errbuf )
         errbuf[0] = 0;
@@ -106,9 +131,7 @@ bool EVETCPConnection::ProcessReceivedData( char* errbuf )
         MutexLock lock( mMInQueue );
 
         // put bytes into packetizer
-        mInQueue.InputData( *mRecvBuf );
-        // process packetizer
-        mInQueue.Process();
+        mInQueue.InputData( data, len );
     }
 
     mTimeoutTimer.Start();
@@ -141,6 +164,7 @@ void EVETCPConnection::ClearBuffers()
         MutexLock lock( mMInQueue );
 
         mInQueue.ClearBuffers();
+        mInflateBuf.Resize<uint8>( 0 );
     }
 }
 
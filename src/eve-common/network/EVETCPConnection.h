@@ -44,6 +44,8 @@ public:
     static const uint32 TIMEOUT_MS;
     /// Hardcoded limit of packet size (NetClient.dll).
     static const uint32 PACKET_SIZE_LIMIT;
+    /// Default compression level of outgoing packets.
+    static const int DEFLATE_LEVEL;
 
     /**
      * @brief Creates empty EVE connection.
@@ -53,9 +55,26 @@ public:
     /**
      * @brief Queues given PyRep into send queue.
      *
-     * @param[in] rep PyRep to be queued.
+     * @param[in] rep     PyRep to be queued.
+     * @param[in] deflate Whether the packet may be deflated; pass false
+     *                    if its bulk is deflated already.
      */
-    void QueueRep( const PyRep* rep );
+    void QueueRep( const PyRep* rep, bool deflate = true );
+
+    /**
+     * @brief Sets compression level of outgoing packets.
+     *
+     * Outgoing traffic is mostly small and latency-sensitive
+     * (destiny updates, notifications), hence the fast default;
+     * bulky data which are sent repeatedly (cached objects) are
+     * deflated once at high level before they get here.
+     *
+     * Levels zlib doesn't know are rejected and DEFLATE_LEVEL
+     * is used instead.
+     *
+     * @param[in] level Compression level (Z_BEST_SPEED to Z_BEST_COMPRESSION).
+     */
+    void SetDeflateLevel( int level );
 
     /**
      * @brief Pops PyRep from receive queue.
@@ -88,17 +107,21 @@ protected:
     EVETCPConnection( Socket* sock, uint32 rIP, uint16 rPort );
 
     bool RecvData( char* errbuf = 0 );
-    bool ProcessReceivedData( char* errbuf = 0 );
+    bool ProcessReceivedData( const uint8* data, size_t len, char* errbuf = 0 );
 
     void ClearBuffers();
 
     /// Timer used to implement timeout.
     Timer mTimeoutTimer;
+    /// Compression level of outgoing packets.
+    int mDeflateLevel;
 
     /// Mutex to protect received data queue.
     Mutex mMInQueue;
     /// Received data queue.
     StreamPacketizer mInQueue;
+    /// Reusable buffer for inflated packets; protected by mMInQueue.
+    Buffer mInflateBuf;
 };
 
 #endif /* !__NETWORK__EVE_TCP_CONNECTION_H__INCL__ */
@@ -25,6 +25,7 @@
 
 #include "eve-common.h"
 
+#include "marshal/EVEUnmarshal.h"
 #include "python/PyPacket.h"
 #include "python/PyVisitor.h"
 #include "python/PyRep.h"
@@ -598,13 +599,15 @@ PyCallStream::PyCallStream()
 : remoteObject(0),
   method(""),
   arg_tuple(NULL),
-  arg_dict(NULL)
+  arg_dict(NULL),
+  call_stream(NULL)
 {
 }
 
 PyCallStream::~PyCallStream() {
     PySafeDecRef(arg_tuple);
     PySafeDecRef(arg_dict);
+    PySafeDecRef(call_stream);
 }
 
 PyCallStream *PyCallStream::Clone() const {
@@ -612,12 +615,15 @@ PyCallStream *PyCallStream::Clone() const {
     res->remoteObject = remoteObject;
     res->remoteObjectStr = remoteObjectStr;
     res->method = method;
-    res->arg_tuple = new PyTuple( *arg_tuple );
+    if(arg_tuple != NULL)
+        res->arg_tuple = new PyTuple( *arg_tuple );
     if(arg_dict == NULL) {
         res->arg_dict = NULL;
     } else {
         res->arg_dict = new PyDict( *arg_dict );
     }
+    if(call_stream != NULL)
+        res->call_stream = new PySubStream( *call_stream );
     return res;
 }
 
@@ -629,6 +635,10 @@ void PyCallStream::Dump(LogType type, PyVisitor& dumper)
     } else
         _log(type, "  Remote Object: %d", remoteObject);
     _log(type, "  Method: %s", method.c_str());
+    if(!DecodeArgs()) {
+        _log(type, "  Arguments: undecodable");
+        return;
+    }
     _log(type, "  Arguments:");
     arg_tuple->visit( dumper );
     if(arg_dict == NULL) {
@@ -645,8 +655,10 @@ bool PyCallStream::Decode(const std::string &type, PyTuple *&in_payload) {
 
     PySafeDecRef(arg_tuple);
     PySafeDecRef(arg_dict);
+    PySafeDecRef(call_stream);
     arg_tuple = NULL;
     arg_dict = NULL;
+    call_stream = NULL;
 
     if(type != "macho.CallReq") {
         codelog(NET__PACKET_ERROR, "failed: packet payload has unknown string type '%s'", type.c_str());
@@ -679,25 +691,63 @@ bool PyCallStream::Decode(const std::string &type, PyTuple *&in_payload) {
         PyDecRef(payload);
         return false;
     }
-    PySubStream *ss = (PySubStream *) payload2->items[1];
+    call_stream = (PySubStream *) payload2->items[1];
+    PyIncRef(call_stream);
+    PyDecRef(payload);
+
+    //the arguments are left marshaled unless the header can't be read directly
+    if(_DecodeHeader())
+        return true;
+
+    return DecodeArgs();
+}
+
+bool PyCallStream::_DecodeHeader() {
+    if(call_stream->data() == NULL)
+        return false;
+
+    UnmarshalStream v;
+    if(!v.BeginStream(call_stream->data()->content()))
+        return false;
+
+    uint32 count;
+    if(!v.PullTupleHeader(count) || count != 4)
+        return false;
+
+    int32 object;
+    if(v.PullInt(object)) {
+        remoteObject = object;
+        remoteObjectStr = "";
+    } else if(v.PullString(remoteObjectStr)) {
+        remoteObject = 0;
+    } else
+        return false;
+
+    return v.PullString(method);
+}
+
+bool PyCallStream::DecodeArgs() {
+    if(arg_tuple != NULL)
+        return true;
+    if(call_stream == NULL)
+        return false;
+
+    PySubStream *ss = call_stream;
 
     ss->DecodeData();
     if(ss->decoded() == NULL) {
         codelog(NET__PACKET_ERROR, "Unable to decode call stream");
-        PyDecRef(payload);
         return false;
     }
 
     if(!ss->decoded()->IsTuple()) {
         codelog(NET__PACKET_ERROR, "packet body does not contain a tuple");
-        PyDecRef(payload);
         return false;
     }
 
     PyTuple *maint = (PyTuple *) ss->decoded();
     if(maint->items.size() != 4) {
         codelog(NET__PACKET_ERROR, "packet body has %lu elements, expected %d", maint->items.size(), 4);
-        PyDecRef(payload);
         return false;
     }
 
@@ -713,8 +763,7 @@ bool PyCallStream::Decode(const std::string &type, PyTuple *&in_payload) {
     } else {
         codelog(NET__PACKET_ERROR, "tuple[0] has invalid type %s", maint->items[0]->TypeString());
         codelog(NET__PACKET_ERROR, " in:");
-        payload->Dump(NET__PACKET_ERROR, "    ");
-        PyDecRef(payload);
+        maint->Dump(NET__PACKET_ERROR, "    ");
         return false;
     }
 
@@ -726,8 +775,7 @@ bool PyCallStream::Decode(const std::string &type, PyTuple *&in_payload) {
         codelog(NET__PACKET_ERROR, "tuple[1] has non-string type");
         maint->items[1]->Dump(NET__PACKET_ERROR, " --> ");
         codelog(NET__PACKET_ERROR, " in:");
-        payload->Dump(NET__PACKET_ERROR, "    ");
-        PyDecRef(payload);
+        maint->Dump(NET__PACKET_ERROR, "    ");
         return false;
     }
 
@@ -736,33 +784,46 @@ bool PyCallStream::Decode(const std::string &type, PyTuple *&in_payload) {
         codelog(NET__PACKET_ERROR, "argument list has non-tuple type");
         maint->items[2]->Dump(NET__PACKET_ERROR, " --> ");
         codelog(NET__PACKET_ERROR, "in:");
-        payload->Dump(NET__PACKET_ERROR, "    ");
-        PyDecRef(payload);
+        maint->Dump(NET__PACKET_ERROR, "    ");
         return false;
     }
-    arg_tuple = (PyTuple *) maint->items[2];
-    maint->items[2] = NULL; //we keep this one
 
     //options dict
     if(maint->items[3]->IsNone()) {
         arg_dict = NULL;
     } else if(maint->items[3]->IsDict()) {
         arg_dict = (PyDict *) maint->items[3];
-        maint->items[3] = NULL; //we keep this too.
+        PyIncRef(arg_dict);  //shared with the decoded substream
     } else {
         codelog(NET__PACKET_ERROR, "tuple[3] has non-dict type");
         maint->items[3]->Dump(NET__PACKET_ERROR, " --> ");
         codelog(NET__PACKET_ERROR, "in:");
-        payload->Dump(NET__PACKET_ERROR, "    ");
-        PyDecRef(payload);
+        maint->Dump(NET__PACKET_ERROR, "    ");
         return false;
     }
 
-    PyDecRef(payload);
+    arg_tuple = (PyTuple *) maint->items[2];
+    PyIncRef(arg_tuple);  //shared with the decoded substream
+
     return true;
 }
 
 PyTuple *PyCallStream::Encode() {
+    //arguments which were never decoded are passed on as received
+    if(arg_tuple == NULL && call_stream != NULL) {
+        PyIncRef(call_stream);
+
+        PyTuple *it2 = new PyTuple(2);
+        it2->items[0] = new PyInt(remoteObject==0?1:0);
+        it2->items[1] = call_stream;
+
+        PyTuple *it1 = new PyTuple(2);
+        it1->items[0] = it2;
+        it1->items[1] = new PyNone();
+
+        return(it1);
+    }
+
     PyTuple *res_tuple = new PyTuple(4);
 
     //remoteObject
@@ -965,15 +1026,7 @@ PyTuple *EVENotificationStream::Encode() {
     t3->items[0] = new PyInt(0);
     t3->items[1] = t4;
 
-    PyTuple *t2 = new PyTuple(2);
-    t2->items[0] = new PyInt(0);
-    t2->items[1] = new PySubStream(t3);
-
-    PyTuple *t1 = new PyTuple(2);
-    t1->items[0] = t2;
-    t1->items[1] = new PyNone();
-
-    return(t1);
+    return(Encode(new PySubStream(t3)));
 /*
     //remoteObject
     if(remoteObject == 0)
@@ -1002,3 +1055,16 @@ PyTuple *EVENotificationStream::Encode() {
     return(arg_tuple);
     */
 }
+
+PyTuple *EVENotificationStream::Encode(PySubStream *stream) {
+
+    PyTuple *t2 = new PyTuple(2);
+    t2->items[0] = new PyInt(0);
+    t2->items[1] = stream;
+
+    PyTuple *t1 = new PyTuple(2);
+    t1->items[0] = t2;
+    t1->items[1] = new PyNone();
+
+    return(t1);
+}
@@ -26,12 +26,9 @@
 #ifndef EVE_PY_PACKET_H
 #define EVE_PY_PACKET_H
 
+#include "marshal/EVEMarshal.h"
 #include "network/packet_types.h"
-
-class PyRep;
-class PyTuple;
-class PyDict;
-class PyVisitor;
+#include "python/PyRep.h"
 
 class PyAddress {
 public:
@@ -133,6 +130,17 @@ public:
 
     void Dump(LogType type, PyVisitor& dumper);
     bool Decode(const std::string &type, PyTuple *&payload); //consumes substream
+    /**
+     * @brief Decodes arguments of the call.
+     *
+     * Decode() reads only the remote object and method straight
+     * from the call substream; the arguments stay marshaled until
+     * they are decoded, either by this or by the packet's DecodeFrom().
+     *
+     * @retval true  arg_tuple and arg_dict are set.
+     * @retval false Call substream is malformed.
+     */
+    bool DecodeArgs();
     PyTuple *Encode();
     PyCallStream *Clone() const;
 
@@ -140,8 +148,12 @@ public:
     std::string remoteObjectStr;
 
     std::string method;
-    PyTuple *arg_tuple;
+    PyTuple *arg_tuple;  //NULL until DecodeArgs()
     PyDict  *arg_dict;   //named parameters
+    PySubStream *call_stream;   //the call as received, NULL if built locally
+
+protected:
+    bool _DecodeHeader();
 };
 
 class EVENotificationStream {
@@ -154,6 +166,25 @@ public:
     PyTuple *Encode();
     EVENotificationStream *Clone() const;
 
+    /**
+     * @brief Marshals notification arguments straight into a substream.
+     *
+     * The substream holds the same bytes Encode() produces around
+     * the arguments, without building and cloning their tree.
+     *
+     * @param[in] args Arguments; must have EncodeTo (encode="direct").
+     *
+     * @return The substream; NULL if encoding failed.
+     */
+    template<typename T>
+    static PySubStream *EncodeArgs(const T &args);
+    /**
+     * @brief Encodes notification around substream made by EncodeArgs().
+     *
+     * @param[in] stream The substream; consumed.
+     */
+    static PyTuple *Encode(PySubStream *stream);
+
     std::string notifyType; //not encoded by Encode() since it is in the address part, mainly here for convenience.
 
     uint32 remoteObject;        //seen 1, hack: 0 means it was a string
@@ -162,5 +193,26 @@ public:
     PyTuple *args;
 };
 
+template<typename T>
+PySubStream *EVENotificationStream::EncodeArgs(const T &args) {
+    Buffer *data = new Buffer;
+
+    // ( 0, ( 1, args ) ), see Encode()
+    MarshalStream v;
+    v.BeginStream(*data);
+    v.SaveTupleHeader(2);
+    v.SaveInt(0);
+    v.SaveTupleHeader(2);
+    v.SaveInt(1);
+    const bool res = args.EncodeTo(v);
+    v.EndStream();
+
+    if(!res) {
+        SafeDelete(data);
+        return NULL;
+    }
+
+    return new PySubStream(new PyBuffer(&data));
+}
 
 #endif
@@ -393,20 +393,23 @@ int32 PyString::hash() const
     if( mHashCache != -1 )
         return mHashCache;
 
-    register int len;
-    register unsigned char *p;
+    mHashCache = Hash( mValue.c_str(), mValue.length() );
+    return mHashCache;
+}
+
+int32 PyString::Hash( const char* str, size_t len )
+{
+    register const unsigned char *p;
     register int32 x;
 
-    len = mValue.length();
-    p = (unsigned char *) mValue.c_str();
+    p = (const unsigned char *) str;
     x = *p << 7;
-    while (--len >= 0)
+    for( size_t i = 0; i < len; ++i )
         x = (1000003*x) ^ *p++;
-    x ^= mValue.length();
+    x ^= len;
     if (x == -1)
         x = -2;
 
-    mHashCache = x;
     return x;
 }
 
@@ -439,21 +442,9 @@ int32 PyWString::hash() const
     if( mHashCache != -1 )
         return mHashCache;
 
-    register int len;
-    register unsigned char *p;
-    register int32 x;
-
-    len = mValue.length();
-    p = (unsigned char *) mValue.c_str();
-    x = *p << 7;
-    while (--len >= 0)
-        x = (1000003*x) ^ *p++;
-    x ^= mValue.length();
-    if (x == -1)
-        x = -2;
-
-    mHashCache = x;
-    return x;
+    // same as PyString so that equal strings of either type match as keys
+    mHashCache = PyString::Hash( mValue.c_str(), mValue.length() );
+    return mHashCache;
 }
 
 /************************************************************************/
@@ -619,8 +610,149 @@ PyList& PyList::operator=( const PyList& oth )
 /************************************************************************/
 /* PyRep Dict Class                                                     */
 /************************************************************************/
-PyDict::PyDict() : PyRep( PyRep::PyTypeDict ), items() {}
-PyDict::PyDict( const PyDict& oth ) : PyRep( PyRep::PyTypeDict ), items()
+/**
+ * @brief Compares two dictionary keys.
+ *
+ * Numbers compare by value and strings by content, regardless
+ * of their exact type; tuples compare element by element.
+ * Anything else is equal only to itself.
+ */
+static bool PyKeyEquals( const PyRep* a, const PyRep* b )
+{
+    if( a == b )
+        return true;
+    if( NULL == a || NULL == b )
+        return false;
+
+    switch( a->GetType() )
+    {
+        case PyRep::PyTypeInt:
+            if( b->IsInt() )
+                return a->AsInt()->value() == b->AsInt()->value();
+            if( b->IsLong() )
+                return a->AsInt()->value() == b->AsLong()->value();
+            return false;
+
+        case PyRep::PyTypeLong:
+            if( b->IsLong() )
+                return a->AsLong()->value() == b->AsLong()->value();
+            if( b->IsInt() )
+                return a->AsLong()->value() == b->AsInt()->value();
+            return false;
+
+        case PyRep::PyTypeFloat:
+            return b->IsFloat() && a->AsFloat()->value() == b->AsFloat()->value();
+
+        case PyRep::PyTypeBool:
+            return b->IsBool() && a->AsBool()->value() == b->AsBool()->value();
+
+        case PyRep::PyTypeNone:
+            return b->IsNone();
+
+        case PyRep::PyTypeString:
+            if( b->IsString() )
+                return a->AsString()->content() == b->AsString()->content();
+            if( b->IsWString() )
+                return a->AsString()->content() == b->AsWString()->content();
+            return false;
+
+        case PyRep::PyTypeWString:
+            if( b->IsWString() )
+                return a->AsWString()->content() == b->AsWString()->content();
+            if( b->IsString() )
+                return a->AsWString()->content() == b->AsString()->content();
+            return false;
+
+        case PyRep::PyTypeBuffer:
+        {
+            if( !b->IsBuffer() )
+                return false;
+
+            const Buffer& ba = a->AsBuffer()->content();
+            const Buffer& bb = b->AsBuffer()->content();
+            return ba.size() == bb.size()
+                   && ( 0 == ba.size() || 0 == memcmp( &ba[ 0 ], &bb[ 0 ], ba.size() ) );
+        }
+
+        case PyRep::PyTypeTuple:
+        {
+            if( !b->IsTuple() )
+                return false;
+
+            const PyTuple* ta = a->AsTuple();
+            const PyTuple* tb = b->AsTuple();
+            if( ta->size() != tb->size() )
+                return false;
+
+            for( size_t i = 0; i < ta->size(); ++i )
+            {
+                if( !PyKeyEquals( ta->GetItem( i ), tb->GetItem( i ) ) )
+                    return false;
+            }
+
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/// Matches a key object.
+struct PyKeyMatch
+{
+    PyKeyMatch( const PyRep* key ) : mKey( key ) {}
+    bool operator()( const PyRep* key ) const { return PyKeyEquals( mKey, key ); }
+
+    const PyRep* const mKey;
+};
+
+/// Matches a string key without creating a PyString for it.
+struct PyStringKeyMatch
+{
+    PyStringKeyMatch( const char* key, size_t len ) : mKey( key ), mLen( len ) {}
+    bool operator()( const PyRep* key ) const
+    {
+        if( key->IsString() )
+            return key->AsString()->content().compare( 0, std::string::npos, mKey, mLen ) == 0;
+        if( key->IsWString() )
+            return key->AsWString()->content().compare( 0, std::string::npos, mKey, mLen ) == 0;
+        return false;
+    }
+
+    const char* const mKey;
+    const size_t mLen;
+};
+
+template<typename Match>
+int32 PyDict::_Find( int32 hash, const Match& match ) const
+{
+    if( mIndex.empty() )
+    {
+        // small dictionary, scan the entries
+        for( size_t i = 0; i < items.size(); ++i )
+        {
+            if( items[ i ].hash == hash && match( items[ i ].first ) )
+                return (int32)i;
+        }
+
+        return -1;
+    }
+
+    const size_t mask = mIndex.size() - 1;
+    for( size_t slot = (uint32)hash & mask;; slot = ( slot + 1 ) & mask )
+    {
+        const int32 i = mIndex[ slot ];
+        if( i < 0 )
+            return -1;
+
+        if( items[ i ].hash == hash && match( items[ i ].first ) )
+            return i;
+    }
+}
+
+PyDict::PyDict() : PyRep( PyRep::PyTypeDict ), items(), mIndex() {}
+PyDict::PyDict( const PyDict& oth ) : PyRep( PyRep::PyTypeDict ), items(), mIndex()
 {
     // Use assigment operator
     *this = oth;
@@ -653,6 +785,7 @@ void PyDict::clear()
     }
 
     items.clear();
+    mIndex.clear();
 }
 
 PyRep* PyDict::GetItem( PyRep* key ) const
@@ -660,11 +793,11 @@ PyRep* PyDict::GetItem( PyRep* key ) const
     /* make sure we have valid arguments */
     assert( key );
 
-    const_iterator res = items.find( key );
-    if( res == items.end() )
+    const int32 res = _Find( key->hash(), PyKeyMatch( key ) );
+    if( res < 0 )
         return NULL;
 
-    return res->second;
+    return items[ res ].second;
 }
 
 PyRep* PyDict::GetItemString( const char* key ) const
@@ -672,11 +805,14 @@ PyRep* PyDict::GetItemString( const char* key ) const
     /* make sure we have valid arguments */
     assert( key );
 
-    PyString* str = new PyString( key );
-    PyRep* res = GetItem( str );
-    PyDecRef( str );
+    /* hash the raw string, as PyString would */
+    const size_t len = strlen( key );
 
-    return res;
+    const int32 res = _Find( PyString::Hash( key, len ), PyStringKeyMatch( key, len ) );
+    if( res < 0 )
+        return NULL;
+
+    return items[ res ].second;
 }
 
 void PyDict::SetItem( PyRep* key, PyRep* value )
@@ -694,20 +830,22 @@ void PyDict::SetItem( PyRep* key, PyRep* value )
     PyIncRef( value );
 
     /* check if we need to replace a dictionary entry */
-    iterator itr = items.find( key );
-    if( itr == items.end() )
+    const int32 hash = key->hash();
+    const int32 res = _Find( hash, PyKeyMatch( key ) );
+    if( res < 0 )
     {
         // Keep both key & value
-        items.insert( std::make_pair( key, value ) );
+        items.push_back( Entry( key, value, hash ) );
+        _IndexLast();
     }
     else
     {
-        // We don't need it anymore, we're using itr->first.
+        // We don't need it anymore, we're using the stored key.
         PyDecRef( key );
 
-        // Replace itr->second with value.
-        PySafeDecRef( itr->second );
-        itr->second = value;
+        // Replace the stored value with value.
+        PySafeDecRef( items[ res ].second );
+        items[ res ].second = value;
     }
 }
 
@@ -726,6 +864,7 @@ void PyDict::SetItem( const char* key, PyRep* value )
 PyDict& PyDict::operator=( const PyDict& oth )
 {
     clear();
+    items.reserve( oth.size() );
 
     const_iterator cur, end;
     cur = oth.begin();
@@ -741,6 +880,45 @@ PyDict& PyDict::operator=( const PyDict& oth )
     return *this;
 }
 
+void PyDict::_IndexLast()
+{
+    if( items.size() <= SMALL_SIZE )
+        return;
+
+    // keep the index at most 2/3 full
+    if( 3 * items.size() > 2 * mIndex.size() )
+    {
+        size_t slotCount = 4 * SMALL_SIZE;
+        while( 3 * items.size() > 2 * slotCount )
+            slotCount <<= 1;
+
+        _BuildIndex( slotCount );
+        return;
+    }
+
+    const size_t mask = mIndex.size() - 1;
+    size_t slot = (uint32)items.back().hash & mask;
+    while( 0 <= mIndex[ slot ] )
+        slot = ( slot + 1 ) & mask;
+
+    mIndex[ slot ] = (int32)( items.size() - 1 );
+}
+
+void PyDict::_BuildIndex( size_t slotCount )
+{
+    mIndex.assign( slotCount, -1 );
+
+    const size_t mask = slotCount - 1;
+    for( size_t i = 0; i < items.size(); ++i )
+    {
+        size_t slot = (uint32)items[ i ].hash & mask;
+        while( 0 <= mIndex[ slot ] )
+            slot = ( slot + 1 ) & mask;
+
+        mIndex[ slot ] = (int32)i;
+    }
+}
+
 /************************************************************************/
 /* PyRep Object Class                                                   */
 /************************************************************************/
@@ -416,6 +416,16 @@ public:
 
     int32 hash() const;
 
+    /**
+     * @brief Hashes a string the same way hash() does.
+     *
+     * @param[in] str The string.
+     * @param[in] len Length of the string.
+     *
+     * @return The hash.
+     */
+    static int32 Hash( const char* str, size_t len );
+
 protected:
     const std::string mValue;
     mutable int32 mHashCache;
@@ -652,38 +662,28 @@ protected:
  */
 class PyDict : public PyRep
 {
-protected:
-    // hash function
-    class _hash : public std::unary_function<PyRep*, size_t>
-    {
-    public:
-        size_t operator()( const PyRep* _Keyval ) const
-        {
-            assert( _Keyval );
-
-            return (size_t)_Keyval->hash();
-        }
-    };
-
-    // comparison function
-    class _comp : public std::binary_function<PyRep*, PyRep*, bool>
+public:
+    /**
+     * @brief A dictionary entry.
+     *
+     * Laid out like std::pair so that iterators are used the same
+     * way as map iterators. Keys must not be modified through them.
+     */
+    struct Entry
     {
-    public:
-        bool operator()( const PyRep* _Arg1, const PyRep* _Arg2 ) const
-        {
-            assert( _Arg1 );
-            assert( _Arg2 );
-
-            // Suffers from hash collision but whatever ... still
-            // better than raw pointer comparison
-            return ( _Arg1->hash() == _Arg2->hash() );
-        }
+        Entry( PyRep* key, PyRep* value, int32 keyHash ) : first( key ), second( value ), hash( keyHash ) {}
+
+        /// The key.
+        PyRep* first;
+        /// The value.
+        PyRep* second;
+        /// Cached hash of the key.
+        int32 hash;
     };
 
-public:
-    typedef std::tr1::unordered_map<PyRep*, PyRep*, _hash, _comp>   storage_type;
-    typedef storage_type::iterator                                  iterator;
-    typedef storage_type::const_iterator                            const_iterator;
+    typedef std::vector<Entry>              storage_type;
+    typedef storage_type::iterator          iterator;
+    typedef storage_type::const_iterator    const_iterator;
 
     PyDict();
     PyDict( const PyDict& oth );
@@ -749,10 +749,39 @@ public:
      */
     PyDict& operator=( const PyDict& oth );
 
-    storage_type items;
-
 protected:
     virtual ~PyDict();
+
+    /// Dictionaries up to this size are searched linearly, without an index.
+    static const size_t SMALL_SIZE = 8;
+
+    /**
+     * @brief Looks up an entry.
+     *
+     * @param[in] hash  Hash of the key.
+     * @param[in] match Predicate telling if a key is the one looked up.
+     *
+     * @return Position of the entry in items; -1 if not found.
+     */
+    template<typename Match>
+    int32 _Find( int32 hash, const Match& match ) const;
+    /**
+     * @brief Adds the last entry of items to the index.
+     *
+     * Builds or grows the index when needed.
+     */
+    void _IndexLast();
+    /**
+     * @brief Rebuilds the index from scratch.
+     *
+     * @param[in] slotCount Number of slots; a power of two.
+     */
+    void _BuildIndex( size_t slotCount );
+
+    /// The entries, in insertion order.
+    storage_type items;
+    /// Open-addressing table of positions in items (-1 if free); empty for small dictionaries.
+    std::vector<int32> mIndex;
 };
 
 /**
@@ -145,6 +145,18 @@ typedef int SOCKET;
 #   endif /* !SO_NOSIGPIPE */
 #endif /* !MSG_NOSIGNAL */
 
+/*************************************************************************/
+/* Keywords                                                              */
+/*************************************************************************/
+/*
+ * THREAD_LOCAL: storage class of thread-local variables.
+ */
+#if defined( HAVE___THREAD )
+#   define THREAD_LOCAL __thread
+#elif defined( HAVE___DECLSPEC_THREAD )
+#   define THREAD_LOCAL __declspec( thread )
+#endif /* HAVE___DECLSPEC_THREAD */
+
 /*************************************************************************/
 /* cfloat, cmath                                                         */
 /*************************************************************************/
@@ -133,6 +133,7 @@
 #   include <execinfo.h>
 #   include <pthread.h>
 #   include <unistd.h>
+#   include <sys/mman.h>
 #endif /* !HAVE_WINDOWS_H */
 
 #ifdef HAVE_WINSOCK2_H
@@ -0,0 +1,858 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-core.h"
+
+#include "log/AsyncLog.h"
+#include "log/LogNew.h"
+#include "threading/Atomic.h"
+
+/*************************************************************************/
+/* Format string handling                                                */
+/*************************************************************************/
+/// Type of argument consumed by a conversion.
+enum ArgType
+{
+    ARG_NONE,     ///< No argument ("%%").
+    ARG_INT,      ///< int, or anything promoted to it.
+    ARG_LONG,     ///< long.
+    ARG_LLONG,    ///< long long.
+    ARG_SIZE,     ///< size_t.
+    ARG_INTMAX,   ///< intmax_t.
+    ARG_PTRDIFF,  ///< ptrdiff_t.
+    ARG_DOUBLE,   ///< double, or float promoted to it.
+    ARG_LDOUBLE,  ///< long double.
+    ARG_POINTER,  ///< void*.
+    ARG_STRING,   ///< const char*.
+    ARG_INVALID   ///< Conversion which cannot be deferred.
+};
+
+/// A single conversion specification.
+struct FormatSpec
+{
+    /// The specification, starting at '%'.
+    const char* begin;
+    /// End of the specification.
+    const char* end;
+    /// Whether the width is passed as an argument.
+    bool starWidth;
+    /// Whether the precision is passed as an argument.
+    bool starPrecision;
+    /// Precision given in the specification; -1 if none.
+    int precision;
+    /// Type of the argument.
+    ArgType type;
+};
+
+/// Maximal length of a single conversion specification.
+static const size_t SPEC_SIZE = 32;
+/// Length of a captured NULL string.
+static const uint32 NULL_STRING = 0xFFFFFFFF;
+
+/**
+ * @brief Parses a conversion specification.
+ *
+ * @param[in]  p    The specification, starting at '%'.
+ * @param[out] spec The parsed specification.
+ *
+ * @return Pointer past the specification.
+ */
+static const char* ParseSpec( const char* p, FormatSpec& spec )
+{
+    enum { LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_LD, LEN_J, LEN_Z, LEN_T } length = LEN_NONE;
+
+    spec.begin = p++;
+    spec.starWidth = false;
+    spec.starPrecision = false;
+    spec.precision = -1;
+    spec.type = ARG_INVALID;
+
+    // flags
+    while( '\0' != *p && NULL != strchr( "-+ #0'", *p ) )
+        ++p;
+
+    // width
+    if( '*' == *p )
+    {
+        spec.starWidth = true;
+        ++p;
+    }
+    else
+    {
+        while( '0' <= *p && *p <= '9' )
+            ++p;
+    }
+
+    // precision
+    if( '.' == *p )
+    {
+        ++p;
+        if( '*' == *p )
+        {
+            spec.starPrecision = true;
+            ++p;
+        }
+        else
+        {
+            spec.precision = 0;
+            while( '0' <= *p && *p <= '9' )
+                spec.precision = 10 * spec.precision + ( *p++ - '0' );
+        }
+    }
+
+    // length modifier
+    switch( *p )
+    {
+        case 'h':
+            if( 'h' == *++p )
+            {
+                ++p;
+                length = LEN_HH;
+            }
+            else
+                length = LEN_H;
+            break;
+        case 'l':
+            if( 'l' == *++p )
+            {
+                ++p;
+                length = LEN_LL;
+            }
+            else
+                length = LEN_L;
+            break;
+        case 'q': ++p; length = LEN_LL; break;
+        case 'L': ++p; length = LEN_LD; break;
+        case 'j': ++p; length = LEN_J;  break;
+        case 'z': ++p; length = LEN_Z;  break;
+        case 't': ++p; length = LEN_T;  break;
+        case 'I':
+            // MSVC-specific sizes
+            if( '6' == p[1] && '4' == p[2] )
+            {
+                p += 3;
+                length = LEN_LL;
+            }
+            else if( '3' == p[1] && '2' == p[2] )
+                p += 3;
+            else
+            {
+                ++p;
+                length = LEN_Z;
+            }
+            break;
+    }
+
+    // conversion
+    switch( *p )
+    {
+        case '\0':
+            spec.end = p;
+            return p;
+
+        case '%':
+            spec.type = ARG_NONE;
+            break;
+
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+            switch( length )
+            {
+                case LEN_NONE:
+                case LEN_HH:
+                case LEN_H:  spec.type = ARG_INT;     break;
+                case LEN_L:  spec.type = ARG_LONG;    break;
+                case LEN_LL: spec.type = ARG_LLONG;   break;
+                case LEN_J:  spec.type = ARG_INTMAX;  break;
+                case LEN_Z:  spec.type = ARG_SIZE;    break;
+                case LEN_T:  spec.type = ARG_PTRDIFF; break;
+                case LEN_LD: break;
+            }
+            // wint_t
+            if( 'c' == *p && ARG_INT != spec.type )
+                spec.type = ARG_INVALID;
+            break;
+
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if( LEN_NONE == length || LEN_L == length )
+                spec.type = ARG_DOUBLE;
+            else if( LEN_LD == length )
+                spec.type = ARG_LDOUBLE;
+            break;
+
+        case 's':
+            // wide strings are not supported
+            if( LEN_NONE == length )
+                spec.type = ARG_STRING;
+            break;
+
+        case 'p':
+            spec.type = ARG_POINTER;
+            break;
+
+        // %n and %m depend on the calling context.
+    }
+
+    spec.end = ++p;
+    return p;
+}
+
+/**
+ * @brief Appends a captured argument.
+ *
+ * @retval true  The argument has been appended.
+ * @retval false Out of space.
+ */
+template< typename T >
+static bool PutArg( uint8* buf, size_t size, size_t& len, const T& value )
+{
+    if( size - len < sizeof( T ) )
+        return false;
+
+    memcpy( &buf[ len ], &value, sizeof( T ) );
+    len += sizeof( T );
+    return true;
+}
+
+/**
+ * @brief Reads a captured argument.
+ *
+ * @return The argument; zero if the arguments are exhausted.
+ */
+template< typename T >
+static T GetArg( const uint8* args, size_t len, size_t& pos )
+{
+    T value = T();
+    if( len - pos >= sizeof( T ) )
+    {
+        memcpy( &value, &args[ pos ], sizeof( T ) );
+        pos += sizeof( T );
+    }
+
+    return value;
+}
+
+/**
+ * @brief Formats a single argument.
+ *
+ * @return The value returned by snprintf.
+ */
+template< typename T >
+static int FormatArg( char* out, size_t size, const char* spec, const int* stars, size_t starCount, T value )
+{
+    switch( starCount )
+    {
+        case 0:  return snprintf( out, size, spec, value );
+        case 1:  return snprintf( out, size, spec, stars[0], value );
+        default: return snprintf( out, size, spec, stars[0], stars[1], value );
+    }
+}
+
+/*************************************************************************/
+/* AsyncLog::Ring                                                        */
+/*************************************************************************/
+/// Kinds of records stored in rings.
+enum RecordKind
+{
+    RECORD_PADDING, ///< Unused space up to the end of ring.
+    RECORD_LOGSYS,  ///< A logsys message.
+    RECORD_NEWLOG   ///< A NewLog message.
+};
+
+/// Record flag: the format string is an already formatted message.
+static const uint8 RECORD_FORMATTED = 0x01;
+
+/**
+ * @brief Header of a record stored in a ring.
+ *
+ * Followed by the source, the format string (both
+ * NUL-terminated) and the captured arguments. A padding
+ * record consists of @a size and @a kind only.
+ */
+struct RecordHeader
+{
+    /// Total size of the record, a multiple of 8.
+    uint32 size;
+    /// Kind of the record (RecordKind).
+    uint8 kind;
+    /// RECORD_FORMATTED if set.
+    uint8 flags;
+    /// Length of the source, including the terminator; 0 if none.
+    uint16 sourceLen;
+    /// Log type or color.
+    uint32 type;
+    /// Indentation or prefix.
+    uint32 arg;
+    /// Length of the format string, including the terminator.
+    uint32 fmtLen;
+    /// Length of the captured arguments.
+    uint32 argsLen;
+    /// Time of the log call.
+    int64 time;
+};
+
+/**
+ * @brief Single-producer/single-consumer ring of log records.
+ *
+ * The owning thread advances mHead, the writer advances mTail;
+ * both only ever grow and wrap around naturally.
+ */
+class AsyncLog::Ring
+{
+public:
+    /// Ownership state of the ring.
+    enum State
+    {
+        STATE_FREE,    ///< Not used by any thread.
+        STATE_OWNED,   ///< Used by a thread.
+        STATE_ORPHANED ///< The thread exited; free once drained.
+    };
+
+    Ring()
+    : mHead( 0 ),
+      mTail( 0 ),
+      mDropped( 0 ),
+      mReported( 0 ),
+      mState( STATE_FREE )
+    {
+    }
+
+    /// Write position; owned by the producer.
+    volatile uint32 mHead;
+    /// Read position; owned by the writer.
+    volatile uint32 mTail;
+    /// Number of dropped records; owned by the producer.
+    volatile uint32 mDropped;
+    /// Number of dropped records reported so far; owned by the writer.
+    uint32 mReported;
+    /// Ownership state (State).
+    volatile uint32 mState;
+
+    /// The records.
+    uint8 mData[ RING_SIZE ];
+};
+
+/*************************************************************************/
+/* AsyncLog                                                              */
+/*************************************************************************/
+#ifdef THREAD_LOCAL
+/// Ring of the current thread.
+static THREAD_LOCAL void* sThreadRing = NULL;
+/// Whether the current thread is the writer.
+static THREAD_LOCAL bool sWriterThread = false;
+#endif /* THREAD_LOCAL */
+
+AsyncLog::AsyncLog()
+: mRunning( 0 ),
+  mDropped( 0 )
+#ifndef HAVE_WINDOWS_H
+  ,mRingKeyCreated( false )
+#endif /* !HAVE_WINDOWS_H */
+{
+    for( size_t i = 0; i < RING_COUNT; ++i )
+        mRings[ i ] = NULL;
+}
+
+AsyncLog::~AsyncLog()
+{
+    Stop();
+
+#ifndef HAVE_WINDOWS_H
+    if( mRingKeyCreated )
+        pthread_key_delete( mRingKey );
+#endif /* !HAVE_WINDOWS_H */
+
+    for( size_t i = 0; i < RING_COUNT; ++i )
+        SafeDelete( mRings[ i ] );
+}
+
+bool AsyncLog::Start()
+{
+    if( IsRunning() )
+        return true;
+
+#ifndef THREAD_LOCAL
+    sLog.Warning( "AsyncLog", "Thread-local storage is not supported, logging synchronously." );
+    return false;
+#else /* THREAD_LOCAL */
+    for( size_t i = 0; i < RING_COUNT; ++i )
+    {
+        if( NULL == mRings[ i ] )
+            mRings[ i ] = new Ring;
+    }
+
+#   ifndef HAVE_WINDOWS_H
+    if( !mRingKeyCreated )
+    {
+        if( 0 != pthread_key_create( &mRingKey, ReleaseThreadRing ) )
+        {
+            sLog.Error( "AsyncLog", "Failed to create thread key, logging synchronously." );
+            return false;
+        }
+
+        mRingKeyCreated = true;
+    }
+#   endif /* !HAVE_WINDOWS_H */
+
+    AtomicStore( mRunning, 1 );
+
+#   ifdef HAVE_WINDOWS_H
+    mThread = CreateThread( NULL, 0, RunThread, this, 0, NULL );
+    if( NULL == mThread )
+#   else /* !HAVE_WINDOWS_H */
+    if( 0 != pthread_create( &mThread, NULL, RunThread, this ) )
+#   endif /* !HAVE_WINDOWS_H */
+    {
+        AtomicStore( mRunning, 0 );
+
+        sLog.Error( "AsyncLog", "Failed to start writer thread, logging synchronously." );
+        return false;
+    }
+
+    return true;
+#endif /* THREAD_LOCAL */
+}
+
+void AsyncLog::Stop()
+{
+    if( !IsRunning() )
+        return;
+
+    AtomicStore( mRunning, 0 );
+
+#ifdef HAVE_WINDOWS_H
+    WaitForSingleObject( mThread, INFINITE );
+    CloseHandle( mThread );
+#else /* !HAVE_WINDOWS_H */
+    pthread_join( mThread, NULL );
+#endif /* !HAVE_WINDOWS_H */
+}
+
+bool AsyncLog::PushLogsys( LogType type, uint32 iden, const char* fmt, va_list ap )
+{
+    return Push( RECORD_LOGSYS, type, iden, NULL, fmt, ap );
+}
+
+bool AsyncLog::PushNewLog( uint8 color, char pfx, const char* source, const char* fmt, va_list ap )
+{
+    return Push( RECORD_NEWLOG, color, static_cast< uint8 >( pfx ), source, fmt, ap );
+}
+
+bool AsyncLog::CaptureArgs( const char* fmt, va_list ap, uint8* buf, size_t size, size_t& len )
+{
+    len = 0;
+
+    FormatSpec spec;
+    for( const char* p = strchr( fmt, '%' ); NULL != p; p = strchr( p, '%' ) )
+    {
+        p = ParseSpec( p, spec );
+        if( ARG_INVALID == spec.type
+            || SPEC_SIZE <= static_cast< size_t >( spec.end - spec.begin ) )
+            return false;
+
+        int precision = spec.precision;
+        if( spec.starWidth )
+        {
+            if( !PutArg( buf, size, len, va_arg( ap, int ) ) )
+                return false;
+        }
+        if( spec.starPrecision )
+        {
+            precision = va_arg( ap, int );
+            if( !PutArg( buf, size, len, precision ) )
+                return false;
+        }
+
+        bool fits = true;
+        switch( spec.type )
+        {
+            case ARG_NONE:                                                               break;
+            case ARG_INT:     fits = PutArg( buf, size, len, va_arg( ap, int ) );         break;
+            case ARG_LONG:    fits = PutArg( buf, size, len, va_arg( ap, long ) );        break;
+            case ARG_LLONG:   fits = PutArg( buf, size, len, va_arg( ap, long long ) );   break;
+            case ARG_SIZE:    fits = PutArg( buf, size, len, va_arg( ap, size_t ) );      break;
+            case ARG_INTMAX:  fits = PutArg( buf, size, len, va_arg( ap, intmax_t ) );    break;
+            case ARG_PTRDIFF: fits = PutArg( buf, size, len, va_arg( ap, ptrdiff_t ) );   break;
+            case ARG_DOUBLE:  fits = PutArg( buf, size, len, va_arg( ap, double ) );      break;
+            case ARG_LDOUBLE: fits = PutArg( buf, size, len, va_arg( ap, long double ) ); break;
+            case ARG_POINTER: fits = PutArg( buf, size, len, va_arg( ap, void* ) );       break;
+
+            case ARG_STRING:
+            {
+                const char* str = va_arg( ap, const char* );
+                if( NULL == str )
+                {
+                    fits = PutArg( buf, size, len, NULL_STRING );
+                    break;
+                }
+
+                // with a precision, the string need not be terminated
+                uint32 strLen = 0;
+                if( 0 <= precision )
+                {
+                    while( strLen < static_cast< uint32 >( precision ) && '\0' != str[ strLen ] )
+                        ++strLen;
+                }
+                else
+                    strLen = static_cast< uint32 >( strlen( str ) );
+
+                fits = PutArg( buf, size, len, strLen )
+                       && strLen < size - len;
+                if( fits )
+                {
+                    memcpy( &buf[ len ], str, strLen );
+                    buf[ len + strLen ] = '\0';
+                    len += strLen + 1;
+                }
+            } break;
+
+            case ARG_INVALID:
+                return false;
+        }
+
+        if( !fits )
+            return false;
+    }
+
+    return true;
+}
+
+void AsyncLog::FormatArgs( const char* fmt, const uint8* args, size_t len, char* out, size_t size )
+{
+    assert( 0 < size );
+
+    size_t pos = 0;
+    size_t argPos = 0;
+    char specStr[ SPEC_SIZE ];
+
+    FormatSpec spec;
+    const char* p = fmt;
+    while( pos + 1 < size )
+    {
+        // copy the literal text
+        const char* next = strchr( p, '%' );
+        const size_t literalLen = std::min( NULL == next ? strlen( p ) : static_cast< size_t >( next - p ),
+                                            size - pos - 1 );
+        memcpy( &out[ pos ], p, literalLen );
+        pos += literalLen;
+
+        if( NULL == next || pos + 1 >= size )
+            break;
+
+        p = ParseSpec( next, spec );
+        if( ARG_INVALID == spec.type
+            || SPEC_SIZE <= static_cast< size_t >( spec.end - spec.begin ) )
+            break;
+
+        memcpy( specStr, spec.begin, spec.end - spec.begin );
+        specStr[ spec.end - spec.begin ] = '\0';
+
+        int stars[ 2 ];
+        size_t starCount = 0;
+        if( spec.starWidth )
+            stars[ starCount++ ] = GetArg< int >( args, len, argPos );
+        if( spec.starPrecision )
+            stars[ starCount++ ] = GetArg< int >( args, len, argPos );
+
+        char* dst = &out[ pos ];
+        const size_t avail = size - pos;
+
+        int written = 0;
+        switch( spec.type )
+        {
+            case ARG_NONE:    dst[0] = '%'; written = 1; break;
+            case ARG_INT:     written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< int >( args, len, argPos ) );         break;
+            case ARG_LONG:    written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< long >( args, len, argPos ) );        break;
+            case ARG_LLONG:   written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< long long >( args, len, argPos ) );   break;
+            case ARG_SIZE:    written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< size_t >( args, len, argPos ) );      break;
+            case ARG_INTMAX:  written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< intmax_t >( args, len, argPos ) );    break;
+            case ARG_PTRDIFF: written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< ptrdiff_t >( args, len, argPos ) );   break;
+            case ARG_DOUBLE:  written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< double >( args, len, argPos ) );      break;
+            case ARG_LDOUBLE: written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< long double >( args, len, argPos ) ); break;
+            case ARG_POINTER: written = FormatArg( dst, avail, specStr, stars, starCount, GetArg< void* >( args, len, argPos ) );       break;
+
+            case ARG_STRING:
+            {
+                const char* str = NULL;
+
+                const uint32 strLen = GetArg< uint32 >( args, len, argPos );
+                if( NULL_STRING != strLen && argPos + strLen < len )
+                {
+                    str = reinterpret_cast< const char* >( &args[ argPos ] );
+                    argPos += strLen + 1;
+                }
+
+                written = FormatArg( dst, avail, specStr, stars, starCount, str );
+            } break;
+
+            case ARG_INVALID:
+                break;
+        }
+
+        // snprintf may return -1 on truncation
+        if( 0 > written || avail <= static_cast< size_t >( written ) )
+            pos = size - 1;
+        else
+            pos += written;
+    }
+
+    out[ pos ] = '\0';
+}
+
+bool AsyncLog::Push( uint8 kind, uint32 type, uint32 arg, const char* source, const char* fmt, va_list ap )
+{
+    if( !IsRunning() )
+        return false;
+
+    Ring* ring = GetThreadRing();
+    if( NULL == ring )
+        return false;
+
+    RecordHeader hdr;
+    hdr.kind = kind;
+    hdr.flags = 0;
+    hdr.type = type;
+    hdr.arg = arg;
+    hdr.time = time( NULL );
+
+    hdr.sourceLen = 0;
+    if( NULL != source )
+        hdr.sourceLen = static_cast< uint16 >( std::min< size_t >( strlen( source ), 0xFF ) + 1 );
+
+    // capture the arguments; fall back to formatting right away
+    uint8 args[ ARGS_SIZE ];
+    size_t argsLen = 0;
+    char msg[ MESSAGE_SIZE ];
+
+    size_t fmtLen = strlen( fmt ) + 1;
+    va_list ap2;
+
+    va_copy( ap2, ap );
+    const bool captured = ( MESSAGE_SIZE >= fmtLen && CaptureArgs( fmt, ap2, args, sizeof( args ), argsLen ) );
+    va_end( ap2 );
+
+    if( !captured )
+    {
+        va_copy( ap2, ap );
+        vsnprintf( msg, sizeof( msg ), fmt, ap2 );
+        va_end( ap2 );
+
+        hdr.flags |= RECORD_FORMATTED;
+        fmt = msg;
+        fmtLen = strlen( msg ) + 1;
+        argsLen = 0;
+    }
+
+    hdr.fmtLen = static_cast< uint32 >( fmtLen );
+    hdr.argsLen = static_cast< uint32 >( argsLen );
+    hdr.size = static_cast< uint32 >( ( sizeof( hdr ) + hdr.sourceLen + fmtLen + argsLen + 7 ) & ~7 );
+
+    // reserve the space, skipping the end of the ring if the record doesn't fit there
+    uint32 head = ring->mHead;
+    const uint32 tail = AtomicLoad( ring->mTail );
+
+    const uint32 offset = head & ( RING_SIZE - 1 );
+    const uint32 contiguous = RING_SIZE - offset;
+    const uint32 needed = ( contiguous < hdr.size ? contiguous + hdr.size : hdr.size );
+
+    if( RING_SIZE - ( head - tail ) < needed )
+    {
+        AtomicIncrement( ring->mDropped );
+        return true;
+    }
+
+    if( contiguous < hdr.size )
+    {
+        memcpy( &ring->mData[ offset ], &contiguous, sizeof( uint32 ) );
+        ring->mData[ offset + sizeof( uint32 ) ] = RECORD_PADDING;
+
+        head += contiguous;
+    }
+
+    // copy the record
+    uint8* data = &ring->mData[ head & ( RING_SIZE - 1 ) ];
+
+    memcpy( data, &hdr, sizeof( hdr ) );
+    data += sizeof( hdr );
+
+    if( 0 < hdr.sourceLen )
+    {
+        memcpy( data, source, hdr.sourceLen - 1 );
+        data[ hdr.sourceLen - 1 ] = '\0';
+        data += hdr.sourceLen;
+    }
+
+    memcpy( data, fmt, fmtLen );
+    data += fmtLen;
+
+    memcpy( data, args, argsLen );
+
+    // publish it
+    AtomicStore( ring->mHead, head + hdr.size );
+    return true;
+}
+
+AsyncLog::Ring* AsyncLog::GetThreadRing()
+{
+#ifdef THREAD_LOCAL
+    if( sWriterThread )
+        return NULL;
+    if( NULL != sThreadRing )
+        return static_cast< Ring* >( sThreadRing );
+
+    for( size_t i = 0; i < RING_COUNT; ++i )
+    {
+        Ring* ring = mRings[ i ];
+
+        if( Ring::STATE_FREE == ring->mState
+            && AtomicCompareExchange( ring->mState, Ring::STATE_FREE, Ring::STATE_OWNED ) )
+        {
+#   ifndef HAVE_WINDOWS_H
+            pthread_setspecific( mRingKey, ring );
+#   endif /* !HAVE_WINDOWS_H */
+
+            sThreadRing = ring;
+            return ring;
+        }
+    }
+#endif /* THREAD_LOCAL */
+
+    return NULL;
+}
+
+size_t AsyncLog::Drain()
+{
+    size_t count = 0;
+    for( size_t i = 0; i < RING_COUNT; ++i )
+        count += DrainRing( *mRings[ i ] );
+
+    return count;
+}
+
+size_t AsyncLog::DrainRing( Ring& ring )
+{
+    size_t count = 0;
+    char msg[ MESSAGE_SIZE ];
+
+    const uint32 state = AtomicLoad( ring.mState );
+    const uint32 head = AtomicLoad( ring.mHead );
+
+    uint32 tail = ring.mTail;
+    while( tail != head )
+    {
+        const uint8* data = &ring.mData[ tail & ( RING_SIZE - 1 ) ];
+
+        uint32 size;
+        memcpy( &size, data, sizeof( uint32 ) );
+
+        if( RECORD_PADDING != data[ sizeof( uint32 ) ] )
+        {
+            RecordHeader hdr;
+            memcpy( &hdr, data, sizeof( hdr ) );
+
+            const char* source = reinterpret_cast< const char* >( data + sizeof( hdr ) );
+            const char* fmt = source + hdr.sourceLen;
+            const uint8* args = reinterpret_cast< const uint8* >( fmt + hdr.fmtLen );
+
+            const char* text = fmt;
+            if( 0 == ( hdr.flags & RECORD_FORMATTED ) )
+            {
+                FormatArgs( fmt, args, hdr.argsLen, msg, sizeof( msg ) );
+                text = msg;
+            }
+
+            if( RECORD_LOGSYS == hdr.kind )
+                log_write( static_cast< LogType >( hdr.type ), hdr.arg, static_cast< time_t >( hdr.time ), text );
+            else
+                sLog.WriteMsg( static_cast< NewLog::Color >( hdr.type ), static_cast< char >( hdr.arg ),
+                               0 < hdr.sourceLen ? source : NULL, static_cast< time_t >( hdr.time ), "%s", text );
+
+            ++count;
+        }
+
+        tail += size;
+        AtomicStore( ring.mTail, tail );
+    }
+
+    // report drops
+    const uint32 dropped = AtomicLoad( ring.mDropped );
+    if( dropped != ring.mReported )
+    {
+        const uint32 delta = dropped - ring.mReported;
+        ring.mReported = dropped;
+        mDropped += delta;
+
+        sLog.WriteMsg( NewLog::COLOR_YELLOW, 'W', "AsyncLog", time( NULL ),
+                       "Dropped %u message(s) due to a full log buffer (%u total).", delta, mDropped );
+        ++count;
+    }
+
+    // release the ring of exited thread
+    if( Ring::STATE_ORPHANED == state )
+        AtomicCompareExchange( ring.mState, Ring::STATE_ORPHANED, Ring::STATE_FREE );
+
+    return count;
+}
+
+void AsyncLog::Run()
+{
+#ifdef THREAD_LOCAL
+    sWriterThread = true;
+#endif /* THREAD_LOCAL */
+
+    while( 0 != AtomicLoad( mRunning ) )
+    {
+        if( 0 < Drain() )
+        {
+            sLog.Flush();
+            log_flush();
+        }
+        else
+            Sleep( IDLE_SLEEP );
+    }
+
+    // write out whatever is left
+    Drain();
+
+    sLog.Flush();
+    log_flush();
+}
+
+#ifdef HAVE_WINDOWS_H
+DWORD WINAPI AsyncLog::RunThread( LPVOID arg )
+{
+    static_cast< AsyncLog* >( arg )->Run();
+    return 0;
+}
+#else /* !HAVE_WINDOWS_H */
+void* AsyncLog::RunThread( void* arg )
+{
+    static_cast< AsyncLog* >( arg )->Run();
+    return NULL;
+}
+
+void AsyncLog::ReleaseThreadRing( void* ring )
+{
+    AtomicStore( static_cast< Ring* >( ring )->mState, Ring::STATE_ORPHANED );
+}
+#endif /* !HAVE_WINDOWS_H */
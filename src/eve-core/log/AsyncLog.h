@@ -0,0 +1,217 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __LOG__ASYNC_LOG_H__INCL__
+#define __LOG__ASYNC_LOG_H__INCL__
+
+#include "log/logsys.h"
+#include "utils/Singleton.h"
+
+/**
+ * @brief Asynchronous backend for NewLog and logsys.
+ *
+ * While running, log calls do not format or write anything;
+ * they copy the format string and the raw arguments into a
+ * per-thread single-producer ring buffer and return. A background
+ * writer thread drains the rings, formats the messages and hands
+ * them to NewLog and logsys for coloring, writing, rotation and
+ * flushing, once per batch.
+ *
+ * When a ring is full, the message is dropped and counted; the
+ * writer reports the drops as a warning. Threads which could not
+ * get a ring (all slots taken, or the writer itself) log synchronously.
+ */
+class AsyncLog
+: public Singleton< AsyncLog >
+{
+public:
+    /// Primary constructor.
+    AsyncLog();
+    /// Destructor, stops the writer and frees the rings.
+    ~AsyncLog();
+
+    /**
+     * @brief Starts the writer thread.
+     *
+     * @retval true  Log calls are queued from now on.
+     * @retval false Failed to start; logging stays synchronous.
+     */
+    bool Start();
+    /**
+     * @brief Stops the writer thread.
+     *
+     * Queued messages are written out before returning.
+     */
+    void Stop();
+
+    /** @return True if log calls are being queued. */
+    bool IsRunning() const { return 0 != mRunning; }
+    /** @return Total number of messages dropped due to full rings. */
+    uint32 GetDropped() const { return mDropped; }
+
+    /**
+     * @brief Queues a logsys message.
+     *
+     * @param[in] type The log type.
+     * @param[in] iden Indentation of the message.
+     * @param[in] fmt  The format string.
+     * @param[in] ap   The arguments; left untouched.
+     *
+     * @retval true  The message has been queued (or dropped).
+     * @retval false The message must be written synchronously.
+     */
+    bool PushLogsys( LogType type, uint32 iden, const char* fmt, va_list ap );
+    /**
+     * @brief Queues a NewLog message.
+     *
+     * @param[in] color  Color of the message.
+     * @param[in] pfx    Single-character prefix of the message.
+     * @param[in] source Origin of the message.
+     * @param[in] fmt    The format string.
+     * @param[in] ap     The arguments; left untouched.
+     *
+     * @retval true  The message has been queued (or dropped).
+     * @retval false The message must be written synchronously.
+     */
+    bool PushNewLog( uint8 color, char pfx, const char* source, const char* fmt, va_list ap );
+
+    /**
+     * @brief Captures the arguments of a format string.
+     *
+     * Strings are copied, so the result does not reference
+     * caller's memory.
+     *
+     * @param[in]  fmt  The format string.
+     * @param[in]  ap   The arguments.
+     * @param[out] buf  Buffer to store the arguments into.
+     * @param[in]  size Size of the buffer.
+     * @param[out] len  Number of bytes stored.
+     *
+     * @retval true  The arguments have been captured.
+     * @retval false The format string contains an unsupported
+     *               conversion or the arguments do not fit.
+     */
+    static bool CaptureArgs( const char* fmt, va_list ap, uint8* buf, size_t size, size_t& len );
+    /**
+     * @brief Formats a message from captured arguments.
+     *
+     * The output is the same as vsnprintf would produce
+     * from the original arguments.
+     *
+     * @param[in]  fmt  The format string passed to CaptureArgs.
+     * @param[in]  args The captured arguments.
+     * @param[in]  len  Length of the captured arguments.
+     * @param[out] out  Buffer to store the message into.
+     * @param[in]  size Size of the buffer.
+     */
+    static void FormatArgs( const char* fmt, const uint8* args, size_t len, char* out, size_t size );
+
+protected:
+    class Ring;
+
+    /// Number of ring slots, i.e. threads which may log asynchronously at once.
+    static const size_t RING_COUNT = 64;
+    /// Size of a single ring, in bytes; must be a power of two.
+    static const size_t RING_SIZE = 0x10000;
+    /// Maximal length of a formatted message.
+    static const size_t MESSAGE_SIZE = 0x1000;
+    /// Maximal length of captured arguments.
+    static const size_t ARGS_SIZE = 0x800;
+    /// How long the writer sleeps when there is nothing to write, in milliseconds.
+    static const uint32 IDLE_SLEEP = 5;
+
+    /**
+     * @brief Queues a message into the ring of calling thread.
+     *
+     * @param[in] kind   Kind of the record.
+     * @param[in] type   Log type or color.
+     * @param[in] arg    Indentation or prefix.
+     * @param[in] source Origin of message; may be NULL.
+     * @param[in] fmt    The format string.
+     * @param[in] ap     The arguments.
+     *
+     * @retval true  The message has been queued (or dropped).
+     * @retval false The message must be written synchronously.
+     */
+    bool Push( uint8 kind, uint32 type, uint32 arg, const char* source, const char* fmt, va_list ap );
+    /**
+     * @brief Obtains the ring of calling thread, claiming a free one if needed.
+     *
+     * @return The ring; NULL if none is available.
+     */
+    Ring* GetThreadRing();
+
+    /**
+     * @brief Writes out all queued messages.
+     *
+     * @return Number of messages written.
+     */
+    size_t Drain();
+    /**
+     * @brief Writes out all messages queued in a ring.
+     *
+     * @param[in] ring The ring to drain.
+     *
+     * @return Number of messages written.
+     */
+    size_t DrainRing( Ring& ring );
+
+    /// Body of the writer thread.
+    void Run();
+
+#ifdef HAVE_WINDOWS_H
+    /// Writer thread entry point.
+    static DWORD WINAPI RunThread( LPVOID arg );
+#else /* !HAVE_WINDOWS_H */
+    /// Writer thread entry point.
+    static void* RunThread( void* arg );
+    /// Releases the ring of an exiting thread.
+    static void ReleaseThreadRing( void* ring );
+#endif /* !HAVE_WINDOWS_H */
+
+    /// The ring slots; allocated on first Start().
+    Ring* mRings[ RING_COUNT ];
+    /// Nonzero while the writer is running.
+    volatile uint32 mRunning;
+    /// Total number of dropped messages reported so far.
+    uint32 mDropped;
+
+#ifdef HAVE_WINDOWS_H
+    /// Handle of the writer thread.
+    HANDLE mThread;
+#else /* !HAVE_WINDOWS_H */
+    /// The writer thread.
+    pthread_t mThread;
+    /// Key releasing rings of exiting threads.
+    pthread_key_t mRingKey;
+    /// Whether mRingKey has been created.
+    bool mRingKeyCreated;
+#endif /* !HAVE_WINDOWS_H */
+};
+
+/// Evaluates to an AsyncLog instance.
+#define sAsyncLog \
+    ( AsyncLog::get() )
+
+#endif /* !__LOG__ASYNC_LOG_H__INCL__ */
@@ -25,6 +25,7 @@
 
 #include "eve-core.h"
 
+#include "log/AsyncLog.h"
 #include "log/LogNew.h"
 #include "log/logtypes.h"
 #include "log/logsys.h"
@@ -62,6 +63,9 @@ const char* const NewLog::COLOR_TABLE[ COLOR_COUNT ] =
 
 NewLog::NewLog()
 : mLogfile( NULL ),
+  mLogfileSize( 0 ),
+  mRotateSize( 0 ),
+  mRotateCount( 0 ),
   mTime( 0 )
 #ifdef HAVE_WINDOWS_H
   ,mStdOutHandle( GetStdHandle( STD_OUTPUT_HANDLE ) ),
@@ -176,6 +180,7 @@ bool NewLog::SetLogfile( FILE* file )
         assert( 0 == fclose( mLogfile ) );
 
     mLogfile = file;
+    mLogfileSize = 0;
     return true;
 }
 
@@ -184,8 +189,27 @@ void NewLog::PrintMsg( Color color, char pfx, const char* source, const char* fm
     if( !m_initialized )
         return;
 
+    if( sAsyncLog.PushNewLog( color, pfx, source, fmt, ap ) )
+        return;
+
+    WriteMsgVa( color, pfx, source, time( NULL ), fmt, ap );
+}
+
+void NewLog::WriteMsg( Color color, char pfx, const char* source, time_t time, const char* fmt, ... )
+{
+    va_list ap;
+    va_start( ap, fmt );
+
+    WriteMsgVa( color, pfx, source, time, fmt, ap );
+
+    va_end( ap );
+}
+
+void NewLog::WriteMsgVa( Color color, char pfx, const char* source, time_t time, const char* fmt, va_list ap )
+{
     MutexLock l( mMutex );
 
+    SetTime( time );
     PrintTime();
 
     SetColor( color );
@@ -203,14 +227,34 @@ void NewLog::PrintMsg( Color color, char pfx, const char* source, const char* fm
     Print( "\n" );
 
     SetColor( COLOR_DEFAULT );
+
+#ifndef NDEBUG
+    // flush immediately so logfile is accurate if we crash;
+    // the asynchronous writer flushes once per batch instead
+    if( !sAsyncLog.IsRunning() )
+        Flush();
+#endif /* !NDEBUG */
+
+    if( 0 < mRotateSize && mRotateSize <= mLogfileSize )
+    {
+        ++mRotateCount;
+        SetLogfileDefault( mLogPath );
+    }
 }
 
-void NewLog::PrintTime()
+void NewLog::Flush()
 {
     MutexLock l( mMutex );
 
-    // this will be replaced my a timing thread somehow
-    SetTime( time( NULL ) );
+    if( NULL != mLogfile )
+        fflush( mLogfile );
+
+    fflush( stdout );
+}
+
+void NewLog::PrintTime()
+{
+    MutexLock l( mMutex );
 
     tm t;
     localtime_r( &mTime, &t );
@@ -238,12 +282,9 @@ void NewLog::PrintVa( const char* fmt, va_list ap )
         va_list ap2;
         va_copy( ap2, ap );
 
-        vfprintf( mLogfile, fmt, ap2 );
-
-#ifndef NDEBUG
-        // flush immediately so logfile is accurate if we crash
-        fflush( mLogfile );
-#endif /* !NDEBUG */
+        const int written = vfprintf( mLogfile, fmt, ap2 );
+        if( 0 < written )
+            mLogfileSize += written;
 
         va_end( ap2 );
     }
@@ -274,11 +315,22 @@ void NewLog::SetLogfileDefault(std::string logPath)
     tm t;
     localtime_r( &mTime, &t );
 
-    // open default logfile
+    mLogPath = logPath;
+
+    // open default logfile; rotated ones get a sequence number
     char filename[ FILENAME_MAX + 1 ];
-    std::string logFile = logPath + "log_%02u-%02u-%04u-%02u-%02u.log";
-    snprintf( filename, FILENAME_MAX + 1, logFile.c_str(),
-              t.tm_mday, t.tm_mon + 1, t.tm_year + 1900, t.tm_hour, t.tm_min );
+    if( 0 == mRotateCount )
+    {
+        std::string logFile = logPath + "log_%02u-%02u-%04u-%02u-%02u.log";
+        snprintf( filename, FILENAME_MAX + 1, logFile.c_str(),
+                  t.tm_mday, t.tm_mon + 1, t.tm_year + 1900, t.tm_hour, t.tm_min );
+    }
+    else
+    {
+        std::string logFile = logPath + "log_%02u-%02u-%04u-%02u-%02u.%u.log";
+        snprintf( filename, FILENAME_MAX + 1, logFile.c_str(),
+                  t.tm_mday, t.tm_mon + 1, t.tm_year + 1900, t.tm_hour, t.tm_min, mRotateCount );
+    }
     //snprintf( filename, FILENAME_MAX + 1, EVEMU_ROOT "/log/log_%02u-%02u-%04u-%02u-%02u.log",
     //          t.tm_mday, t.tm_mon + 1, t.tm_year + 1900, t.tm_hour, t.tm_min );
 
@@ -41,6 +41,8 @@
 class NewLog
 : public Singleton< NewLog >
 {
+    friend class AsyncLog;
+
 public:
     /// Primary constructor, initializes logging.
     NewLog();
@@ -112,6 +114,14 @@ public:
      * @retval false Failed to open the new logfile.
      */
     bool SetLogfile( FILE* file );
+    /**
+     * @brief Sets the size at which the logfile is rotated.
+     *
+     * Rotation opens a new default logfile.
+     *
+     * @param[in] size Size in bytes; 0 disables rotation.
+     */
+    void SetRotateSize( size_t size ) { mRotateSize = size; }
 
     /**
      * @brief Sets the log system time every main loop.
@@ -150,7 +160,36 @@ protected:
      */
     void PrintMsg( Color color, char pfx, const char* source, const char* fmt, va_list ap );
     /**
-     * @brief Prints current time.
+     * @brief Writes a message out.
+     *
+     * Called by PrintMsg, or by the asynchronous writer
+     * for queued messages.
+     *
+     * @param[in] color  Color of the message.
+     * @param[in] pfx    Single-character prefix/identificator.
+     * @param[in] source Origin of message.
+     * @param[in] time   Time of the message.
+     * @param[in] fmt    The format string.
+     * @param[in] ...    The arguments.
+     */
+    void WriteMsg( Color color, char pfx, const char* source, time_t time, const char* fmt, ... );
+    /**
+     * @brief Writes a message out.
+     *
+     * @param[in] color  Color of the message.
+     * @param[in] pfx    Single-character prefix/identificator.
+     * @param[in] source Origin of message.
+     * @param[in] time   Time of the message.
+     * @param[in] fmt    The format string.
+     * @param[in] ap     The arguments.
+     */
+    void WriteMsgVa( Color color, char pfx, const char* source, time_t time, const char* fmt, va_list ap );
+    /**
+     * @brief Flushes standard output and the logfile.
+     */
+    void Flush();
+    /**
+     * @brief Prints time of the current message.
      */
     void PrintTime();
 
@@ -188,6 +227,14 @@ protected:
 
     /// The active logfile.
     FILE* mLogfile;
+    /// Number of bytes written to the active logfile.
+    size_t mLogfileSize;
+    /// Logfile size triggering rotation; 0 if disabled.
+    size_t mRotateSize;
+    /// Number of rotations done so far.
+    uint32 mRotateCount;
+    /// Directory of the default logfile.
+    std::string mLogPath;
     /// Current timestamp.
     time_t mTime; // crap there should be 1 generic easy to understand time manager.
     /// Protection against concurrent log messages
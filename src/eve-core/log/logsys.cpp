@@ -25,6 +25,7 @@
 
 #include "eve-core.h"
 
+#include "log/AsyncLog.h"
 #include "log/logsys.h"
 #include "utils/utils_hex.h"
 
@@ -80,50 +81,40 @@ void log_messageVA(LogType type, const char *fmt, va_list args) {
 
 extern void log_messageVA( LogType type, uint32 iden, const char *fmt, va_list args )
 {
-    /* allocate enough room for a large message */
-    size_t log_msg_size = 0x1000;
-    size_t log_msg_index = 0;
-    char* log_msg = (char*)malloc(log_msg_size);
+    if( sAsyncLog.PushLogsys( type, iden, fmt, args ) )
+        return;
 
-    /* handle the time part.. cross platform */
-    tm t;
-    time_t tTime;
-    time(&tTime);
-    localtime_r( &tTime, &t );
-    int va_size = snprintf(&log_msg[log_msg_index], log_msg_size, "%02u:%02u:%02u [%s] ", t.tm_hour, t.tm_min, t.tm_sec, log_type_info[type].display_name );
-
-    /* store the resulting size */
-    log_msg_size-=va_size;
-    log_msg_index+=va_size;
-
-    /* add the required spaces */
-    for (uint32 i = 0; i < iden; i++)
-    {
-        log_msg[log_msg_index++] = ' ';
-    }
+    /* allocate enough room for a large message */
+    char log_msg[ 0x1000 ];
+    vsnprintf( log_msg, sizeof( log_msg ), fmt, args );
 
-    /* make sure the resulting size is corrected */
-    log_msg_size-=iden;
+    log_write( type, iden, time( NULL ), log_msg );
 
-    /* put in the rest of the va stuff */
-    va_size = vsnprintf(&log_msg[log_msg_index], log_msg_size, fmt, args);
-    log_msg_index+=va_size;
+    //keep the logfile updated
+    log_flush();
+}
 
-    /* make sure that there is a new line at the end */
-    log_msg[log_msg_index++] = '\n';
-    log_msg[log_msg_index++] = '\0';
+void log_write( LogType type, uint32 iden, time_t when, const char* message )
+{
+    /* handle the time part.. cross platform */
+    tm t;
+    localtime_r( &when, &t );
 
-    fputs(log_msg, stdout);
+    /* the required spaces go between the header and the message */
+    fprintf( stdout, "%02u:%02u:%02u [%s] %*s%s\n", t.tm_hour, t.tm_min, t.tm_sec,
+             log_type_info[type].display_name, static_cast< int >( iden ), "", message );
 
     //print into the logfile (if any)
     if(logsys_log_file != NULL) {
-        //fprintf(logsys_log_file, "%s\n", message.c_str());
-        fputs(log_msg, logsys_log_file);
-        //keep the logfile updated
-        fflush(logsys_log_file);
+        fprintf( logsys_log_file, "%02u:%02u:%02u [%s] %*s%s\n", t.tm_hour, t.tm_min, t.tm_sec,
+                 log_type_info[type].display_name, static_cast< int >( iden ), "", message );
     }
+}
 
-    free(log_msg);
+void log_flush()
+{
+    if(logsys_log_file != NULL)
+        fflush(logsys_log_file);
 }
 
 void log_enable( LogType t )
@@ -154,7 +145,11 @@ bool log_close_logfile()
 {
     if( NULL == logsys_log_file )
         return true;
-    return ( 0 == fclose( logsys_log_file ) );
+
+    FILE* file = logsys_log_file;
+    logsys_log_file = NULL;
+
+    return ( 0 == fclose( file ) );
 }
 
 bool load_log_settings(const char *filename) {
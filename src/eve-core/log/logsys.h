@@ -109,6 +109,9 @@ extern bool load_log_settings( const char* filename );
 extern void log_message(LogType type, const char *fmt, ...);
 extern void log_messageVA(LogType type, const char *fmt, va_list args);
 extern void log_messageVA(LogType type, uint32 iden, const char *fmt, va_list args);
+//writes out an already formatted message; used by the asynchronous writer
+extern void log_write(LogType type, uint32 iden, time_t when, const char* message);
+extern void log_flush();
 extern void log_hex(LogType type, const void *data, unsigned long length, unsigned char padding=4);
 extern void log_phex(LogType type, const void *data, unsigned long length, unsigned char padding=4);
 
@@ -122,6 +122,7 @@ LOG_TYPE( NPC, WARNING, DISABLED, "Warning" )
 LOG_TYPE( NPC, MESSAGE, DISABLED, "Message" )
 LOG_TYPE( NPC, TRACE, DISABLED, "Trace" )
 LOG_TYPE( NPC, AI_TRACE, DISABLED, "AITrace" )
+LOG_TYPE( NPC, AI_STATS, DISABLED, "AIStats" )
 
 LOG_CATEGORY( AGENT )
 LOG_TYPE( AGENT, ERROR,   ENABLED, "Error" )
@@ -27,61 +27,77 @@
 
 #include "network/StreamPacketizer.h"
 
-StreamPacketizer::~StreamPacketizer()
+StreamPacketizer::StreamPacketizer()
+: mReadIndex( 0 ),
+  mWriteIndex( 0 )
 {
-    ClearBuffers();
 }
 
 void StreamPacketizer::InputData( const Buffer& data )
 {
-    mBuffer.AppendSeq( data.begin<uint8>(), data.end<uint8>() );
+    if( 0 < data.size() )
+        InputData( &data[0], data.size() );
 }
 
-void StreamPacketizer::Process()
+void StreamPacketizer::InputData( const uint8* data, size_t len )
 {
-    Buffer::const_iterator<uint8> cur, end;
-    cur = mBuffer.begin<uint8>();
-    end = mBuffer.end<uint8>();
-    while( true )
+    if( 0 == len )
+        return;
+
+    if( mBuffer.size() < mWriteIndex + len )
     {
-        if( sizeof( uint32 ) > ( end - cur ) )
-            break;
+        // reclaim consumed space first
+        const size_t unconsumed = ( mWriteIndex - mReadIndex );
+        if( 0 < mReadIndex )
+        {
+            if( 0 < unconsumed )
+                memmove( &mBuffer[0], &mBuffer[ mReadIndex ], unconsumed );
+
+            mReadIndex = 0;
+            mWriteIndex = unconsumed;
+        }
+
+        // grow only if still not enough
+        if( mBuffer.size() < mWriteIndex + len )
+            mBuffer.Resize<uint8>( (size_t)npowof2( mWriteIndex + len ) );
+    }
+
+    memcpy( &mBuffer[ mWriteIndex ], data, len );
+    mWriteIndex += len;
+}
 
-        const Buffer::const_iterator<uint32> len = cur.As<uint32>();
-        const Buffer::const_iterator<uint8> start = ( len + 1 ).As<uint8>();
+bool StreamPacketizer::PeekPacket( Buffer::const_iterator<uint8>& first, Buffer::const_iterator<uint8>& last ) const
+{
+    const size_t available = ( mWriteIndex - mReadIndex );
+    if( sizeof( uint32 ) > available )
+        return false;
 
-        if( *len > (uint32)( end - start ) )
-            break;
+    uint32 len;
+    memcpy( &len, &mBuffer[ mReadIndex ], sizeof( uint32 ) );
 
-        mPackets.push( new Buffer( start, start + *len ) );
-        cur = ( start + *len );
-    }
+    if( len > available - sizeof( uint32 ) )
+        return false;
 
-    if( cur != mBuffer.begin<uint8>() )
-        mBuffer.AssignSeq( cur, end );
+    first = mBuffer.begin<uint8>() + ( mReadIndex + sizeof( uint32 ) );
+    last = first + len;
+    return true;
 }
 
-Buffer* StreamPacketizer::PopPacket()
+void StreamPacketizer::PopPacket()
 {
-    Buffer* ret = NULL;
-    if( !mPackets.empty() )
-    {
-        ret = mPackets.front();
-        mPackets.pop();
-    }
+    Buffer::const_iterator<uint8> first, last;
+    if( !PeekPacket( first, last ) )
+        return;
 
-    return ret;
+    mReadIndex = ( last - mBuffer.begin<uint8>() );
+
+    // everything consumed, rewind for free
+    if( mReadIndex == mWriteIndex )
+        mReadIndex = mWriteIndex = 0;
 }
 
 void StreamPacketizer::ClearBuffers()
 {
-    Buffer* buf;
-    while( ( buf = PopPacket() ) )
-        SafeDelete( buf );
+    mReadIndex = mWriteIndex = 0;
+    mBuffer.Resize<uint8>( 0 );
 }
-
-
-
-
-
-
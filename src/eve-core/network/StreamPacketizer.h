@@ -28,24 +28,64 @@
 
 #include "utils/Buffer.h"
 
+/**
+ * @brief Splits stream of length-prefixed frames into packets.
+ *
+ * Received data are kept in a single receive buffer; complete
+ * frames are exposed as views into this buffer, so no per-frame
+ * copy or allocation is made. Consumed space is reclaimed by moving
+ * the unconsumed tail to the front only when the buffer would
+ * otherwise have to grow, so in steady state the buffer is never
+ * reallocated.
+ *
+ * @author Zhur, Bloody.Rabbit
+ */
 class StreamPacketizer
 {
 public:
-    ~StreamPacketizer();
+    StreamPacketizer();
 
+    /**
+     * @brief Appends received data.
+     *
+     * @param[in] data Received data.
+     */
     void InputData( const Buffer& data );
-    void Process();
+    /**
+     * @brief Appends received data.
+     *
+     * @param[in] data Pointer to received data.
+     * @param[in] len  Length of received data.
+     */
+    void InputData( const uint8* data, size_t len );
 
-    Buffer* PopPacket();
+    /**
+     * @brief Obtains the first complete packet.
+     *
+     * The returned view stays valid until the packet is popped
+     * or more data are put into the packetizer.
+     *
+     * @param[out] first Iterator pointing to first byte of packet.
+     * @param[out] last  Iterator pointing to byte after the packet.
+     *
+     * @retval true  Complete packet is available.
+     * @retval false No complete packet is available.
+     */
+    bool PeekPacket( Buffer::const_iterator<uint8>& first, Buffer::const_iterator<uint8>& last ) const;
+    /**
+     * @brief Discards the first complete packet.
+     */
+    void PopPacket();
 
     void ClearBuffers();
 
 protected:
+    /** Receive buffer; its whole size is used as storage. */
     Buffer mBuffer;
-
-    std::queue<Buffer*> mPackets;
+    /** Index of first unconsumed byte in mBuffer. */
+    size_t mReadIndex;
+    /** Index of byte after the last received one in mBuffer. */
+    size_t mWriteIndex;
 };
 
 #endif /* !__STREAM_PACKETIZER_H__INCL__ */
-
-
@@ -399,16 +399,12 @@ bool TCPConnection::RecvData( char* errbuf )
     {
         if( mRecvBuf == NULL )
             mRecvBuf = new Buffer( TCPCONN_RECVBUF_SIZE );
-        else if( mRecvBuf->size() < TCPCONN_RECVBUF_SIZE )
-            mRecvBuf->Resize<uint8>( TCPCONN_RECVBUF_SIZE );
 
         int status = mSock->recv( &(*mRecvBuf)[ 0 ], mRecvBuf->size(), 0 );
 
         if( status > 0 )
         {
-            mRecvBuf->Resize<uint8>( status );
-
-            if( !ProcessReceivedData( errbuf ) )
+            if( !ProcessReceivedData( &(*mRecvBuf)[ 0 ], status, errbuf ) )
                 return false;
         }
         else if( status == 0 )
@@ -154,11 +154,13 @@ protected:
      * Called every time a chunk of new data is received. Please note that
      * receive buffer is overwritten every time data is received.
      *
+     * @param[in]  data   Pointer to received data.
+     * @param[in]  len    Length of received data.
      * @param[out] errbuf Buffer which receives description of error.
      *
      * @return True if processing ran fine, false if not.
      */
-    virtual bool ProcessReceivedData( char* errbuf = 0 ) = 0;
+    virtual bool ProcessReceivedData( const uint8* data, size_t len, char* errbuf = 0 ) = 0;
 
     /**
      * @brief Sends data in send queue.
@@ -223,7 +225,7 @@ protected:
     /** Send queue. */
     std::deque<Buffer*> mSendQueue;
 
-    /** Receive buffer. */
+    /** Receive buffer; allocated once with TCPCONN_RECVBUF_SIZE bytes and never resized. */
     Buffer* mRecvBuf;
 };
 
@@ -0,0 +1,112 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __THREADING__ATOMIC_H__INCL__
+#define __THREADING__ATOMIC_H__INCL__
+
+/*
+ * Minimal set of atomic operations on 32-bit words.
+ *
+ * Only what lock-free single-producer/single-consumer queues
+ * need: ordered loads and stores, increment and compare-and-swap.
+ * All of them act as full memory barriers.
+ */
+
+/**
+ * @brief Reads a shared word.
+ *
+ * No memory access following the load may be reordered before it.
+ *
+ * @param[in] value The word to read.
+ *
+ * @return The value of the word.
+ */
+inline uint32 AtomicLoad( const volatile uint32& value )
+{
+    uint32 result = value;
+#ifdef HAVE_WINDOWS_H
+    MemoryBarrier();
+#else /* !HAVE_WINDOWS_H */
+    __sync_synchronize();
+#endif /* !HAVE_WINDOWS_H */
+    return result;
+}
+
+/**
+ * @brief Writes a shared word.
+ *
+ * No memory access preceding the store may be reordered after it.
+ *
+ * @param[in] value    The word to write.
+ * @param[in] newValue The value to store.
+ */
+inline void AtomicStore( volatile uint32& value, uint32 newValue )
+{
+#ifdef HAVE_WINDOWS_H
+    MemoryBarrier();
+#else /* !HAVE_WINDOWS_H */
+    __sync_synchronize();
+#endif /* !HAVE_WINDOWS_H */
+    value = newValue;
+}
+
+/**
+ * @brief Atomically increments a shared word.
+ *
+ * @param[in] value The word to increment.
+ *
+ * @return The incremented value.
+ */
+inline uint32 AtomicIncrement( volatile uint32& value )
+{
+#ifdef HAVE_WINDOWS_H
+    return static_cast< uint32 >( InterlockedIncrement( reinterpret_cast< volatile LONG* >( &value ) ) );
+#else /* !HAVE_WINDOWS_H */
+    return __sync_add_and_fetch( &value, 1 );
+#endif /* !HAVE_WINDOWS_H */
+}
+
+/**
+ * @brief Atomically replaces a shared word if it holds an expected value.
+ *
+ * @param[in] value    The word to modify.
+ * @param[in] expected The value the word must hold.
+ * @param[in] newValue The value to store.
+ *
+ * @retval true  The word held @a expected and now holds @a newValue.
+ * @retval false The word was left untouched.
+ */
+inline bool AtomicCompareExchange( volatile uint32& value, uint32 expected, uint32 newValue )
+{
+#ifdef HAVE_WINDOWS_H
+    return expected == static_cast< uint32 >(
+        InterlockedCompareExchange( reinterpret_cast< volatile LONG* >( &value ),
+                                    static_cast< LONG >( newValue ),
+                                    static_cast< LONG >( expected ) ) );
+#else /* !HAVE_WINDOWS_H */
+    return __sync_bool_compare_and_swap( &value, expected, newValue );
+#endif /* !HAVE_WINDOWS_H */
+}
+
+#endif /* !__THREADING__ATOMIC_H__INCL__ */
@@ -0,0 +1,181 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-core.h"
+
+#include "log/LogNew.h"
+#include "threading/Atomic.h"
+#include "threading/WorkerPool.h"
+
+WorkerPool::WorkerPool()
+: mRunning( 0 ),
+  mActive( 0 )
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    Stop();
+
+    Job* job;
+    while( NULL != ( job = PopCompleted() ) )
+        delete job;
+}
+
+bool WorkerPool::Start( size_t threads )
+{
+    if( IsRunning() )
+        return true;
+
+    AtomicStore( mRunning, 1 );
+
+    for( size_t i = 0; i < threads; ++i )
+    {
+#ifdef HAVE_WINDOWS_H
+        HANDLE thread = CreateThread( NULL, 0, RunThread, this, 0, NULL );
+        if( NULL == thread )
+            break;
+#else /* !HAVE_WINDOWS_H */
+        pthread_t thread;
+        if( 0 != pthread_create( &thread, NULL, RunThread, this ) )
+            break;
+#endif /* !HAVE_WINDOWS_H */
+
+        mThreads.push_back( thread );
+    }
+
+    if( mThreads.size() < threads )
+        sLog.Warning( "WorkerPool", "Started only %lu of %lu worker threads.", mThreads.size(), threads );
+
+    if( !IsRunning() )
+    {
+        AtomicStore( mRunning, 0 );
+        return false;
+    }
+
+    return true;
+}
+
+void WorkerPool::Stop()
+{
+    AtomicStore( mRunning, 0 );
+
+    for( size_t i = 0; i < mThreads.size(); ++i )
+    {
+#ifdef HAVE_WINDOWS_H
+        WaitForSingleObject( mThreads[ i ], INFINITE );
+        CloseHandle( mThreads[ i ] );
+#else /* !HAVE_WINDOWS_H */
+        pthread_join( mThreads[ i ], NULL );
+#endif /* !HAVE_WINDOWS_H */
+    }
+    mThreads.clear();
+
+    // run whatever is left
+    MutexLock lock( mMutex );
+    while( !mPending.empty() )
+    {
+        Job* job = mPending.front();
+        mPending.pop_front();
+
+        job->Run();
+        mCompleted.push_back( job );
+    }
+}
+
+size_t WorkerPool::GetJobCount()
+{
+    MutexLock lock( mMutex );
+
+    return mPending.size() + mActive + mCompleted.size();
+}
+
+void WorkerPool::Push( Job* job )
+{
+    if( !IsRunning() )
+    {
+        job->Run();
+
+        MutexLock lock( mMutex );
+        mCompleted.push_back( job );
+        return;
+    }
+
+    MutexLock lock( mMutex );
+    mPending.push_back( job );
+}
+
+WorkerPool::Job* WorkerPool::PopCompleted()
+{
+    MutexLock lock( mMutex );
+    if( mCompleted.empty() )
+        return NULL;
+
+    Job* job = mCompleted.front();
+    mCompleted.pop_front();
+    return job;
+}
+
+void WorkerPool::Run()
+{
+    while( 0 != AtomicLoad( mRunning ) )
+    {
+        Job* job = NULL;
+        {
+            MutexLock lock( mMutex );
+            if( !mPending.empty() )
+            {
+                job = mPending.front();
+                mPending.pop_front();
+                ++mActive;
+            }
+        }
+
+        if( NULL == job )
+        {
+            Sleep( IDLE_SLEEP );
+            continue;
+        }
+
+        job->Run();
+
+        MutexLock lock( mMutex );
+        --mActive;
+        mCompleted.push_back( job );
+    }
+}
+
+#ifdef HAVE_WINDOWS_H
+DWORD WINAPI WorkerPool::RunThread( LPVOID arg )
+{
+    static_cast< WorkerPool* >( arg )->Run();
+    return 0;
+}
+#else /* !HAVE_WINDOWS_H */
+void* WorkerPool::RunThread( void* arg )
+{
+    static_cast< WorkerPool* >( arg )->Run();
+    return NULL;
+}
+#endif /* !HAVE_WINDOWS_H */
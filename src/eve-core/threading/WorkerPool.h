@@ -0,0 +1,133 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __THREADING__WORKER_POOL_H__INCL__
+#define __THREADING__WORKER_POOL_H__INCL__
+
+#include "threading/Mutex.h"
+
+/**
+ * @brief Runs jobs on a set of background threads.
+ *
+ * Jobs are pushed by an owning thread, run by whichever
+ * worker gets to them first and handed back through
+ * PopCompleted(), so the owner can act on their results
+ * without any further locking.
+ *
+ * A pool which has not been started runs jobs right
+ * away, on the pushing thread.
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @brief A piece of work for the pool.
+     */
+    class Job
+    {
+    public:
+        virtual ~Job() {}
+
+        /**
+         * @brief Does the work; called on a worker thread.
+         */
+        virtual void Run() = 0;
+    };
+
+    /// How long an idle worker sleeps before looking for jobs again, in milliseconds.
+    static const uint32 IDLE_SLEEP = 5;
+
+    WorkerPool();
+    /**
+     * @brief Stops the pool and destroys all jobs still held.
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param[in] threads Number of threads to start.
+     *
+     * @retval true  At least one thread has been started.
+     * @retval false No thread could be started; jobs will run synchronously.
+     */
+    bool Start( size_t threads );
+    /**
+     * @brief Stops the worker threads.
+     *
+     * Waits for running jobs to finish. Jobs no worker has
+     * picked up yet are run on the calling thread.
+     */
+    void Stop();
+
+    /** @return True if there are worker threads running. */
+    bool IsRunning() const { return !mThreads.empty(); }
+    /** @return Number of jobs pushed, but not popped yet. */
+    size_t GetJobCount();
+
+    /**
+     * @brief Queues a job.
+     *
+     * @param[in] job The job; the pool takes ownership until it is popped.
+     */
+    void Push( Job* job );
+    /**
+     * @brief Pops a completed job.
+     *
+     * @return The job, owned by caller; NULL if none has completed.
+     */
+    Job* PopCompleted();
+
+protected:
+    /// Body of a worker thread.
+    void Run();
+
+#ifdef HAVE_WINDOWS_H
+    /// Worker thread entry point.
+    static DWORD WINAPI RunThread( LPVOID arg );
+
+    /// Handles of the worker threads.
+    std::vector<HANDLE> mThreads;
+#else /* !HAVE_WINDOWS_H */
+    /// Worker thread entry point.
+    static void* RunThread( void* arg );
+
+    /// The worker threads.
+    std::vector<pthread_t> mThreads;
+#endif /* !HAVE_WINDOWS_H */
+
+    /// Nonzero while the workers should keep running.
+    volatile uint32 mRunning;
+
+    /// Guards the queues below.
+    Mutex mMutex;
+    /// Jobs waiting for a worker.
+    std::deque<Job*> mPending;
+    /// Jobs which have run.
+    std::deque<Job*> mCompleted;
+    /// Number of jobs being run right now.
+    size_t mActive;
+};
+
+#endif /* !__THREADING__WORKER_POOL_H__INCL__ */
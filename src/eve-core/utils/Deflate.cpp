@@ -25,80 +25,329 @@
 
 #include "eve-core.h"
 
+#include "log/LogNew.h"
 #include "utils/Deflate.h"
 
 const uint8 DeflateHeaderByte = 0x78; //'x'
 
+/*
+ * Initializing a z_stream allocates its whole state (some 256 KiB
+ * for deflate at default settings), so each thread keeps its streams
+ * and merely resets them between uses. Deflate streams are kept
+ * per compression level, since switching the level of a used stream
+ * with deflateParams() may flush into the stale output pointer.
+ * The streams are allocated on first use and released when
+ * the thread exits. Without thread-local storage, every call
+ * sets up and tears down its own stream.
+ */
+#ifdef THREAD_LOCAL
+/**
+ * @brief Streams of a single thread.
+ */
+struct ThreadStreams
+{
+    /// Deflate streams, indexed by compression level.
+    z_stream* deflate[ Z_BEST_COMPRESSION + 1 ];
+    /// Inflate stream.
+    z_stream* inflate;
+};
+
+/// Streams of the current thread.
+static THREAD_LOCAL ThreadStreams* sThreadStreams = NULL;
+
+/**
+ * @brief Releases streams of exiting thread.
+ *
+ * @param[in] streams ThreadStreams of the thread.
+ */
+static void _ReleaseThreadStreams( void* streams )
+{
+    ThreadStreams* ts = static_cast< ThreadStreams* >( streams );
+
+    for( int i = 0; i <= Z_BEST_COMPRESSION; ++i )
+    {
+        if( NULL != ts->deflate[ i ] )
+        {
+            deflateEnd( ts->deflate[ i ] );
+            SafeDelete( ts->deflate[ i ] );
+        }
+    }
+
+    if( NULL != ts->inflate )
+    {
+        inflateEnd( ts->inflate );
+        SafeDelete( ts->inflate );
+    }
+
+    delete ts;
+    sThreadStreams = NULL;
+}
+
+#   ifdef HAVE_WINDOWS_H
+static VOID WINAPI _ReleaseThreadStreamsFls( PVOID streams )
+{
+    if( NULL != streams )
+        _ReleaseThreadStreams( streams );
+}
+
+/// Fiber-local slot which releases the streams at thread exit.
+static const DWORD sThreadStreamsIndex = FlsAlloc( _ReleaseThreadStreamsFls );
+#   else /* !HAVE_WINDOWS_H */
+/// Key which releases the streams at thread exit.
+static pthread_key_t sThreadStreamsKey;
+/// Guard of key creation.
+static pthread_once_t sThreadStreamsKeyOnce = PTHREAD_ONCE_INIT;
+
+static void _CreateThreadStreamsKey()
+{
+    pthread_key_create( &sThreadStreamsKey, _ReleaseThreadStreams );
+}
+#   endif /* !HAVE_WINDOWS_H */
+
+/**
+ * @return Streams of calling thread.
+ */
+static ThreadStreams* _GetThreadStreams()
+{
+    if( NULL == sThreadStreams )
+    {
+        ThreadStreams* ts = new ThreadStreams;
+        memset( ts, 0, sizeof( ThreadStreams ) );
+
+#   ifdef HAVE_WINDOWS_H
+        FlsSetValue( sThreadStreamsIndex, ts );
+#   else /* !HAVE_WINDOWS_H */
+        pthread_once( &sThreadStreamsKeyOnce, _CreateThreadStreamsKey );
+        pthread_setspecific( sThreadStreamsKey, ts );
+#   endif /* !HAVE_WINDOWS_H */
+
+        sThreadStreams = ts;
+    }
+
+    return sThreadStreams;
+}
+#endif /* THREAD_LOCAL */
+
+/**
+ * @brief Obtains deflate stream of calling thread.
+ *
+ * @param[in] level Compression level to use.
+ *
+ * @return Reset deflate stream; NULL if initialization failed.
+ */
+static z_stream* _GetDeflateStream( int level )
+{
+    if( Z_DEFAULT_COMPRESSION == level )
+        level = 6; // zlib's default
+    else if( Z_NO_COMPRESSION > level || Z_BEST_COMPRESSION < level )
+        return NULL;
+
+#ifdef THREAD_LOCAL
+    z_stream*& stream = _GetThreadStreams()->deflate[ level ];
+    if( NULL != stream )
+    {
+        if( Z_OK != deflateReset( stream ) )
+            return NULL;
+
+        return stream;
+    }
+#else /* !THREAD_LOCAL */
+    z_stream* stream;
+#endif /* !THREAD_LOCAL */
+
+    stream = new z_stream;
+    memset( stream, 0, sizeof( z_stream ) );
+
+    if( Z_OK != deflateInit( stream, level ) )
+        SafeDelete( stream );
+
+    return stream;
+}
+
+/**
+ * @brief Releases deflate stream obtained by _GetDeflateStream().
+ *
+ * @param[in] stream The stream.
+ */
+static void _PutDeflateStream( z_stream* stream )
+{
+#ifndef THREAD_LOCAL
+    deflateEnd( stream );
+    SafeDelete( stream );
+#endif /* !THREAD_LOCAL */
+}
+
+/**
+ * @brief Obtains inflate stream of calling thread.
+ *
+ * @return Reset inflate stream; NULL if initialization failed.
+ */
+static z_stream* _GetInflateStream()
+{
+#ifdef THREAD_LOCAL
+    z_stream*& stream = _GetThreadStreams()->inflate;
+    if( NULL != stream )
+    {
+        if( Z_OK != inflateReset( stream ) )
+            return NULL;
+
+        return stream;
+    }
+#else /* !THREAD_LOCAL */
+    z_stream* stream;
+#endif /* !THREAD_LOCAL */
+
+    stream = new z_stream;
+    memset( stream, 0, sizeof( z_stream ) );
+
+    if( Z_OK != inflateInit( stream ) )
+        SafeDelete( stream );
+
+    return stream;
+}
+
+/**
+ * @brief Releases inflate stream obtained by _GetInflateStream().
+ *
+ * @param[in] stream The stream.
+ */
+static void _PutInflateStream( z_stream* stream )
+{
+#ifndef THREAD_LOCAL
+    inflateEnd( stream );
+    SafeDelete( stream );
+#endif /* !THREAD_LOCAL */
+}
+
+/**
+ * @brief Inflates given data at given point of buffer.
+ *
+ * @param[in]  input       Pointer to data to be inflated.
+ * @param[in]  inputSize   Length of data to be inflated.
+ * @param[out] output      Destination for inflated data; grown when necessary.
+ * @param[in]  outputIndex Index in @a output where inflated data begin.
+ * @param[out] outputSize  Length of inflated data.
+ * @param[in]  sizeHint    Expected length of inflated data, 0 if unknown.
+ *
+ * @retval true  Inflation ran successfully.
+ * @retval false Failed to inflate data.
+ */
+static bool _InflateAt( const uint8* input, size_t inputSize, Buffer& output, size_t outputIndex, size_t& outputSize, size_t sizeHint )
+{
+    outputSize = 0;
+
+    z_stream* stream = _GetInflateStream();
+    if( NULL == stream )
+        return false;
+
+    stream->next_in = (Bytef*)input;
+    stream->avail_in = (uInt)inputSize;
+
+    // with an exact hint the whole stream inflates in a single call
+    if( output.size() < outputIndex + sizeHint )
+        output.Resize<uint8>( outputIndex + sizeHint );
+
+    int res = Z_OK;
+    while( Z_OK == res )
+    {
+        // grow the output if it's full
+        if( output.size() <= outputIndex + outputSize )
+            output.Resize<uint8>( outputIndex + std::max< size_t >( 2 * std::max( outputSize, inputSize ), 0x100 ) );
+
+        stream->next_out = &output[ outputIndex + outputSize ];
+        stream->avail_out = (uInt)( output.size() - outputIndex - outputSize );
+
+        res = inflate( stream, Z_NO_FLUSH );
+        outputSize = stream->total_out;
+
+        // no progress with room left means truncated input
+        if( Z_BUF_ERROR == res && 0 < stream->avail_out )
+            break;
+        else if( Z_BUF_ERROR == res )
+            res = Z_OK;
+    }
+
+    _PutInflateStream( stream );
+    return ( Z_STREAM_END == res );
+}
+
 bool IsDeflated( const Buffer& data )
 {
     return ( DeflateHeaderByte == data[0] );
 }
 
-bool DeflateData( Buffer& data )
+bool DeflateData( Buffer& data, int level )
 {
     Buffer dataDeflated;
-    if( !DeflateData( data, dataDeflated ) )
+    if( !DeflateData( data, dataDeflated, level ) )
         return false;
 
     data = dataDeflated;
     return true;
 }
 
-bool DeflateData( const Buffer& input, Buffer& output )
+bool DeflateData( const Buffer& input, Buffer& output, int level )
 {
-    const Buffer::iterator<uint8> out = output.end<uint8>();
+    z_stream* stream = _GetDeflateStream( level );
+    if( NULL == stream )
+    {
+        sLog.Error( "Deflate", "Failed to set up deflate stream at level %d.", level );
+        return false;
+    }
 
-    size_t outputSize = compressBound( input.size() );
-    output.ResizeAt( out, outputSize );
+    const size_t outputIndex = output.size();
+    output.Resize<uint8>( outputIndex + deflateBound( stream, input.size() ) );
 
-    int res = compress( &*out, (uLongf*)&outputSize, &input[0], input.size() );
+    stream->next_in = (Bytef*)&input[0];
+    stream->avail_in = (uInt)input.size();
+    stream->next_out = &output[ outputIndex ];
+    stream->avail_out = (uInt)( output.size() - outputIndex );
 
-    if( Z_OK == res )
+    // output is bounded, so the stream always finishes in one go
+    const int res = deflate( stream, Z_FINISH );
+    const size_t outputSize = stream->total_out;
+    _PutDeflateStream( stream );
+
+    if( Z_STREAM_END == res )
     {
-        output.ResizeAt( out, outputSize );
+        output.Resize<uint8>( outputIndex + outputSize );
         return true;
     }
     else
     {
-        output.ResizeAt( out, 0 );
+        sLog.Error( "Deflate", "Failed to deflate %lu bytes: %d.", input.size(), res );
+
+        output.Resize<uint8>( outputIndex );
         return false;
     }
 }
 
-bool InflateData( Buffer& data )
+bool InflateData( Buffer& data, size_t sizeHint )
 {
     Buffer dataInflated;
-    if( !InflateData( data, dataInflated ) )
+    if( !InflateData( data, dataInflated, sizeHint ) )
         return false;
 
     data = dataInflated;
     return true;
 }
 
-bool InflateData( const Buffer& input, Buffer& output )
+bool InflateData( const Buffer& input, Buffer& output, size_t sizeHint )
 {
-    const Buffer::iterator<uint8> out = output.end<uint8>();
+    const size_t outputIndex = output.size();
 
     size_t outputSize = 0;
-    size_t sizeMultiplier = 0;
-
-    int res = 0;
-    do
+    if( !_InflateAt( &input[0], input.size(), output, outputIndex, outputSize, sizeHint ) )
     {
-        outputSize = ( input.size() << ++sizeMultiplier );
-        output.ResizeAt( out, outputSize );
-
-        res = uncompress( &*out, (uLongf*)&outputSize, &input[0], input.size() );
-    } while( Z_BUF_ERROR == res );
-
-    if( Z_OK == res )
-    {
-        output.ResizeAt( out, outputSize );
-        return true;
-    }
-    else
-    {
-        output.ResizeAt( out, 0 );
+        output.Resize<uint8>( outputIndex );
         return false;
     }
+
+    output.Resize<uint8>( outputIndex + outputSize );
+    return true;
+}
+
+bool InflateData( const uint8* input, size_t inputSize, Buffer& output, size_t& outputSize, size_t sizeHint )
+{
+    return _InflateAt( input, inputSize, output, 0, outputSize, sizeHint );
 }
@@ -30,6 +30,11 @@
 
 extern const uint8 DeflateHeaderByte;
 
+/*
+ * All (de)compression below reuses zlib streams kept per thread,
+ * so no zlib state is allocated once a thread has warmed up.
+ */
+
 /**
  * @brief Checks whether given data is deflated.
  *
@@ -43,58 +48,67 @@ bool IsDeflated( const Buffer& data );
 /**
  * @brief Deflates given data.
  *
- * @param[in,out] data Data to be deflated, overwritten by result.
+ * @param[in,out] data  Data to be deflated, overwritten by result.
+ * @param[in]     level Compression level (Z_BEST_SPEED to Z_BEST_COMPRESSION).
  *
  * @retval true  Deflation ran successfully.
  * @retval false Error occurred during deflation.
  */
-bool DeflateData( Buffer& data );
+bool DeflateData( Buffer& data, int level = Z_DEFAULT_COMPRESSION );
 /**
  * @brief Deflates given data.
  *
  * @param[in]  input  Data to be deflated.
  * @param[out] output Destination of deflated data.
+ * @param[in]  level  Compression level (Z_BEST_SPEED to Z_BEST_COMPRESSION).
  *
  * @retval true  Deflation ran successfully.
  * @retval false Error occurred during deflation.
  */
-bool DeflateData( const Buffer& input, Buffer& output );
+bool DeflateData( const Buffer& input, Buffer& output, int level = Z_DEFAULT_COMPRESSION );
 
 /**
  * @brief Inflates given data.
  *
- * @param[in,out] data Data to be inflated, overwritten by result.
+ * @param[in,out] data     Data to be inflated, overwritten by result.
+ * @param[in]     sizeHint Expected length of inflated data, 0 if unknown.
  *
  * @retval true  Inflation ran successfully.
  * @retval false Failed to inflate data.
  */
-bool InflateData( Buffer& data );
+bool InflateData( Buffer& data, size_t sizeHint = 0 );
 /**
  * @brief Inflates given data.
  *
- * One of the key things of the ZLIB stuff is that we 'sometimes'
- * don't know the size of the uncompressed data. My idea is to fix
- * this regarding the first phase of the parsing of the data
- * (the parser) is to go trough a couple of output buffer size.
+ * The data are inflated by a streaming inflate, growing
+ * the output as it fills up, so the size of inflated data
+ * need not be known in advance. If it is, passing it as
+ * @a sizeHint sizes the output exactly up front.
  *
- * The first buffer size would be 2x the initial buffer size,
- * implying that the compression ratio is about 50%.
- * The second buffer size would be 4x the initial buffer size,
- * implying that the compression ratio is about 75%.
- * The third buffer size would be 8x the initial buffer size
- * implying that the compression ratio is about 87.5%.
+ * @param[in]  input    Data to be inflated.
+ * @param[out] output   Destination for inflated data.
+ * @param[in]  sizeHint Expected length of inflated data, 0 if unknown.
  *
- * We would go on in this progress until we find buffer size
- * big enough to hold uncompressed data.
+ * @retval true  Inflation ran successfully.
+ * @retval false Failed to inflate data.
+ */
+bool InflateData( const Buffer& input, Buffer& output, size_t sizeHint = 0 );
+/**
+ * @brief Inflates given data into reusable buffer.
  *
- * This theory is really stupid because there is no way to actually know.
+ * Inflated data are written at beginning of @a output, which
+ * is grown when necessary but never shrunk; this allows the same
+ * buffer to be reused for many inflations without reallocating.
  *
- * @param[in]  input  Data to be inflated.
- * @param[out] output Destination for inflated data.
+ * @param[in]  input      Pointer to data to be inflated.
+ * @param[in]  inputSize  Length of data to be inflated.
+ * @param[out] output     Destination for inflated data.
+ * @param[out] outputSize Length of inflated data.
+ * @param[in]  sizeHint   Expected length of inflated data, 0 if unknown.
  *
  * @retval true  Inflation ran successfully.
  * @retval false Failed to inflate data.
  */
-bool InflateData( const Buffer& input, Buffer& output );
+bool InflateData( const uint8* input, size_t inputSize, Buffer& output, size_t& outputSize, size_t sizeHint = 0 );
 
 #endif
@@ -0,0 +1,135 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-core.h"
+
+#include "utils/MappedFile.h"
+
+/*************************************************************************/
+/* MappedFile                                                            */
+/*************************************************************************/
+MappedFile::MappedFile()
+: mData( NULL ),
+  mSize( 0 )
+#ifdef HAVE_WINDOWS_H
+  , mFile( INVALID_HANDLE_VALUE ),
+  mMapping( NULL )
+#endif /* HAVE_WINDOWS_H */
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef HAVE_WINDOWS_H
+
+bool MappedFile::Open( const char* path )
+{
+    Close();
+
+    mFile = ::CreateFile( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( INVALID_HANDLE_VALUE == mFile )
+        return false;
+
+    LARGE_INTEGER size;
+    if( !::GetFileSizeEx( mFile, &size ) || 0 == size.QuadPart || (uint64)size.QuadPart > (size_t)-1 )
+    {
+        Close();
+        return false;
+    }
+
+    mMapping = ::CreateFileMapping( mFile, NULL, PAGE_READONLY, 0, 0, NULL );
+    if( NULL == mMapping )
+    {
+        Close();
+        return false;
+    }
+
+    mData = static_cast<const uint8*>( ::MapViewOfFile( mMapping, FILE_MAP_READ, 0, 0, 0 ) );
+    if( NULL == mData )
+    {
+        Close();
+        return false;
+    }
+
+    mSize = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if( NULL != mData )
+        ::UnmapViewOfFile( mData );
+    if( NULL != mMapping )
+        ::CloseHandle( mMapping );
+    if( INVALID_HANDLE_VALUE != mFile )
+        ::CloseHandle( mFile );
+
+    mData = NULL;
+    mSize = 0;
+    mMapping = NULL;
+    mFile = INVALID_HANDLE_VALUE;
+}
+
+#else /* !HAVE_WINDOWS_H */
+
+bool MappedFile::Open( const char* path )
+{
+    Close();
+
+    const int fd = ::open( path, O_RDONLY );
+    if( 0 > fd )
+        return false;
+
+    struct stat st;
+    if( 0 != ::fstat( fd, &st ) || 0 >= st.st_size )
+    {
+        ::close( fd );
+        return false;
+    }
+
+    void* data = ::mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    // the mapping stays valid after the descriptor is closed
+    ::close( fd );
+
+    if( MAP_FAILED == data )
+        return false;
+
+    mData = static_cast<const uint8*>( data );
+    mSize = st.st_size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if( NULL != mData )
+        ::munmap( const_cast<uint8*>( mData ), mSize );
+
+    mData = NULL;
+    mSize = 0;
+}
+
+#endif /* !HAVE_WINDOWS_H */
@@ -0,0 +1,73 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __UTILS__MAPPED_FILE_H__INCL__
+#define __UTILS__MAPPED_FILE_H__INCL__
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The mapped pages are shared by all threads (and processes)
+ * reading the same file and are paged in by the OS on demand.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /** @return Pointer to the mapped contents; NULL if not open. */
+    const uint8* data() const { return mData; }
+    /** @return Size of the mapped contents. */
+    size_t size() const { return mSize; }
+    /** @return True if a file is mapped. */
+    bool isOpen() const { return NULL != mData; }
+
+    /**
+     * @brief Maps a file.
+     *
+     * @param[in] path Path to the file.
+     *
+     * @retval true  The file has been mapped.
+     * @retval false Failed to open or map the file, or it is empty.
+     */
+    bool Open( const char* path );
+    /**
+     * @brief Unmaps the file.
+     */
+    void Close();
+
+protected:
+    /// The mapped contents.
+    const uint8* mData;
+    /// Size of the mapped contents.
+    size_t mSize;
+
+#ifdef HAVE_WINDOWS_H
+    HANDLE mFile;
+    HANDLE mMapping;
+#endif /* HAVE_WINDOWS_H */
+};
+
+#endif /* !__UTILS__MAPPED_FILE_H__INCL__ */
@@ -85,6 +85,13 @@ public:
         assert( mRefCount == 0);
     }
 
+    /**
+     * @brief Obtains current reference count of object.
+     *
+     * @return Number of references held to this object.
+     */
+    size_t GetRefCount() const { return mRefCount; }
+
 protected:
     /**
      * @brief Increments reference count of object by one.
@@ -0,0 +1,261 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-core.h"
+
+#include "utils/TickProfiler.h"
+
+const uint64 TickProfiler::HISTOGRAM_BOUNDS[ TickProfiler::HISTOGRAM_BUCKETS - 1 ] =
+{
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 250000, 1000000
+};
+
+TickProfiler::TickProfiler( uint64 budgetUSec, uint64 slowUSec, size_t offenderCount,
+                            size_t windowSize, size_t slowTickCount )
+: mBudgetUSec( budgetUSec ),
+  mSlowUSec( slowUSec ),
+  mOffenderCount( offenderCount ),
+  mWindowSize( windowSize ),
+  mSlowTickCount( slowTickCount ),
+  mTickStart( 0 )
+{
+    Reset();
+}
+
+void TickProfiler::BeginTick()
+{
+    mPhases.clear();
+    mOffenders.clear();
+
+    mTickStart = GetTimeUSec();
+}
+
+bool TickProfiler::EndTick( uint64 usec )
+{
+    ++mTickCount;
+    if( usec > mBudgetUSec )
+        ++mOverBudgetCount;
+
+    // phase totals; there are only a handful of phases
+    std::vector<Phase>::const_iterator cur, end;
+    cur = mPhases.begin();
+    end = mPhases.end();
+    for(; cur != end; ++cur)
+    {
+        std::vector<PhaseStats>::iterator stats = mPhaseStats.begin();
+        for(; stats != mPhaseStats.end(); ++stats)
+        {
+            if( stats->name == cur->name )
+                break;
+        }
+
+        if( stats == mPhaseStats.end() )
+        {
+            PhaseStats newStats;
+            newStats.name = cur->name;
+            newStats.totalUSec = 0;
+            newStats.peakUSec = 0;
+
+            stats = mPhaseStats.insert( mPhaseStats.end(), newStats );
+        }
+
+        stats->totalUSec += cur->usec;
+        stats->peakUSec = std::max( stats->peakUSec, cur->usec );
+    }
+
+    // histogram over the rolling window
+    if( mWindow.size() < mWindowSize )
+        mWindow.push_back( usec );
+    else
+    {
+        --mHistogram[ _GetBucket( mWindow[ mWindowPos ] ) ];
+
+        mWindow[ mWindowPos ] = usec;
+        mWindowPos = ( mWindowPos + 1 ) % mWindowSize;
+    }
+    ++mHistogram[ _GetBucket( usec ) ];
+
+    if( usec <= mSlowUSec )
+    {
+        mPhases.clear();
+        mOffenders.clear();
+        return false;
+    }
+
+    mSlowTicks.push_back( SlowTick() );
+
+    // the tick is over, hand its data to the report
+    SlowTick& slowTick = mSlowTicks.back();
+    slowTick.tick = mTickCount;
+    slowTick.usec = usec;
+    slowTick.phases.swap( mPhases );
+    slowTick.offenders.swap( mOffenders );
+
+    while( mSlowTicks.size() > mSlowTickCount )
+        mSlowTicks.pop_front();
+
+    return true;
+}
+
+void TickProfiler::AddPhase( const char* name, uint64 usec )
+{
+    std::vector<Phase>::iterator cur, end;
+    cur = mPhases.begin();
+    end = mPhases.end();
+    for(; cur != end; ++cur)
+    {
+        if( cur->name == name )
+        {
+            cur->usec += usec;
+            return;
+        }
+    }
+
+    Phase phase;
+    phase.name = name;
+    phase.usec = usec;
+
+    mPhases.push_back( phase );
+}
+
+void TickProfiler::AddSample( const char* kind, uint32 id, uint64 usec )
+{
+    if( mOffenderCount == 0 )
+        return;
+
+    if( mOffenders.size() == mOffenderCount )
+    {
+        if( usec <= mOffenders.back().usec )
+            return;
+
+        mOffenders.pop_back();
+    }
+
+    // keep slowest first; the list is short
+    std::vector<Sample>::iterator pos = mOffenders.begin();
+    while( pos != mOffenders.end() && pos->usec >= usec )
+        ++pos;
+
+    Sample sample;
+    sample.kind = kind;
+    sample.id = id;
+    sample.usec = usec;
+
+    mOffenders.insert( pos, sample );
+}
+
+void TickProfiler::Reset()
+{
+    mPhases.clear();
+    mOffenders.clear();
+
+    mTickCount = 0;
+    mOverBudgetCount = 0;
+    mPhaseStats.clear();
+
+    mWindow.clear();
+    mWindow.reserve( mWindowSize );
+    mWindowPos = 0;
+    for( size_t i = 0; i < HISTOGRAM_BUCKETS; ++i )
+        mHistogram[ i ] = 0;
+
+    mSlowTicks.clear();
+}
+
+void TickProfiler::FormatSummary( std::string& into ) const
+{
+    char line[ 0x100 ];
+
+    snprintf( line, sizeof( line ), "%" PRIu64 " ticks, %" PRIu64 " over the %" PRIu64 " us budget.\n",
+              mTickCount, mOverBudgetCount, mBudgetUSec );
+    into += line;
+
+    if( !mPhaseStats.empty() )
+    {
+        into += "Phases (total ms / average us / peak us):\n";
+
+        std::vector<PhaseStats>::const_iterator cur, end;
+        cur = mPhaseStats.begin();
+        end = mPhaseStats.end();
+        for(; cur != end; ++cur)
+        {
+            snprintf( line, sizeof( line ), "  %-12s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+                      cur->name, cur->totalUSec / 1000, cur->totalUSec / std::max<uint64>( mTickCount, 1 ), cur->peakUSec );
+            into += line;
+        }
+    }
+
+    snprintf( line, sizeof( line ), "Last %lu ticks:\n", (unsigned long)mWindow.size() );
+    into += line;
+
+    for( size_t i = 0; i < HISTOGRAM_BUCKETS; ++i )
+    {
+        if( i + 1 < HISTOGRAM_BUCKETS )
+            snprintf( line, sizeof( line ), "  <= %7.1f ms: %u\n", HISTOGRAM_BOUNDS[ i ] / 1000.0, mHistogram[ i ] );
+        else
+            snprintf( line, sizeof( line ), "   > %7.1f ms: %u\n", HISTOGRAM_BOUNDS[ i - 1 ] / 1000.0, mHistogram[ i ] );
+        into += line;
+    }
+
+    snprintf( line, sizeof( line ), "%lu slow ticks (> %" PRIu64 " us) kept.\n",
+              (unsigned long)mSlowTicks.size(), mSlowUSec );
+    into += line;
+}
+
+void TickProfiler::FormatSlowTick( const SlowTick& slowTick, std::string& into )
+{
+    char line[ 0x100 ];
+
+    snprintf( line, sizeof( line ), "Tick %" PRIu64 " took %" PRIu64 " us:", slowTick.tick, slowTick.usec );
+    into += line;
+
+    std::vector<Phase>::const_iterator phase = slowTick.phases.begin();
+    for(; phase != slowTick.phases.end(); ++phase)
+    {
+        snprintf( line, sizeof( line ), " %s %" PRIu64 " us;", phase->name, phase->usec );
+        into += line;
+    }
+
+    if( !slowTick.offenders.empty() )
+        into += " slowest:";
+
+    std::vector<Sample>::const_iterator sample = slowTick.offenders.begin();
+    for(; sample != slowTick.offenders.end(); ++sample)
+    {
+        snprintf( line, sizeof( line ), " %s %u %" PRIu64 " us%s", sample->kind, sample->id, sample->usec,
+                  ( sample + 1 == slowTick.offenders.end() ) ? "" : "," );
+        into += line;
+    }
+}
+
+size_t TickProfiler::_GetBucket( uint64 usec )
+{
+    for( size_t i = 0; i + 1 < HISTOGRAM_BUCKETS; ++i )
+    {
+        if( usec <= HISTOGRAM_BOUNDS[ i ] )
+            return i;
+    }
+
+    return HISTOGRAM_BUCKETS - 1;
+}
@@ -0,0 +1,239 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __UTILS__TICK_PROFILER_H__INCL__
+#define __UTILS__TICK_PROFILER_H__INCL__
+
+#include "utils/utils_time.h"
+
+/**
+ * @brief Collects timings of the server main loop.
+ *
+ * Each tick is split into named phases, and inside phases
+ * into samples of individual objects (a system, a client).
+ * The profiler keeps totals per phase, a histogram of tick
+ * durations over a rolling window, the number of ticks which
+ * blew the budget and, for every tick slower than the slow
+ * threshold, a report with its phases and top offenders.
+ *
+ * Phase and sample kind names must be string literals (or
+ * otherwise outlive the profiler); they are compared by
+ * pointer, not by contents.
+ */
+class TickProfiler
+{
+public:
+    /// Number of histogram buckets; the last one is open-ended.
+    static const size_t HISTOGRAM_BUCKETS = 10;
+    /// Upper bounds of the histogram buckets, in microseconds.
+    static const uint64 HISTOGRAM_BOUNDS[ HISTOGRAM_BUCKETS - 1 ];
+
+    /**
+     * @brief Time spent in a phase.
+     */
+    struct Phase
+    {
+        const char* name;
+        uint64 usec;
+    };
+
+    /**
+     * @brief Time spent on a single object.
+     */
+    struct Sample
+    {
+        const char* kind;
+        uint32 id;
+        uint64 usec;
+    };
+
+    /**
+     * @brief Totals of a phase since the last reset.
+     */
+    struct PhaseStats
+    {
+        const char* name;
+        uint64 totalUSec;
+        uint64 peakUSec;
+    };
+
+    /**
+     * @brief Report of a tick which exceeded the slow threshold.
+     */
+    struct SlowTick
+    {
+        uint64 tick;                    ///< Number of the tick since the last reset.
+        uint64 usec;
+        std::vector<Phase> phases;
+        std::vector<Sample> offenders;  ///< Slowest samples, slowest first.
+    };
+
+    /**
+     * @brief Measures a phase for the lifetime of the object.
+     */
+    class ScopedPhase
+    {
+    public:
+        ScopedPhase( TickProfiler& profiler, const char* name )
+        : mProfiler( profiler ), mName( name ), mStart( GetTimeUSec() ) {}
+        ~ScopedPhase() { mProfiler.AddPhase( mName, GetTimeUSec() - mStart ); }
+
+    protected:
+        TickProfiler& mProfiler;
+        const char* const mName;
+        const uint64 mStart;
+    };
+
+    /**
+     * @brief Measures a sample for the lifetime of the object.
+     */
+    class ScopedSample
+    {
+    public:
+        ScopedSample( TickProfiler& profiler, const char* kind, uint32 id )
+        : mProfiler( profiler ), mKind( kind ), mID( id ), mStart( GetTimeUSec() ) {}
+        ~ScopedSample() { mProfiler.AddSample( mKind, mID, GetTimeUSec() - mStart ); }
+
+    protected:
+        TickProfiler& mProfiler;
+        const char* const mKind;
+        const uint32 mID;
+        const uint64 mStart;
+    };
+
+    /**
+     * @param[in] budgetUSec     Duration a tick should not exceed.
+     * @param[in] slowUSec       Duration above which a tick is reported.
+     * @param[in] offenderCount  Number of slowest samples kept per tick.
+     * @param[in] windowSize     Number of ticks the histogram covers.
+     * @param[in] slowTickCount  Number of slow tick reports kept.
+     */
+    TickProfiler( uint64 budgetUSec, uint64 slowUSec, size_t offenderCount = 5,
+                  size_t windowSize = 6000, size_t slowTickCount = 8 );
+
+    /** @return Duration above which a tick is reported. */
+    uint64 GetSlowThreshold() const { return mSlowUSec; }
+    /** @param[in] usec Duration above which a tick is reported. */
+    void SetSlowThreshold( uint64 usec ) { mSlowUSec = usec; }
+
+    /**
+     * @brief Starts timing a new tick.
+     */
+    void BeginTick();
+    /**
+     * @brief Ends the tick started by BeginTick().
+     *
+     * @retval true  The tick was slow; its report is GetSlowTicks().back().
+     * @retval false The tick was not slow.
+     */
+    bool EndTick() { return EndTick( GetTimeUSec() - mTickStart ); }
+    /**
+     * @brief Ends the current tick, which took given time.
+     *
+     * @param[in] usec Duration of the tick.
+     *
+     * @retval true  The tick was slow; its report is GetSlowTicks().back().
+     * @retval false The tick was not slow.
+     */
+    bool EndTick( uint64 usec );
+
+    /**
+     * @brief Adds time spent in a phase of the current tick.
+     *
+     * @param[in] name Name of the phase.
+     * @param[in] usec Time spent.
+     */
+    void AddPhase( const char* name, uint64 usec );
+    /**
+     * @brief Adds time spent on an object in the current tick.
+     *
+     * @param[in] kind Kind of the object (e.g. "system").
+     * @param[in] id   ID of the object.
+     * @param[in] usec Time spent.
+     */
+    void AddSample( const char* kind, uint32 id, uint64 usec );
+
+    /** @return Number of ticks since the last reset. */
+    uint64 GetTickCount() const { return mTickCount; }
+    /** @return Number of ticks over budget since the last reset. */
+    uint64 GetOverBudgetCount() const { return mOverBudgetCount; }
+    /** @return Number of ticks in the histogram window. */
+    size_t GetWindowCount() const { return mWindow.size(); }
+    /** @return Number of ticks in the window which fell into the bucket. */
+    uint32 GetHistogram( size_t bucket ) const { return mHistogram[ bucket ]; }
+    /** @return Totals of all phases seen since the last reset. */
+    const std::vector<PhaseStats>& GetPhaseStats() const { return mPhaseStats; }
+    /** @return Reports of the last slow ticks, oldest first. */
+    const std::deque<SlowTick>& GetSlowTicks() const { return mSlowTicks; }
+
+    /**
+     * @brief Drops all collected data.
+     */
+    void Reset();
+
+    /**
+     * @brief Formats a summary of the collected data.
+     *
+     * @param[out] into Where to append the summary.
+     */
+    void FormatSummary( std::string& into ) const;
+    /**
+     * @brief Formats a slow tick report.
+     *
+     * @param[in]  slowTick The report.
+     * @param[out] into     Where to append the text.
+     */
+    static void FormatSlowTick( const SlowTick& slowTick, std::string& into );
+
+protected:
+    /// @return Index of the histogram bucket of a tick duration.
+    static size_t _GetBucket( uint64 usec );
+
+    const uint64 mBudgetUSec;
+    uint64 mSlowUSec;
+    const size_t mOffenderCount;
+    const size_t mWindowSize;
+    const size_t mSlowTickCount;
+
+    /// When the current tick started.
+    uint64 mTickStart;
+    /// Phases of the current tick.
+    std::vector<Phase> mPhases;
+    /// Slowest samples of the current tick, slowest first.
+    std::vector<Sample> mOffenders;
+
+    uint64 mTickCount;
+    uint64 mOverBudgetCount;
+    std::vector<PhaseStats> mPhaseStats;
+
+    /// Durations of the last ticks, a ring of up to mWindowSize entries.
+    std::vector<uint64> mWindow;
+    /// Where the next duration goes once the ring is full.
+    size_t mWindowPos;
+    uint32 mHistogram[ HISTOGRAM_BUCKETS ];
+
+    std::deque<SlowTick> mSlowTicks;
+};
+
+#endif /* !__UTILS__TICK_PROFILER_H__INCL__ */
@@ -71,3 +71,27 @@ uint64 Win32TimeNow() {
     return(UnixTimeToWin32Time(time(NULL), 0));
 #endif /* !HAVE_WINDOWS_H */
 }
+
+uint64 GetTimeUSec()
+{
+#if defined( HAVE_WINDOWS_H )
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &count );
+
+    return ( count.QuadPart / freq.QuadPart ) * 1000000
+         + ( count.QuadPart % freq.QuadPart ) * 1000000 / freq.QuadPart;
+#elif defined( CLOCK_MONOTONIC )
+    timespec ts;
+    ::clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return uint64( ts.tv_sec ) * 1000000
+         + ts.tv_nsec / 1000;
+#else /* !CLOCK_MONOTONIC */
+    timeval tv;
+    ::gettimeofday( &tv, NULL );
+
+    return uint64( tv.tv_sec ) * 1000000
+         + tv.tv_usec;
+#endif /* !CLOCK_MONOTONIC */
+}
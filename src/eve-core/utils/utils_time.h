@@ -46,4 +46,14 @@ extern uint64 Win32TimeNow();
 extern void Win32TimeToUnixTime( uint64 win32t, time_t &unix_time, uint32 &nsec );
 extern std::string Win32TimeToString(uint64 win32t);
 
+/**
+ * @brief Obtains time from a monotonic clock.
+ *
+ * Only differences between two values are meaningful;
+ * intended for measuring how long things take.
+ *
+ * @return Time in microseconds.
+ */
+extern uint64 GetTimeUSec();
+
 #endif /* !__UTILS_TIME_H__INCL__ */
@@ -0,0 +1,99 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-loadgen.h"
+
+#include "LatencyStats.h"
+
+/**
+ * @brief Obtains percentile of sorted samples.
+ *
+ * @param[in] samples Sorted samples; must not be empty.
+ * @param[in] pct     Percentile to obtain (0 - 100).
+ */
+static uint64 _Percentile( const std::vector<uint64>& samples, double pct )
+{
+    // nearest-rank method
+    size_t rank = (size_t)ceil( pct / 100.0 * samples.size() );
+    if( 0 < rank )
+        --rank;
+
+    return samples[ std::min( rank, samples.size() - 1 ) ];
+}
+
+void LatencyStats::AddSample( const std::string& phase, uint64 usec )
+{
+    _GetPhase( phase ).samples.push_back( usec );
+}
+
+void LatencyStats::AddFailure( const std::string& phase )
+{
+    ++_GetPhase( phase ).failures;
+}
+
+void LatencyStats::Report( FILE* into )
+{
+    fprintf( into, "%-20s %8s %8s %10s %10s %10s %10s %10s\n",
+             "phase", "ok", "failed", "p50 [ms]", "p90 [ms]", "p99 [ms]", "max [ms]", "mean [ms]" );
+
+    std::vector<std::string>::const_iterator cur, end;
+    cur = mOrder.begin();
+    end = mOrder.end();
+    for(; cur != end; ++cur )
+    {
+        Phase& phase = mPhases[ *cur ];
+        std::vector<uint64>& samples = phase.samples;
+
+        if( samples.empty() )
+        {
+            fprintf( into, "%-20s %8u %8u %10s %10s %10s %10s %10s\n",
+                     cur->c_str(), 0, phase.failures, "-", "-", "-", "-", "-" );
+            continue;
+        }
+
+        std::sort( samples.begin(), samples.end() );
+
+        uint64 sum = 0;
+        for( size_t i = 0; i < samples.size(); ++i )
+            sum += samples[ i ];
+
+        fprintf( into, "%-20s %8lu %8u %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                 cur->c_str(), (unsigned long)samples.size(), phase.failures,
+                 _Percentile( samples, 50 ) / 1000.0,
+                 _Percentile( samples, 90 ) / 1000.0,
+                 _Percentile( samples, 99 ) / 1000.0,
+                 samples.back() / 1000.0,
+                 (double)sum / samples.size() / 1000.0 );
+    }
+}
+
+LatencyStats::Phase& LatencyStats::_GetPhase( const std::string& name )
+{
+    std::map<std::string, Phase>::iterator res = mPhases.find( name );
+    if( mPhases.end() != res )
+        return res->second;
+
+    mOrder.push_back( name );
+    return mPhases[ name ];
+}
@@ -0,0 +1,85 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __LATENCY_STATS_H__INCL__
+#define __LATENCY_STATS_H__INCL__
+
+/**
+ * @brief Collects latency samples per phase.
+ *
+ * Samples are kept in full, so the percentiles
+ * reported are exact.
+ */
+class LatencyStats
+{
+public:
+    /**
+     * @brief Records successful request.
+     *
+     * @param[in] phase Phase the request belongs to.
+     * @param[in] usec  Latency of the request in microseconds.
+     */
+    void AddSample( const std::string& phase, uint64 usec );
+    /**
+     * @brief Records failed request.
+     *
+     * @param[in] phase Phase the request belongs to.
+     */
+    void AddFailure( const std::string& phase );
+
+    /**
+     * @brief Prints report of all phases.
+     *
+     * @param[in] into File to print the report to.
+     */
+    void Report( FILE* into );
+
+protected:
+    /// Samples of one phase.
+    struct Phase
+    {
+        Phase() : failures( 0 ) {}
+
+        /// Latencies of successful requests, in microseconds.
+        std::vector<uint64> samples;
+        /// Count of failed requests.
+        uint32 failures;
+    };
+
+    /**
+     * @brief Obtains phase of given name, creating it if necessary.
+     *
+     * Phases are reported in order of their first appearance.
+     *
+     * @param[in] name Name of phase.
+     */
+    Phase& _GetPhase( const std::string& name );
+
+    /// Names of phases in order of appearance.
+    std::vector<std::string> mOrder;
+    /// The phases.
+    std::map<std::string, Phase> mPhases;
+};
+
+#endif /* !__LATENCY_STATS_H__INCL__ */
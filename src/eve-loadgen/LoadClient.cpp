@@ -0,0 +1,464 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-loadgen.h"
+
+#include "LatencyStats.h"
+#include "LoadClient.h"
+
+LoadClient::LoadClient( uint32 index, const LoadAccount& account, const LoadScript& script, LatencyStats& stats, uint32 timeoutMs )
+: mIndex( index ),
+  mAccount( account ),
+  mScript( script ),
+  mStats( stats ),
+  mTimeoutUSec( uint64( timeoutMs ) * 1000 ),
+  mState( STATE_DISCONNECTED ),
+  mStepStart( 0 ),
+  mUserID( 0 ),
+  mNextCommand( 0 ),
+  mPhase( "script" ),
+  mPendingCall( 0 ),
+  mLastCallID( 0 ),
+  mSleepUntil( 0 )
+{
+    char buf[ 16 ];
+    snprintf( buf, sizeof( buf ), "%u", mIndex );
+
+    mVars[ "client" ] = buf;
+    mVars[ "user" ] = "'" + mAccount.name + "'";
+    if( !mAccount.characterID.empty() )
+        mVars[ "char" ] = mAccount.characterID;
+}
+
+bool LoadClient::Connect( uint32 ip, uint16 port )
+{
+    mStepStart = GetTimeUSec();
+
+    char errbuf[ TCPCONN_ERRBUF_SIZE ];
+    if( !mNet.Connect( ip, port, errbuf ) )
+    {
+        _Fail( "connect", "%s", errbuf );
+        return false;
+    }
+
+    _StepDone( "connect" );
+    mState = STATE_VERSION;
+
+    return true;
+}
+
+bool LoadClient::Process()
+{
+    if( IsFinished() || STATE_DISCONNECTED == mState )
+        return false;
+
+    bool progress = false;
+
+    PyRep* rep;
+    while( !IsFinished() && NULL != ( rep = mNet.PopRep() ) )
+    {
+        _HandleRep( rep );
+        progress = true;
+    }
+
+    if( STATE_SCRIPT == mState && 0 == mPendingCall )
+    {
+        const size_t nextCommand = mNextCommand;
+        _RunScript();
+        progress = progress || ( nextCommand != mNextCommand );
+    }
+
+    if( IsFinished() )
+        return true;
+
+    const char* phase = NULL;
+    switch( mState )
+    {
+        case STATE_VERSION:   phase = "version";      break;
+        case STATE_CRYPTO:    phase = "crypto";       break;
+        case STATE_LOGIN:     phase = "login";        break;
+        case STATE_HANDSHAKE: phase = "handshake";    break;
+        default:              phase = mPhase.c_str(); break;
+    }
+
+    if( TCPConnection::STATE_CONNECTED != mNet.GetState() )
+        _Fail( phase, "Connection lost." );
+    else if( ( STATE_SCRIPT != mState || 0 != mPendingCall )
+             && mTimeoutUSec < GetTimeUSec() - mStepStart )
+        _Fail( phase, "Request timed out." );
+
+    return progress;
+}
+
+void LoadClient::_HandleRep( PyRep* rep )
+{
+    switch( mState )
+    {
+        case STATE_VERSION:
+        {
+            VersionExchangeServer server;
+            if( !server.Decode( &rep ) )
+            {
+                _Fail( "version", "Invalid version exchange." );
+                return;
+            }
+
+            _StepDone( "version" );
+
+            VersionExchangeClient version;
+            version.birthday = server.birthday;
+            version.macho_version = server.macho_version;
+            version.user_count = server.user_count;
+            version.version_number = server.version_number;
+            version.build_version = server.build_version;
+            version.project_version = server.project_version;
+
+            rep = version.Encode();
+            mNet.QueueRep( rep );
+            PyDecRef( rep );
+
+            NetCommand_VK vk;
+            vk.vipKey = "";
+
+            rep = vk.Encode();
+            mNet.QueueRep( rep );
+            PyDecRef( rep );
+
+            CryptoRequestPacket cr;
+            cr.keyVersion = "placebo";
+            cr.keyParams = new PyDict;
+
+            rep = cr.Encode();
+            mNet.QueueRep( rep );
+            PyDecRef( rep );
+
+            mState = STATE_CRYPTO;
+        } break;
+
+        case STATE_CRYPTO:
+        {
+            const bool ok = ( rep->IsString() && "OK CC" == rep->AsString()->content() );
+            PyDecRef( rep );
+
+            if( !ok )
+            {
+                _Fail( "crypto", "Placebo crypto not accepted." );
+                return;
+            }
+
+            _StepDone( "crypto" );
+
+            std::string hash;
+            if( !PasswordModule::GeneratePassHash( mAccount.name, mAccount.password, hash ) )
+            {
+                _Fail( "login", "Failed to generate password hash." );
+                return;
+            }
+
+            CryptoChallengePacket ccp;
+            ccp.clientChallenge = "";
+            ccp.macho_version = MachoNetVersion;
+            ccp.boot_version = EVEVersionNumber;
+            ccp.boot_build = EVEBuildVersion;
+            ccp.boot_codename = EVEProjectCodename;
+            ccp.boot_region = EVEProjectRegion;
+            ccp.user_name = mAccount.name;
+            ccp.user_password_hash = hash;
+            ccp.user_languageid = "EN";
+            ccp.user_affiliateid = 0;
+
+            rep = ccp.Encode();
+            mNet.QueueRep( rep );
+            PyDecRef( rep );
+
+            mState = STATE_LOGIN;
+        } break;
+
+        case STATE_LOGIN:
+        {
+            // password version comes first
+            if( rep->IsInt() )
+            {
+                PyDecRef( rep );
+                return;
+            }
+
+            CryptoServerHandshake shake;
+            if( !shake.Decode( &rep ) )
+            {
+                _Fail( "login", "Login of account '%s' rejected.", mAccount.name.c_str() );
+                return;
+            }
+
+            _StepDone( "login" );
+
+            CryptoHandshakeResult result;
+            result.challenge_responsehash = shake.challenge_responsehash;
+            result.func_output = "";
+            result.func_result = new PyNone;
+
+            rep = result.Encode();
+            mNet.QueueRep( rep );
+            PyDecRef( rep );
+
+            mState = STATE_HANDSHAKE;
+        } break;
+
+        case STATE_HANDSHAKE:
+        {
+            CryptoHandshakeAck ack;
+            if( !ack.Decode( &rep ) )
+            {
+                _Fail( "handshake", "Invalid handshake acknowledgement." );
+                return;
+            }
+
+            _StepDone( "handshake" );
+
+            mUserID = ack.userid;
+
+            char buf[ 16 ];
+            snprintf( buf, sizeof( buf ), "%u", mUserID );
+            mVars[ "userid" ] = buf;
+
+            mState = STATE_SCRIPT;
+        } break;
+
+        case STATE_SCRIPT:
+        {
+            PyPacket* packet = new PyPacket;
+            if( packet->Decode( &rep ) )
+                _HandlePacket( packet );
+            else
+                sLog.Warning( "LoadClient", "Client %u: Failed to decode packet.", mIndex );
+
+            SafeDelete( packet );
+        } break;
+
+        default:
+        {
+            PyDecRef( rep );
+        } break;
+    }
+}
+
+void LoadClient::_HandlePacket( PyPacket* packet )
+{
+    if( 0 == mPendingCall || packet->dest.callID != mPendingCall )
+        // notifications, session changes etc.
+        return;
+
+    if( ERRORRESPONSE == packet->type )
+    {
+        sLog.Warning( "LoadClient", "Client %u: Call %" PRIu64 " in phase '%s' raised an exception.", mIndex, mPendingCall, mPhase.c_str() );
+
+        mStats.AddFailure( mPhase );
+        mPendingCall = 0;
+        mPendingBind.clear();
+        return;
+    }
+    else if( CALL_RSP != packet->type )
+        return;
+
+    if( !mPendingBind.empty() )
+    {
+        // ( BoundObject, None ) in a substream
+        PyRep* result = NULL;
+        if( NULL != packet->payload && 0 < packet->payload->size()
+            && packet->payload->GetItem( 0 )->IsSubStream() )
+        {
+            PySubStream* ss = packet->payload->GetItem( 0 )->AsSubStream();
+            ss->DecodeData();
+            result = ss->decoded();
+        }
+
+        BoundObject bound;
+        if( NULL == result || !result->IsTuple() || 0 == result->AsTuple()->size()
+            || !bound.Decode( result->AsTuple()->GetItem( 0 ) ) )
+        {
+            _Fail( mPhase.c_str(), "Invalid bind response." );
+            return;
+        }
+
+        mVars[ mPendingBind ] = "'" + bound.bindspec + "'";
+    }
+
+    _StepDone( mPhase.c_str() );
+
+    mPendingCall = 0;
+    mPendingBind.clear();
+}
+
+void LoadClient::_RunScript()
+{
+    const std::vector<LoadCommand>& commands = mScript.commands();
+
+    while( 0 == mPendingCall && !IsFinished() )
+    {
+        if( 0 != mSleepUntil )
+        {
+            if( GetTimeUSec() < mSleepUntil )
+                return;
+            mSleepUntil = 0;
+        }
+
+        if( commands.size() <= mNextCommand )
+        {
+            mState = STATE_DONE;
+            mNet.Disconnect();
+            return;
+        }
+
+        const LoadCommand& cmd = commands[ mNextCommand++ ];
+        switch( cmd.type )
+        {
+            case LoadCommand::CMD_PHASE:
+            {
+                mPhase = cmd.name;
+            } break;
+
+            case LoadCommand::CMD_SLEEP:
+            {
+                mSleepUntil = GetTimeUSec() + uint64( cmd.sleepMs ) * 1000;
+            } break;
+
+            case LoadCommand::CMD_CALL:
+            case LoadCommand::CMD_BIND:
+            {
+                PyTuple* args = LoadScript::ParseArgs( LoadScript::Substitute( cmd.args, mVars ) );
+                if( NULL == args )
+                {
+                    _Fail( mPhase.c_str(), "Script line %u: malformed arguments.", cmd.line );
+                    return;
+                }
+
+                if( LoadCommand::CMD_BIND == cmd.type )
+                {
+                    // a single argument is the bind parameter itself
+                    PyRep* bindParams = args;
+                    if( 1 == args->size() )
+                    {
+                        bindParams = args->GetItem( 0 );
+                        PyIncRef( bindParams );
+                        PyDecRef( args );
+                    }
+
+                    // MachoBindObject( bindParams, None )
+                    PyTuple* bindArgs = new PyTuple( 2 );
+                    bindArgs->SetItem( 0, bindParams );
+                    bindArgs->SetItem( 1, new PyNone );
+
+                    mPendingBind = cmd.name;
+                    _SendCall( cmd.service, false, "MachoBindObject", bindArgs );
+                }
+                else if( '$' == cmd.service[0] )
+                {
+                    LoadScript::VarMap::const_iterator res = mVars.find( cmd.service.substr( 1 ) );
+                    if( mVars.end() == res || res->second.size() < 2 )
+                    {
+                        PyDecRef( args );
+                        _Fail( mPhase.c_str(), "Script line %u: nothing bound to '%s'.", cmd.line, cmd.service.c_str() );
+                        return;
+                    }
+
+                    // strip the quotes
+                    _SendCall( res->second.substr( 1, res->second.size() - 2 ), true, cmd.method, args );
+                }
+                else
+                    _SendCall( cmd.service, false, cmd.method, args );
+            } break;
+        }
+    }
+}
+
+void LoadClient::_SendCall( const std::string& service, bool bound, const std::string& method, PyTuple* args )
+{
+    PyCallStream call;
+    if( bound )
+    {
+        call.remoteObject = 0;
+        call.remoteObjectStr = service;
+    }
+    else
+        call.remoteObject = 1;
+    call.method = method;
+    call.arg_tuple = args;
+
+    // Encode() gives ( ( flag, substream ), channel ); the packet wants just the first
+    PyTuple* encoded = call.Encode();
+
+    PyPacket* packet = new PyPacket;
+    packet->type_string = "macho.CallReq";
+    packet->type = CALL_REQ;
+
+    packet->source.type = PyAddress::Client;
+    packet->source.typeID = mUserID;
+    packet->source.callID = ++mLastCallID;
+
+    packet->dest.type = PyAddress::Any;
+    packet->dest.service = ( bound ? "" : service );
+
+    packet->userid = mUserID;
+
+    packet->payload = new PyTuple( 1 );
+    packet->payload->SetItem( 0, encoded->GetItem( 0 ) );
+    PyIncRef( encoded->GetItem( 0 ) );
+    PyDecRef( encoded );
+
+    PyRep* rep = packet->Encode();
+    SafeDelete( packet );
+
+    mPendingCall = mLastCallID;
+    mStepStart = GetTimeUSec();
+
+    mNet.QueueRep( rep );
+    PyDecRef( rep );
+}
+
+void LoadClient::_StepDone( const char* phase )
+{
+    const uint64 now = GetTimeUSec();
+
+    mStats.AddSample( phase, now - mStepStart );
+    mStepStart = now;
+}
+
+void LoadClient::_Fail( const char* phase, const char* fmt, ... )
+{
+    va_list ap;
+    va_start( ap, fmt );
+
+    char msg[ 512 ];
+    vsnprintf( msg, sizeof( msg ), fmt, ap );
+
+    va_end( ap );
+
+    sLog.Error( "LoadClient", "Client %u failed in phase '%s': %s", mIndex, phase, msg );
+
+    mStats.AddFailure( phase );
+    mState = STATE_FAILED;
+    mPendingCall = 0;
+
+    mNet.Disconnect();
+}
@@ -0,0 +1,185 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __LOAD_CLIENT_H__INCL__
+#define __LOAD_CLIENT_H__INCL__
+
+#include "LoadScript.h"
+
+class LatencyStats;
+
+/**
+ * @brief Credentials of one simulated client.
+ */
+struct LoadAccount
+{
+    /// Account name.
+    std::string name;
+    /// Account password.
+    std::string password;
+    /// Character to use; available to scripts as <code>$char</code>.
+    std::string characterID;
+};
+
+/**
+ * @brief A simulated client.
+ *
+ * Speaks the client side of the handshake EVEClientSession
+ * expects (version exchange, placebo crypto, login, handshake
+ * result), then replays a LoadScript. Every step is timed and
+ * recorded into LatencyStats; the handshake steps are recorded
+ * under phases "connect", "version", "crypto", "login" and
+ * "handshake".
+ *
+ * The client never blocks (except in Connect()); Process()
+ * merely advances it as far as received data allow, so many
+ * clients may be driven from a single thread.
+ */
+class LoadClient
+{
+public:
+    /// States of simulated client.
+    enum State
+    {
+        STATE_DISCONNECTED, ///< Not connected yet.
+        STATE_VERSION,      ///< Waiting for version exchange.
+        STATE_CRYPTO,       ///< Waiting for crypto acceptance.
+        STATE_LOGIN,        ///< Waiting for login result.
+        STATE_HANDSHAKE,    ///< Waiting for handshake acknowledgement.
+        STATE_SCRIPT,       ///< Replaying script.
+        STATE_DONE,         ///< Script finished.
+        STATE_FAILED        ///< Something went wrong; see log.
+    };
+
+    /**
+     * @param[in] index     Index of client; available to scripts as <code>$client</code>.
+     * @param[in] account   Credentials to log in with.
+     * @param[in] script    Script to replay.
+     * @param[in] stats     Where to record latencies.
+     * @param[in] timeoutMs Time after which pending request is considered failed.
+     */
+    LoadClient( uint32 index, const LoadAccount& account, const LoadScript& script, LatencyStats& stats, uint32 timeoutMs );
+
+    /** @return Current state. */
+    State GetState() const { return mState; }
+    /** @return True if client finished, successfully or not. */
+    bool IsFinished() const { return ( STATE_DONE == mState || STATE_FAILED == mState ); }
+
+    /**
+     * @brief Connects to server.
+     *
+     * @param[in] ip   Address of server.
+     * @param[in] port Port of server.
+     *
+     * @retval true  Connection established.
+     * @retval false Connection failed.
+     */
+    bool Connect( uint32 ip, uint16 port );
+
+    /**
+     * @brief Advances the client.
+     *
+     * @retval true  Some progress has been made.
+     * @retval false Nothing to do right now.
+     */
+    bool Process();
+
+protected:
+    /**
+     * @brief Processes received rep according to current state.
+     *
+     * @param[in] rep Received rep; consumed.
+     */
+    void _HandleRep( PyRep* rep );
+    /**
+     * @brief Processes received packet while replaying script.
+     *
+     * @param[in] packet Received packet.
+     */
+    void _HandlePacket( PyPacket* packet );
+    /**
+     * @brief Executes script commands until a request is pending or the script ends.
+     */
+    void _RunScript();
+    /**
+     * @brief Sends a call request.
+     *
+     * @param[in] service Service to call; bindspec if @a bound.
+     * @param[in] bound   Whether a bound object is called.
+     * @param[in] method  Method to call.
+     * @param[in] args    Arguments; consumed.
+     */
+    void _SendCall( const std::string& service, bool bound, const std::string& method, PyTuple* args );
+
+    /**
+     * @brief Closes current phase step.
+     *
+     * @param[in] phase Phase of step.
+     */
+    void _StepDone( const char* phase );
+    /**
+     * @brief Fails the client.
+     *
+     * @param[in] phase Phase which failed.
+     * @param[in] fmt   Format of error message.
+     */
+    void _Fail( const char* phase, const char* fmt, ... );
+
+    /// Index of client.
+    const uint32 mIndex;
+    /// Credentials.
+    const LoadAccount mAccount;
+    /// Script being replayed.
+    const LoadScript& mScript;
+    /// Where latencies go.
+    LatencyStats& mStats;
+    /// Request timeout.
+    const uint64 mTimeoutUSec;
+
+    /// Connection to server.
+    EVETCPConnection mNet;
+    /// Current state.
+    State mState;
+    /// When current step started.
+    uint64 mStepStart;
+
+    /// Variables available to script.
+    LoadScript::VarMap mVars;
+    /// Account ID assigned by server.
+    uint32 mUserID;
+    /// Index of next script command.
+    size_t mNextCommand;
+    /// Phase of script being replayed.
+    std::string mPhase;
+    /// Call ID of pending request, 0 if none.
+    uint64 mPendingCall;
+    /// Variable to store bindspec to, if pending request is a bind.
+    std::string mPendingBind;
+    /// Last call ID used.
+    uint64 mLastCallID;
+    /// Time until which the script sleeps.
+    uint64 mSleepUntil;
+};
+
+#endif /* !__LOAD_CLIENT_H__INCL__ */
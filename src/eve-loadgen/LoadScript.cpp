@@ -0,0 +1,339 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-loadgen.h"
+
+#include "LoadScript.h"
+
+/**
+ * @brief Skips whitespace.
+ *
+ * @param[in,out] cur Current position in text.
+ * @param[in]     end End of text.
+ */
+static void _SkipSpace( const char*& cur, const char* end )
+{
+    while( cur < end && isspace( (unsigned char)*cur ) )
+        ++cur;
+}
+
+/**
+ * @brief Checks whether text at current position starts with given word.
+ *
+ * @param[in] cur  Current position in text.
+ * @param[in] end  End of text.
+ * @param[in] word Word to check for.
+ */
+static bool _StartsWith( const char* cur, const char* end, const char* word )
+{
+    const size_t len = strlen( word );
+    return ( (size_t)( end - cur ) >= len && 0 == strncmp( cur, word, len ) );
+}
+
+bool LoadScript::Load( const char* filename )
+{
+    FILE* file = fopen( filename, "r" );
+    if( NULL == file )
+    {
+        sLog.Error( "LoadScript", "Unable to open script '%s'.", filename );
+        return false;
+    }
+
+    mCommands.clear();
+
+    bool result = true;
+    uint32 lineNo = 0;
+    char line[ 4096 ];
+    while( NULL != fgets( line, sizeof( line ), file ) )
+    {
+        ++lineNo;
+
+        // split off the command word
+        std::string text( line );
+        std::string::size_type pos = text.find_first_not_of( " \t\r\n" );
+        if( std::string::npos == pos || '#' == text[ pos ] )
+            continue;
+        text = text.substr( pos, text.find_last_not_of( " \t\r\n" ) + 1 - pos );
+
+        std::istringstream str( text );
+        std::string word;
+        str >> word;
+
+        LoadCommand cmd;
+        cmd.sleepMs = 0;
+        cmd.line = lineNo;
+
+        if( "phase" == word )
+        {
+            cmd.type = LoadCommand::CMD_PHASE;
+            str >> cmd.name;
+        }
+        else if( "call" == word )
+        {
+            cmd.type = LoadCommand::CMD_CALL;
+            str >> cmd.service >> cmd.method;
+        }
+        else if( "bind" == word )
+        {
+            cmd.type = LoadCommand::CMD_BIND;
+            str >> cmd.name >> cmd.service;
+        }
+        else if( "sleep" == word )
+        {
+            cmd.type = LoadCommand::CMD_SLEEP;
+            str >> cmd.sleepMs;
+        }
+        else
+        {
+            sLog.Error( "LoadScript", "%s:%u: Unknown command '%s'.", filename, lineNo, word.c_str() );
+            result = false;
+            continue;
+        }
+
+        if( str.fail() )
+        {
+            sLog.Error( "LoadScript", "%s:%u: Missing arguments of command '%s'.", filename, lineNo, word.c_str() );
+            result = false;
+            continue;
+        }
+
+        if( LoadCommand::CMD_CALL == cmd.type || LoadCommand::CMD_BIND == cmd.type )
+        {
+            std::getline( str, cmd.args );
+            if( cmd.args.find_first_not_of( " \t" ) == std::string::npos )
+                cmd.args = "()";
+
+            // check syntax now rather than in every client
+            PyTuple* args = ParseArgs( Substitute( cmd.args, VarMap() ) );
+            if( NULL == args )
+            {
+                sLog.Error( "LoadScript", "%s:%u: Malformed arguments '%s'.", filename, lineNo, cmd.args.c_str() );
+                result = false;
+                continue;
+            }
+            PyDecRef( args );
+        }
+
+        mCommands.push_back( cmd );
+    }
+
+    fclose( file );
+    return result;
+}
+
+std::string LoadScript::Substitute( const std::string& text, const VarMap& vars )
+{
+    std::string result;
+    result.reserve( text.size() );
+
+    std::string::size_type pos = 0;
+    while( pos < text.size() )
+    {
+        if( '$' != text[ pos ] )
+        {
+            result += text[ pos++ ];
+            continue;
+        }
+
+        std::string::size_type end = pos + 1;
+        while( end < text.size() && ( isalnum( (unsigned char)text[ end ] ) || '_' == text[ end ] ) )
+            ++end;
+
+        VarMap::const_iterator res = vars.find( text.substr( pos + 1, end - pos - 1 ) );
+        if( vars.end() != res )
+            result += res->second;
+        else
+            // unknown variables stand for None, so syntax may be checked without them
+            result += "None";
+
+        pos = end;
+    }
+
+    return result;
+}
+
+PyTuple* LoadScript::ParseArgs( const std::string& text )
+{
+    const char* cur = text.c_str();
+    const char* end = cur + text.size();
+
+    _SkipSpace( cur, end );
+    if( cur == end || '(' != *cur )
+        return NULL;
+    ++cur;
+
+    std::vector<PyRep*> items;
+    if( !_ParseItems( cur, end, ')', items ) )
+        return NULL;
+
+    _SkipSpace( cur, end );
+    if( cur != end )
+    {
+        for( size_t i = 0; i < items.size(); ++i )
+            PyDecRef( items[ i ] );
+        return NULL;
+    }
+
+    PyTuple* tuple = new PyTuple( items.size() );
+    for( size_t i = 0; i < items.size(); ++i )
+        tuple->SetItem( i, items[ i ] );
+
+    return tuple;
+}
+
+PyRep* LoadScript::_ParseValue( const char*& cur, const char* end )
+{
+    _SkipSpace( cur, end );
+    if( cur == end )
+        return NULL;
+
+    if( '(' == *cur || '[' == *cur )
+    {
+        const char close = ( '(' == *cur ? ')' : ']' );
+        ++cur;
+
+        std::vector<PyRep*> items;
+        if( !_ParseItems( cur, end, close, items ) )
+            return NULL;
+
+        if( ')' == close )
+        {
+            PyTuple* tuple = new PyTuple( items.size() );
+            for( size_t i = 0; i < items.size(); ++i )
+                tuple->SetItem( i, items[ i ] );
+            return tuple;
+        }
+        else
+        {
+            PyList* list = new PyList;
+            for( size_t i = 0; i < items.size(); ++i )
+                list->AddItem( items[ i ] );
+            return list;
+        }
+    }
+
+    bool wide = false;
+    if( 'u' == *cur && cur + 1 < end && ( '\'' == cur[1] || '"' == cur[1] ) )
+    {
+        wide = true;
+        ++cur;
+    }
+
+    if( '\'' == *cur || '"' == *cur )
+    {
+        const char quote = *cur++;
+        const char* first = cur;
+        while( cur < end && quote != *cur )
+            ++cur;
+        if( cur == end )
+            return NULL;
+
+        const std::string str( first, cur - first );
+        ++cur;
+
+        if( wide )
+            return new PyWString( str );
+        else
+            return new PyString( str );
+    }
+
+    if( _StartsWith( cur, end, "None" ) )
+    {
+        cur += 4;
+        return new PyNone;
+    }
+    if( _StartsWith( cur, end, "True" ) )
+    {
+        cur += 4;
+        return new PyBool( true );
+    }
+    if( _StartsWith( cur, end, "False" ) )
+    {
+        cur += 5;
+        return new PyBool( false );
+    }
+
+    // number
+    const char* first = cur;
+    if( cur < end && ( '-' == *cur || '+' == *cur ) )
+        ++cur;
+    bool real = false;
+    while( cur < end && ( isdigit( (unsigned char)*cur ) || '.' == *cur || 'e' == *cur || 'E' == *cur ) )
+    {
+        if( !isdigit( (unsigned char)*cur ) )
+            real = true;
+        ++cur;
+    }
+    if( first == cur )
+        return NULL;
+
+    const std::string num( first, cur - first );
+    if( real )
+        return new PyFloat( str2<double>( num ) );
+
+    const int64 value = str2<int64>( num );
+    if( cur < end && 'L' == *cur )
+    {
+        ++cur;
+        return new PyLong( value );
+    }
+    else if( INT_MIN <= value && value <= INT_MAX )
+        return new PyInt( (int32)value );
+    else
+        return new PyLong( value );
+}
+
+bool LoadScript::_ParseItems( const char*& cur, const char* end, char close, std::vector<PyRep*>& into )
+{
+    std::vector<PyRep*> items;
+
+    _SkipSpace( cur, end );
+    while( cur < end && close != *cur )
+    {
+        PyRep* item = _ParseValue( cur, end );
+        if( NULL == item )
+            break;
+        items.push_back( item );
+
+        _SkipSpace( cur, end );
+        if( cur < end && ',' == *cur )
+        {
+            ++cur;
+            _SkipSpace( cur, end );
+        }
+        else if( cur < end && close != *cur )
+            break;
+    }
+
+    if( cur == end || close != *cur )
+    {
+        for( size_t i = 0; i < items.size(); ++i )
+            PyDecRef( items[ i ] );
+        return false;
+    }
+    ++cur;
+
+    into.insert( into.end(), items.begin(), items.end() );
+    return true;
+}
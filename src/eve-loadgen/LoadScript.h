@@ -0,0 +1,141 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __LOAD_SCRIPT_H__INCL__
+#define __LOAD_SCRIPT_H__INCL__
+
+class PyRep;
+class PyTuple;
+
+/**
+ * @brief One step of a load script.
+ */
+struct LoadCommand
+{
+    enum Type
+    {
+        CMD_PHASE, ///< Following steps are timed under @a name.
+        CMD_CALL,  ///< Call @a method of @a service with @a args.
+        CMD_BIND,  ///< Bind @a service with @a args, store bindspec to variable @a name.
+        CMD_SLEEP  ///< Wait for @a sleepMs milliseconds.
+    };
+
+    /// Type of command.
+    Type type;
+    /// Phase name (CMD_PHASE) or variable name (CMD_BIND).
+    std::string name;
+    /// Service name or bindspec variable (CMD_CALL, CMD_BIND).
+    std::string service;
+    /// Method name (CMD_CALL).
+    std::string method;
+    /// Argument tuple literal; variables are substituted per client.
+    std::string args;
+    /// Sleep duration (CMD_SLEEP).
+    uint32 sleepMs;
+    /// Line in script, for error reporting.
+    uint32 line;
+};
+
+/**
+ * @brief Sequence of calls replayed by each simulated client.
+ *
+ * The script is a text file with one command per line:
+ * @code
+ * # comment
+ * phase <name>
+ * call  <service> <method> <args>
+ * bind  <variable> <service> <args>
+ * sleep <milliseconds>
+ * @endcode
+ * where <args> is a Python-like tuple literal, e.g.
+ * <code>( 1, 'abc', u'wide', 12L, 1.5, None, [ True ] )</code>.
+ * A <service> of <code>$variable</code> calls the object bound
+ * into the variable by a previous <code>bind</code>. Variables
+ * (<code>$name</code>) are substituted in <args> before parsing.
+ */
+class LoadScript
+{
+public:
+    /// Type of variable map.
+    typedef std::map<std::string, std::string> VarMap;
+
+    /**
+     * @brief Loads script from file.
+     *
+     * @param[in] filename Name of script file.
+     *
+     * @retval true  Load succeeded.
+     * @retval false Load failed; errors have been logged.
+     */
+    bool Load( const char* filename );
+
+    /** @return Loaded commands. */
+    const std::vector<LoadCommand>& commands() const { return mCommands; }
+
+    /**
+     * @brief Substitutes variables in given text.
+     *
+     * @param[in] text Text with <code>$name</code> references.
+     * @param[in] vars Variables to substitute.
+     *
+     * @return Text with variables substituted.
+     */
+    static std::string Substitute( const std::string& text, const VarMap& vars );
+    /**
+     * @brief Parses tuple literal.
+     *
+     * @param[in] text Literal to be parsed.
+     *
+     * @return Parsed tuple; NULL if parsing failed.
+     */
+    static PyTuple* ParseArgs( const std::string& text );
+
+protected:
+    /**
+     * @brief Parses single literal value.
+     *
+     * @param[in,out] cur Current position in text; advanced past the value.
+     * @param[in]     end End of text.
+     *
+     * @return Parsed value; NULL if parsing failed.
+     */
+    static PyRep* _ParseValue( const char*& cur, const char* end );
+    /**
+     * @brief Parses items of a tuple or list literal.
+     *
+     * @param[in,out] cur   Current position in text, just after the opening bracket.
+     * @param[in]     end   End of text.
+     * @param[in]     close Closing bracket.
+     * @param[out]    into  Parsed items; caller owns them.
+     *
+     * @retval true  Parsing succeeded.
+     * @retval false Parsing failed; nothing is stored.
+     */
+    static bool _ParseItems( const char*& cur, const char* end, char close, std::vector<PyRep*>& into );
+
+    /// The commands.
+    std::vector<LoadCommand> mCommands;
+};
+
+#endif /* !__LOAD_SCRIPT_H__INCL__ */
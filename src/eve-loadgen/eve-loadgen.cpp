@@ -0,0 +1,251 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-loadgen.h"
+
+#include <fstream>
+
+#include "LatencyStats.h"
+#include "LoadClient.h"
+#include "LoadScript.h"
+
+const char* const LOG_FILE =          EVEMU_ROOT "/log/eve-loadgen.log";
+const char* const LOG_SETTINGS_FILE = EVEMU_ROOT "/etc/log.ini";
+
+/**
+ * @brief Prints usage.
+ */
+static void PrintUsage()
+{
+    fprintf( stderr,
+        "Usage: eve-loadgen [options] <script>\n"
+        "\n"
+        "Logs many simulated clients into a server at once and replays <script>\n"
+        "from each of them, reporting per-phase latency percentiles.\n"
+        "\n"
+        "Options:\n"
+        "  -s <host>     Server to connect to (default 127.0.0.1).\n"
+        "  -P <port>     Port to connect to (default 26000).\n"
+        "  -n <count>    Number of simulated clients (default 1).\n"
+        "  -r <rate>     Clients to start per second, 0 for all at once (default 0).\n"
+        "  -u <pattern>  Account name pattern, %%u is replaced by client index\n"
+        "                (default 'loadtest%%u').\n"
+        "  -p <password> Password of generated accounts (default 'loadtest').\n"
+        "  -a <file>     File with lines '<account> <password> [<characterID>]';\n"
+        "                overrides -u and -p, cycled if shorter than -n.\n"
+        "  -t <seconds>  Request timeout (default 60).\n" );
+}
+
+/**
+ * @brief Loads accounts from file.
+ *
+ * @param[in]  filename Name of file.
+ * @param[out] into     Where to store the accounts.
+ *
+ * @retval true  Load succeeded.
+ * @retval false Load failed.
+ */
+static bool LoadAccounts( const char* filename, std::vector<LoadAccount>& into )
+{
+    std::ifstream file( filename );
+    if( !file )
+    {
+        sLog.Error( "init", "Unable to open account file '%s'.", filename );
+        return false;
+    }
+
+    std::string line;
+    while( std::getline( file, line ) )
+    {
+        std::istringstream str( line );
+
+        LoadAccount account;
+        if( !( str >> account.name >> account.password ) || '#' == account.name[0] )
+            continue;
+        str >> account.characterID;
+
+        into.push_back( account );
+    }
+
+    if( into.empty() )
+    {
+        sLog.Error( "init", "No accounts in account file '%s'.", filename );
+        return false;
+    }
+
+    return true;
+}
+
+int main( int argc, char* argv[] )
+{
+#if defined( HAVE_CRTDBG_H ) && !defined( NDEBUG )
+    // Under Visual Studio setup memory leak detection
+    _CrtSetDbgFlag( _CRTDBG_LEAK_CHECK_DF | _CrtSetDbgFlag( _CRTDBG_REPORT_FLAG ) );
+#endif /* defined( HAVE_CRTDBG_H ) && !defined( NDEBUG ) */
+
+    // Load server log settings ( will be removed )
+    if( !load_log_settings( LOG_SETTINGS_FILE ) )
+        sLog.Warning( "init", "Unable to read %s (this file is optional)", LOG_SETTINGS_FILE );
+    else
+        sLog.Success( "init", "Log settings loaded from %s", LOG_SETTINGS_FILE );
+
+    if( !log_open_logfile( LOG_FILE ) )
+        sLog.Warning( "init", "Unable to open log file '%s', only logging to the screen now.", LOG_FILE );
+    else
+        sLog.Success( "init", "Opened log file %s", LOG_FILE );
+
+    std::string host = "127.0.0.1";
+    uint16 port = 26000;
+    uint32 clientCount = 1;
+    uint32 rate = 0;
+    std::string pattern = "loadtest%u";
+    std::string password = "loadtest";
+    const char* accountFile = NULL;
+    uint32 timeout = 60;
+    const char* scriptFile = NULL;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg( argv[ i ] );
+
+        if( 2 == arg.size() && '-' == arg[0] && i + 1 < argc )
+        {
+            const char* value = argv[ ++i ];
+
+            switch( arg[1] )
+            {
+                case 's': host = value;                       break;
+                case 'P': port = str2<uint16>( value );       break;
+                case 'n': clientCount = str2<uint32>( value ); break;
+                case 'r': rate = str2<uint32>( value );       break;
+                case 'u': pattern = value;                    break;
+                case 'p': password = value;                   break;
+                case 'a': accountFile = value;                break;
+                case 't': timeout = str2<uint32>( value );    break;
+                default:  PrintUsage();                       return 1;
+            }
+        }
+        else if( NULL == scriptFile && '-' != arg[0] )
+            scriptFile = argv[ i ];
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if( NULL == scriptFile || 0 == clientCount )
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    LoadScript script;
+    if( !script.Load( scriptFile ) )
+        return 1;
+
+    std::vector<LoadAccount> accounts;
+    if( NULL != accountFile )
+    {
+        if( !LoadAccounts( accountFile, accounts ) )
+            return 1;
+    }
+    else
+    {
+        for( uint32 i = 0; i < clientCount; ++i )
+        {
+            char name[ 256 ];
+            snprintf( name, sizeof( name ), pattern.c_str(), i );
+
+            LoadAccount account;
+            account.name = name;
+            account.password = password;
+
+            accounts.push_back( account );
+        }
+    }
+
+    char errbuf[ 1024 ];
+    const uint32 ip = ResolveIP( host.c_str(), errbuf );
+    if( 0 == ip )
+    {
+        sLog.Error( "init", "Unable to resolve '%s': %s", host.c_str(), errbuf );
+        return 1;
+    }
+
+    LatencyStats stats;
+
+    std::vector<LoadClient*> clients;
+    for( uint32 i = 0; i < clientCount; ++i )
+        clients.push_back( new LoadClient( i, accounts[ i % accounts.size() ], script, stats, timeout * 1000 ) );
+
+    sLog.Log( "main", "Starting %u clients against %s:%u.", clientCount, host.c_str(), port );
+
+    const uint64 start = GetTimeUSec();
+    uint32 started = 0;
+    uint32 finished = 0;
+
+    while( finished < clientCount )
+    {
+        const uint64 now = GetTimeUSec();
+        bool progress = false;
+
+        // start clients as the rate allows
+        while( started < clientCount
+               && ( 0 == rate || uint64( started ) * 1000000 <= ( now - start ) * rate ) )
+        {
+            clients[ started++ ]->Connect( ip, port );
+            progress = true;
+        }
+
+        finished = 0;
+        for( uint32 i = 0; i < started; ++i )
+        {
+            if( clients[ i ]->Process() )
+                progress = true;
+
+            if( clients[ i ]->IsFinished() )
+                ++finished;
+        }
+
+        if( !progress )
+            Sleep( 1 );
+    }
+
+    const double elapsed = ( GetTimeUSec() - start ) / 1000000.0;
+
+    uint32 failed = 0;
+    for( uint32 i = 0; i < clientCount; ++i )
+    {
+        if( LoadClient::STATE_FAILED == clients[ i ]->GetState() )
+            ++failed;
+
+        SafeDelete( clients[ i ] );
+    }
+
+    printf( "\n%u clients, %u failed, %.2f s total\n\n", clientCount, failed, elapsed );
+    stats.Report( stdout );
+
+    return ( 0 == failed ? 0 : 2 );
+}
@@ -30,6 +30,7 @@
 #include "PyBoundObject.h"
 #include "chat/LSCService.h"
 #include "imageserver/ImageServer.h"
+#include "map/UniverseMgr.h"
 #include "npc/NPC.h"
 #include "ship/DestinyManager.h"
 #include "ship/ShipOperatorInterface.h"
@@ -50,6 +51,7 @@ Client::Client(PyServiceMgr &services, EVETCPConnection** con)
   m_moveTimer(500),
   m_movePoint(0, 0, 0),
   m_timeEndTrain(0),
+  m_loginVerified(false),
   m_destinyEventQueue( new PyList ),
   m_destinyUpdateQueue( new PyList ),
   m_nextNotifySequence(1)
@@ -70,6 +72,9 @@ Client::Client(PyServiceMgr &services, EVETCPConnection** con)
 }
 
 Client::~Client() {
+    //drop our login if it is still queued.
+    sLoginQueue.Remove( this );
+
     if( GetChar() ) {
         // we have valid character
 
@@ -108,6 +113,20 @@ Client::~Client() {
 
     PyDecRef( m_destinyEventQueue );
     PyDecRef( m_destinyUpdateQueue );
+
+    std::map<uint32, ItemChange>::iterator cur, end;
+    cur = m_queuedItemChanges.begin();
+    end = m_queuedItemChanges.end();
+    for(; cur != end; cur++)
+    {
+        PyDecRef( cur->second.itemRow );
+
+        std::map<int32, PyRep*>::iterator cCur, cEnd;
+        cCur = cur->second.changes.begin();
+        cEnd = cur->second.changes.end();
+        for(; cCur != cEnd; cCur++)
+            PyDecRef( cCur->second );
+    }
 }
 
 bool Client::ProcessNet()
@@ -587,6 +606,8 @@ void Client::_UpdateSession( const CharacterConstRef& character )
 
     if (IsInSpace())
         mSession.SetInt("shipid", GetShipID());
+
+    m_services.entity_list.UpdateOccupancy( this );
 }
 
 
@@ -673,9 +694,11 @@ void Client::_UpdateSession2( uint32 characterID )
         m_char->SetActiveShip(m_shipId);
     if (IsInSpace())
         mSession.SetInt( "shipid", shipID );
+
+    m_services.entity_list.UpdateOccupancy( this );
 }
 
-void Client::_SendCallReturn( const PyAddress& source, uint64 callID, PyRep** return_value, const char* channel )
+void Client::_SendCallReturn( const PyAddress& source, uint64 callID, PyRep** return_value, const char* channel, bool encoded )
 {
     //build the packet:
     PyPacket* p = new PyPacket;
@@ -691,7 +714,10 @@ void Client::_SendCallReturn( const PyAddress& source, uint64 callID, PyRep** re
     p->userid = GetAccountID();
 
     p->payload = new PyTuple(1);
-    p->payload->SetItem( 0, new PySubStream( *return_value ) );
+    if( encoded )
+        p->payload->SetItem( 0, *return_value );
+    else
+        p->payload->SetItem( 0, new PySubStream( *return_value ) );
     *return_value = NULL;   //consumed
 
     if(channel != NULL)
@@ -700,7 +726,8 @@ void Client::_SendCallReturn( const PyAddress& source, uint64 callID, PyRep** re
         p->named_payload->SetItemString( "channel", new PyString( channel ) );
     }
 
-    FastQueuePacket( &p );
+    // encoded results carry their own deflated data
+    FastQueuePacket( &p, !encoded );
 }
 
 void Client::_SendException( const PyAddress& source, uint64 callID, MACHONETMSG_TYPE in_response_to, MACHONETERR_TYPE exception_type, PyRep** payload )
@@ -733,6 +760,8 @@ void Client::_SendSessionChange()
     if( !mSession.isDirty() )
         return;
 
+    m_services.entity_list.UpdateOccupancy( this );
+
     SessionChangeNotification scn;
     scn.changes = new PyDict;
 
@@ -870,21 +899,115 @@ void Client::_SendPingResponse( const PyAddress& source, uint64 callID )
 //easily provide us with our own copy of the data.
 void Client::QueueDestinyUpdate(PyTuple **du)
 {
-    DoDestinyAction act;
-    act.update_id = DestinyManager::GetStamp();
-    act.update = *du;
+    // same as DoDestinyAction, with the stamp shared by the whole tick
+    PyTuple* act = new PyTuple( 2 );
+    act->SetItem( 0, DestinyManager::GetStampRep() );
+    act->SetItem( 1, *du );
     *du = NULL;
 
-    m_destinyUpdateQueue->AddItem( act.Encode() );
+    m_destinyUpdateQueue->AddItem( act );
 }
 
 void Client::QueueDestinyEvent(PyTuple** multiEvent)
 {
-    m_destinyEventQueue->AddItem( *multiEvent );
+    if( !_MergeAttributeChange( *multiEvent ) )
+        m_destinyEventQueue->AddItem( *multiEvent );
     *multiEvent = NULL;
 }
 
+bool Client::_MergeAttributeChange(PyTuple* change)
+{
+    // ( "OnModuleAttributeChange", ownerID, itemKey, attributeID, time, newValue, oldValue )
+    if( change->size() != 7 )
+        return false;
+
+    PyRep* name = change->GetItem( 0 );
+    PyRep* item = change->GetItem( 2 );
+    PyRep* attr = change->GetItem( 3 );
+    if( !name->IsString() || name->AsString()->content() != "OnModuleAttributeChange"
+        || !item->IsInt() || !attr->IsInt() )
+        return false;
+
+    const std::pair<uint32, uint32> key( item->AsInt()->value(), attr->AsInt()->value() );
+
+    std::map<std::pair<uint32, uint32>, size_t>::iterator res = m_queuedAttributeChanges.find( key );
+    if( res != m_queuedAttributeChanges.end() )
+    {
+        PyTuple* queued = m_destinyEventQueue->GetItem( res->second )->AsTuple();
+        if( queued->GetRefCount() == 1 )
+        {
+            // the queued event keeps its place and its old value,
+            // it takes over the time and the new value.
+            PyIncRef( change->GetItem( 4 ) );
+            queued->SetItem( 4, change->GetItem( 4 ) );
+            PyIncRef( change->GetItem( 5 ) );
+            queued->SetItem( 5, change->GetItem( 5 ) );
+
+            PyDecRef( change );
+            return true;
+        }
+    }
+
+    // the event is appended by the caller
+    m_queuedAttributeChanges[ key ] = m_destinyEventQueue->size();
+    return false;
+}
+
+void Client::QueueItemChange(uint32 itemID, PyRep* itemRow, std::map<int32, PyRep*>& changes)
+{
+    std::map<uint32, ItemChange>::iterator res = m_queuedItemChanges.find( itemID );
+    if( res == m_queuedItemChanges.end() )
+    {
+        ItemChange change;
+        change.itemRow = itemRow;
+        change.changes = changes;
+        changes.clear();
+
+        m_queuedItemChanges.insert( std::make_pair( itemID, change ) );
+        m_queuedItemChangeOrder.push_back( itemID );
+        return;
+    }
+
+    // take the latest row, keep the oldest value of every column
+    PyDecRef( res->second.itemRow );
+    res->second.itemRow = itemRow;
+
+    std::map<int32, PyRep*>::iterator cur, end;
+    cur = changes.begin();
+    end = changes.end();
+    for(; cur != end; cur++)
+    {
+        if( !res->second.changes.insert( *cur ).second )
+            PyDecRef( cur->second );
+    }
+    changes.clear();
+}
+
+void Client::_SendQueuedItemChanges()
+{
+    std::vector<uint32>::const_iterator cur, end;
+    cur = m_queuedItemChangeOrder.begin();
+    end = m_queuedItemChangeOrder.end();
+    for(; cur != end; cur++)
+    {
+        std::map<uint32, ItemChange>::iterator res = m_queuedItemChanges.find( *cur );
+
+        NotifyOnItemChange change;
+        change.itemRow = res->second.itemRow;
+        change.changes = res->second.changes;
+
+        PyTuple* tmp = change.Encode();  //this is consumed below
+        SendNotification( "OnItemChange", "charid", &tmp, false ); //unsequenced.
+    }
+
+    m_queuedItemChanges.clear();
+    m_queuedItemChangeOrder.clear();
+}
+
 void Client::_SendQueuedUpdates() {
+    // item changes go first, attribute changes may refer to their new state
+    _SendQueuedItemChanges();
+
     if( !m_destinyUpdateQueue->empty() )
     {
         DoDestinyUpdateMain dum;
@@ -901,10 +1024,16 @@ void Client::_SendQueuedUpdates() {
         //I haven't found it yet
         dum.waitForBubble = false;
 
-        //now send it
-        PyTuple* t = dum.Encode();
-        t->Dump(DESTINY__UPDATES, "");
-        SendNotification( "DoDestinyUpdate", "clientID", &t );
+        if( is_log_enabled( DESTINY__UPDATES ) )
+        {
+            PyTuple* t = dum.Encode();
+            t->Dump(DESTINY__UPDATES, "");
+            PyDecRef( t );
+        }
+
+        //now send it, marshaled straight from the queues
+        PySubStream* ss = EVENotificationStream::EncodeArgs( dum );
+        SendNotification( "DoDestinyUpdate", "clientID", &ss );
     }
     else if( !m_destinyEventQueue->empty() )
     {
@@ -914,15 +1043,37 @@ void Client::_SendQueuedUpdates() {
         nom.events = m_destinyEventQueue;
         PyIncRef( m_destinyEventQueue );
 
+        if( is_log_enabled( DESTINY__UPDATES ) )
+        {
+            PyTuple* t = nom.Encode();
+            t->Dump(DESTINY__UPDATES, "");
+            PyDecRef( t );
+        }
+
         //send it
-        PyTuple* t = nom.Encode();   //this is consumed below
-        t->Dump(DESTINY__UPDATES, "");
-        SendNotification( "OnMultiEvent", "charid", &t );
+        PySubStream* ss = EVENotificationStream::EncodeArgs( nom );   //this is consumed below
+        SendNotification( "OnMultiEvent", "charid", &ss );
     } //else nothing to be sent ...
 
-    // clear the queues now, after the packets have been sent
-    m_destinyEventQueue->clear();
-    m_destinyUpdateQueue->clear();
+    // reuse the queues now, after the packets have been sent
+    _ResetQueue( m_destinyEventQueue );
+    _ResetQueue( m_destinyUpdateQueue );
+    m_queuedAttributeChanges.clear();
+}
+
+void Client::_ResetQueue( PyList*& queue )
+{
+    if( queue->GetRefCount() == 1 )
+    {
+        // keeps the storage for the next tick
+        queue->clear();
+    }
+    else
+    {
+        // still referenced by a packet which has not been marshaled yet
+        PyDecRef( queue );
+        queue = new PyList;
+    }
 }
 
 void Client::SendNotification(const char *notifyType, const char *idType, PyTuple **payload, bool seq) {
@@ -942,8 +1093,28 @@ void Client::SendNotification(const char *notifyType, const char *idType, PyTupl
     SendNotification(dest, notify, seq);
 }
 
+void Client::SendNotification(const char *notifyType, const char *idType, PySubStream **stream, bool seq) {
+    PySubStream *ss = *stream;
+    *stream = NULL;    //consumed
+
+    if(ss == NULL) {
+        sLog.Error("Client", "%s: Failed to encode notify of type %s.", GetName(), notifyType);
+        return;
+    }
+
+    PyAddress dest;
+    dest.type = PyAddress::Broadcast;
+    dest.service = notifyType;
+    dest.bcast_idtype = idType;
+
+    _SendNotification(dest, EVENotificationStream::Encode(ss), seq);
+}
 
 void Client::SendNotification(const PyAddress &dest, EVENotificationStream &noti, bool seq) {
+    _SendNotification(dest, noti.Encode(), seq);
+}
+
+void Client::_SendNotification(const PyAddress &dest, PyTuple *payload, bool seq) {
 
     //build the packet:
     PyPacket *p = new PyPacket();
@@ -957,7 +1128,7 @@ void Client::SendNotification(const PyAddress &dest, EVENotificationStream &noti
 
     p->userid = GetAccountID();
 
-    p->payload = noti.Encode();
+    p->payload = payload;
 
     if(seq) {
         p->named_payload = new PyDict();
@@ -1025,7 +1196,12 @@ void Client::StargateJump(uint32 fromGate, uint32 toGate) {
     }
 
     //TODO: verify that they are actually close to 'fromGate'
-    //TODO: verify that 'fromGate' actually jumps to 'toGate'
+
+    uint32 destGate, destSystemID;
+    if(sUniverse.GetStargateJump(fromGate, destGate, destSystemID) && destGate != toGate) {
+        sLog.Error("Client","%s: Stargate %u does not lead to stargate %u.", GetName(), fromGate, toGate);
+        return;
+    }
 
     uint32 solarSystemID, constellationID, regionID;
     GPoint position;
@@ -1238,8 +1414,8 @@ void Client::TargetLost(SystemEntity *who)
     multi.events = new PyList;
     multi.events->AddItem( te.Encode() );
 
-    PyTuple* tmp = multi.Encode();   //this is consumed below
-    SendNotification("OnMultiEvent", "clientID", &tmp);
+    PySubStream* ss = EVENotificationStream::EncodeArgs( multi );   //this is consumed below
+    SendNotification("OnMultiEvent", "clientID", &ss);
 }
 
 void Client::TargetedAdd(SystemEntity *who) {
@@ -1252,8 +1428,8 @@ void Client::TargetedAdd(SystemEntity *who) {
     multi.events = new PyList;
     multi.events->AddItem( te.Encode() );
 
-    PyTuple* tmp = multi.Encode();   //this is consumed below
-    SendNotification("OnMultiEvent", "clientID", &tmp);
+    PySubStream* ss = EVENotificationStream::EncodeArgs( multi );   //this is consumed below
+    SendNotification("OnMultiEvent", "clientID", &ss);
 }
 
 void Client::TargetedLost(SystemEntity *who)
@@ -1267,8 +1443,8 @@ void Client::TargetedLost(SystemEntity *who)
     multi.events = new PyList;
     multi.events->AddItem( te.Encode() );
 
-    PyTuple* tmp = multi.Encode();   //this is consumed below
-    SendNotification("OnMultiEvent", "clientID", &tmp);
+    PySubStream* ss = EVENotificationStream::EncodeArgs( multi );   //this is consumed below
+    SendNotification("OnMultiEvent", "clientID", &ss);
 }
 
 void Client::TargetsCleared()
@@ -1282,8 +1458,8 @@ void Client::TargetsCleared()
     multi.events = new PyList;
     multi.events->AddItem( te.Encode() );
 
-    PyTuple* tmp = multi.Encode();   //this is consumed below
-    SendNotification("OnMultiEvent", "clientID", &tmp);
+    PySubStream* ss = EVENotificationStream::EncodeArgs( multi );   //this is consumed below
+    SendNotification("OnMultiEvent", "clientID", &ss);
 }
 
 void Client::SavePosition() {
@@ -1566,83 +1742,65 @@ bool Client::_VerifyCrypto( CryptoRequestPacket& cr )
     }
 }
 
-bool Client::_VerifyLogin( CryptoChallengePacket& ccp )
+uint32 Client::_GetQueuePosition()
 {
-    std::string account_hash;
-    std::string transport_closed_msg = "LoginAuthFailed";
-
-    AccountInfo account_info;
-    CryptoServerHandshake server_shake;
+    //we have made it through the queue.
+    if( m_loginVerified )
+        return 1;
 
-    /* send passwordVersion required: 1=plain, 2=hashed */
-    PyRep* rsp = new PyInt( 2 );
+    return sLoginQueue.GetPosition( this );
+}
 
+bool Client::_VerifyLogin( CryptoChallengePacket& ccp )
+{
     //sLog.Debug("Client","%s: Received Client Challenge.", GetAddress().c_str());
     //sLog.Debug("Client","Login with %s:", ccp.user_name.c_str());
 
-    if (!services().serviceDB().GetAccountInformation( ccp.user_name.c_str(),  account_info)) {
-        goto error_login_auth_failed;
-    }
+    /* the credentials are checked off the main loop; we carry on in OnLoginVerified */
+    sLoginQueue.Enqueue( this, ccp.user_name, ccp.user_password_hash, ccp.user_languageid );
 
-    /* check wether the account has been banned and if so send the semi correct message */
-    if (account_info.banned) {
-        transport_closed_msg = "ACCOUNTBANNED";
-        goto error_login_auth_failed;
-    }
+    return true;
+}
 
-    /* if we have stored a password we need to create a hash from the username and pass and remove the pass */
-    if( account_info.password.empty() )
-        account_hash = account_info.hash;
-    else
+void Client::OnLoginVerified( const LoginQueue::Result& result )
+{
+    if( !result.success )
     {
-        /* here we generate the password hash ourselves */
-        std::string password_hash;
-        if( !PasswordModule::GeneratePassHash(
-                ccp.user_name,
-                account_info.password,
-                password_hash ) )
-        {
-            sLog.Error("Client", "unable to generate password hash, sending LoginAuthFailed");
-            goto error_login_auth_failed;
-        }
-
-        if( !services().serviceDB().UpdateAccountHash(
-                ccp.user_name.c_str(),
-                password_hash ) )
-        {
-            sLog.Error("Client", "unable to update account hash, sending LoginAuthFailed");
-            goto error_login_auth_failed;
-        }
+        std::string transport_closed_msg = result.failure;
+        GPSTransportClosed* except = new GPSTransportClosed( transport_closed_msg );
+        mNet->QueueRep( except );
+        PyDecRef( except );
 
-        account_hash = password_hash;
+        // let the client try again
+        _ExpectLogin();
+        return;
     }
 
-    /* here we check if the user successfully entered his password or if he failed */
-    if (account_hash != ccp.user_password_hash) {
-        goto error_login_auth_failed;
-    }
+    const AccountInfo& account_info = result.account;
 
     /* Check if we already have a client online and if we do disconnect it
      * @note we should send GPSTransportClosed with reason "The user's connection has been usurped on the proxy"
      */
     if (account_info.online) {
         Client* client = sEntityList.FindAccount(account_info.id);
-        if (client != NULL)
+        if (client != NULL && client != this)
             client->DisconnectClient();
     }
 
+    /* send passwordVersion required: 1=plain, 2=hashed */
+    PyRep* rsp = new PyInt( 2 );
     mNet->QueueRep( rsp );
     PyDecRef( rsp );
 
     sLog.Log("Client","successful");
 
-    /* update account information, increase login count, last login timestamp and mark account as online */
-    m_services.serviceDB().UpdateAccountInformation( account_info.name.c_str(), true );
+    m_loginVerified = true;
 
     /* marshaled Python string "None" */
     static const uint8 handshakeFunc[] = { 0x74, 0x04, 0x00, 0x00, 0x00, 0x4E, 0x6F, 0x6E, 0x65 };
 
     /* send our handshake */
+    CryptoServerHandshake server_shake;
 
     server_shake.serverChallenge = "";
     server_shake.func_marshaled_code = new PyBuffer( handshakeFunc, handshakeFunc + sizeof( handshakeFunc ) );
@@ -1668,26 +1826,23 @@ bool Client::_VerifyLogin( CryptoChallengePacket& ccp )
 
     // Setup session, but don't send the change yet.
     mSession.SetString( "address", EVEClientSession::GetAddress().c_str() );
-    mSession.SetString( "languageID", ccp.user_languageid.c_str() );
+    mSession.SetString( "languageID", result.languageID.c_str() );
 
     //user type 1 is normal user, type 23 is a trial account user.
     mSession.SetInt( "userType", 1 );
     mSession.SetInt( "userid", account_info.id );
     mSession.SetLong( "role", account_info.role );
-
-    return true;
-
-error_login_auth_failed:
-
-    GPSTransportClosed* except = new GPSTransportClosed( transport_closed_msg );
-    mNet->QueueRep( except );
-    PyDecRef( except );
-
-    return false;
 }
 
 bool Client::_VerifyFuncResult( CryptoHandshakeResult& result )
 {
+    //nothing has been sent to run before our login is verified.
+    if( !m_loginVerified )
+    {
+        sLog.Error("Client","%s: Received handshake result before login was verified.", GetAddress().c_str());
+        return false;
+    }
+
     _log(NET__PRES_DEBUG, "%s: Handshake result received.", GetAddress().c_str());
 
     //send this before session change
@@ -1764,14 +1919,19 @@ bool Client::Handle_CallReq( PyPacket* packet, PyCallStream& req )
         //this should be sLog.Debug, but because of the number of messages, I left it as .Log for readability, and ease of finding other debug messages
         sLog.Log("Server", "%s call made to %s",req.method.c_str(),packet->dest.service.c_str());
 
-    //build arguments
-    PyCallArgs args( this, req.arg_tuple, req.arg_dict );
+    //build arguments; calls registered as direct decode them straight from the stream
+    if( !dest->IsDirectCall( req.method ) && !req.DecodeArgs() )
+    {
+        sLog.Error("Client","Failed to decode arguments of call %s.", req.method.c_str());
+        return false;
+    }
+    PyCallArgs args( this, req );
 
     //parts of call may be consumed here
     PyResult result = dest->Call( req.method, args );
 
     _SendSessionChange();  //send out the session change before the return.
-    _SendCallReturn( packet->dest, packet->source.callID, &result.ssResult );
+    _SendCallReturn( packet->dest, packet->source.callID, &result.ssResult, NULL, result.ssEncoded );
 
     return true;
 }
@@ -1829,5 +1989,6 @@ bool Client::Handle_Notify( PyPacket* packet )
 void Client::UpdateSession(const char *sessionType, int value)
 {
     mSession.SetInt(sessionType, value);
+    m_services.entity_list.UpdateOccupancy( this );
 }
 
@@ -56,6 +56,7 @@ detect clients moving into agro radius
 #define EVE_CLIENT_H
 
 #include "ClientSession.h"
+#include "account/LoginQueue.h"
 
 #include "inventory/InventoryItem.h"
 #include "character/Character.h"
@@ -162,6 +163,8 @@ public:
 
     void SendNotification(const PyAddress &dest, EVENotificationStream &noti, bool seq=true);
     void SendNotification(const char *notifyType, const char *idType, PyTuple **payload, bool seq=true);
+    //sends arguments already marshaled by EVENotificationStream::EncodeArgs(); consumes stream.
+    void SendNotification(const char *notifyType, const char *idType, PySubStream **stream, bool seq=true);
 
     //destiny stuff...
     void WarpTo(const GPoint &p, double distance);
@@ -220,6 +223,17 @@ public:
     virtual PyDict *MakeSlimItem() const;
     virtual void QueueDestinyUpdate(PyTuple** du);
     virtual void QueueDestinyEvent(PyTuple** multiEvent);
+    /**
+     * @brief Queues an OnItemChange for the end of the tick.
+     *
+     * Changes of the same item within one tick are merged into
+     * a single notification carrying the latest row.
+     *
+     * @param[in]     itemID  The item which changed.
+     * @param[in]     itemRow Current row of the item; consumed.
+     * @param[in,out] changes Map of column to old value; consumed and cleared.
+     */
+    void QueueItemChange(uint32 itemID, PyRep* itemRow, std::map<int32, PyRep*>& changes);
 
     virtual void TargetAdded(SystemEntity *who);
     virtual void TargetLost(SystemEntity *who);
@@ -238,13 +252,19 @@ public:
     void DisconnectClient();
     void BanClient();
 
+    /********************************************************************/
+    /* Login Queue Interface                                            */
+    /********************************************************************/
+    //called on the main loop once our queued login has been verified.
+    void OnLoginVerified( const LoginQueue::Result& result );
+
 protected:
-    void _ReduceDamage(Damage &d);
+    virtual void _ReduceDamage(Damage &d);
     void _UpdateSession( const CharacterConstRef& character );
     void _UpdateSession2( uint32 characterID  );
 
     // Packet stuff
-    void _SendCallReturn( const PyAddress& source, uint64 callID, PyRep** return_value, const char* channel = NULL );
+    void _SendCallReturn( const PyAddress& source, uint64 callID, PyRep** return_value, const char* channel = NULL, bool encoded = false );
     void _SendException( const PyAddress& source, uint64 callID, MACHONETMSG_TYPE in_response_to, MACHONETERR_TYPE exception_type, PyRep** payload );
     void _SendSessionChange();
     void _SendPingRequest();
@@ -291,12 +311,15 @@ protected:
 
     EvilNumber m_timeEndTrain;
 
+    //whether our login has been verified.
+    bool m_loginVerified;
+
     /********************************************************************/
     /* EVEClientSession interface                                       */
     /********************************************************************/
     void _GetVersion( VersionExchangeServer& version );
     uint32 _GetUserCount();
-    uint32 _GetQueuePosition() { /* hack */ return 1; }
+    uint32 _GetQueuePosition();
 
     /********************************************************************/
     /* EVEClientLogin statemachine                                      */
@@ -320,6 +343,23 @@ private:
     PyList* m_destinyEventQueue;    //we own these. These are events as used in OnMultiEvent
     PyList* m_destinyUpdateQueue;    //we own these. They are the `update` which go into DoDestinyAction
     void _SendQueuedUpdates();
+    void _SendNotification(const PyAddress &dest, PyTuple *payload, bool seq);
+    //empties the queue, keeping its storage unless a packet still holds it
+    static void _ResetQueue(PyList*& queue);
+
+    //OnModuleAttributeChange events queued this tick, by (itemID, attributeID); index into m_destinyEventQueue
+    std::map<std::pair<uint32, uint32>, size_t> m_queuedAttributeChanges;
+    bool _MergeAttributeChange(PyTuple* change);
+
+    //OnItemChange notifications queued this tick.
+    struct ItemChange
+    {
+        PyRep* itemRow;
+        std::map<int32, PyRep*> changes;
+    };
+    std::map<uint32, ItemChange> m_queuedItemChanges;
+    std::vector<uint32> m_queuedItemChangeOrder;
+    void _SendQueuedItemChanges();
 
     uint32 m_nextNotifySequence;
 
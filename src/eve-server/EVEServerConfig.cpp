@@ -46,6 +46,8 @@ EVEServerConfig::EVEServerConfig()
     // account
     account.autoAccountRole = 0;
     account.loginMessage = "";
+    account.loginWorkers = 2;
+    account.maxConcurrentLogins = 8;
 
     // character
     character.startBalance = 6666000000.0f;
@@ -66,6 +68,9 @@ EVEServerConfig::EVEServerConfig()
     files.logSettings = "../etc/log.ini";
     files.cacheDir = "../server_cache/";
     files.imageDir = "../image_cache/";
+    files.asyncLog = false;
+    files.logRotateSize = 0;
+    files.staticData = "../server_cache/StaticData.bin";
 
     // net
     net.port = 26000;
@@ -73,6 +78,11 @@ EVEServerConfig::EVEServerConfig()
     net.imageServerPort = 26001;
     net.apiServer = "localhost";
     net.apiServerPort = 64;
+    net.deflateLevel = EVETCPConnection::DEFLATE_LEVEL;
+
+    // world
+    world.batchDestiny = false;
+    world.itemCacheSize = 50000;
 }
 
 bool EVEServerConfig::ProcessEveServer( const TiXmlElement* ele )
@@ -84,6 +94,7 @@ bool EVEServerConfig::ProcessEveServer( const TiXmlElement* ele )
     AddMemberParser( "database",  &EVEServerConfig::ProcessDatabase );
     AddMemberParser( "files",     &EVEServerConfig::ProcessFiles );
     AddMemberParser( "net",       &EVEServerConfig::ProcessNet );
+    AddMemberParser( "world",     &EVEServerConfig::ProcessWorld );
 
     // parse the element
     const bool result = ParseElementChildren( ele );
@@ -95,6 +106,7 @@ bool EVEServerConfig::ProcessEveServer( const TiXmlElement* ele )
     RemoveParser( "database" );
     RemoveParser( "files" );
     RemoveParser( "net" );
+    RemoveParser( "world" );
 
     // return status of parsing
     return result;
@@ -121,11 +133,15 @@ bool EVEServerConfig::ProcessAccount( const TiXmlElement* ele )
 {
     AddValueParser( "autoAccountRole", account.autoAccountRole );
     AddValueParser( "loginMessage",    account.loginMessage );
+    AddValueParser( "loginWorkers",        account.loginWorkers );
+    AddValueParser( "maxConcurrentLogins", account.maxConcurrentLogins );
 
     const bool result = ParseElementChildren( ele );
 
     RemoveParser( "autoAccountRole" );
     RemoveParser( "loginMessage" );
+    RemoveParser( "loginWorkers" );
+    RemoveParser( "maxConcurrentLogins" );
 
     return result;
 }
@@ -174,6 +190,9 @@ bool EVEServerConfig::ProcessFiles( const TiXmlElement* ele )
     AddValueParser( "logSettings", files.logSettings );
     AddValueParser( "cacheDir",    files.cacheDir );
     AddValueParser( "imageDir",       files.imageDir );
+    AddValueParser( "asyncLog",    files.asyncLog );
+    AddValueParser( "logRotateSize", files.logRotateSize );
+    AddValueParser( "staticData",  files.staticData );
 
     const bool result = ParseElementChildren( ele );
 
@@ -181,6 +200,9 @@ bool EVEServerConfig::ProcessFiles( const TiXmlElement* ele )
     RemoveParser( "logSettings" );
     RemoveParser( "cacheDir" );
     RemoveParser( "imageDir" );
+    RemoveParser( "asyncLog" );
+    RemoveParser( "logRotateSize" );
+    RemoveParser( "staticData" );
 
     return result;
 }
@@ -192,6 +214,7 @@ bool EVEServerConfig::ProcessNet( const TiXmlElement* ele )
     AddValueParser( "imageServer", net.imageServer);
     AddValueParser( "apiServerPort", net.apiServerPort);
     AddValueParser( "apiServer", net.apiServer);
+    AddValueParser( "deflateLevel", net.deflateLevel );
 
     const bool result = ParseElementChildren( ele );
 
@@ -200,6 +223,20 @@ bool EVEServerConfig::ProcessNet( const TiXmlElement* ele )
     RemoveParser( "imageServer" );
     RemoveParser( "apiServerPort" );
     RemoveParser( "apiServer" );
+    RemoveParser( "deflateLevel" );
+
+    return result;
+}
+
+bool EVEServerConfig::ProcessWorld( const TiXmlElement* ele )
+{
+    AddValueParser( "batchDestiny",  world.batchDestiny );
+    AddValueParser( "itemCacheSize", world.itemCacheSize );
+
+    const bool result = ParseElementChildren( ele );
+
+    RemoveParser( "batchDestiny" );
+    RemoveParser( "itemCacheSize" );
 
     return result;
 }
@@ -61,6 +61,10 @@ public:
         uint32 autoAccountRole;
         /// A message shown to every client on login.
         std::string loginMessage;
+        /// Number of threads verifying logins; 0 verifies them on the main loop.
+        uint32 loginWorkers;
+        /// Number of logins verified at once; the rest wait in the login queue.
+        uint32 maxConcurrentLogins;
     } account;
 
     /// From <character/>
@@ -104,6 +108,12 @@ public:
         std::string cacheDir;
         // used as the base directory for the image server
         std::string imageDir;
+        /// Whether log messages are written by a background thread.
+        bool asyncLog;
+        /// Logfile size triggering rotation, in megabytes; 0 disables rotation.
+        uint32 logRotateSize;
+        /// Static data snapshot file; empty disables the snapshot.
+        std::string staticData;
     } files;
 
     /// From <net/>
@@ -119,8 +129,19 @@ public:
         uint16 apiServerPort;
         /// the apiServer for API functions. should be the evemu server external ip/host
         std::string apiServer;
+        /// Compression level of outgoing packets (1 - fastest, 9 - smallest).
+        int32 deflateLevel;
     } net;
 
+    /// From <world/>
+    struct
+    {
+        /// Whether to integrate ball movement per solar system in batches.
+        bool batchDestiny;
+        /// Number of items kept loaded before idle ones are unloaded; 0 means unbounded.
+        uint32 itemCacheSize;
+    } world;
+
 protected:
     bool ProcessEveServer( const TiXmlElement* ele );
     bool ProcessRates( const TiXmlElement* ele );
@@ -129,6 +150,7 @@ protected:
     bool ProcessDatabase( const TiXmlElement* ele );
     bool ProcessFiles( const TiXmlElement* ele );
     bool ProcessNet( const TiXmlElement* ele );
+    bool ProcessWorld( const TiXmlElement* ele );
 };
 
 /// A macro for easier access to the singleton.
@@ -30,7 +30,8 @@
 #include "ship/DestinyManager.h"
 #include "system/SystemManager.h"
 
-EntityList::EntityList() : m_services( NULL ) {}
+//ticks are budgeted at the main loop delay (10 ms); anything over 50 ms gets reported.
+EntityList::EntityList() : m_tickProfiler( 10000, 50000 ), m_services( NULL ) {}
 EntityList::~EntityList() {
     {
         client_list::iterator cur, end;
@@ -68,12 +69,19 @@ void EntityList::Process()
     client_list::iterator client_end = m_clients.end();
     client_list::iterator client_tmp;
 
+    const uint64 clients_start = GetTimeUSec();
     while(client_cur != client_end)
     {
         active_client = *client_cur;
-        if(!active_client->ProcessNet())
+
+        const uint64 start = GetTimeUSec();
+        const bool alive = active_client->ProcessNet();
+        m_tickProfiler.AddSample("client", active_client->GetAccountID(), GetTimeUSec() - start);
+
+        if(!alive)
         {
             sLog.Log("Entity List", "Destroying client for account %u", active_client->GetAccountID());
+            _RemoveOccupancy(active_client);
             SafeDelete(active_client);
 
             client_tmp = client_cur++;
@@ -84,6 +92,7 @@ void EntityList::Process()
             client_cur++;
         }
     }
+    m_tickProfiler.AddPhase("clients", GetTimeUSec() - clients_start);
 
     SystemManager *active_system = NULL;
     bool destiny = DestinyManager::IsTicActive();
@@ -101,13 +110,25 @@ void EntityList::Process()
     while(cur != end)
     {
         active_system = cur->second;
+        const uint64 start = GetTimeUSec();
+        uint64 destiny_end = start;
+
         //if it is destiny time, process it first.
         if(destiny)
         {
             active_system->ProcessDestiny();
+
+            destiny_end = GetTimeUSec();
+            m_tickProfiler.AddPhase("destiny", destiny_end - start);
         }
 
-        if(!active_system->Process())
+        const bool alive = active_system->Process();
+
+        const uint64 end_time = GetTimeUSec();
+        m_tickProfiler.AddPhase("systems", end_time - destiny_end);
+        m_tickProfiler.AddSample("system", active_system->GetID(), end_time - start);
+
+        if(!alive)
         {
             sLog.Log("Entity List", "Destroying system");
             tmp = cur++;
@@ -125,18 +146,116 @@ void EntityList::Process()
     }
 }
 
-Client *EntityList::FindCharacter(uint32 char_id) const {
-    //could likely improve this with a map, but its a little more work since
-    //clients are added to the list before we know who they are.
+void EntityList::UpdateOccupancy(Client *client) {
+    Occupancy now;
+    now.characterID = client->GetCharacterID();
+    now.corporationID = client->GetCorporationID();
+    now.locationID = client->GetLocationID();
+    now.stationID = client->GetStationID();
+    now.systemID = client->GetSystemID();
+    now.constellationID = client->GetConstellationID();
+    now.regionID = client->GetRegionID();
+
+    std::map<Client *, Occupancy>::const_iterator res = m_occupancy.find(client);
+    if(res != m_occupancy.end()) {
+        const Occupancy &old = res->second;
+        if(    old.characterID == now.characterID
+            && old.corporationID == now.corporationID
+            && old.locationID == now.locationID
+            && old.stationID == now.stationID
+            && old.systemID == now.systemID
+            && old.constellationID == now.constellationID
+            && old.regionID == now.regionID )
+            return;
+
+        _RemoveOccupancy(client);
+    }
 
-    client_list::const_iterator cur, end;
-    cur = m_clients.begin();
-    end = m_clients.end();
+    //clients are filed once they have picked a character.
+    if(now.characterID == 0)
+        return;
+
+    m_characters[now.characterID] = client;
+    _AddOccupant(m_corporationClients, now.corporationID, client);
+    _AddOccupant(m_locationClients, now.locationID, client);
+    _AddOccupant(m_stationClients, now.stationID, client);
+    _AddOccupant(m_systemClients, now.systemID, client);
+    _AddOccupant(m_constellationClients, now.constellationID, client);
+    _AddOccupant(m_regionClients, now.regionID, client);
+
+    m_occupancy.insert(std::make_pair(client, now));
+}
+
+void EntityList::_RemoveOccupancy(Client *client) {
+    std::map<Client *, Occupancy>::iterator res = m_occupancy.find(client);
+    if(res == m_occupancy.end())
+        return;
+
+    const Occupancy &old = res->second;
+
+    std::map<uint32, Client *>::iterator chr = m_characters.find(old.characterID);
+    //the character may have been taken over by a newer login meanwhile.
+    if(chr != m_characters.end() && chr->second == client)
+        m_characters.erase(chr);
+
+    _RemoveOccupant(m_corporationClients, old.corporationID, client);
+    _RemoveOccupant(m_locationClients, old.locationID, client);
+    _RemoveOccupant(m_stationClients, old.stationID, client);
+    _RemoveOccupant(m_systemClients, old.systemID, client);
+    _RemoveOccupant(m_constellationClients, old.constellationID, client);
+    _RemoveOccupant(m_regionClients, old.regionID, client);
+
+    m_occupancy.erase(res);
+}
+
+void EntityList::_GetOccupants(const occupancy_map &from, const std::set<uint32> &ids, std::vector<Client *> &result) const {
+    std::set<uint32>::const_iterator cur, end;
+    cur = ids.begin();
+    end = ids.end();
     for(; cur != end; cur++) {
-        if((*cur)->GetCharacterID() == char_id)
-            return(*cur);
+        const client_set *clients = _FindOccupants(from, *cur);
+        if(clients != NULL)
+            result.insert(result.end(), clients->begin(), clients->end());
     }
-    return NULL;
+}
+
+void EntityList::_AddOccupant(occupancy_map &into, uint32 id, Client *client) {
+    if(id != 0)
+        into[id].insert(client);
+}
+
+void EntityList::_RemoveOccupant(occupancy_map &from, uint32 id, Client *client) {
+    occupancy_map::iterator res = from.find(id);
+    if(res == from.end())
+        return;
+
+    res->second.erase(client);
+    if(res->second.empty())
+        from.erase(res);
+}
+
+const EntityList::client_set *EntityList::_FindOccupants(const occupancy_map &from, uint32 id) {
+    occupancy_map::const_iterator res = from.find(id);
+    if(res == from.end())
+        return NULL;
+
+    return &res->second;
+}
+
+uint32 EntityList::_CountOccupants(const occupancy_map &from, uint32 id) {
+    const client_set *clients = _FindOccupants(from, id);
+    if(clients == NULL)
+        return 0;
+
+    return uint32(clients->size());
+}
+
+Client *EntityList::FindCharacter(uint32 char_id) const {
+    std::map<uint32, Client *>::const_iterator res = m_characters.find(char_id);
+    if(res == m_characters.end())
+        return NULL;
+
+    return res->second;
 }
 
 Client *EntityList::FindCharacter(const char *name) const {
@@ -186,27 +305,15 @@ Client *EntityList::FindAccount(uint32 account_id) const {
 }
 
 void EntityList::FindByStationID(uint32 stationID, std::vector<Client *> &result) const {
-    //this could likely be done better
-
-    client_list::const_iterator cur, end;
-    cur = m_clients.begin();
-    end = m_clients.end();
-    for(; cur != end; cur++) {
-        if((*cur)->GetStationID() == stationID)
-            result.push_back(*cur);
-    }
+    const client_set *clients = _FindOccupants(m_stationClients, stationID);
+    if(clients != NULL)
+        result.insert(result.end(), clients->begin(), clients->end());
 }
 
 void EntityList::FindByRegionID(uint32 regionID, std::vector<Client *> &result) const {
-    //this could likely be done better
-
-    client_list::const_iterator cur, end;
-    cur = m_clients.begin();
-    end = m_clients.end();
-    for(; cur != end; cur++) {
-        if((*cur)->GetRegionID() == regionID)
-            result.push_back(*cur);
-    }
+    const client_set *clients = _FindOccupants(m_regionClients, regionID);
+    if(clients != NULL)
+        result.insert(result.end(), clients->begin(), clients->end());
 }
 
 void EntityList::Broadcast(const char *notifyType, const char *idType, PyTuple **payload) const {
@@ -254,25 +361,27 @@ void EntityList::Multicast( const char* notifyType, const char* idType, PyTuple*
     PyTuple* p = *payload;
     *payload = NULL;
 
-    std::list<Client*>::const_iterator cur, end;
-    cur = m_clients.begin();
-    end = m_clients.end();
-    for(; cur != end; cur++)
+    const client_set* clients = NULL;
+    switch( target )
     {
-        switch( target )
+    case NOTIF_DEST__LOCATION:
+        clients = _FindOccupants( m_locationClients, target_id );
+        break;
+    case NOTIF_DEST__CORPORATION:
+        clients = _FindOccupants( m_corporationClients, target_id );
+        break;
+    }
+
+    if( NULL != clients )
+    {
+        client_set::const_iterator cur, end;
+        cur = clients->begin();
+        end = clients->end();
+        for(; cur != end; cur++)
         {
-        case NOTIF_DEST__LOCATION:
-            if( (*cur)->GetLocationID() != target_id )
-                continue;
-            break;
-        case NOTIF_DEST__CORPORATION:
-            if( (*cur)->GetCorporationID() != target_id )
-                continue;
-            break;
+            PyTuple* temp = new PyTuple( *p );
+            (*cur)->SendNotification( notifyType, idType, &temp, seq );
         }
-
-        PyTuple* temp = new PyTuple( *p );
-        (*cur)->SendNotification( notifyType, idType, &temp, seq );
     }
 
     PyDecRef( p );
@@ -284,43 +393,22 @@ void EntityList::Multicast(const char *notifyType, const char *idType, PyTuple *
     PyTuple *payload = *in_payload;
     *in_payload = NULL;
 
-    //cache all these locally to avoid calling empty all the time.
-    const bool chars_empty = mcset.characters.empty();
-    const bool locs_empty = mcset.locations.empty();
-    const bool corps_empty = mcset.corporations.empty();
-
-    if( !chars_empty || !locs_empty || !corps_empty )
-    {
-        std::list<Client *>::const_iterator cur, end;
-        cur = m_clients.begin();
-        end = m_clients.end();
-        for(; cur != end; cur++)
-        {
-            if(      !chars_empty
-                 && mcset.characters.find((*cur)->GetCharacterID()) != mcset.characters.end() )
-            {
-                //found, carry on...
-            }
-            else if(   !locs_empty
-                      && mcset.locations.find((*cur)->GetLocationID()) != mcset.locations.end() )
-            {
-                //found, carry on...
-            }
-            else if(   !corps_empty
-                      && mcset.corporations.find((*cur)->GetCorporationID()) != mcset.corporations.end() )
-            {
-                //found, carry on...
-            }
-            else
-            {
-                //not found in any of the above sets.
-                continue;
-            }
+    //gather everybody matching any of the sets, each client once.
+    std::vector<Client *> result;
+    GetClients( mcset.characters, result );
+    _GetOccupants( m_locationClients, mcset.locations, result );
+    _GetOccupants( m_corporationClients, mcset.corporations, result );
 
-            PyTuple *temp = new PyTuple( *payload );
-            (*cur)->SendNotification( notifyType, idType, &temp, seq );
+    std::sort( result.begin(), result.end() );
+    result.erase( std::unique( result.begin(), result.end() ), result.end() );
 
-        }
+    std::vector<Client *>::const_iterator cur, end;
+    cur = result.begin();
+    end = result.end();
+    for(; cur != end; cur++)
+    {
+        PyTuple *temp = new PyTuple( *payload );
+        (*cur)->SendNotification( notifyType, idType, &temp, seq );
     }
 
     PyDecRef( payload );
@@ -360,17 +448,13 @@ void EntityList::Unicast(uint32 charID, const char *notifyType, const char *idTy
 }
 
 void EntityList::GetClients(const character_set &cset, std::vector<Client *> &result) const {
-    //this could likely be done better
-
-    character_set::const_iterator res;
-    client_list::const_iterator cur, end;
-    cur = m_clients.begin();
-    end = m_clients.end();
+    character_set::const_iterator cur, end;
+    cur = cset.begin();
+    end = cset.end();
     for(; cur != end; cur++) {
-        res = cset.find((*cur)->GetCharacterID());
-        if(res != cset.end()) {
-            result.push_back(*cur);
-        }
+        Client *client = FindCharacter(*cur);
+        if(client != NULL)
+            result.push_back(client);
     }
 }
 
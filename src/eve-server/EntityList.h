@@ -32,6 +32,7 @@
 
 #include "threading/Mutex.h"
 #include "utils/Singleton.h"
+#include "utils/TickProfiler.h"
 
 class Client;
 class PyAddress;
@@ -64,11 +65,25 @@ public:
     void UseServices(PyServiceMgr *svc) { m_services = svc; }
 
     typedef std::set<uint32> character_set;
+    typedef std::set<Client *> client_set;
 
     void Add(Client **client);
 
     void Process();
 
+    /**
+     * @brief Timings of the main loop; Process() fills in clients, systems and destiny.
+     */
+    TickProfiler &GetTickProfiler() { return m_tickProfiler; }
+
+    /**
+     * @brief Files the client under its current character and location.
+     *
+     * Must be called whenever the client's session changes; cheap
+     * if neither the character nor the location changed.
+     */
+    void UpdateOccupancy(Client *client);
+
     Client *FindCharacter(uint32 char_id) const;
     Client *FindCharacter(const char *name) const;
     Client *FindByShip(uint32 ship_id) const;
@@ -77,6 +92,18 @@ public:
         void FindByRegionID(uint32 regionID, std::vector<Client *> &result) const;
     uint32 GetClientCount() const { return(uint32(m_clients.size())); }
 
+    /**
+     * @return Clients in the solar system, docked or not; NULL if there are none.
+     */
+    const client_set *GetSystemClients(uint32 systemID) const { return _FindOccupants(m_systemClients, systemID); }
+    /**
+     * @return Clients docked in the station; NULL if there are none.
+     */
+    const client_set *GetStationClients(uint32 stationID) const { return _FindOccupants(m_stationClients, stationID); }
+    uint32 GetSystemCount(uint32 systemID) const { return _CountOccupants(m_systemClients, systemID); }
+    uint32 GetConstellationCount(uint32 constellationID) const { return _CountOccupants(m_constellationClients, constellationID); }
+    uint32 GetRegionCount(uint32 regionID) const { return _CountOccupants(m_regionClients, regionID); }
+
     SystemManager *FindOrBootSystem(uint32 systemID);
 
     void Broadcast(const char *notifyType, const char *idType, PyTuple **payload) const;
@@ -89,13 +116,47 @@ public:
     void GetClients(const character_set &cset, std::vector<Client *> &result) const;
 
 protected:
+    typedef std::map<uint32, client_set> occupancy_map;
+
+    /**
+     * @brief Character and location a client is filed under.
+     */
+    struct Occupancy
+    {
+        uint32 characterID;
+        uint32 corporationID;
+        uint32 locationID;
+        uint32 stationID;
+        uint32 systemID;
+        uint32 constellationID;
+        uint32 regionID;
+    };
+
+    void _RemoveOccupancy(Client *client);
+    void _GetOccupants(const occupancy_map &from, const std::set<uint32> &ids, std::vector<Client *> &result) const;
+    static void _AddOccupant(occupancy_map &into, uint32 id, Client *client);
+    static void _RemoveOccupant(occupancy_map &from, uint32 id, Client *client);
+    static const client_set *_FindOccupants(const occupancy_map &from, uint32 id);
+    static uint32 _CountOccupants(const occupancy_map &from, uint32 id);
+
     typedef std::list<Client *> client_list;
     client_list m_clients;
+
+    std::map<Client *, Occupancy> m_occupancy;
+    std::map<uint32, Client *> m_characters;
+    occupancy_map m_corporationClients;
+    occupancy_map m_locationClients;
+    occupancy_map m_stationClients;
+    occupancy_map m_systemClients;
+    occupancy_map m_constellationClients;
+    occupancy_map m_regionClients;
     typedef std::map<uint32, SystemManager *> system_list;
     system_list m_systems;
 
     Mutex mMutex;
 
+    TickProfiler m_tickProfiler;
+
     PyServiceMgr *m_services;    //we do not own this, only used for booting systems.
 };
 
@@ -53,29 +53,39 @@ PyResult PyCallable::Call(const std::string &method, PyCallArgs &args) {
     }
 }
 
+bool PyCallable::IsDirectCall(const std::string &method) const {
+    return m_serviceDispatch->IsDirect(method);
+}
+
 
 PyCallArgs::PyCallArgs(Client *c, PyTuple* tup, PyDict* dict)
 : client(c),
-  tuple(tup)
+  tuple(tup),
+  stream(NULL)
 {
     PyIncRef( tup );
 
-    PyDict::const_iterator cur, end;
-    cur = dict->begin();
-    end = dict->end();
-    for(; cur != end; cur++) {
-        if(!cur->first->IsString()) {
-            _log(SERVICE__ERROR, "Non-string key in call named arguments. Skipping.");
-            cur->first->Dump(SERVICE__ERROR, "    ");
-            continue;
-        }
-        byname[ cur->first->AsString()->content() ] = cur->second;
-        PyIncRef( cur->second );
+    _SetNamed( dict );
+}
+
+PyCallArgs::PyCallArgs(Client *c, const PyCallStream &req)
+: client(c),
+  tuple(req.arg_tuple),
+  stream(NULL)
+{
+    if(tuple == NULL) {
+        stream = req.call_stream;
+        PyIncRef( stream );
+    } else {
+        PyIncRef( tuple );
+        if(req.arg_dict != NULL)
+            _SetNamed( req.arg_dict );
     }
 }
 
 PyCallArgs::~PyCallArgs() {
     PySafeDecRef( tuple );
+    PySafeDecRef( stream );
 
     std::map<std::string, PyRep *>::iterator cur, end;
     cur = byname.begin();
@@ -88,6 +98,11 @@ void PyCallArgs::Dump(LogType type) const {
     if(!is_log_enabled(type))
         return;
 
+    if(tuple == NULL) {
+        _log(type, "  Call Arguments: not decoded yet");
+        return;
+    }
+
     _log(type, "  Call Arguments:");
     tuple->Dump(type, "      ");
     if(!byname.empty()) {
@@ -102,15 +117,83 @@ void PyCallArgs::Dump(LogType type) const {
     }
 }
 
+void PyCallArgs::_SetNamed(PyDict *dict) {
+    PyDict::const_iterator cur, end;
+    cur = dict->begin();
+    end = dict->end();
+    for(; cur != end; cur++) {
+        if(!cur->first->IsString()) {
+            _log(SERVICE__ERROR, "Non-string key in call named arguments. Skipping.");
+            cur->first->Dump(SERVICE__ERROR, "    ");
+            continue;
+        }
+
+        PyRep *&arg = byname[ cur->first->AsString()->content() ];
+        PySafeDecRef( arg );
+        arg = cur->second;
+        PyIncRef( arg );
+    }
+}
+
+bool PyCallArgs::_BeginArgs(UnmarshalStream &v) const {
+    if(stream->data() == NULL || !v.BeginStream( stream->data()->content() ))
+        return false;
+
+    //skip remote object and method, the call stream has them already
+    uint32 count;
+    return v.PullTupleHeader( count ) && count == 4
+        && v.PullRep() != NULL && v.PullRep() != NULL;
+}
+
+bool PyCallArgs::_EndArgs(UnmarshalStream &v) {
+    if(!v.PullNone()) {
+        PyRep *named = v.PullRep();
+        if(named == NULL || !named->IsDict())
+            return false;
+
+        _SetNamed( named->AsDict() );
+    }
+
+    PyDecRef( stream );
+    stream = NULL;
+    return true;
+}
+
+bool PyCallArgs::_UnmarshalArgs() {
+    PySubStream *ss = stream;
+    stream = NULL;
+
+    ss->DecodeData();
+    PyRep *call = ss->decoded();
+    if(call == NULL || !call->IsTuple() || call->AsTuple()->size() != 4
+       || !call->AsTuple()->GetItem( 2 )->IsTuple()) {
+        _log(SERVICE__ERROR, "Malformed call stream.");
+        PyDecRef( ss );
+        return false;
+    }
+
+    tuple = call->AsTuple()->GetItem( 2 )->AsTuple();
+    PyIncRef( tuple );
+
+    PyRep *named = call->AsTuple()->GetItem( 3 );
+    if(named->IsDict())
+        _SetNamed( named->AsDict() );
+
+    PyDecRef( ss );
+    return true;
+}
+
 /* PyResult */
-PyResult::PyResult( PyRep* result ) : ssResult( NULL == result ? new PyNone : result ) {}
-PyResult::PyResult( const PyResult& oth ) : ssResult( NULL ) { *this = oth; }
+PyResult::PyResult( PyRep* result ) : ssResult( NULL == result ? new PyNone : result ), ssEncoded( false ) {}
+PyResult::PyResult( PySubStream* encoded ) : ssResult( NULL == encoded ? (PyRep*)new PyNone : encoded ), ssEncoded( NULL != encoded ) {}
+PyResult::PyResult( const PyResult& oth ) : ssResult( NULL ), ssEncoded( false ) { *this = oth; }
 PyResult::~PyResult() { PySafeDecRef( ssResult ); }
 
 PyResult& PyResult::operator=( const PyResult& oth )
 {
     PySafeDecRef( ssResult );
     ssResult = oth.ssResult;
+    ssEncoded = oth.ssEncoded;
 
     if( NULL != ssResult )
         PyIncRef( ssResult );
@@ -34,6 +34,7 @@ class Client;
 class PyRep;
 class PyTuple;
 class PyDict;
+class PySubStream;
 
 class PyServiceMgr;
 class PyCallStream;
@@ -42,25 +43,86 @@ class PyCallArgs
 {
 public:
     PyCallArgs( Client *c, PyTuple* tup, PyDict* dict );
+    /**
+     * @brief Creates arguments of received call.
+     *
+     * If the arguments of @a req have not been decoded, they are
+     * kept marshaled; tuple and byname are then empty until Decode().
+     *
+     * @param[in] c   Calling client.
+     * @param[in] req The call.
+     */
+    PyCallArgs( Client *c, const PyCallStream& req );
     ~PyCallArgs();
 
     void Dump( LogType type ) const;
 
+    /**
+     * @brief Decodes arguments into a packet.
+     *
+     * Marshaled arguments are read with the packet's DecodeFrom(),
+     * which fills byname as well; the stream is unmarshaled only
+     * if that fails. Consumes the arguments either way.
+     *
+     * @param[out] args The packet to be filled.
+     *
+     * @retval true  Arguments decoded successfully.
+     * @retval false Arguments don't match the packet.
+     */
+    template<typename T>
+    bool Decode( T& args )
+    {
+        if( NULL != stream )
+        {
+            UnmarshalStream v;
+            if( _BeginArgs( v ) && args.DecodeFrom( v ) && _EndArgs( v ) )
+                return true;
+
+            if( !_UnmarshalArgs() )
+                return false;
+        }
+
+        if( NULL == tuple )
+            return false;
+
+        return args.Decode( &tuple );
+    }
+
     Client* const client;    //we do not own this
     PyTuple* tuple;        //we own this, but it may be taken
     std::map<std::string, PyRep*> byname;    //we own this, but elements may be taken.
+    PySubStream* stream;   //we own this, marshaled call until the arguments are decoded
+
+protected:
+    void _SetNamed( PyDict* dict );
+
+    bool _BeginArgs( UnmarshalStream& v ) const;
+    bool _EndArgs( UnmarshalStream& v );
+    bool _UnmarshalArgs();
 };
 
 class PyResult
 {
 public:
     PyResult( PyRep* result );
+    /**
+     * @brief Creates result which is encoded already.
+     *
+     * The substream is put into the call response as is, instead
+     * of wrapping the result into a new one; its contents are
+     * expected to be deflated already if they are large.
+     *
+     * @param[in] encoded Substream with marshaled result.
+     */
+    explicit PyResult( PySubStream* encoded );
     PyResult( const PyResult& oth );
     ~PyResult();
 
     PyResult& operator=( const PyResult& oth );
 
     PyRep* ssResult;
+    /// Whether ssResult is the encoded substream.
+    bool ssEncoded;
 };
 
 class PyException
@@ -88,6 +150,8 @@ public:
         virtual ~CallDispatcher() {}
 
         virtual PyResult Dispatch( const std::string& method_name, PyCallArgs& call ) = 0;
+        /** Whether the handler of the method decodes its arguments with PyCallArgs::Decode(). */
+        virtual bool IsDirect( const std::string& method_name ) const = 0;
     };
 
     PyCallable();
@@ -95,6 +159,8 @@ public:
 
     //returns ownership:
     virtual PyResult Call( const std::string& method, PyCallArgs& args );
+    //whether arguments of the call may stay marshaled:
+    bool IsDirectCall( const std::string& method ) const;
 
 protected:
     void _SetCallDispatcher( CallDispatcher* d ) { m_serviceDispatch = d; }
@@ -118,8 +118,36 @@ PyResult PyService::Handle_MachoBindObject( PyCallArgs& call )
         //do the call:
         PyResult result = our_obj->Call( boundcall.method_name, sub_args );
 
-        PyIncRef( result.ssResult );
-        robjs->SetItem( 1, result.ssResult );
+        PyRep* subResult;
+        if( result.ssEncoded )
+        {
+            // goes into our tuple, not directly into the response. The substream
+            // may be shared with the cache, so decode a private copy rather than
+            // attaching a decoded tree to it.
+            const PySubStream* ss = (const PySubStream*)result.ssResult;
+            if( NULL != ss->data() )
+                subResult = Unmarshal( ss->data()->content() );
+            else
+            {
+                subResult = ss->decoded();
+                PySafeIncRef( subResult );
+            }
+
+            if( NULL == subResult )
+            {
+                codelog( SERVICE__ERROR, "%s Service: %s: Failed to unmarshal result of bound call to %s", GetName(), call.client->GetName(), boundcall.method_name.c_str() );
+
+                PyDecRef( robjs );
+                throw PyException( MakeCustomError( "Failed to unmarshal result of %s.", boundcall.method_name.c_str() ) );
+            }
+        }
+        else
+        {
+            subResult = result.ssResult;
+            PyIncRef( subResult );
+        }
+
+        robjs->SetItem( 1, subResult );
 
         //ok, now we have finished our sub-call... hooray.
     }
@@ -47,8 +47,10 @@ public:
     virtual ~PyCallableDispatcher() {
     }
 
-    void RegisterCall(const char *call_name, CallProc p) {
+    void RegisterCall(const char *call_name, CallProc p, bool direct = false) {
         m_serviceCalls[call_name] = p;
+        if(direct)
+            m_directCalls.insert(call_name);
     }
 
     //CallDispatcher interface:
@@ -64,15 +66,21 @@ public:
         CallProc p = res->second;
         return (m_parent->*p)(call);
     }
+    virtual bool IsDirect(const std::string &method_name) const {
+        return(m_directCalls.find(method_name) != m_directCalls.end());
+    }
 
 protected:   //_MAY_ consume args
     std::map<std::string, CallProc> m_serviceCalls;
+    std::set<std::string> m_directCalls;    //calls which decode their arguments with PyCallArgs::Decode()
 
     Svc *const m_parent;    //we do not own this pointer
 };
 
 //convenience macro, you do not HAVE to use this
 #define PyCallable_REG_CALL(c,m) m_dispatch->RegisterCall(#m, &c::Handle_##m);
+//for calls whose handler decodes the arguments with PyCallArgs::Decode(), they are read straight from the marshal stream
+#define PyCallable_REG_CALL_DIRECT(c,m) m_dispatch->RegisterCall(#m, &c::Handle_##m, true);
 
 //macro of a template... nice.
 #define PyCallable_Make_Dispatcher(objname) \
@@ -29,6 +29,7 @@
 #include "PyService.h"
 #include "PyServiceMgr.h"
 #include "PyBoundObject.h"
+#include "chat/LSCService.h"
 
 PyServiceMgr::PyServiceMgr( uint32 nodeID, EntityList& elist, ItemFactory& ifactory )
 : item_factory( ifactory ),
@@ -63,7 +64,9 @@ PyServiceMgr::~PyServiceMgr() {
 }
 
 void PyServiceMgr::Process() {
-    //well... we used to have something to do, but not right now...
+    item_factory.Process();
+    if( lsc_service != NULL )
+        lsc_service->Process();
 }
 
 void PyServiceMgr::RegisterService(PyService *d) {
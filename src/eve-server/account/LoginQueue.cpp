@@ -0,0 +1,236 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-server.h"
+
+#include "Client.h"
+#include "account/LoginQueue.h"
+
+/*************************************************************************/
+/* LoginQueue::CheckJob                                                  */
+/*************************************************************************/
+LoginQueue::CheckJob::CheckJob( uint32 ticket, const std::string& user, const std::string& passwordHash, const std::string& languageID )
+: mTicket( ticket ),
+  mUser( user ),
+  mPasswordHash( passwordHash )
+{
+    mResult.success = false;
+    mResult.failure = "LoginAuthFailed";
+    mResult.languageID = languageID;
+}
+
+void LoginQueue::CheckJob::Run()
+{
+    ServiceDB db;
+    AccountInfo& account_info = mResult.account;
+
+    if( !db.GetAccountInformation( mUser.c_str(), account_info ) )
+        return;
+
+    /* check wether the account has been banned and if so send the semi correct message */
+    if( account_info.banned )
+    {
+        mResult.failure = "ACCOUNTBANNED";
+        return;
+    }
+
+    /* if we have stored a password we need to create a hash from the username and pass and remove the pass */
+    std::string account_hash;
+    if( account_info.password.empty() )
+        account_hash = account_info.hash;
+    else
+    {
+        /* here we generate the password hash ourselves */
+        std::string password_hash;
+        if( !PasswordModule::GeneratePassHash( mUser, account_info.password, password_hash ) )
+        {
+            sLog.Error( "LoginQueue", "unable to generate password hash, sending LoginAuthFailed" );
+            return;
+        }
+
+        if( !db.UpdateAccountHash( mUser.c_str(), password_hash ) )
+        {
+            sLog.Error( "LoginQueue", "unable to update account hash, sending LoginAuthFailed" );
+            return;
+        }
+
+        account_hash = password_hash;
+    }
+
+    /* here we check if the user successfully entered his password or if he failed */
+    if( account_hash != mPasswordHash )
+        return;
+
+    /* update account information, increase login count, last login timestamp and mark account as online */
+    db.UpdateAccountInformation( account_info.name.c_str(), true );
+
+    mResult.success = true;
+    mResult.failure.clear();
+}
+
+/*************************************************************************/
+/* LoginQueue                                                            */
+/*************************************************************************/
+LoginQueue::LoginQueue()
+: mMaxConcurrent( 1 ),
+  mNextTicket( 1 )
+{
+}
+
+void LoginQueue::Start( size_t workers, uint32 maxConcurrent )
+{
+    mMaxConcurrent = std::max<uint32>( maxConcurrent, 1 );
+
+    if( 0 < workers && mWorkers.Start( workers ) )
+        sLog.Log( "LoginQueue", "Verifying logins on %lu worker threads, %u at once.", workers, mMaxConcurrent );
+    else
+        sLog.Log( "LoginQueue", "Verifying logins on the main loop, %u at once.", mMaxConcurrent );
+}
+
+void LoginQueue::Stop()
+{
+    mWorkers.Stop();
+
+    WorkerPool::Job* job;
+    while( NULL != ( job = mWorkers.PopCompleted() ) )
+        delete job;
+    mActive.clear();
+
+    std::list<Waiting>::iterator cur, end;
+    cur = mWaiting.begin();
+    end = mWaiting.end();
+    for(; cur != end; cur++)
+        delete cur->job;
+    mWaiting.clear();
+}
+
+void LoginQueue::Enqueue( Client* client, const std::string& user, const std::string& passwordHash, const std::string& languageID )
+{
+    // a client has one login in flight at most
+    Remove( client );
+
+    Waiting w;
+    w.ticket = mNextTicket++;
+    w.client = client;
+    w.job = new CheckJob( w.ticket, user, passwordHash, languageID );
+
+    mWaiting.push_back( w );
+
+    _log( CLIENT__TRACE, "%s: Login of '%s' queued at position %lu.", client->GetAddress().c_str(), user.c_str(), mWaiting.size() );
+}
+
+void LoginQueue::Remove( Client* client )
+{
+    std::list<Waiting>::iterator cur, end;
+    cur = mWaiting.begin();
+    end = mWaiting.end();
+    for(; cur != end; cur++)
+    {
+        if( cur->client == client )
+        {
+            delete cur->job;
+            mWaiting.erase( cur );
+            break;
+        }
+    }
+
+    // the job can't be taken back from a worker; drop its result
+    std::map<uint32, Client*>::iterator curA, endA;
+    curA = mActive.begin();
+    endA = mActive.end();
+    for(; curA != endA; curA++)
+    {
+        if( curA->second == client )
+            curA->second = NULL;
+    }
+}
+
+uint32 LoginQueue::GetPosition( const Client* client ) const
+{
+    uint32 position = 1;
+
+    std::list<Waiting>::const_iterator cur, end;
+    cur = mWaiting.begin();
+    end = mWaiting.end();
+    for(; cur != end; cur++, position++)
+    {
+        if( cur->client == client )
+            return position;
+    }
+
+    std::map<uint32, Client*>::const_iterator curA, endA;
+    curA = mActive.begin();
+    endA = mActive.end();
+    for(; curA != endA; curA++)
+    {
+        // admitted already
+        if( curA->second == client )
+            return 1;
+    }
+
+    return position;
+}
+
+void LoginQueue::Process()
+{
+    // deliver results first so their slots may be reused
+    _DeliverResults();
+
+    bool admitted = false;
+    while( !mWaiting.empty() && mActive.size() < mMaxConcurrent )
+    {
+        Waiting w = mWaiting.front();
+        mWaiting.pop_front();
+
+        mActive.insert( std::make_pair( w.ticket, w.client ) );
+        // runs right away if there are no workers
+        mWorkers.Push( w.job );
+        admitted = true;
+    }
+
+    if( admitted && !mWorkers.IsRunning() )
+        _DeliverResults();
+}
+
+void LoginQueue::_DeliverResults()
+{
+    WorkerPool::Job* job;
+    while( NULL != ( job = mWorkers.PopCompleted() ) )
+    {
+        CheckJob* check = static_cast<CheckJob*>( job );
+
+        std::map<uint32, Client*>::iterator res = mActive.find( check->ticket() );
+        if( res != mActive.end() )
+        {
+            Client* client = res->second;
+            mActive.erase( res );
+
+            if( NULL != client )
+                client->OnLoginVerified( check->result() );
+        }
+
+        delete check;
+    }
+}
+
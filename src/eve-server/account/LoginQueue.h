@@ -0,0 +1,161 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __ACCOUNT__LOGIN_QUEUE_H__INCL__
+#define __ACCOUNT__LOGIN_QUEUE_H__INCL__
+
+#include "threading/WorkerPool.h"
+
+#include "ServiceDB.h"
+
+class Client;
+
+/**
+ * @brief Admission queue for logins.
+ *
+ * Login attempts are queued in order of arrival; at most
+ * a configured number of them are verified at once. The
+ * verification (account lookup, password hashing and the
+ * account updates) runs on worker threads; the result is
+ * handed back to the client on the main loop by Process().
+ */
+class LoginQueue
+: public Singleton< LoginQueue >
+{
+public:
+    /**
+     * @brief Outcome of a login verification.
+     */
+    struct Result
+    {
+        /// Whether the credentials are good.
+        bool success;
+        /// Reason sent with GPSTransportClosed on failure.
+        std::string failure;
+        /// The account; valid on success.
+        AccountInfo account;
+        /// Language the client asked for.
+        std::string languageID;
+    };
+
+    LoginQueue();
+
+    /**
+     * @brief Starts the verification workers.
+     *
+     * @param[in] workers       Number of worker threads; 0 verifies on the main loop.
+     * @param[in] maxConcurrent Number of logins verified at once.
+     */
+    void Start( size_t workers, uint32 maxConcurrent );
+    /**
+     * @brief Stops the workers, dropping all queued logins.
+     */
+    void Stop();
+
+    /**
+     * @brief Queues a login of client.
+     *
+     * @param[in] client       The client; receives the result through Client::OnLoginVerified().
+     * @param[in] user         Account name sent by client.
+     * @param[in] passwordHash Password hash sent by client.
+     * @param[in] languageID   Language sent by client.
+     */
+    void Enqueue( Client* client, const std::string& user, const std::string& passwordHash, const std::string& languageID );
+    /**
+     * @brief Forgets about client; its result will be dropped.
+     *
+     * @param[in] client The client going away.
+     */
+    void Remove( Client* client );
+
+    /**
+     * @brief Obtains position of client in the queue.
+     *
+     * @param[in] client The client.
+     *
+     * @return Position of queued client, counting from 1; for others the position they would get.
+     */
+    uint32 GetPosition( const Client* client ) const;
+    /** @return Number of logins waiting for admission. */
+    size_t GetWaitingCount() const { return mWaiting.size(); }
+    /** @return Number of logins being verified. */
+    size_t GetActiveCount() const { return mActive.size(); }
+
+    /**
+     * @brief Admits waiting logins and delivers results.
+     *
+     * Must be called from the main loop.
+     */
+    void Process();
+
+protected:
+    /**
+     * @brief Verifies credentials of a single login.
+     */
+    class CheckJob
+    : public WorkerPool::Job
+    {
+    public:
+        CheckJob( uint32 ticket, const std::string& user, const std::string& passwordHash, const std::string& languageID );
+
+        void Run();
+
+        uint32 ticket() const { return mTicket; }
+        const Result& result() const { return mResult; }
+
+    protected:
+        const uint32 mTicket;
+        const std::string mUser;
+        const std::string mPasswordHash;
+
+        Result mResult;
+    };
+
+    /**
+     * @brief Hands results of completed jobs to their clients.
+     */
+    void _DeliverResults();
+
+    struct Waiting
+    {
+        uint32 ticket;
+        Client* client;
+        CheckJob* job;
+    };
+
+    /// Logins waiting for admission, in order of arrival.
+    std::list<Waiting> mWaiting;
+    /// Logins being verified by ticket; client is NULL if it went away.
+    std::map<uint32, Client*> mActive;
+
+    uint32 mMaxConcurrent;
+    uint32 mNextTicket;
+
+    WorkerPool mWorkers;
+};
+
+#define sLoginQueue \
+    ( LoginQueue::get() )
+
+#endif /* !__ACCOUNT__LOGIN_QUEUE_H__INCL__ */
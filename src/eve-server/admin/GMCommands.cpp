@@ -1580,3 +1580,54 @@ PyResult Command_cloak( Client* who, CommandDB* db, PyServiceMgr* services, cons
     return NULL;
 }
 
+
+PyResult Command_tickstats( Client* who, CommandDB* db, PyServiceMgr* services, const Seperator& args )
+{
+    TickProfiler& profiler = sEntityList.GetTickProfiler();
+
+    if( args.argCount() == 2 && args.arg( 1 ) == "reset" )
+    {
+        profiler.Reset();
+        return new PyString( "Tick statistics reset." );
+    }
+    else if( args.argCount() == 3 && args.arg( 1 ) == "slow" && args.isNumber( 2 ) )
+    {
+        const uint64 ms = atoi( args.arg( 2 ).c_str() );
+        profiler.SetSlowThreshold( ms * 1000 );
+
+        char reply[64];
+        snprintf( reply, 64, "Slow tick threshold set to %" PRIu64 " ms.", ms );
+        return new PyString( reply );
+    }
+    else if( args.argCount() != 1 )
+        throw PyException( MakeCustomError( "Correct Usage: /tickstats [reset|slow (ms)]" ) );
+
+    std::string reply;
+    profiler.FormatSummary( reply );
+
+    const std::deque<TickProfiler::SlowTick>& slow = profiler.GetSlowTicks();
+    std::deque<TickProfiler::SlowTick>::const_iterator cur, end;
+    cur = slow.begin();
+    end = slow.end();
+    for(; cur != end; cur++)
+    {
+        std::string line;
+        TickProfiler::FormatSlowTick( *cur, line );
+        reply += "\n" + line;
+    }
+
+    SystemManager* system = who->System();
+    if( NULL != system )
+    {
+        const SystemManager::AIStats& ai = system->GetAIStats();
+
+        char line[160];
+        snprintf( line, 160,
+            "\nNPC AI in %s: %u npcs in %u batches, %" PRIu64 " us (peak %" PRIu64 " us), %u queries, %u reuses.",
+            system->GetName().c_str(), ai.npcs, ai.batches, ai.usec, ai.peakUSec, ai.queries, ai.reuses
+        );
+        reply += line;
+    }
+
+    return new PyString( reply );
+}
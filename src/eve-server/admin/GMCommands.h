@@ -67,6 +67,8 @@ COMMAND( killallnpcs, ROLE_ADMIN,
         " - insta-pops all NPC ships in the current bubble")
 COMMAND( cloak, ROLE_ADMIN,
 		" - instantly and unconditionally toggles cloak state of your vessel")
+COMMAND( tickstats, ROLE_ADMIN,
+        "[reset|slow (ms)] - shows server tick timings, the tick duration histogram and the last slow ticks" )
 /*COMMAND( entity, ROLE_ADMIN,
         "(entityID) - unknown" )
 COMMAND( chatban, ROLE_ADMIN,
@@ -272,9 +272,8 @@ PyResult ObjCacheService::Handle_GetCachableObject(PyCallArgs &call) {
     }
     */
 
-    PyObject *result = m_cache.GetCachedObject(args.objectID);
-
-    return result;
+    // served pre-marshaled, so a login storm doesn't encode it over and over
+    return PyResult( m_cache.GetEncodedCachedObject(args.objectID) );
 }
 
 void ObjCacheService::PrimeCache()
@@ -415,6 +414,11 @@ void ObjCacheService::GiveCache(const PyRep *objectID, PyRep **contents) {
     m_cache.UpdateCache(objectID, contents);
 }
 
+void ObjCacheService::GiveCache(const PyRep *objectID, PyRep **contents, uint32 version) {
+    //contents is consumed.
+    m_cache.UpdateCache(objectID, contents, version);
+}
+
 PyObject *ObjCacheService::MakeObjectCachedSessionMethodCallResult(const PyRep *objectID, const char *sessionInfoName, const char *clientWhen) {
     if(!IsCacheLoaded(objectID))
         return NULL;
@@ -79,6 +79,9 @@ public:
     void GiveCache(const PyRep *objectID, PyRep **contents);
     void GiveCache(const ObjectCachedMethodID &m, PyRep **contents) { GiveCache(m.objectID, contents); }
     void GiveCache(const ObjectCachedSessionMethodID &m, PyRep **contents) { GiveCache(m.objectID, contents); }
+    //for contents which keep their own version stamp:
+    void GiveCache(const PyRep *objectID, PyRep **contents, uint32 version);
+    void GiveCache(const ObjectCachedMethodID &m, PyRep **contents, uint32 version) { GiveCache(m.objectID, contents, version); }
 
     PyObject *MakeObjectCachedMethodCallResult(const PyRep *objectID, const char *versionCheck="run");
     PyObject *MakeObjectCachedMethodCallResult(const ObjectCachedMethodID &m, const char *versionCheck="run") { return(MakeObjectCachedMethodCallResult(m.objectID, versionCheck)); }
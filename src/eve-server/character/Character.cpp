@@ -28,6 +28,7 @@
 #include "Client.h"
 #include "EntityList.h"
 #include "character/Character.h"
+#include "corporation/CorpMemberIndex.h"
 #include "inventory/AttributeEnum.h"
 
 /*
@@ -891,6 +892,11 @@ void Character::UpdateSkillQueue()
                 PySafeDecRef( tmp );
 
                 c->UpdateSkillTraining();
+
+                // Apply the new skill level to the ship the character is flying:
+                ShipRef ship = c->GetShip();
+                if( ship )
+                    ship->UpdateSkill( currentTraining );
             }
 
             // erase first element in skill queue
@@ -1098,6 +1104,18 @@ void Character::SaveCharacter()
         )
     );
 
+    // keep member lists of corporations current
+    MemberInfo member;
+    member.charID = itemID();
+    member.corpID = corporationID();
+    member.title = title();
+    member.startDateTime = corporationDateTime();
+    member.roles = corpRole();
+    member.rolesAtHQ = rolesAtHQ();
+    member.rolesAtBase = rolesAtBase();
+    member.rolesAtOther = rolesAtOther();
+    sCorpMemberIndex.Update( member );
+
     // Save this character's own attributes:
     SaveAttributes();
 }
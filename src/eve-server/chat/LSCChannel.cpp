@@ -65,6 +65,8 @@ PyRep *LSCChannelMod::Encode() {
     return line.Encode();
 }
 
+const size_t LSCChannel::PENDING_THRESHOLD = 50;
+
 LSCChannel::LSCChannel(
     LSCService *svc,
     uint32 channelID,
@@ -99,6 +101,12 @@ LSCChannel::LSCChannel(
 
 LSCChannel::~LSCChannel() {
     _log(LSC__CHANNELS, "Destroying channel \"%s\"", m_displayName.c_str());
+
+    std::list<PendingEvent>::iterator cur, end;
+    cur = m_pending.begin();
+    end = m_pending.end();
+    for(; cur != end; cur++)
+        PyDecRef( cur->payload );
 }
 
 void LSCChannel::GetChannelInfo(uint32 * channelID, uint32 * ownerID, std::string &displayName, std::string &motd, std::string &comparisonKey,
@@ -151,16 +159,8 @@ bool LSCChannel::JoinChannel(Client * c) {
         join.member_count = m_chars.size();
         join.channelID = EncodeID();
 
-        MulticastTarget mct;
-
-        std::map<uint32, LSCChannelChar>::iterator cur, end;
-        cur = m_chars.begin();
-        end = m_chars.end();
-        for( ; cur != end; cur++ )
-            mct.characters.insert( cur->first );
-
         PyTuple *answer = join.Encode();
-        m_service->entityList().Multicast( "OnLSC", GetTypeString(), &answer, mct );
+        _QueueEvent( c->GetCharacterID(), true, &answer );
     //}
 
 
@@ -180,16 +180,8 @@ void LSCChannel::LeaveChannel(uint32 charID, OnLSC_SenderInfo * si) {
     leave.member_count = m_chars.size();
     leave.channelID = EncodeID();
 
-    MulticastTarget mct;
-
-    std::map<uint32, LSCChannelChar>::iterator cur, end;
-    cur = m_chars.begin();
-    end = m_chars.end();
-    for(; cur != end; cur++)
-        mct.characters.insert( cur->first );
-
     PyTuple *answer = leave.Encode();
-    m_service->entityList().Multicast("OnLSC", GetTypeString(), &answer, mct);
+    _QueueEvent(charID, false, &answer);
 }
 
 void LSCChannel::LeaveChannel(Client *c, bool self) {
@@ -205,22 +197,21 @@ void LSCChannel::LeaveChannel(Client *c, bool self) {
     leave.member_count = m_chars.size();
     leave.channelID = EncodeID();
 
-    MulticastTarget mct;
-
-    std::map<uint32, LSCChannelChar>::iterator cur, end;
-    cur = m_chars.begin();
-    end = m_chars.end();
-    for(; cur != end; cur++)
-        mct.characters.insert( cur->first );
-
     PyTuple *answer = leave.Encode();
-    m_service->entityList().Multicast("OnLSC", GetTypeString(), &answer, mct);
+
+    //the one leaving hears about it right away, the rest may have to wait.
+    PyTuple *own = new PyTuple( *answer );
+    c->SendNotification("OnLSC", GetTypeString(), &own);
 
     m_chars.erase(charID);
     c->ChannelLeft(this);
+
+    _QueueEvent(charID, false, &answer);
 }
 
 void LSCChannel::Evacuate(Client * c) {
+    FlushPending();
+
     OnLSC_DestroyChannel dc;
 
     dc.channelID = EncodeID();
@@ -272,6 +263,9 @@ void LSCChannel::SendMessage(Client * c, const char * message, bool self) {
     m_service->entityList().Multicast("OnLSC", GetTypeString(), &answer, mct);
 */
 
+    // keep joins and leaves ahead of what is said after them
+    FlushPending();
+
     // NEW KENNY TRANSLATOR VERSION:
     // execute Multicast() twice: once for all clients where IsKennyTranslatorEnabled() == false and once for all clients where it is true
     MulticastTarget mct_Kennyfied;
@@ -300,19 +294,22 @@ void LSCChannel::SendMessage(Client * c, const char * message, bool self) {
                 notKennyfiedCharListSize++;
             }
         } else {
-            std::map<uint32, LSCChannelChar>::iterator cur, end;
-            cur = m_chars.begin();
-            end = m_chars.end();
+            std::vector<Client *> members;
+            _GetMembers( members );
+
+            std::vector<Client *>::const_iterator cur, end;
+            cur = members.begin();
+            end = members.end();
             for(; cur != end; cur++)
             {
-                if( (m_service->entityList().FindCharacter(cur->first)->IsKennyTranslatorEnabled()) )
+                if( (*cur)->IsKennyTranslatorEnabled() )
                 {
-                    mct_Kennyfied.characters.insert( cur->first );
+                    mct_Kennyfied.characters.insert( (*cur)->GetCharacterID() );
                     kennyfiedCharListSize++;
                 }
                 else
                 {
-                    mct_NotKennyfied.characters.insert( cur->first );
+                    mct_NotKennyfied.characters.insert( (*cur)->GetCharacterID() );
                     notKennyfiedCharListSize++;
                 }
             }
@@ -357,6 +354,107 @@ void LSCChannel::SendMessage(Client * c, const char * message, bool self) {
     m_service->entityList().Multicast("OnLSC", GetTypeString(), &answerKennyfied, mct_Kennyfied);
 }
 
+void LSCChannel::FlushPending() {
+    if( m_pending.empty() )
+        return;
+
+    // everybody gets all events of this tick, so look the members up once
+    std::vector<Client *> members;
+    _GetMembers( members );
+
+    std::list<PendingEvent>::iterator cur, end;
+    cur = m_pending.begin();
+    end = m_pending.end();
+    for(; cur != end; cur++)
+    {
+        _Broadcast( members, cur->payload );
+        PyDecRef( cur->payload );
+    }
+
+    m_pending.clear();
+}
+
+void LSCChannel::_QueueEvent(uint32 charID, bool join, PyTuple **payload) {
+    PyTuple *p = *payload;
+    *payload = NULL;
+
+    if( m_pending.empty() && m_chars.size() < PENDING_THRESHOLD )
+    {
+        std::vector<Client *> members;
+        _GetMembers( members );
+
+        _Broadcast( members, p );
+        PyDecRef( p );
+        return;
+    }
+
+    // somebody who joins and leaves again within one tick is never announced
+    std::list<PendingEvent>::iterator cur, end;
+    cur = m_pending.begin();
+    end = m_pending.end();
+    for(; cur != end; cur++)
+    {
+        if( !join && cur->join && cur->charID == charID )
+        {
+            PyDecRef( cur->payload );
+            m_pending.erase( cur );
+
+            PyDecRef( p );
+            return;
+        }
+    }
+
+    PendingEvent event;
+    event.charID = charID;
+    event.join = join;
+    event.payload = p;
+    m_pending.push_back( event );
+
+    m_service->QueueFlush( m_channelID );
+}
+
+void LSCChannel::_Broadcast(const std::vector<Client *> &members, PyTuple *payload) {
+    std::vector<Client *>::const_iterator cur, end;
+    cur = members.begin();
+    end = members.end();
+    for(; cur != end; cur++)
+    {
+        PyTuple *temp = new PyTuple( *payload );
+        (*cur)->SendNotification( "OnLSC", GetTypeString(), &temp );
+    }
+}
+
+void LSCChannel::_GetMembers(std::vector<Client *> &into) {
+    if( m_type == solarsystem )
+    {
+        // local is joined by (nearly) everybody in the system; walk the residents
+        const EntityList::client_set *residents = m_service->entityList().GetSystemClients( m_channelID );
+        if( residents != NULL )
+        {
+            EntityList::client_set::const_iterator cur, end;
+            cur = residents->begin();
+            end = residents->end();
+            for(; cur != end; cur++)
+            {
+                if( IsJoined( (*cur)->GetCharacterID() ) )
+                    into.push_back( *cur );
+            }
+        }
+    }
+    else
+    {
+        std::map<uint32, LSCChannelChar>::const_iterator cur, end;
+        cur = m_chars.begin();
+        end = m_chars.end();
+        for(; cur != end; cur++)
+        {
+            Client *member = m_service->entityList().FindCharacter( cur->first );
+            if( member != NULL )
+                into.push_back( member );
+        }
+    }
+}
+
 bool LSCChannel::IsJoined(uint32 charID) {
     return m_chars.find(charID) != m_chars.end();
 }
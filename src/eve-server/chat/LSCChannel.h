@@ -160,6 +160,12 @@ public:
     void Evacuate(Client * c);
     void SendMessage(Client * c, const char * message, bool self = false);
 
+    /**
+     * @brief Sends out join and leave notifications queued since the last call.
+     */
+    void FlushPending();
+    bool HasPending() const { return !m_pending.empty(); }
+
 
     static OnLSC_SenderInfo *_MakeSenderInfo(Client *from);
 
@@ -184,8 +190,22 @@ protected:
     std::vector<LSCChannelMod> m_mods;
     std::map<uint32, LSCChannelChar> m_chars;
 
+    // Channels with at least this many members queue join and leave
+    // notifications and send them out once per tick.
+    static const size_t PENDING_THRESHOLD;
+
+    struct PendingEvent {
+        uint32 charID;
+        bool join;
+        PyTuple *payload;
+    };
+    std::list<PendingEvent> m_pending;
+
 
     OnLSC_SenderInfo *_FakeSenderInfo();
+    void _QueueEvent(uint32 charID, bool join, PyTuple **payload);
+    void _Broadcast(const std::vector<Client *> &members, PyTuple *payload);
+    void _GetMembers(std::vector<Client *> &into);
 
 };
 
@@ -556,6 +556,22 @@ void LSCService::CharacterLogout(uint32 charID, OnLSC_SenderInfo* si)
     SafeDelete( si );
 }
 
+void LSCService::Process()
+{
+    std::set<uint32>::const_iterator cur, end;
+    cur = m_pendingChannels.begin();
+    end = m_pendingChannels.end();
+    for(; cur != end; cur++)
+    {
+        // the channel may be gone already
+        std::map<uint32, LSCChannel*>::iterator res = m_channels.find( *cur );
+        if( res != m_channels.end() )
+            res->second->FlushPending();
+    }
+
+    m_pendingChannels.clear();
+}
+
 
 PyResult LSCService::Handle_CreateChannel( PyCallArgs& call )
 {
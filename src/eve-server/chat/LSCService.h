@@ -75,6 +75,15 @@ public:
     void CreateSystemChannel(uint32 systemID);
     void CharacterLogout(uint32 charID, OnLSC_SenderInfo * si);
 
+    /**
+     * @brief Sends out the queued join and leave notifications of all channels.
+     */
+    void Process();
+    /**
+     * @brief Schedules the channel's queued notifications for the next Process().
+     */
+    void QueueFlush(uint32 channelID) { m_pendingChannels.insert(channelID); }
+
     void SendMail(uint32 sender, uint32 recipient, const std::string &subject, const std::string &content) {
         std::vector<int32> recs(1, recipient);
         SendMail(sender, recs, subject, content);
@@ -90,6 +99,7 @@ protected:
     LSCDB m_db;
 
     std::map<uint32, LSCChannel *> m_channels;  //we own these pointers
+    std::set<uint32> m_pendingChannels;         //channels with queued notifications
 
     //make sure you add things to the constructor too
     PyCallable_DECL_CALL(GetChannels)
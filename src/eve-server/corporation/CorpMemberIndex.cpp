@@ -0,0 +1,215 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+#include "eve-server.h"
+
+#include "corporation/CorpMemberIndex.h"
+
+/*************************************************************************/
+/* MemberOrder                                                           */
+/*************************************************************************/
+class MemberOrder
+{
+public:
+    MemberOrder( CorpMemberIndex::SortColumn column, bool descending )
+    : mColumn( column ),
+      mDescending( descending )
+    {
+    }
+
+    bool operator()( const MemberInfo* a, const MemberInfo* b ) const
+    {
+        return mDescending ? _Less( *b, *a ) : _Less( *a, *b );
+    }
+
+protected:
+    bool _Less( const MemberInfo& a, const MemberInfo& b ) const
+    {
+        switch( mColumn )
+        {
+            case CorpMemberIndex::SORT_TITLE:      return a.title < b.title;
+            case CorpMemberIndex::SORT_START_DATE: return a.startDateTime < b.startDateTime;
+            case CorpMemberIndex::SORT_ROLES:      return a.roles < b.roles;
+            default:                               return a.charID < b.charID;
+        }
+    }
+
+    const CorpMemberIndex::SortColumn mColumn;
+    const bool mDescending;
+};
+
+/*************************************************************************/
+/* CorpMemberIndex                                                       */
+/*************************************************************************/
+CorpMemberIndex::CorpMemberIndex()
+{
+}
+
+CorpMemberIndex::~CorpMemberIndex()
+{
+    std::map<uint32, Corporation*>::iterator cur, end;
+    cur = m_corporations.begin();
+    end = m_corporations.end();
+    for(; cur != end; ++cur)
+        SafeDelete( cur->second );
+}
+
+uint32 CorpMemberIndex::Select( uint32 corpID, const Query& query, std::vector<uint32>& into )
+{
+    Corporation* corp = _GetCorporation( corpID );
+
+    std::vector<const MemberInfo*> selected;
+    selected.reserve( corp->members.size() );
+
+    std::map<uint32, MemberInfo>::const_iterator cur, end;
+    cur = corp->members.begin();
+    end = corp->members.end();
+    for(; cur != end; ++cur)
+    {
+        if( 0 == query.roleMask || 0 != ( cur->second.roles & query.roleMask ) )
+            selected.push_back( &cur->second );
+    }
+
+    // members come ordered by character ID, which breaks ties
+    if( SORT_CHARACTER_ID != query.sort || query.descending )
+        std::stable_sort( selected.begin(), selected.end(), MemberOrder( query.sort, query.descending ) );
+
+    into.clear();
+    into.reserve( selected.size() );
+
+    std::vector<const MemberInfo*>::const_iterator sCur, sEnd;
+    sCur = selected.begin();
+    sEnd = selected.end();
+    for(; sCur != sEnd; ++sCur)
+        into.push_back( (*sCur)->charID );
+
+    return corp->version;
+}
+
+const MemberInfo* CorpMemberIndex::GetMember( uint32 corpID, uint32 charID )
+{
+    Corporation* corp = _GetCorporation( corpID );
+
+    std::map<uint32, MemberInfo>::const_iterator res = corp->members.find( charID );
+    if( res == corp->members.end() )
+        return NULL;
+
+    return &res->second;
+}
+
+uint32 CorpMemberIndex::GetMemberCount( uint32 corpID )
+{
+    return _GetCorporation( corpID )->members.size();
+}
+
+uint32 CorpMemberIndex::GetVersion( uint32 corpID )
+{
+    return _GetCorporation( corpID )->version;
+}
+
+void CorpMemberIndex::Update( const MemberInfo& info )
+{
+    std::map<uint32, uint32>::iterator res = m_memberCorporations.find( info.charID );
+    if( res != m_memberCorporations.end() && res->second != info.corpID )
+        _Remove( info.charID );
+
+    std::map<uint32, Corporation*>::iterator corp = m_corporations.find( info.corpID );
+    if( corp == m_corporations.end() )
+        // nobody looked at the corporation yet, it's loaded with the member
+        return;
+
+    std::map<uint32, MemberInfo>::iterator member = corp->second->members.find( info.charID );
+    if( member == corp->second->members.end() )
+        corp->second->members.insert( std::make_pair( info.charID, info ) );
+    else if( member->second != info )
+        member->second = info;
+    else
+        return;
+
+    m_memberCorporations[ info.charID ] = info.corpID;
+    ++corp->second->version;
+}
+
+void CorpMemberIndex::Reload( uint32 charID )
+{
+    MemberInfo info;
+    if( m_db.GetMember( charID, info ) )
+        Update( info );
+    else
+        _Remove( charID );
+}
+
+bool CorpMemberIndex::ParseSortColumn( const std::string& name, SortColumn& into )
+{
+    if( "characterID" == name )
+        into = SORT_CHARACTER_ID;
+    else if( "title" == name )
+        into = SORT_TITLE;
+    else if( "startDateTime" == name )
+        into = SORT_START_DATE;
+    else if( "roles" == name )
+        into = SORT_ROLES;
+    else
+        return false;
+
+    return true;
+}
+
+CorpMemberIndex::Corporation* CorpMemberIndex::_GetCorporation( uint32 corpID )
+{
+    std::map<uint32, Corporation*>::iterator res = m_corporations.find( corpID );
+    if( res != m_corporations.end() )
+        return res->second;
+
+    Corporation* corp = new Corporation;
+    corp->version = 0;
+
+    std::vector<MemberInfo> members;
+    if( !m_db.GetMembers( corpID, members ) )
+        sLog.Error( "CorpMemberIndex", "Failed to load members of corporation %u.", corpID );
+
+    std::vector<MemberInfo>::const_iterator cur, end;
+    cur = members.begin();
+    end = members.end();
+    for(; cur != end; ++cur)
+    {
+        corp->members.insert( std::make_pair( cur->charID, *cur ) );
+        m_memberCorporations[ cur->charID ] = corpID;
+    }
+
+    m_corporations.insert( std::make_pair( corpID, corp ) );
+    return corp;
+}
+
+void CorpMemberIndex::_Remove( uint32 charID )
+{
+    std::map<uint32, uint32>::iterator res = m_memberCorporations.find( charID );
+    if( res == m_memberCorporations.end() )
+        return;
+
+    std::map<uint32, Corporation*>::iterator corp = m_corporations.find( res->second );
+    if( corp != m_corporations.end() && 0 < corp->second->members.erase( charID ) )
+        ++corp->second->version;
+
+    m_memberCorporations.erase( res );
+}
@@ -0,0 +1,139 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+#ifndef __CORPORATION__CORP_MEMBER_INDEX_H__INCL__
+#define __CORPORATION__CORP_MEMBER_INDEX_H__INCL__
+
+#include "corporation/CorporationDB.h"
+
+/**
+ * @brief In-memory index of corporation members.
+ *
+ * Member lists are loaded from the database the first time
+ * a corporation is asked for and kept current afterwards by
+ * Update() (character saves) and Reload() (changes made
+ * directly in the database). Every change bumps the version
+ * of the affected corporation so that views built from it
+ * know when to rebuild.
+ */
+class CorpMemberIndex
+: public Singleton< CorpMemberIndex >
+{
+public:
+    /**
+     * @brief Columns a member list may be sorted by.
+     */
+    enum SortColumn
+    {
+        SORT_CHARACTER_ID,
+        SORT_TITLE,
+        SORT_START_DATE,
+        SORT_ROLES
+    };
+
+    /**
+     * @brief Selection of members.
+     */
+    struct Query
+    {
+        Query() : sort( SORT_CHARACTER_ID ), descending( false ), roleMask( 0 ) {}
+
+        /// Column to sort by.
+        SortColumn sort;
+        /// Whether to sort in descending order.
+        bool descending;
+        /// Only members holding any of these roles; 0 selects everybody.
+        uint64 roleMask;
+    };
+
+    CorpMemberIndex();
+    ~CorpMemberIndex();
+
+    /**
+     * @brief Selects members of a corporation.
+     *
+     * @param[in]  corpID  The corporation.
+     * @param[in]  query   Sort order and filter.
+     * @param[out] into    Character IDs of selected members, in order.
+     *
+     * @return Version of the member list the selection was made from.
+     */
+    uint32 Select( uint32 corpID, const Query& query, std::vector<uint32>& into );
+
+    /**
+     * @brief Obtains a member of a corporation.
+     *
+     * @return The member; NULL if the character is not a member.
+     */
+    const MemberInfo* GetMember( uint32 corpID, uint32 charID );
+    /**
+     * @return Number of members of the corporation.
+     */
+    uint32 GetMemberCount( uint32 corpID );
+    /**
+     * @return Current version of the corporation's member list.
+     */
+    uint32 GetVersion( uint32 corpID );
+
+    /**
+     * @brief Records the current state of a member.
+     *
+     * Moves the member between corporations if its
+     * corporation changed. Cheap if nothing changed or
+     * neither corporation is loaded.
+     */
+    void Update( const MemberInfo& info );
+    /**
+     * @brief Reloads a member from the database.
+     */
+    void Reload( uint32 charID );
+
+    /**
+     * @brief Translates a column name into SortColumn.
+     *
+     * @retval true  The column is sortable.
+     * @retval false Unknown column.
+     */
+    static bool ParseSortColumn( const std::string& name, SortColumn& into );
+
+protected:
+    struct Corporation
+    {
+        std::map<uint32, MemberInfo> members;
+        uint32 version;
+    };
+
+    Corporation* _GetCorporation( uint32 corpID );
+    void _Remove( uint32 charID );
+
+    CorporationDB m_db;
+
+    std::map<uint32, Corporation*> m_corporations;
+    /// Corporation of every member of a loaded corporation.
+    std::map<uint32, uint32> m_memberCorporations;
+};
+
+#define sCorpMemberIndex \
+    ( CorpMemberIndex::get() )
+
+#endif /* !__CORPORATION__CORP_MEMBER_INDEX_H__INCL__ */
@@ -30,6 +30,7 @@
 #include "PyServiceCD.h"
 #include "cache/ObjCacheService.h"
 #include "chat/LSCService.h"
+#include "corporation/CorpMemberIndex.h"
 #include "corporation/CorpRegistryService.h"
 
 class CorpRegistryBound
@@ -151,6 +152,60 @@ protected:
     CorporationDB& m_db;
 };
 
+class SparseCorpMemberListBound
+: public PyBoundObject
+{
+public:
+    PyCallable_Make_Dispatcher(SparseCorpMemberListBound)
+
+    SparseCorpMemberListBound(PyServiceMgr *mgr, uint32 corpID)
+    : PyBoundObject(mgr),
+      m_dispatch(new Dispatcher(this)),
+      m_corpID(corpID),
+      m_version(0)
+    {
+        _SetCallDispatcher(m_dispatch);
+
+        m_strBoundObjectName = "SparseCorpMemberListBound";
+
+        PyCallable_REG_CALL(SparseCorpMemberListBound, Fetch)
+        PyCallable_REG_CALL(SparseCorpMemberListBound, FetchByKey)
+        PyCallable_REG_CALL(SparseCorpMemberListBound, GetByKey)
+        PyCallable_REG_CALL(SparseCorpMemberListBound, Sort)
+        PyCallable_REG_CALL(SparseCorpMemberListBound, Filter)
+
+        _Select();
+    }
+    virtual ~SparseCorpMemberListBound() {delete m_dispatch;}
+    virtual void Release() {
+        delete this;
+    }
+
+    uint32 GetRowCount() const { return m_keys.size(); }
+
+    PyCallable_DECL_CALL(Fetch) //(startPos, fetchSize)
+    PyCallable_DECL_CALL(FetchByKey) //([keys])
+    PyCallable_DECL_CALL(GetByKey) //(key)
+    PyCallable_DECL_CALL(Sort) //(column, descending)
+    PyCallable_DECL_CALL(Filter) //(roleMask)
+
+protected:
+    // rebuilds our selection if the member list changed since
+    void _Refresh();
+    void _Select();
+    PyList *_EncodeRow(uint32 charID);
+    PyTuple *_EncodeKeyedRow(uint32 charID);
+
+    Dispatcher *const m_dispatch;
+
+    const uint32 m_corpID;
+    CorpMemberIndex::Query m_query;
+
+    // selected character IDs in display order
+    std::vector<uint32> m_keys;
+    uint32 m_version;
+};
+
 PyCallable_Make_InnerDispatcher(CorpRegistryService)
 
 CorpRegistryService::CorpRegistryService(PyServiceMgr *mgr)
@@ -375,9 +430,18 @@ PyClass
         dict["N=707075:302"]=0x1CC2383E961BFA8
 */
 PyResult CorpRegistryBound::Handle_GetMembers(PyCallArgs &call) {
+    SparseCorpMemberListBound *bObj = new SparseCorpMemberListBound(m_manager, call.client->GetCorporationID());
 
-    sLog.Debug( "CorpRegistryBound", "Called GetMembers stub." );
-    return NULL;
+    CorpMemberSparseRowset ret;
+    ret.memberCount = bObj->GetRowCount();
+
+    // Only the row count goes out now, the rows are fetched in pages
+    PyDict *dict = new PyDict();
+    dict->SetItemString("realRowCount", new PyInt(ret.memberCount));
+
+    ret.bindedObject = m_manager->BindObject(call.client, bObj, &dict);
+
+    return ret.Encode();
 }
 
 PyResult CorpRegistryBound::Handle_GetSuggestedTickerNames(PyCallArgs &call) {
@@ -454,6 +518,145 @@ PyResult SparseCorpOfficeListBound::Handle_Fetch(PyCallArgs &call) {
     return m_db.Fetch(call.client->GetCorporationID(), args.arg1, args.arg2);
 }
 
+PyResult SparseCorpMemberListBound::Handle_Fetch(PyCallArgs &call) {
+    Call_TwoIntegerArgs args;
+    if (!args.Decode(&call.tuple)) {
+        codelog(SERVICE__ERROR, "%s: Bad arguments", call.client->GetName());
+        return NULL;
+    }
+
+    _Refresh();
+
+    PyList *res = new PyList;
+    if (args.arg1 < 0 || args.arg2 <= 0)
+        return res;
+
+    const size_t first = std::min<size_t>(args.arg1, m_keys.size());
+    const size_t last = std::min<size_t>(first + args.arg2, m_keys.size());
+    for (size_t i = first; i < last; i++) {
+        PyTuple *row = _EncodeKeyedRow(m_keys[i]);
+        if (row != NULL)
+            res->AddItem(row);
+    }
+
+    return res;
+}
+
+PyResult SparseCorpMemberListBound::Handle_FetchByKey(PyCallArgs &call) {
+    Call_SingleIntList args;
+    if (!args.Decode(&call.tuple)) {
+        codelog(SERVICE__ERROR, "%s: Bad arguments", call.client->GetName());
+        return NULL;
+    }
+
+    PyList *res = new PyList;
+
+    std::vector<int32>::const_iterator cur, end;
+    cur = args.ints.begin();
+    end = args.ints.end();
+    for (; cur != end; cur++) {
+        PyTuple *row = _EncodeKeyedRow(*cur);
+        if (row != NULL)
+            res->AddItem(row);
+    }
+
+    return res;
+}
+
+PyResult SparseCorpMemberListBound::Handle_GetByKey(PyCallArgs &call) {
+    Call_SingleIntegerArg args;
+    if (!args.Decode(&call.tuple)) {
+        codelog(SERVICE__ERROR, "%s: Bad arguments", call.client->GetName());
+        return NULL;
+    }
+
+    PyList *row = _EncodeRow(args.arg);
+    if (row == NULL)
+        return new PyNone;
+
+    return row;
+}
+
+PyResult SparseCorpMemberListBound::Handle_Sort(PyCallArgs &call) {
+    Call_SortCorpMembers args;
+    if (!args.Decode(&call.tuple)) {
+        codelog(SERVICE__ERROR, "%s: Bad arguments", call.client->GetName());
+        return NULL;
+    }
+
+    if (!CorpMemberIndex::ParseSortColumn(args.column, m_query.sort)) {
+        codelog(SERVICE__ERROR, "%s: Cannot sort members by %s", call.client->GetName(), args.column.c_str());
+        return NULL;
+    }
+    m_query.descending = args.descending;
+
+    _Select();
+    return new PyInt(GetRowCount());
+}
+
+PyResult SparseCorpMemberListBound::Handle_Filter(PyCallArgs &call) {
+    Call_FilterCorpMembers args;
+    if (!args.Decode(&call.tuple)) {
+        codelog(SERVICE__ERROR, "%s: Bad arguments", call.client->GetName());
+        return NULL;
+    }
+
+    m_query.roleMask = args.roleMask;
+
+    _Select();
+    return new PyInt(GetRowCount());
+}
+
+void SparseCorpMemberListBound::_Refresh() {
+    if (m_version != sCorpMemberIndex.GetVersion(m_corpID))
+        _Select();
+}
+
+void SparseCorpMemberListBound::_Select() {
+    m_version = sCorpMemberIndex.Select(m_corpID, m_query, m_keys);
+}
+
+PyList *SparseCorpMemberListBound::_EncodeRow(uint32 charID) {
+    const MemberInfo *info = sCorpMemberIndex.GetMember(m_corpID, charID);
+    if (info == NULL)
+        return NULL;
+
+    // columns as listed in CorpMemberSparseRowset
+    PyList *row = new PyList;
+    row->AddItemInt(info->charID);
+    row->AddItemInt(info->corpID);
+    row->AddItem(new PyNone);                   // divisionID
+    row->AddItem(new PyNone);                   // squadronID
+    row->AddItemString(info->title.c_str());
+    row->AddItemLong(info->roles);
+    row->AddItemLong(0);                        // grantableRoles
+    row->AddItemLong(info->startDateTime);
+    row->AddItem(new PyNone);                   // baseID
+    row->AddItemLong(info->rolesAtHQ);
+    row->AddItemLong(0);                        // grantableRolesAtHQ
+    row->AddItemLong(info->rolesAtBase);
+    row->AddItemLong(0);                        // grantableRolesAtBase
+    row->AddItemLong(info->rolesAtOther);
+    row->AddItemLong(0);                        // grantableRolesAtOther
+    row->AddItemLong(0);                        // titleMask
+    row->AddItem(new PyNone);                   // accountKey
+    row->AddItemLong(Win32TimeNow());           // rowDate
+    row->AddItemLong(0);                        // blockRoles
+
+    return row;
+}
+
+PyTuple *SparseCorpMemberListBound::_EncodeKeyedRow(uint32 charID) {
+    PyList *row = _EncodeRow(charID);
+    if (row == NULL)
+        return NULL;
+
+    PyTuple *res = new PyTuple(2);
+    res->SetItem(0, new PyInt(charID));
+    res->SetItem(1, row);
+    return res;
+}
+
 PyResult CorpRegistryBound::Handle_GetMyApplications(PyCallArgs &call) {
     /// We have a dict
     /// With an STI and an integer
@@ -756,6 +959,7 @@ PyResult CorpRegistryBound::Handle_UpdateApplicationOffer(PyCallArgs &call) {
             codelog(SERVICE__ERROR, "%s: Failed to record corp join for char %u corp %u", call.client->GetName(), OCAC.charID, OCAC.corpID);
             return NULL;
         }
+        sCorpMemberIndex.Reload(ocmc.charID);
 
         Client *recruit = m_manager->entity_list.FindCharacter(ocmc.charID);
         if(recruit != NULL) {
@@ -896,7 +1100,7 @@ PyResult CorpRegistryBound::Handle_UpdateCorporation(PyCallArgs &call) {
     }
 
     // Only send notification if it is needed...
-    if (((PyDict*)notif.data)->items.size()) {
+    if (((PyDict*)notif.data)->size()) {
         MulticastTarget mct;
         mct.corporations.insert(notif.key);
         PyTuple * answer = notif.Encode();
@@ -71,6 +71,29 @@ public:
 };
 
 
+
+class MemberInfo {
+public:
+    uint32 charID;
+    uint32 corpID;
+    std::string title;
+    uint64 startDateTime;
+    uint64 roles;
+    uint64 rolesAtHQ;
+    uint64 rolesAtBase;
+    uint64 rolesAtOther;
+
+    MemberInfo() : charID(0), corpID(0), startDateTime(0), roles(0), rolesAtHQ(0), rolesAtBase(0), rolesAtOther(0) { }
+
+    bool operator==(const MemberInfo &oth) const {
+        return charID == oth.charID && corpID == oth.corpID && title == oth.title
+            && startDateTime == oth.startDateTime && roles == oth.roles
+            && rolesAtHQ == oth.rolesAtHQ && rolesAtBase == oth.rolesAtBase && rolesAtOther == oth.rolesAtOther;
+    }
+    bool operator!=(const MemberInfo &oth) const { return !( *this == oth ); }
+};
+
+
 #endif
 
 
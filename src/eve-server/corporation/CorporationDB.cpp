@@ -823,6 +823,67 @@ PyRep *CorporationDB::Fetch(uint32 corpID, uint32 from, uint32 count) {
 
     return reply.Encode();
 }
+
+static void _ReadMemberInfo(DBResultRow &row, MemberInfo &into) {
+    into.charID = row.GetUInt(0);
+    into.corpID = row.GetUInt(1);
+    into.title = row.GetText(2);
+    into.startDateTime = row.GetUInt64(3);
+    into.roles = row.GetUInt64(4);
+    into.rolesAtHQ = row.GetUInt64(5);
+    into.rolesAtBase = row.GetUInt64(6);
+    into.rolesAtOther = row.GetUInt64(7);
+}
+
+bool CorporationDB::GetMembers(uint32 corpID, std::vector<MemberInfo> &into) {
+    DBQueryResult res;
+
+    if (!sDatabase.RunQuery(res,
+        " SELECT characterID, corporationID, title, corporationDateTime, "
+        "   corpRole, rolesAtHQ, rolesAtBase, rolesAtOther "
+        " FROM character_ "
+        " WHERE corporationID = %u ", corpID
+        ))
+    {
+        codelog(SERVICE__ERROR, "Error in query: %s", res.error.c_str());
+        return false;
+    }
+
+    into.reserve(into.size() + res.GetRowCount());
+
+    DBResultRow row;
+    while(res.GetRow(row)) {
+        MemberInfo info;
+        _ReadMemberInfo(row, info);
+        into.push_back(info);
+    }
+    return true;
+}
+
+bool CorporationDB::GetMember(uint32 charID, MemberInfo &into) {
+    DBQueryResult res;
+
+    if (!sDatabase.RunQuery(res,
+        " SELECT characterID, corporationID, title, corporationDateTime, "
+        "   corpRole, rolesAtHQ, rolesAtBase, rolesAtOther "
+        " FROM character_ "
+        " WHERE characterID = %u ", charID
+        ))
+    {
+        codelog(SERVICE__ERROR, "Error in query: %s", res.error.c_str());
+        return false;
+    }
+
+    DBResultRow row;
+    if (!res.GetRow(row)) {
+        codelog(SERVICE__ERROR, "Unable to find character %u", charID);
+        return false;
+    }
+
+    _ReadMemberInfo(row, into);
+    return true;
+}
+
 uint32 CorporationDB::GetQuoteForRentingAnOffice(uint32 stationID) {
     DBQueryResult res;
     DBResultRow row;
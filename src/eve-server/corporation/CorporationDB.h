@@ -70,6 +70,9 @@ public:
     uint32 GetOffices(uint32 corpID);
     PyRep *Fetch(uint32 corpID, uint32 from, uint32 count);
 
+    bool GetMembers(uint32 corpID, std::vector<MemberInfo> &into);
+    bool GetMember(uint32 charID, MemberInfo &into);
+
     uint32 GetQuoteForRentingAnOffice(uint32 corpID);
     uint32 ReserveOffice(const OfficeInfo & oInfo);
 
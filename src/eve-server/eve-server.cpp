@@ -27,12 +27,16 @@
 
 #include "EVEServerConfig.h"
 #include "NetService.h"
+
+#include "log/AsyncLog.h"
+
 // account services
 #include "account/AccountService.h"
 #include "account/AuthService.h"
 #include "account/BrowserLockdownSvc.h"
 #include "account/ClientStatMgrService.h"
 #include "account/InfoGatheringMgr.h"
+#include "account/LoginQueue.h"
 #include "account/TutorialService.h"
 #include "account/UserService.h"
 // admin services
@@ -80,6 +84,7 @@
 #include "imageserver/ImageServer.h"
 // inventory services
 #include "inventory/InvBrokerService.h"
+#include "inventory/StaticDataMgr.h"
 // mail services
 #include "mail/MailMgrService.h"
 #include "mail/MailingListMgrService.h"
@@ -89,6 +94,7 @@
 #include "manufacturing/RamProxyService.h"
 // map services
 #include "map/MapService.h"
+#include "map/UniverseMgr.h"
 // market services
 #include "market/BillMgrService.h"
 #include "market/ContractMgrService.h"
@@ -165,6 +171,9 @@ int main( int argc, char* argv[] )
     }
 
     sLog.InitializeLogging(sConfig.files.logDir);
+    sLog.SetRotateSize( sConfig.files.logRotateSize * 1024 * 1024 );
+    if( sConfig.files.asyncLog && sAsyncLog.Start() )
+        sLog.Success( "server init", "Asynchronous logging enabled." );
     sLog.Log("server init", "Loading server configuration...");
 
     sLog.Log("", "" );
@@ -215,6 +224,8 @@ int main( int argc, char* argv[] )
         std::cout << std::endl << "press any key to exit...";  std::cin.get();
         return 1;
     }
+    // map the static data snapshot before anything reads types
+    sStaticData.Initialize( sConfig.files.staticData );
     _sDgmTypeAttrMgr = new dgmtypeattributemgr(); // needs to be after db init as its using it
 
     //Start up the TCP server
@@ -349,6 +360,11 @@ int main( int argc, char* argv[] )
 	//sDGM_Ship_Bonus_Modifiers_Table.Initialize();
 	sLog.Log("server init", "---> sDGM_Types_to_Wrecks_Table: Loading...");
 	sDGM_Types_to_Wrecks_Table.Initialize();
+	sLog.Log("server init", "---> sUniverse: Loading...");
+	sUniverse.Initialize();
+
+    // start verifying logins
+    sLoginQueue.Start( sConfig.account.loginWorkers, sConfig.account.maxConcurrentLogins );
 
     sLog.Log("server init", "Init done.");
 
@@ -373,23 +389,41 @@ int main( int argc, char* argv[] )
     uint32 etime;
     uint32 last_time = GetTickCount();
 
+    TickProfiler& profiler = sEntityList.GetTickProfiler();
+
     EVETCPConnection* tcpc;
     while( RunLoops == true )
     {
         Timer::SetCurrentTime();
         start = GetTickCount();
+        profiler.BeginTick();
 
         //check for timeouts in other threads
         //timeout_manager.CheckTimeouts();
         while( ( tcpc = tcps.PopConnection() ) )
         {
+            tcpc->SetDeflateLevel( sConfig.net.deflateLevel );
             Client* c = new Client( services, &tcpc );
 
             sEntityList.Add( &c );
         }
 
         sEntityList.Process();
-        services.Process();
+        {
+            TickProfiler::ScopedPhase phase( profiler, "logins" );
+            sLoginQueue.Process();
+        }
+        {
+            TickProfiler::ScopedPhase phase( profiler, "services" );
+            services.Process();
+        }
+
+        if( profiler.EndTick() )
+        {
+            std::string report;
+            TickProfiler::FormatSlowTick( profiler.GetSlowTicks().back(), report );
+            sLog.Warning( "Tick Profiler", "Slow %s", report.c_str() );
+        }
 
         /* UPDATE */
         last_time = GetTickCount();
@@ -402,6 +436,9 @@ int main( int argc, char* argv[] )
 
     sLog.Log("server shutdown", "Main loop stopped" );
 
+    // drop logins still in the queue
+    sLoginQueue.Stop();
+
     // Shutting down EVE Client TCP listener
     tcps.Close();
     sLog.Log("server shutdown", "TCP listener stopped." );
@@ -420,6 +457,8 @@ int main( int argc, char* argv[] )
     sLog.Log("server shutdown", "Cleanup db cache" );
     delete _sDgmTypeAttrMgr;
 
+    // write out queued log messages before the logfile goes away
+    sAsyncLog.Stop();
     log_close_logfile();
 
     //std::cout << std::endl << "press the ENTER key to exit...";  std::cin.get();
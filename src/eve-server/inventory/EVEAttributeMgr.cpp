@@ -30,6 +30,7 @@
 #include "inventory/EVEAttributeMgr.h"
 #include "inventory/InventoryDB.h"
 #include "inventory/InventoryItem.h"
+#include "inventory/StaticDataMgr.h"
 
 /*
  * EVEAttributeMgr
@@ -122,6 +123,12 @@ void EVEAdvancedAttributeMgr::EncodeAttributes(std::map<int32, PyRep *> &into) c
  * TypeAttributeMgr
  */
 bool TypeAttributeMgr::Load(InventoryDB &db) {
+    // the snapshot has them without a query; a type missing there has none
+    if(sStaticData.IsLoaded()) {
+        sStaticData.GetTypeAttributes(type().id(), *this);
+        return true;
+    }
+
     // load new contents from DB
     return db.LoadTypeAttributes(type().id(), *this);
 }
@@ -531,6 +538,7 @@ bool AttributeMap::SendAttributeChanges( PyTuple* attrChange )
         // This item is owned by the EVE System either directly, as in the case of a character object,
         // or indirectly, as in the case of a Station, which is owned by the corporation that runs it.
         // So, we don't need to queue up Destiny events in these cases.
+        PyDecRef( attrChange );
         return true;
     }
     else
@@ -542,6 +550,7 @@ bool AttributeMap::SendAttributeChanges( PyTuple* attrChange )
         {
             //sLog.Error("AttributeMap::SendAttributeChanges()", "unable to find client:%u", mItem.ownerID());
             //return false;
+            PyDecRef( attrChange );
             return true;
         }
         else
@@ -550,6 +559,7 @@ bool AttributeMap::SendAttributeChanges( PyTuple* attrChange )
             {
                 //sLog.Warning( "AttributeMap::SendAttributeChanges()", "client->Destiny() returned NULL" );
                 //return false;
+                PyDecRef( attrChange );
             }
             else
                 client->QueueDestinyEvent(&attrChange);
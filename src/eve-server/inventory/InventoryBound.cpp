@@ -34,6 +34,7 @@ InventoryBound::InventoryBound( PyServiceMgr *mgr, Inventory &inventory, EVEItem
 : PyBoundObject(mgr),
   m_dispatch(new Dispatcher(this)),
   mInventory(inventory),
+  mInventoryItem(mgr->item_factory.GetItem(inventory.inventoryID())),
   mFlag(flag)
 {
     _SetCallDispatcher(m_dispatch);
@@ -59,6 +59,7 @@ protected:
     Dispatcher *const m_dispatch;
 
     Inventory &mInventory;
+    InventoryItemRef mInventoryItem;    // keeps mInventory loaded while we are bound.
     EVEItemFlags mFlag;
 
     PyRep *_ExecAdd(Client *c, const std::vector<int32> &items, uint32 quantity, EVEItemFlags flag);
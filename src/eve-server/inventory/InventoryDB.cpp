@@ -1829,5 +1829,121 @@ bool InventoryDB::GetOpenPowerSlots(uint32 slotType, ShipRef ship, uint32 &into)
 
 }
 
+bool InventoryDB::GetStaticDataCounts(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " (SELECT COUNT(*) FROM invCategories),"
+        " (SELECT COUNT(*) FROM invGroups),"
+        " (SELECT COUNT(*) FROM invTypes),"
+        " (SELECT COUNT(*) FROM dgmTypeAttributes),"
+        " (SELECT COUNT(*) FROM dgmTypeEffects),"
+        " (SELECT COUNT(*) FROM invTypesToWrecks)"))
+    {
+        _log(DATABASE__ERROR, "Failed to query static data counts: %s.", res.error.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool InventoryDB::GetAllCategories(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " categoryID,"
+        " categoryName,"
+        " description,"
+        " published"
+        " FROM invCategories"))
+    {
+        _log(DATABASE__ERROR, "Failed to query categories: %s.", res.error.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool InventoryDB::GetAllGroups(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " groupID,"
+        " categoryID,"
+        " groupName,"
+        " description,"
+        " useBasePrice,"
+        " allowManufacture,"
+        " allowRecycler,"
+        " anchored,"
+        " anchorable,"
+        " fittableNonSingleton,"
+        " published"
+        " FROM invGroups"))
+    {
+        _log(DATABASE__ERROR, "Failed to query groups: %s.", res.error.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool InventoryDB::GetAllTypes(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " typeID,"
+        " groupID,"
+        " typeName,"
+        " description,"
+        " radius,"
+        " mass,"
+        " volume,"
+        " capacity,"
+        " portionSize,"
+        " raceID,"
+        " basePrice,"
+        " published,"
+        " marketGroupID,"
+        " chanceOfDuplicating"
+        " FROM invTypes"))
+    {
+        _log(DATABASE__ERROR, "Failed to query types: %s.", res.error.c_str());
+        return false;
+    }
 
+    return true;
+}
 
+bool InventoryDB::GetAllTypeAttributes(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " typeID,"
+        " attributeID,"
+        " valueInt,"
+        " valueFloat"
+        " FROM dgmTypeAttributes"
+        " ORDER BY typeID"))
+    {
+        _log(DATABASE__ERROR, "Failed to query type attributes: %s.", res.error.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool InventoryDB::GetAllTypeEffects(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " typeID,"
+        " effectID"
+        " FROM dgmTypeEffects"))
+    {
+        _log(DATABASE__ERROR, "Failed to query type effects: %s.", res.error.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -316,6 +316,16 @@ public:
 
     static bool GetTypeID(uint32 itemID, uint32 &typeID);
 
+    /*
+     * Static data snapshot helpers; each returns the whole table.
+     */
+    static bool GetStaticDataCounts(DBQueryResult &res);
+    static bool GetAllCategories(DBQueryResult &res);
+    static bool GetAllGroups(DBQueryResult &res);
+    static bool GetAllTypes(DBQueryResult &res);
+    static bool GetAllTypeAttributes(DBQueryResult &res);
+    static bool GetAllTypeEffects(DBQueryResult &res);
+
 };
 
 
@@ -1028,14 +1028,8 @@ void InventoryItem::SendItemChange(uint32 toID, std::map<int32, PyRep *> &change
     if(c == NULL)
         return; //not found or not online...
 
-    NotifyOnItemChange change;
-    change.itemRow = GetItemRow();
-
-    change.changes = changes;
-    changes.clear();    //consume them.
-
-    PyTuple *tmp = change.Encode();  //this is consumed below
-    c->SendNotification("OnItemChange", "charid", &tmp, false); //unsequenced.
+    //sent out at the end of the tick, merged with further changes of this item.
+    c->QueueItemChange(itemID(), GetItemRow(), changes);
 }
 
 
@@ -1087,8 +1081,8 @@ void InventoryItem::SetOnline(bool online) {
     multi.events = new PyList;
     multi.events->AddItem( ogf.Encode() );
 
-    PyTuple* tmp = multi.Encode();   //this is consumed below
-    c->SendNotification("OnMultiEvent", "clientID", &tmp);
+    PySubStream* ss = EVENotificationStream::EncodeArgs( multi );   //this is consumed below
+    c->SendNotification("OnMultiEvent", "clientID", &ss);
 }
 
 void InventoryItem::SetActive(bool active, uint32 effectID, double duration, bool repeat)
@@ -1128,8 +1122,8 @@ void InventoryItem::SetActive(bool active, uint32 effectID, double duration, boo
     multi.events = new PyList;
     multi.events->AddItem(shipEffect.Encode());
 
-    PyTuple* tmp = multi.Encode();   //this is consumed below
-    c->SendNotification("OnMultiEvent", "clientID", &tmp);
+    PySubStream* ss = EVENotificationStream::EncodeArgs( multi );   //this is consumed below
+    c->SendNotification("OnMultiEvent", "clientID", &ss);
 }
 
 void InventoryItem::SetCustomInfo(const char *ci) {
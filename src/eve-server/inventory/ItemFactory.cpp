@@ -25,6 +25,8 @@
 
 #include "eve-server.h"
 
+#include "EntityList.h"
+#include "EVEServerConfig.h"
 #include "character/Character.h"
 #include "manufacturing/Blueprint.h"
 #include "pos/Structure.h"
@@ -36,12 +38,19 @@
 // Initialize ID Authority variables:
 uint32 ItemFactory::m_nextEntityID = EVEMU_MINIMUM_ENTITY_ID;
 
-ItemFactory::ItemFactory(EntityList& el) : entity_list(el) {}
+const uint32 ItemFactory::EVICT_INTERVAL_MS = 60 * 1000;
+
+ItemFactory::ItemFactory(EntityList& el)
+: entity_list(el),
+  m_evictTimer(EVICT_INTERVAL_MS),
+  m_generation(0)
+{
+}
 
 ItemFactory::~ItemFactory() {
     // items
     {
-        std::map<uint32, InventoryItemRef>::const_iterator cur, end;
+        ItemMap::const_iterator cur, end;
 		uint32 total_item_count = m_items.size();
 		uint32 items_saved = 0;
 		float current_percent_items_saved = 0.0;
@@ -49,8 +58,8 @@ ItemFactory::~ItemFactory() {
         end = m_items.end();
         for(; cur != end; cur++) {
             // save attributes of item
-			if( IsNonStaticItem(cur->second->itemID()) )
-				cur->second->SaveItem();
+			if( IsNonStaticItem(cur->second.item->itemID()) )
+				cur->second.item->SaveItem();
 			
 			items_saved++;
 			if( ((float)items_saved / (float)total_item_count) > (current_percent_items_saved + 0.05) )
@@ -167,7 +176,7 @@ const StationType *ItemFactory::GetStationType(uint32 stationTypeID) {
 template<class _Ty>
 RefPtr<_Ty> ItemFactory::_GetItem(uint32 itemID)
 {
-    std::map<uint32, InventoryItemRef>::iterator res = m_items.find( itemID );
+    ItemMap::iterator res = m_items.find( itemID );
     if( res == m_items.end() )
     {
         // load the item
@@ -176,10 +185,14 @@ RefPtr<_Ty> ItemFactory::_GetItem(uint32 itemID)
             return RefPtr<_Ty>();
 
         //we keep the original ref.
-        res = m_items.insert( std::make_pair( itemID, item ) ).first;
+        CachedItem entry;
+        entry.item = item;
+        res = m_items.insert( std::make_pair( itemID, entry ) ).first;
     }
+    res->second.generation = m_generation;
+
     // return to the user.
-    return RefPtr<_Ty>::StaticCast( res->second );
+    return RefPtr<_Ty>::StaticCast( res->second.item );
 }
 
 InventoryItemRef ItemFactory::GetItem(uint32 itemID)
@@ -243,7 +256,7 @@ InventoryItemRef ItemFactory::SpawnItem(ItemData &data) {
         return InventoryItemRef();
 
     // spawn successful; store the ref
-    m_items.insert( std::make_pair( i->itemID(), i ) );
+    _CacheItem( i );
     return i;
 }
 
@@ -252,7 +265,7 @@ BlueprintRef ItemFactory::SpawnBlueprint(ItemData &data, BlueprintData &bpData)
     if( !bi )
         return BlueprintRef();
 
-    m_items.insert( std::make_pair( bi->itemID(), bi ) );
+    _CacheItem( bi );
     return bi;
 }
 
@@ -261,7 +274,7 @@ CharacterRef ItemFactory::SpawnCharacter(ItemData &data, CharacterData &charData
     if( !c )
         return CharacterRef();
 
-    m_items.insert( std::make_pair( c->itemID(), c ) );
+    _CacheItem( c );
     return c;
 }
 
@@ -270,7 +283,7 @@ ShipRef ItemFactory::SpawnShip(ItemData &data) {
     if( !s )
         return ShipRef();
 
-    m_items.insert( std::make_pair( s->itemID(), s ) );
+    _CacheItem( s );
     return s;
 }
 
@@ -280,7 +293,7 @@ SkillRef ItemFactory::SpawnSkill(ItemData &data)
     if( !s )
         return SkillRef();
 
-    m_items.insert( std::make_pair( s->itemID(), s ) );
+    _CacheItem( s );
     return s;
 }
 
@@ -290,7 +303,7 @@ OwnerRef ItemFactory::SpawnOwner(ItemData &data)
     if( !o )
         return OwnerRef();
 
-    m_items.insert( std::make_pair( o->itemID(), o ) );
+    _CacheItem( o );
     return o;
 }
 
@@ -300,7 +313,7 @@ StructureRef ItemFactory::SpawnStructure(ItemData &data)
     if( !o )
         return StructureRef();
 
-    m_items.insert( std::make_pair( o->itemID(), o ) );
+    _CacheItem( o );
     return o;
 }
 
@@ -310,7 +323,7 @@ CargoContainerRef ItemFactory::SpawnCargoContainer(ItemData &data)
     if( !o )
         return CargoContainerRef();
 
-    m_items.insert( std::make_pair( o->itemID(), o ) );
+    _CacheItem( o );
     return o;
 }
 
@@ -322,17 +335,91 @@ Inventory *ItemFactory::GetInventory(uint32 inventoryID, bool load)
         item = GetItem( inventoryID );
     else
     {
-        std::map<uint32, InventoryItemRef>::iterator res = m_items.find( inventoryID );
+        ItemMap::iterator res = m_items.find( inventoryID );
         if( res != m_items.end() )
-            item = res->second;
+            item = res->second.item;
     }
 
     return Inventory::Cast( item );
 }
 
+void ItemFactory::Process()
+{
+    if( !m_evictTimer.Check() )
+        return;
+
+    // items requested from now on belong to the new generation
+    const uint32 oldGeneration = m_generation++;
+
+    const uint32 budget = sConfig.world.itemCacheSize;
+    if( 0 == budget || m_items.size() <= budget )
+        return;
+
+    // collect idle items, ordered by the generation they were last used in
+    std::multimap<uint32, uint32> candidates;
+
+    ItemMap::const_iterator cur, end;
+    cur = m_items.begin();
+    end = m_items.end();
+    for(; cur != end; ++cur)
+    {
+        if( cur->second.generation <= oldGeneration && _IsEvictable( cur->second.item ) )
+            candidates.insert( std::make_pair( cur->second.generation, cur->first ) );
+    }
+
+    const size_t before = m_items.size();
+
+    std::multimap<uint32, uint32>::const_iterator cCur, cEnd;
+    cCur = candidates.begin();
+    cEnd = candidates.end();
+    for(; cCur != cEnd && m_items.size() > budget; ++cCur)
+    {
+        ItemMap::iterator res = m_items.find( cCur->second );
+        if( res == m_items.end() )
+            continue;
+
+        // keep our own ref until the entry is gone so the item
+        // is destroyed outside of the map
+        InventoryItemRef item = res->second.item;
+        item->SaveItem();
+
+        m_items.erase( res );
+    }
+
+    _log( ITEM__DEBUG, "Evicted %u idle items, %u remain cached (budget %u).",
+          (uint32)( before - m_items.size() ), (uint32)m_items.size(), budget );
+}
+
+void ItemFactory::_CacheItem(const InventoryItemRef &item)
+{
+    CachedItem entry;
+    entry.item = item;
+    entry.generation = m_generation;
+
+    m_items.insert( std::make_pair( item->itemID(), entry ) );
+}
+
+bool ItemFactory::_IsEvictable(const InventoryItemRef &item) const
+{
+    // static map items are shared by everybody and cheap to keep
+    if( !IsNonStaticItem( item->itemID() ) )
+        return false;
+
+    // anybody besides us holding a ref (a client, a bound object,
+    // a parent inventory, a system entity) keeps the item alive
+    if( 1 < item->GetRefCount() )
+        return false;
+
+    // items of characters which are logged in stay around
+    if( NULL != entity_list.FindCharacter( item->ownerID() ) )
+        return false;
+
+    return true;
+}
+
 void ItemFactory::_DeleteItem(uint32 itemID)
 {
-    std::map<uint32, InventoryItemRef>::iterator res = m_items.find( itemID );
+    ItemMap::iterator res = m_items.find( itemID );
     if( res == m_items.end() )
     {
         sLog.Error("Item Factory", "Item ID %u not found when requesting deletion!", itemID );
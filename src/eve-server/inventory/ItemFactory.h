@@ -231,6 +231,20 @@ public:
      */
     Inventory *GetInventory(uint32 inventoryID, bool load=true);
 
+    /**
+     * Unloads idle items once the cache grows over its budget.
+     *
+     * Items that are not referenced outside of the cache, are not
+     * owned by an online character and have not been requested
+     * during the last generation are saved and dropped, oldest first.
+     */
+    void Process();
+
+    /**
+     * @return Number of items currently cached.
+     */
+    size_t GetItemCount() const { return m_items.size(); }
+
     void SetUsingClient(Client *pClient);
 
     Client * GetUsingClient();
@@ -266,9 +280,23 @@ protected:
     template<class _Ty>
     RefPtr<_Ty> _GetItem(uint32 itemID);
 
+    void _CacheItem(const InventoryItemRef &item);
     void _DeleteItem(uint32 itemID);
+    bool _IsEvictable(const InventoryItemRef &item) const;
+
+    struct CachedItem
+    {
+        InventoryItemRef item;
+        uint32 generation;    // generation in which the item was last requested.
+    };
+    typedef std::map<uint32, CachedItem> ItemMap;
+    ItemMap m_items;
+
+    // Eviction:
+    static const uint32 EVICT_INTERVAL_MS;
 
-    std::map<uint32, InventoryItemRef> m_items;
+    Timer m_evictTimer;
+    uint32 m_generation;
 
 	// ID Authority:
 	static uint32 m_nextEntityID;		// holds the next valid ID for in-memory only objects of EVEDB::invCategories::Entity
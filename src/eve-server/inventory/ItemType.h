@@ -28,6 +28,7 @@
 
 #include "inventory/EVEAttributeMgr.h"
 #include "inventory/ItemFactory.h"
+#include "inventory/StaticDataMgr.h"
 
 /*
  * LOADING INVOKATION EXPLANATION:
@@ -334,7 +335,7 @@ protected:
     {
         // pull data
         TypeData data;
-        if( !factory.db().GetType( typeID, data ) )
+        if( !sStaticData.GetType( typeID, data ) && !factory.db().GetType( typeID, data ) )
             return NULL;
 
         // obtain group
@@ -0,0 +1,289 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-server.h"
+
+#include "inventory/EVEAttributeMgr.h"
+#include "inventory/InventoryDB.h"
+#include "inventory/ItemType.h"
+#include "inventory/StaticDataMgr.h"
+#include "system/SystemDB.h"
+
+namespace
+{
+    const char* GetString( const DBResultRow& row, uint32 index )
+    {
+        return row.IsNull( index ) ? "" : row.GetText( index );
+    }
+
+    uint32 GetUInt( const DBResultRow& row, uint32 index )
+    {
+        return row.IsNull( index ) ? 0 : row.GetUInt( index );
+    }
+
+    double GetDouble( const DBResultRow& row, uint32 index )
+    {
+        return row.IsNull( index ) ? 0.0 : row.GetDouble( index );
+    }
+}
+
+/*************************************************************************/
+/* StaticDataMgr                                                         */
+/*************************************************************************/
+StaticDataMgr::StaticDataMgr()
+{
+}
+
+int StaticDataMgr::Initialize( const std::string& path )
+{
+    mSnapshot.Close();
+
+    if( path.empty() )
+    {
+        sLog.Log( "StaticDataMgr", "Static data snapshot disabled." );
+        return 0;
+    }
+
+    uint32 stamp;
+    if( !_GetStamp( stamp ) )
+        return 0;
+
+    if( !mSnapshot.Open( path.c_str(), stamp ) )
+    {
+        sLog.Log( "StaticDataMgr", "Compiling static data snapshot %s ...", path.c_str() );
+
+        // make sure the directory exists
+        const size_t slash = path.find_last_of( "/\\" );
+        if( std::string::npos != slash )
+            CreateDirectory( path.substr( 0, slash ).c_str(), NULL );
+
+        if( !_Compile( path.c_str(), stamp ) || !mSnapshot.Open( path.c_str(), stamp ) )
+        {
+            sLog.Error( "StaticDataMgr", "Unable to create static data snapshot %s; using the database.", path.c_str() );
+            return 0;
+        }
+    }
+
+    sLog.Log( "StaticDataMgr", "Mapped static data snapshot %s.", path.c_str() );
+    return 1;
+}
+
+bool StaticDataMgr::GetCategory( EVEItemCategories category, CategoryData& into ) const
+{
+    const StaticDataSnapshot::CategoryRecord* record = mSnapshot.GetCategory( category );
+    if( NULL == record )
+        return false;
+
+    into.name = mSnapshot.GetString( record->name );
+    into.description = mSnapshot.GetString( record->description );
+    into.published = ( 0 != record->published );
+
+    return true;
+}
+
+bool StaticDataMgr::GetGroup( uint32 groupID, GroupData& into ) const
+{
+    const StaticDataSnapshot::GroupRecord* record = mSnapshot.GetGroup( groupID );
+    if( NULL == record )
+        return false;
+
+    into.category = EVEItemCategories( record->categoryID );
+    into.name = mSnapshot.GetString( record->name );
+    into.description = mSnapshot.GetString( record->description );
+    into.useBasePrice = ( 0 != ( record->flags & StaticDataSnapshot::GROUP_USE_BASE_PRICE ) );
+    into.allowManufacture = ( 0 != ( record->flags & StaticDataSnapshot::GROUP_ALLOW_MANUFACTURE ) );
+    into.allowRecycler = ( 0 != ( record->flags & StaticDataSnapshot::GROUP_ALLOW_RECYCLER ) );
+    into.anchored = ( 0 != ( record->flags & StaticDataSnapshot::GROUP_ANCHORED ) );
+    into.anchorable = ( 0 != ( record->flags & StaticDataSnapshot::GROUP_ANCHORABLE ) );
+    into.fittableNonSingleton = ( 0 != ( record->flags & StaticDataSnapshot::GROUP_FITTABLE_NON_SINGLETON ) );
+    into.published = ( 0 != ( record->flags & StaticDataSnapshot::GROUP_PUBLISHED ) );
+
+    return true;
+}
+
+bool StaticDataMgr::GetType( uint32 typeID, TypeData& into ) const
+{
+    const StaticDataSnapshot::TypeRecord* record = mSnapshot.GetType( typeID );
+    if( NULL == record )
+        return false;
+
+    into.groupID = record->groupID;
+    into.name = mSnapshot.GetString( record->name );
+    into.description = mSnapshot.GetString( record->description );
+    into.radius = record->radius;
+    into.mass = record->mass;
+    into.volume = record->volume;
+    into.capacity = record->capacity;
+    into.portionSize = record->portionSize;
+    into.race = EVERace( record->raceID );
+    into.basePrice = record->basePrice;
+    into.published = ( 0 != record->published );
+    into.marketGroupID = record->marketGroupID;
+    into.chanceOfDuplicating = record->chanceOfDuplicating;
+
+    return true;
+}
+
+bool StaticDataMgr::GetTypeEffects( uint32 typeID, std::vector<uint32>& into ) const
+{
+    const StaticDataSnapshot::TypeRecord* record = mSnapshot.GetType( typeID );
+    if( NULL == record )
+        return false;
+
+    const uint32* effects = mSnapshot.GetEffects( *record );
+    into.assign( effects, effects + record->effectCount );
+
+    return true;
+}
+
+bool StaticDataMgr::GetTypeAttributes( uint32 typeID, EVEAttributeMgr& into ) const
+{
+    const StaticDataSnapshot::TypeRecord* record = mSnapshot.GetType( typeID );
+    if( NULL == record )
+        return false;
+
+    const StaticDataSnapshot::AttributeRecord* attrs = mSnapshot.GetAttributes( *record );
+    for( uint32 i = 0; i < record->attributeCount; ++i )
+    {
+        const EVEAttributeMgr::Attr attr = EVEAttributeMgr::Attr( attrs[ i ].attributeID );
+        if( attrs[ i ].isInt )
+            into.SetInt( attr, attrs[ i ].valueInt );
+        else
+            into.SetReal( attr, attrs[ i ].valueFloat );
+    }
+
+    return true;
+}
+
+bool StaticDataMgr::GetWreckID( uint32 typeID, uint32& into ) const
+{
+    const StaticDataSnapshot::TypeRecord* record = mSnapshot.GetType( typeID );
+    if( NULL == record )
+        return false;
+
+    into = record->wreckTypeID;
+    return true;
+}
+
+bool StaticDataMgr::_GetStamp( uint32& stamp ) const
+{
+    DBQueryResult res;
+    DBResultRow row;
+
+    if( !InventoryDB::GetStaticDataCounts( res ) || !res.GetRow( row ) )
+        return false;
+
+    uint32 counts[ 6 ];
+    for( uint32 i = 0; i < 6; ++i )
+        counts[ i ] = GetUInt( row, i );
+
+    stamp = CRC32::Generate( reinterpret_cast<const uint8*>( counts ), sizeof( counts ) );
+    return true;
+}
+
+bool StaticDataMgr::_Compile( const char* path, uint32 stamp ) const
+{
+    StaticDataBuilder builder;
+    DBResultRow row;
+
+    DBQueryResult categories;
+    if( !InventoryDB::GetAllCategories( categories ) )
+        return false;
+    while( categories.GetRow( row ) )
+        builder.AddCategory( row.GetUInt( 0 ), GetString( row, 1 ), GetString( row, 2 ), 0 != row.GetInt( 3 ) );
+
+    DBQueryResult groups;
+    if( !InventoryDB::GetAllGroups( groups ) )
+        return false;
+    while( groups.GetRow( row ) )
+    {
+        uint8 flags = 0;
+        if( row.GetInt( 4 ) )
+            flags |= StaticDataSnapshot::GROUP_USE_BASE_PRICE;
+        if( row.GetInt( 5 ) )
+            flags |= StaticDataSnapshot::GROUP_ALLOW_MANUFACTURE;
+        if( row.GetInt( 6 ) )
+            flags |= StaticDataSnapshot::GROUP_ALLOW_RECYCLER;
+        if( row.GetInt( 7 ) )
+            flags |= StaticDataSnapshot::GROUP_ANCHORED;
+        if( row.GetInt( 8 ) )
+            flags |= StaticDataSnapshot::GROUP_ANCHORABLE;
+        if( row.GetInt( 9 ) )
+            flags |= StaticDataSnapshot::GROUP_FITTABLE_NON_SINGLETON;
+        if( row.GetInt( 10 ) )
+            flags |= StaticDataSnapshot::GROUP_PUBLISHED;
+
+        builder.AddGroup( row.GetUInt( 0 ), row.GetUInt( 1 ), GetString( row, 2 ), GetString( row, 3 ), flags );
+    }
+
+    DBQueryResult types;
+    if( !InventoryDB::GetAllTypes( types ) )
+        return false;
+    while( types.GetRow( row ) )
+    {
+        StaticDataSnapshot::TypeRecord type;
+        memset( &type, 0, sizeof( type ) );
+
+        type.groupID = row.GetUInt( 1 );
+        type.radius = GetDouble( row, 4 );
+        type.mass = GetDouble( row, 5 );
+        type.volume = GetDouble( row, 6 );
+        type.capacity = GetDouble( row, 7 );
+        type.portionSize = GetUInt( row, 8 );
+        type.raceID = GetUInt( row, 9 );
+        // see InventoryDB::GetType
+        type.basePrice = ( row.IsNull( 10 ) ? 0 : row.GetUInt64( 10 ) ) / 10000.0;
+        type.published = row.GetInt( 11 ) ? 1 : 0;
+        type.marketGroupID = GetUInt( row, 12 );
+        type.chanceOfDuplicating = GetDouble( row, 13 );
+
+        builder.AddType( row.GetUInt( 0 ), type, GetString( row, 2 ), GetString( row, 3 ) );
+    }
+
+    DBQueryResult attributes;
+    if( !InventoryDB::GetAllTypeAttributes( attributes ) )
+        return false;
+    while( attributes.GetRow( row ) )
+    {
+        // see dgmtypeattributemgr
+        if( row.IsNull( 2 ) )
+            builder.AddTypeAttribute( row.GetUInt( 0 ), row.GetUInt( 1 ), GetDouble( row, 3 ) );
+        else
+            builder.AddTypeAttribute( row.GetUInt( 0 ), row.GetUInt( 1 ), row.GetInt( 2 ) );
+    }
+
+    DBQueryResult effects;
+    if( !InventoryDB::GetAllTypeEffects( effects ) )
+        return false;
+    while( effects.GetRow( row ) )
+        builder.AddTypeEffect( row.GetUInt( 0 ), row.GetUInt( 1 ) );
+
+    DBQueryResult wrecks;
+    if( !SystemDB::GetWrecksToTypes( wrecks ) )
+        return false;
+    while( wrecks.GetRow( row ) )
+        builder.SetWreckType( row.GetUInt( 0 ), row.GetUInt( 1 ) );
+
+    return builder.Write( path, stamp );
+}
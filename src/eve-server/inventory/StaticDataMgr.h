@@ -0,0 +1,90 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __INVENTORY__STATIC_DATA_MGR_H__INCL__
+#define __INVENTORY__STATIC_DATA_MGR_H__INCL__
+
+#include "cache/StaticDataSnapshot.h"
+
+class CategoryData;
+class EVEAttributeMgr;
+class GroupData;
+class TypeData;
+
+/**
+ * @brief Item static data served from a mapped snapshot.
+ *
+ * At boot the snapshot file is mapped; if it is missing or does
+ * not match the database (by row counts of the source tables), it
+ * is compiled from the database first. Lookups then never touch
+ * the database, so first use of a type costs no query.
+ *
+ * All getters return false if the snapshot is not available or
+ * does not have the entry; callers fall back to the database.
+ */
+class StaticDataMgr
+: public Singleton< StaticDataMgr >
+{
+public:
+    StaticDataMgr();
+
+    /**
+     * @brief Maps the snapshot, compiling it if needed.
+     *
+     * @param[in] path Path of the snapshot file; empty disables the snapshot.
+     *
+     * @return 1 if the snapshot is available, 0 if not.
+     */
+    int Initialize( const std::string& path );
+
+    /** @return True if the snapshot is available. */
+    bool IsLoaded() const { return mSnapshot.IsOpen(); }
+    /** @return The snapshot. */
+    const StaticDataSnapshot& snapshot() const { return mSnapshot; }
+
+    bool GetCategory( EVEItemCategories category, CategoryData& into ) const;
+    bool GetGroup( uint32 groupID, GroupData& into ) const;
+    bool GetType( uint32 typeID, TypeData& into ) const;
+    bool GetTypeEffects( uint32 typeID, std::vector<uint32>& into ) const;
+    bool GetTypeAttributes( uint32 typeID, EVEAttributeMgr& into ) const;
+    bool GetWreckID( uint32 typeID, uint32& into ) const;
+
+protected:
+    /**
+     * @brief Obtains fingerprint of the source tables.
+     */
+    bool _GetStamp( uint32& stamp ) const;
+    /**
+     * @brief Compiles the snapshot from the database.
+     */
+    bool _Compile( const char* path, uint32 stamp ) const;
+
+    /// The snapshot.
+    StaticDataSnapshot mSnapshot;
+};
+
+#define sStaticData \
+    ( StaticDataMgr::get() )
+
+#endif /* !__INVENTORY__STATIC_DATA_MGR_H__INCL__ */
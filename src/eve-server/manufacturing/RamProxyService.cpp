@@ -40,7 +40,7 @@ RamProxyService::RamProxyService(PyServiceMgr *mgr)
     PyCallable_REG_CALL(RamProxyService, GetJobs2);
     PyCallable_REG_CALL(RamProxyService, AssemblyLinesSelect);
     PyCallable_REG_CALL(RamProxyService, AssemblyLinesGet);
-    PyCallable_REG_CALL(RamProxyService, InstallJob);
+    PyCallable_REG_CALL_DIRECT(RamProxyService, InstallJob);
     PyCallable_REG_CALL(RamProxyService, CompleteJob);
     PyCallable_REG_CALL(RamProxyService, GetRelevantCharSkills);
     PyCallable_REG_CALL(RamProxyService, AssemblyLinesSelectPublic);
@@ -120,7 +120,7 @@ PyResult RamProxyService::Handle_AssemblyLinesGet(PyCallArgs &call) {
 
 PyResult RamProxyService::Handle_InstallJob(PyCallArgs &call) {
     Call_InstallJob args;
-    if(!args.Decode(&call.tuple)) {
+    if(!call.Decode(args)) {
         _log(SERVICE__ERROR, "Failed to decode args.");
         return NULL;
     }
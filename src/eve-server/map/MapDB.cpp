@@ -104,26 +104,45 @@ PyObject *MapDB::GetStationCount() {
     return DBResultToRowset(res);
 }
 
+bool MapDB::GetSolarSystems(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " solarSystemID, constellationID, regionID, security"
+        " FROM mapSolarSystems"))
+    {
+        sLog.Error("MapDB::GetSolarSystems()", "Error in query: %s", res.error.c_str());
+        return false;
+    }
 
+    return true;
+}
 
+bool MapDB::GetSolarSystemJumps(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " fromSolarSystemID, toSolarSystemID"
+        " FROM mapSolarSystemJumps"))
+    {
+        sLog.Error("MapDB::GetSolarSystemJumps()", "Error in query: %s", res.error.c_str());
+        return false;
+    }
 
+    return true;
+}
 
+bool MapDB::GetStargateJumps(DBQueryResult &res)
+{
+    if(!sDatabase.RunQuery(res,
+        "SELECT"
+        " stargateID, celestialID, solarSystemID"
+        " FROM mapJumps"
+        "    LEFT JOIN mapDenormalize ON celestialID=itemID"))
+    {
+        sLog.Error("MapDB::GetStargateJumps()", "Error in query: %s", res.error.c_str());
+        return false;
+    }
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+    return true;
+}
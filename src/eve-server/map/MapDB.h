@@ -37,6 +37,10 @@ public:
     PyObject *GetStationServiceInfo();
     PyObject *GetStationCount();
 
+    static bool GetSolarSystems(DBQueryResult &res);
+    static bool GetSolarSystemJumps(DBQueryResult &res);
+    static bool GetStargateJumps(DBQueryResult &res);
+
 protected:
 };
 
@@ -0,0 +1,68 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-server.h"
+
+#include "map/MapDB.h"
+#include "map/UniverseMgr.h"
+
+/*************************************************************************/
+/* UniverseMgr                                                           */
+/*************************************************************************/
+UniverseMgr::UniverseMgr()
+: UniverseGraph( 1024 )
+{
+}
+
+int UniverseMgr::Initialize()
+{
+    _Populate();
+
+    sLog.Log( "UniverseMgr", "Loaded %lu solar systems, %lu jumps and %lu stargates.",
+              (unsigned long)GetSystemCount(), (unsigned long)GetJumpCount(), (unsigned long)GetStargateCount() );
+    return GetJumpCount();
+}
+
+void UniverseMgr::_Populate()
+{
+    Clear();
+
+    DBQueryResult systems, jumps, stargates;
+    DBResultRow row;
+
+    if( MapDB::GetSolarSystems( systems ) )
+        while( systems.GetRow( row ) )
+            AddSystem( row.GetUInt( 0 ), row.GetUInt( 1 ), row.GetUInt( 2 ), row.GetDouble( 3 ) );
+
+    if( MapDB::GetSolarSystemJumps( jumps ) )
+        while( jumps.GetRow( row ) )
+            AddJump( row.GetUInt( 0 ), row.GetUInt( 1 ) );
+
+    if( MapDB::GetStargateJumps( stargates ) )
+        while( stargates.GetRow( row ) )
+            if( !row.IsNull( 2 ) )
+                AddStargate( row.GetUInt( 0 ), row.GetUInt( 1 ), row.GetUInt( 2 ) );
+
+    Build();
+}
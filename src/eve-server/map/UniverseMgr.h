@@ -0,0 +1,58 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __MAP__UNIVERSE_MGR_H__INCL__
+#define __MAP__UNIVERSE_MGR_H__INCL__
+
+#include "map/UniverseGraph.h"
+
+/**
+ * @brief Universe graph loaded from the static data.
+ *
+ * Loaded once at boot from mapSolarSystems, mapSolarSystemJumps
+ * and mapJumps; answers jump distance, route, stargate and
+ * region/constellation queries without touching the database.
+ */
+class UniverseMgr
+: public UniverseGraph,
+  public Singleton< UniverseMgr >
+{
+public:
+    UniverseMgr();
+
+    /**
+     * @brief Loads the graph.
+     *
+     * @return Number of loaded jumps.
+     */
+    int Initialize();
+
+protected:
+    void _Populate();
+};
+
+#define sUniverse \
+    ( UniverseMgr::get() )
+
+#endif /* !__MAP__UNIVERSE_MGR_H__INCL__ */
@@ -25,6 +25,7 @@
 
 #include "eve-server.h"
 
+#include "map/UniverseMgr.h"
 #include "market/MarketDB.h"
 
 PyRep *MarketDB::GetStationAsks(uint32 stationID) {
@@ -221,6 +222,39 @@ PyRep *MarketDB::GetOrderRow(uint32 orderID) {
     return(DBRowToPackedRow(row));
 }
 
+bool MarketDB::GetOrderBook(uint32 regionID, uint32 typeID, DBQueryResult &into) {
+    //same columns as GetOrders(), both sides at once.
+    if(!sDatabase.RunQuery(into,
+        "SELECT"
+        "    price, volRemaining, typeID, `range`, orderID,"
+        "   volEntered, minVolume, bid, issued as issueDate, duration,"
+        "   stationID, regionID, solarSystemID, jumps"
+        " FROM market_orders"
+        " WHERE regionID=%u AND typeID=%u", regionID, typeID))
+    {
+        codelog(MARKET__ERROR, "Error in query: %s", into.error.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool MarketDB::GetOrderBookRow(uint32 orderID, DBQueryResult &into) {
+    if(!sDatabase.RunQuery(into,
+        "SELECT"
+        "    price, volRemaining, typeID, `range`, orderID,"
+        "   volEntered, minVolume, bid, issued as issueDate, duration,"
+        "   stationID, regionID, solarSystemID, jumps"
+        " FROM market_orders"
+        " WHERE orderID=%u", orderID))
+    {
+        codelog(MARKET__ERROR, "Error in query: %s", into.error.c_str());
+        return false;
+    }
+
+    return true;
+}
+
 PyRep *MarketDB::GetOldPriceHistory(uint32 regionID, uint32 typeID) {
     DBQueryResult res;
 
@@ -498,7 +532,7 @@ uint32 MarketDB::StoreBuyOrder(
     uint32 typeID,
     double price,
     uint32 quantity,
-    uint8 orderRange,
+    int32 orderRange,
     uint32 minVolume,
     uint8 duration,
     bool isCorp
@@ -513,7 +547,7 @@ uint32 MarketDB::StoreSellOrder(
     uint32 typeID,
     double price,
     uint32 quantity,
-    uint8 orderRange,
+    int32 orderRange,
     uint32 minVolume,
     uint8 duration,
     bool isCorp
@@ -521,28 +555,34 @@ uint32 MarketDB::StoreSellOrder(
     return(_StoreOrder(clientID, accountID, stationID, typeID, price, quantity, orderRange, minVolume, duration, isCorp, false));
 }
 
-//NOTE: needs a lot of work to implement orderRange
+//the range of the buy order decides whether the selling station is close enough.
 uint32 MarketDB::FindBuyOrder(
     uint32 stationID,
     uint32 typeID,
     double price,
     uint32 quantity,
-    uint32 orderRange
+    int32 orderRange
 ) {
+    uint32 solarSystemID;
+    uint32 regionID;
+    if(!GetStationInfo(stationID, &solarSystemID, NULL, &regionID, NULL, NULL, NULL)) {
+        codelog(MARKET__ERROR, "Failed to find parents for station %u", stationID);
+        return(0);
+    }
+
     DBQueryResult res;
 
     if(!sDatabase.RunQuery(res,
-        "SELECT orderID"
+        "SELECT orderID, stationID, solarSystemID, `range`"
         "    FROM market_orders"
         "    WHERE bid=1"
         "        AND typeID=%u"
-        "        AND stationID=%u"
+        "        AND regionID=%u"
         "        AND volRemaining >= %u"
         "        AND price <= %f"
-        "    ORDER BY price DESC"
-        "    LIMIT 1",    //right now, we just care about the first order which can satisfy our needs.
+        "    ORDER BY price DESC",
         typeID,
-        stationID,
+        regionID,
         quantity,
         price))
     {
@@ -550,19 +590,23 @@ uint32 MarketDB::FindBuyOrder(
         return false;
     }
 
+    //right now, we just care about the first order which can satisfy our needs.
     DBResultRow row;
-    if(!res.GetRow(row))
-        return(0);    //no order found.
+    while(res.GetRow(row)) {
+        if(sUniverse.IsInOrderRange(row.GetInt(3), row.GetUInt(1), row.GetUInt(2), stationID, solarSystemID))
+            return(row.GetUInt(0));
+    }
 
-    return(row.GetUInt(0));
+    return(0);    //no order found.
 }
 
+//NOTE: the client sends the station of the sell order, so the buyer's range doesn't widen the search.
 uint32 MarketDB::FindSellOrder(
     uint32 stationID,
     uint32 typeID,
     double price,
     uint32 quantity,
-    uint32 orderRange
+    int32 orderRange
 ) {
     DBQueryResult res;
 
@@ -739,7 +783,7 @@ uint32 MarketDB::_StoreOrder(
     uint32 typeID,
     double price,
     uint32 quantity,
-    uint8 orderRange,
+    int32 orderRange,
     uint32 minVolume,
     uint8 duration,
     bool isCorp,
@@ -766,7 +810,7 @@ uint32 MarketDB::_StoreOrder(
         "    isCorp, solarSystemID, escrow, jumps "
         " ) VALUES ("
         "    %u, %u, %u, %u, "
-        "    %u, %u, %f, %u, %u, %" PRIu64 ", "
+        "    %d, %u, %f, %u, %u, %" PRIu64 ", "
         "    1, %u, 0, %u, %u, "
         "    %u, %u, 0, 1"
         " )",
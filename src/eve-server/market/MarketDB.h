@@ -51,6 +51,10 @@ public:
     PyRep *GetCharOrders(uint32 characterID);
     PyRep *GetOrderRow(uint32 orderID);
 
+    //raw rows for MarketOrderBook:
+    bool GetOrderBook(uint32 regionID, uint32 typeID, DBQueryResult &into);
+    bool GetOrderBookRow(uint32 orderID, DBQueryResult &into);
+
     PyRep *GetOldPriceHistory(uint32 regionID, uint32 typeID);
     PyRep *GetNewPriceHistory(uint32 regionID, uint32 typeID);
     PyRep *GetTransactions(uint32 characterID, uint32 typeID, uint32 quantity, double minPrice, double maxPrice, uint64 fromDate, int buySell);
@@ -59,8 +63,8 @@ public:
     PyObject *GetRefTypes();
     PyObject *GetCorporationBills(uint32 corpID, bool payable);
 
-    uint32 FindBuyOrder(uint32 stationID, uint32 typeID, double price, uint32 quantity, uint32 orderRange);
-    uint32 FindSellOrder(uint32 stationID, uint32 typeID, double price, uint32 quantity, uint32 orderRange);
+    uint32 FindBuyOrder(uint32 stationID, uint32 typeID, double price, uint32 quantity, int32 orderRange);
+    uint32 FindSellOrder(uint32 stationID, uint32 typeID, double price, uint32 quantity, int32 orderRange);
 
     bool GetOrderInfo(uint32 orderID, uint32 *orderOwnerID, uint32 *typeID, uint32 *stationID, uint32 *quantity, double *price, bool *isBuy, bool *isCorp);
     bool AlterOrderQuantity(uint32 orderID, uint32 new_qty);
@@ -69,14 +73,14 @@ public:
 
     bool AddCharacterBalance(uint32 char_id, double delta);
 
-    uint32 StoreBuyOrder(uint32 clientID, uint32 accountID, uint32 stationID, uint32 typeID, double price, uint32 quantity, uint8 orderRange, uint32 minVolume, uint8 duration, bool isCorp);
-    uint32 StoreSellOrder(uint32 clientID, uint32 accountID, uint32 stationID, uint32 typeID, double price, uint32 quantity, uint8 orderRange, uint32 minVolume, uint8 duration, bool isCorp);
+    uint32 StoreBuyOrder(uint32 clientID, uint32 accountID, uint32 stationID, uint32 typeID, double price, uint32 quantity, int32 orderRange, uint32 minVolume, uint8 duration, bool isCorp);
+    uint32 StoreSellOrder(uint32 clientID, uint32 accountID, uint32 stationID, uint32 typeID, double price, uint32 quantity, int32 orderRange, uint32 minVolume, uint8 duration, bool isCorp);
     bool RecordTransaction(uint32 typeID, uint32 quantity, double price, MktTransType ttype, uint32 charID, uint32 regionID, uint32 stationID);
 
     bool BuildOldPriceHistory();
 
 protected:
-    uint32 _StoreOrder(uint32 clientID, uint32 accountID, uint32 stationID, uint32 typeID, double price, uint32 quantity, uint8 orderRange, uint32 minVolume, uint8 duration, bool isCorp, bool isBuy);
+    uint32 _StoreOrder(uint32 clientID, uint32 accountID, uint32 stationID, uint32 typeID, double price, uint32 quantity, int32 orderRange, uint32 minVolume, uint8 duration, bool isCorp, bool isBuy);
 };
 
 
@@ -0,0 +1,172 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-server.h"
+
+#include "map/UniverseMgr.h"
+#include "market/MarketDB.h"
+#include "market/MarketOrderBook.h"
+
+/* column indexes of MarketDB::GetOrderBook() */
+static const uint32 ORDER_ID_COLUMN = 4;
+static const uint32 BID_COLUMN = 7;
+static const uint32 SOLAR_SYSTEM_ID_COLUMN = 12;
+static const uint32 JUMPS_COLUMN = 13;
+
+/*************************************************************************/
+/* MarketOrderBook                                                       */
+/*************************************************************************/
+MarketOrderBook::MarketOrderBook()
+: mHeader( NULL ),
+  mVersion( 0 )
+{
+}
+
+MarketOrderBook::~MarketOrderBook()
+{
+    OrderMap::iterator cur, end;
+    cur = mOrders.begin();
+    end = mOrders.end();
+    for(; cur != end; ++cur )
+        PyDecRef( cur->second.row );
+
+    PySafeDecRef( mHeader );
+}
+
+void MarketOrderBook::Load( DBQueryResult& res )
+{
+    PySafeDecRef( mHeader );
+    mHeader = new DBRowDescriptor( res );
+
+    DBResultRow row;
+    while( res.GetRow( row ) )
+        _Set( row );
+
+    mEncodedFor.clear();
+}
+
+void MarketOrderBook::Update( uint32 orderID, DBQueryResult& res )
+{
+    DBResultRow row;
+    if( NULL != mHeader && res.GetRow( row ) && row.GetUInt( ORDER_ID_COLUMN ) == orderID )
+        _Set( row );
+    else
+        Remove( orderID );
+}
+
+void MarketOrderBook::Remove( uint32 orderID )
+{
+    OrderMap::iterator res = mOrders.find( orderID );
+    if( mOrders.end() == res )
+        return;
+
+    mVersion ^= res->second.hash;
+    PyDecRef( res->second.row );
+    mOrders.erase( res );
+
+    mEncodedFor.clear();
+}
+
+PyList* MarketOrderBook::Encode( uint32 fromSystemID )
+{
+    PyList* result = new PyList;
+
+    // sell orders first, then buy orders
+    for( uint32 side = 0; side < 2; ++side )
+    {
+        const bool bid = ( TransactionTypeBuy == side );
+
+        PyIncRef( mHeader );
+        DBRowDescriptor* header = mHeader;
+        CRowSet* rowset = new CRowSet( &header );
+
+        OrderMap::const_iterator cur, end;
+        cur = mOrders.begin();
+        end = mOrders.end();
+        for(; cur != end; ++cur )
+        {
+            const Order& order = cur->second;
+            if( order.bid != bid )
+                continue;
+
+            int32 jumps = sUniverse.GetJumps( fromSystemID, order.solarSystemID );
+            if( UniverseGraph::NO_ROUTE == jumps )
+                jumps = order.jumps;
+            order.row->SetField( JUMPS_COLUMN, new PyInt( jumps ) );
+
+            PyIncRef( order.row );
+            rowset->list().AddItem( order.row );
+        }
+
+        result->AddItem( rowset );
+    }
+
+    mEncodedFor.insert( fromSystemID );
+    return result;
+}
+
+void MarketOrderBook::_Set( const DBResultRow& row )
+{
+    const uint32 orderID = row.GetUInt( ORDER_ID_COLUMN );
+
+    OrderMap::iterator res = mOrders.find( orderID );
+    if( mOrders.end() != res )
+    {
+        mVersion ^= res->second.hash;
+        PyDecRef( res->second.row );
+    }
+    else
+        res = mOrders.insert( std::make_pair( orderID, Order() ) ).first;
+
+    PyIncRef( mHeader );
+
+    Order& order = res->second;
+    order.row = CreatePackedRow( row, mHeader );
+    order.bid = ( TransactionTypeBuy == row.GetInt( BID_COLUMN ) );
+    order.hash = _Hash( row );
+    order.solarSystemID = row.GetUInt( SOLAR_SYSTEM_ID_COLUMN );
+    order.jumps = row.IsNull( JUMPS_COLUMN ) ? 0 : row.GetInt( JUMPS_COLUMN );
+
+    mVersion ^= order.hash;
+    mEncodedFor.clear();
+}
+
+uint32 MarketOrderBook::_Hash( const DBResultRow& row )
+{
+    static const uint8 NULL_MARKER = 0xFF;
+    static const uint8 SEPARATOR = 0x00;
+
+    uint32 crc = 0xFFFFFFFF;
+    for( uint32 i = 0; i < row.ColumnCount(); ++i )
+    {
+        if( row.IsNull( i ) )
+            crc = CRC32::Update( &NULL_MARKER, 1, crc );
+        else
+            crc = CRC32::Update( reinterpret_cast<const uint8*>( row.GetText( i ) ), row.ColumnLength( i ), crc );
+
+        crc = CRC32::Update( &SEPARATOR, 1, crc );
+    }
+
+    return CRC32::Finish( crc );
+}
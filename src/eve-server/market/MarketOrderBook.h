@@ -0,0 +1,113 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __MARKET__MARKET_ORDER_BOOK_H__INCL__
+#define __MARKET__MARKET_ORDER_BOOK_H__INCL__
+
+/**
+ * @brief In-memory GetOrders rowsets of one type in one region.
+ *
+ * Loaded once from the database; afterwards each placed, modified,
+ * filled or cancelled order is applied as a delta, replacing just
+ * that order's packed row. Unchanged rows are shared by all encoded
+ * results.
+ *
+ * The version stamp is the XOR of per-row hashes, so it is kept up
+ * to date in constant time per delta instead of checksumming the
+ * whole marshaled object.
+ *
+ * The jumps column depends on the requester's solar system; it is
+ * filled from the universe graph when the rowsets are built.
+ */
+class MarketOrderBook
+{
+public:
+    MarketOrderBook();
+    ~MarketOrderBook();
+
+    /** @return True if changed since the last Encode() for the system. */
+    bool IsDirty( uint32 fromSystemID ) const { return 0 == mEncodedFor.count( fromSystemID ); }
+    /** @return Version stamp of the contents. */
+    uint32 GetVersion() const { return mVersion; }
+    /** @return Number of orders. */
+    size_t GetOrderCount() const { return mOrders.size(); }
+
+    /**
+     * @brief Loads all orders.
+     *
+     * @param[in] res Result of MarketDB::GetOrderBook().
+     */
+    void Load( DBQueryResult& res );
+    /**
+     * @brief Applies change of an order.
+     *
+     * @param[in] orderID ID of the changed order.
+     * @param[in] res     Result of MarketDB::GetOrderBookRow(); empty if the order is gone.
+     */
+    void Update( uint32 orderID, DBQueryResult& res );
+    /**
+     * @brief Removes an order.
+     */
+    void Remove( uint32 orderID );
+
+    /**
+     * @brief Builds the GetOrders result.
+     *
+     * The rows are shared with earlier results, so those must
+     * have been marshaled already.
+     *
+     * @param[in] fromSystemID Solar system the jumps are counted from.
+     *
+     * @return List of sell and buy CRowsets (new reference).
+     */
+    PyList* Encode( uint32 fromSystemID );
+
+protected:
+    struct Order
+    {
+        PyPackedRow* row;
+        bool bid;
+        uint32 hash;
+        uint32 solarSystemID;
+        /// Value of the jumps column in the database.
+        int32 jumps;
+    };
+    typedef std::map<uint32, Order> OrderMap;
+
+    /** @brief Adds or replaces the order in the row. */
+    void _Set( const DBResultRow& row );
+    /** @return Hash of the row's columns. */
+    static uint32 _Hash( const DBResultRow& row );
+
+    /// Header of the rowsets.
+    DBRowDescriptor* mHeader;
+    /// Orders by orderID.
+    OrderMap mOrders;
+    /// XOR of order hashes.
+    uint32 mVersion;
+    /// Systems for which nothing changed since the last Encode().
+    std::set<uint32> mEncodedFor;
+};
+
+#endif /* !__MARKET__MARKET_ORDER_BOOK_H__INCL__ */
@@ -42,10 +42,10 @@ MarketProxyService::MarketProxyService(PyServiceMgr *mgr)
     PyCallable_REG_CALL(MarketProxyService, GetSystemAsks)
     PyCallable_REG_CALL(MarketProxyService, GetRegionBest)
     PyCallable_REG_CALL(MarketProxyService, GetMarketGroups)
-    PyCallable_REG_CALL(MarketProxyService, GetOrders)
-    PyCallable_REG_CALL(MarketProxyService, GetOldPriceHistory)
-    PyCallable_REG_CALL(MarketProxyService, GetNewPriceHistory)
-    PyCallable_REG_CALL(MarketProxyService, PlaceCharOrder)
+    PyCallable_REG_CALL_DIRECT(MarketProxyService, GetOrders)
+    PyCallable_REG_CALL_DIRECT(MarketProxyService, GetOldPriceHistory)
+    PyCallable_REG_CALL_DIRECT(MarketProxyService, GetNewPriceHistory)
+    PyCallable_REG_CALL_DIRECT(MarketProxyService, PlaceCharOrder)
     PyCallable_REG_CALL(MarketProxyService, GetCharOrders)
     PyCallable_REG_CALL(MarketProxyService, ModifyCharOrder)
     PyCallable_REG_CALL(MarketProxyService, CancelCharOrder)
@@ -55,6 +55,12 @@ MarketProxyService::MarketProxyService(PyServiceMgr *mgr)
 
 MarketProxyService::~MarketProxyService() {
     delete m_dispatch;
+
+    OrderBookMap::iterator cur, end;
+    cur = m_orderBooks.begin();
+    end = m_orderBooks.end();
+    for(; cur != end; cur++)
+        delete cur->second;
 }
 
 
@@ -152,7 +158,7 @@ PyResult MarketProxyService::Handle_GetMarketGroups(PyCallArgs &call) {
 
 PyResult MarketProxyService::Handle_GetOrders(PyCallArgs &call) {
     Call_SingleIntegerArg args; //itemID
-    if(!args.Decode(&call.tuple)) {
+    if(!call.Decode(args)) {
         codelog(MARKET__ERROR, "Invalid arguments");
         return NULL;
     }
@@ -180,39 +186,29 @@ PyResult MarketProxyService::Handle_GetOrders(PyCallArgs &call) {
     return result;*/
     PyRep *result = NULL;
 
+    uint32 regionID = call.client->GetRegionID();
+    MarketOrderBook *book = _GetOrderBook(regionID, args.arg);
+    if(book == NULL) {
+        _log(SERVICE__ERROR, "%s: Failed to load GetOrders for item %u of region %u", call.client->GetName(), args.arg, regionID);
+        return NULL;
+    }
+
+    //the jumps column is counted from the caller's system, so the result is per system.
+    uint32 systemID = call.client->GetSystemID();
     std::string method_name ("GetOrders_");
+    method_name += itoa(systemID);
+    method_name += "_";
     method_name += itoa(args.arg);
     ObjectCachedMethodID method_id(GetName(), method_name.c_str());
 
 #   pragma message( "TODO: temporary solution, make cache objects with arguments" )
 
-#    pragma message("TODO: need to check if cache is refreshed when marker orders change.")
-//    m_manager->cache_service->InvalidateCache(method_id);
-    
-    //check to see if this method is in the cache already.
-    if(!m_manager->cache_service->IsCacheLoaded(method_id))
+    //re-encode only if an order changed since the last request;
+    //the book keeps its version stamp up to date per order.
+    if(book->IsDirty(systemID) || !m_manager->cache_service->IsCacheLoaded(method_id))
     {
-        //this method is not in cache yet, load up the contents and cache it.
-        uint32 locid = call.client->GetSystemID();
-        if(!IsSolarSystem(locid))
-        {
-            codelog(SERVICE__ERROR, "%s: GetSystemID() returned a non-system %u!", call.client->GetName(), locid);
-            return NULL;
-        }
-
-        uint32 regionID;
-        if(!m_db.GetSystemInfo(locid, NULL, &regionID, NULL, NULL))
-        {
-            codelog(SERVICE__ERROR, "%s: Failed to find parents of system %u!", call.client->GetName(), locid);
-            return NULL;
-        }
-
-        result = m_db.GetOrders(regionID, args.arg);
-        if(result == NULL) {
-            codelog(SERVICE__ERROR, "Failed to load cache, generating empty contents.");
-            result = new PyNone();
-        }
-        m_manager->cache_service->GiveCache(method_id, &result);
+        result = book->Encode(systemID);
+        m_manager->cache_service->GiveCache(method_id, &result, book->GetVersion());
     }
 
     //now we know its in the cache one way or the other, so build a
@@ -237,7 +233,7 @@ PyResult MarketProxyService::Handle_GetCharOrders(PyCallArgs &call) {
 
 PyResult MarketProxyService::Handle_GetOldPriceHistory(PyCallArgs &call) {
     Call_SingleIntegerArg args; //itemID
-    if(!args.Decode(&call.tuple)) {
+    if(!call.Decode(args)) {
         codelog(MARKET__ERROR, "Invalid arguments");
         return NULL;
     }
@@ -267,7 +263,7 @@ PyResult MarketProxyService::Handle_GetOldPriceHistory(PyCallArgs &call) {
 
 PyResult MarketProxyService::Handle_GetNewPriceHistory(PyCallArgs &call) {
     Call_SingleIntegerArg args; //itemID
-    if(!args.Decode(&call.tuple)) {
+    if(!call.Decode(args)) {
         codelog(MARKET__ERROR, "Invalid arguments");
         return NULL;
     }
@@ -297,7 +293,7 @@ PyResult MarketProxyService::Handle_GetNewPriceHistory(PyCallArgs &call) {
 
 PyResult MarketProxyService::Handle_PlaceCharOrder(PyCallArgs &call) {
     Call_PlaceCharOrder args;
-    if(!args.Decode(&call.tuple)) {
+    if(!call.Decode(args)) {
         codelog(MARKET__ERROR, "Invalid arguments");
         return NULL;
     }
@@ -315,7 +311,7 @@ PyResult MarketProxyService::Handle_PlaceCharOrder(PyCallArgs &call) {
             args.quantity,
             args.orderRange);
         if(order_id != 0) {
-            _log(MARKET__TRACE, "%s: Found sell order %u to satisfy (type %u, station %u, price %f, qty %u, range %u)", call.client->GetName(), order_id, args.stationID, args.typeID, args.price, args.quantity, args.orderRange);
+            _log(MARKET__TRACE, "%s: Found sell order %u to satisfy (type %u, station %u, price %f, qty %u, range %d)", call.client->GetName(), order_id, args.stationID, args.typeID, args.price, args.quantity, args.orderRange);
 
             _ExecuteSellOrder(order_id, args.stationID, args.quantity, call.client, args.useCorp);
             return NULL;
@@ -360,7 +356,7 @@ PyResult MarketProxyService::Handle_PlaceCharOrder(PyCallArgs &call) {
         }
 
         //send notification of new order...
-        _InvalidateOrdersCache(args.typeID);
+        _UpdateOrdersCache(args.typeID, orderID);
         _BroadcastOnOwnOrderChanged(call.client->GetRegionID(), orderID, "Add", args.useCorp);
     } else {
         //sell order
@@ -418,14 +414,14 @@ PyResult MarketProxyService::Handle_PlaceCharOrder(PyCallArgs &call) {
             args.quantity,
             args.orderRange);
         if(order_id != 0) {
-            _log(MARKET__TRACE, "%s: Found order %u to satisfy (type %u, station %u, price %f, qty %u, range %u)", call.client->GetName(), order_id, args.stationID, args.typeID, args.price, args.quantity, args.orderRange);
+            _log(MARKET__TRACE, "%s: Found order %u to satisfy (type %u, station %u, price %f, qty %u, range %d)", call.client->GetName(), order_id, args.stationID, args.typeID, args.price, args.quantity, args.orderRange);
 
             _ExecuteBuyOrder(order_id, args.stationID, args.quantity, call.client, (InventoryItemRef)item, args.useCorp);
             return NULL;
         }
 
         //else, unable to satisfy immediately...
-        _log(MARKET__TRACE, "%s: Unable to find an immediate order to satisfy (type %u, station %u, price %f, qty %u, range %u)", call.client->GetName(), args.stationID, args.typeID, args.price, args.quantity, args.orderRange);
+        _log(MARKET__TRACE, "%s: Unable to find an immediate order to satisfy (type %u, station %u, price %f, qty %u, range %d)", call.client->GetName(), args.stationID, args.typeID, args.price, args.quantity, args.orderRange);
 
         if(args.duration == 0) {
             _log(MARKET__ERROR, "%s: Failed to satisfy order for %d of %d at %f ISK.", call.client->GetName(), args.typeID, args.quantity, args.price);
@@ -464,7 +460,7 @@ PyResult MarketProxyService::Handle_PlaceCharOrder(PyCallArgs &call) {
         }
 
         //notify client about new order.
-        _InvalidateOrdersCache(args.typeID);
+        _UpdateOrdersCache(args.typeID, orderID);
         _BroadcastOnOwnOrderChanged(call.client->GetRegionID(), orderID, "Add", args.useCorp);
     }
 
@@ -506,7 +502,7 @@ PyResult MarketProxyService::Handle_ModifyCharOrder(PyCallArgs &call) {
         return NULL;
     }
 
-    _InvalidateOrdersCache(typeID);
+    _UpdateOrdersCache(typeID, args.orderID);
     _BroadcastOnOwnOrderChanged(call.client->GetRegionID(), args.orderID, "Modify", isCorp); //force a refresh of market data.
 
     return NULL;
@@ -560,7 +556,7 @@ PyResult MarketProxyService::Handle_CancelCharOrder(PyCallArgs &call) {
         codelog(MARKET__ERROR, "Failed to delete order %u.", args.orderID);
         return NULL;
     }
-    _InvalidateOrdersCache(typeID);
+    _UpdateOrdersCache(typeID, args.orderID);
     _BroadcastOnOwnOrderChanged(call.client->GetRegionID(), args.orderID, "Expiry", isCorp, order); //force a refresh of market data.
     _BroadcastOnMarketRefresh(call.client->GetRegionID());
 
@@ -647,12 +643,58 @@ void MarketProxyService::_BroadcastOnMarketRefresh(uint32 regionID) {
     }
 }
 
-void MarketProxyService::_InvalidateOrdersCache(uint32 typeID)
+MarketOrderBook *MarketProxyService::_GetOrderBook(uint32 regionID, uint32 typeID)
 {
-    std::string method_name ("GetOrders_");
-    method_name += itoa(typeID);
-    ObjectCachedMethodID method_id(GetName(), method_name.c_str());
-    m_manager->cache_service->InvalidateCache( method_id );
+    const std::pair<uint32, uint32> key(typeID, regionID);
+
+    OrderBookMap::iterator res = m_orderBooks.find(key);
+    if(res != m_orderBooks.end())
+        return res->second;
+
+    DBQueryResult orders;
+    if(!m_db.GetOrderBook(regionID, typeID, orders))
+        return NULL;
+
+    MarketOrderBook *book = new MarketOrderBook;
+    book->Load(orders);
+    _log(MARKET__TRACE, "Loaded %lu orders for item %u of region %u.", book->GetOrderCount(), typeID, regionID);
+
+    m_orderBooks.insert(std::make_pair(key, book));
+    return book;
+}
+
+void MarketProxyService::_UpdateOrdersCache(uint32 typeID, uint32 orderID)
+{
+    //books of other types can't hold this order.
+    OrderBookMap::iterator cur = m_orderBooks.lower_bound(std::make_pair(typeID, 0u));
+    if(cur == m_orderBooks.end() || cur->first.first != typeID)
+        return;
+
+    //fetch just this order; it is missing if deleted.
+    DBQueryResult res;
+    if(!m_db.GetOrderBookRow(orderID, res)) {
+        //can't apply the delta; drop the books so they reload.
+        for(; cur != m_orderBooks.end() && cur->first.first == typeID; )
+        {
+            delete cur->second;
+            m_orderBooks.erase(cur++);
+        }
+        return;
+    }
+
+    DBResultRow row;
+    uint32 regionID = 0;
+    if(res.GetRow(row))
+        regionID = row.GetUInt(11);
+    res.Reset();
+
+    for(; cur != m_orderBooks.end() && cur->first.first == typeID; cur++)
+    {
+        if(cur->first.second == regionID)
+            cur->second->Update(orderID, res);
+        else
+            cur->second->Remove(orderID);
+    }
 }
 
 //NOTE: there are a lot of race conditions to deal with here if we ever
@@ -721,7 +763,7 @@ void MarketProxyService::_ExecuteBuyOrder(uint32 buy_order_id, uint32 stationID,
             codelog(MARKET__ERROR, "Failed to delete order %u.", buy_order_id);
             return;
         }
-        _InvalidateOrdersCache(typeID);
+        _UpdateOrdersCache(typeID, buy_order_id);
         _BroadcastOnOwnOrderChanged(seller->GetRegionID(), buy_order_id, "Expiry", isCorp, order);
         _BroadcastOnMarketRefresh(seller->GetRegionID());
     } else {
@@ -730,7 +772,7 @@ void MarketProxyService::_ExecuteBuyOrder(uint32 buy_order_id, uint32 stationID,
             codelog(MARKET__ERROR, "Failed to alter quantity of order %u.", buy_order_id);
             return;
         }
-       _InvalidateOrdersCache(typeID);
+       _UpdateOrdersCache(typeID, buy_order_id);
         _BroadcastOnOwnOrderChanged(seller->GetRegionID(), buy_order_id, "Modify", isCorp);
     }
 
@@ -809,7 +851,7 @@ void MarketProxyService::_ExecuteSellOrder(uint32 sell_order_id, uint32 stationI
             codelog(MARKET__ERROR, "Failed to delete order %u.", sell_order_id);
             return;
         }
-        _InvalidateOrdersCache(typeID);
+        _UpdateOrdersCache(typeID, sell_order_id);
         _BroadcastOnOwnOrderChanged(buyer->GetRegionID(), sell_order_id, "Expiry", isCorp, order);
         _BroadcastOnMarketRefresh(buyer->GetRegionID());
     } else {
@@ -818,7 +860,7 @@ void MarketProxyService::_ExecuteSellOrder(uint32 sell_order_id, uint32 stationI
             codelog(MARKET__ERROR, "Failed to alter quantity of order %u.", sell_order_id);
             return;
         }
-        _InvalidateOrdersCache(typeID);
+        _UpdateOrdersCache(typeID, sell_order_id);
         _BroadcastOnOwnOrderChanged(buyer->GetRegionID(), sell_order_id, "Modify", isCorp);
     }
 
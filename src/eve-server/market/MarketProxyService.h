@@ -27,6 +27,7 @@
 #define __MARKETPROXY_SERVICE_H_INCL__
 
 #include "market/MarketDB.h"
+#include "market/MarketOrderBook.h"
 #include "PyService.h"
 
 class MarketProxyService
@@ -42,6 +43,10 @@ protected:
 
     MarketDB m_db;
 
+    //loaded GetOrders books, by (typeID, regionID).
+    typedef std::map<std::pair<uint32, uint32>, MarketOrderBook *> OrderBookMap;
+    OrderBookMap m_orderBooks;
+
     PyCallable_DECL_CALL(GetStationAsks)
     PyCallable_DECL_CALL(GetSystemAsks)
     PyCallable_DECL_CALL(GetRegionBest)
@@ -63,7 +68,8 @@ protected:
     void _BroadcastOnOwnOrderChanged(uint32 regionID, uint32 orderID, const char *action, bool isCorp, PyRep* order = NULL);
     void _SendOnMarketRefresh(Client *who);
     void _BroadcastOnMarketRefresh(uint32 regionID);
-    void _InvalidateOrdersCache(uint32 regionID);
+    MarketOrderBook *_GetOrderBook(uint32 regionID, uint32 typeID);
+    void _UpdateOrdersCache(uint32 typeID, uint32 orderID);
 
 
     //overloaded in order to support bound objects:
@@ -150,7 +150,7 @@ NPC::~NPC() {
 
 void NPC::Process() {
     SystemEntity::Process();
-    m_AI->Process();
+    //our AI is run by the system manager, in one batch with the other NPCs.
 }
 
 void NPC::Orbit(SystemEntity *who) {
@@ -81,10 +81,10 @@ public:
 	virtual NPCAIMgr * AI() const { return(m_AI); }
 
 	void ForcedSetSpawner(SpawnEntry * spawner) { m_spawner = spawner; }
+    SpawnEntry *GetSpawner() const { return(m_spawner); }    //may be NULL
     void ForcedSetPosition(const GPoint &pt);
 
 
-    virtual bool ApplyDamage(Damage &d);
     virtual void MakeDamageState(DoDestinyDamageState &into) const;
 
     void UseShieldRecharge();
@@ -136,7 +136,7 @@ protected:
     double m_armorDamage;
     double m_hullDamage;
 
-    void _SendDamageStateChanged() const;
+    virtual bool _ApplyDamage(Damage &d, const DamageResonances &resonances);
 
 };
 
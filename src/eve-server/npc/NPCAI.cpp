@@ -29,7 +29,9 @@
 #include "inventory/AttributeEnum.h"
 #include "npc/NPC.h"
 #include "npc/NPCAI.h"
+#include "npc/NPCTargetIndex.h"
 #include "ship/DestinyManager.h"
+#include "system/BubbleManager.h"
 #include "system/Damage.h"
 #include "system/SystemBubble.h"
 
@@ -39,14 +41,12 @@ NPCAIMgr::NPCAIMgr(NPC *who)
   m_entityChaseMaxDistance2(who->Item()->GetAttribute(AttrEntityChaseMaxDistance)*who->Item()->GetAttribute(AttrEntityChaseMaxDistance)),
   m_entityAttackRange2(who->Item()->GetAttribute(AttrEntityAttackRange)*who->Item()->GetAttribute(AttrEntityAttackRange)),
   m_npc(who),
-  m_processTimer(50),    //arbitrary.
   m_mainAttackTimer(1),    //we want this to always trigger the first time through.
   m_shieldBoosterTimer(static_cast<int32>(who->Item()->GetAttribute(AttrEntityShieldBoostDuration).get_int())),
   m_armorRepairTimer(static_cast<int32>(who->Item()->GetAttribute(AttrEntityArmorRepairDuration).get_int())),
   m_beginFindTarget(20000)
 
 {
-    m_processTimer.Start();
     m_mainAttackTimer.Start();
 	m_beginFindTarget.Start();
 
@@ -58,10 +58,7 @@ NPCAIMgr::NPCAIMgr(NPC *who)
         m_armorRepairTimer.Start();
 }
 
-void NPCAIMgr::Process() {
-    if(!m_processTimer.Check())
-        return;
-
+void NPCAIMgr::Process(NPCTargetIndex &targets) {
     // Test to see if we have a Shield Booster
     if( m_shieldBoosterTimer.Enabled() )
     {
@@ -87,43 +84,21 @@ void NPCAIMgr::Process() {
 			//TODO: wander around?
 			//TODO: look around for shit to shoot at?
 			//         The parameter proximityRange tells us how far we "see"
-			bool targetSelected = false;
 			if( m_beginFindTarget.Check() )
 			{
-				std::set<SystemEntity *> possibleTargets;
-				m_npc->Bubble()->GetEntities(possibleTargets);
-				std::set<SystemEntity *>::iterator cur, end;
-				cur = possibleTargets.begin();
-				end = possibleTargets.end();
-				for(; cur != end; cur++)
+				// We find the nearest uncloaked pilot in our bubble who is not in a capsule.
+				// TODO: Determine the weakest target to engage
+				// TODO: Check to see if target's standings are below 0.0, if so, engage, otherwise, ignore:
+				//Client * const currentClient = target->CastToClient();
+				//if( currentClient->GetStandingsFrom(this->m_npc->CastToNPC()->GetCorporationID()) >= 0.0 )
+				//	break;
+				//
+				// Anywhere in our bubble is in sight.
+				SystemEntity *target = targets.FindTarget( m_npc, 2.0 * BUBBLE_RADIUS_METERS );
+				if( target != NULL )
 				{
-					// We find a target
-					// TODO: Determine the weakest target to engage
-					if( (*cur)->IsClient() )
-					{
-						// Check to see if this player ship is not cloaked, so we can really target them:
-						if( ((*cur)->CastToClient()->Destiny()) != NULL )
-						{
-							if( !((*cur)->CastToClient()->Destiny()->IsCloaked()) )
-							{
-								// TODO: Check to see if target's standings are below 0.0, if so, engage, otherwise, ignore:
-								//Client * const currentClient = (*cur)->CastToClient();
-								//if( currentClient->GetStandingsFrom(this->m_npc->CastToNPC()->GetCorporationID()) >= 0.0 )
-								//	break;
-						
-								// Check to see if it's a capsule
-								// Target him and begin the process of the attack.
-								if( !((*cur)->Item()->groupID() == EVEDB::invGroups::Capsule) )
-								{
-									this->Targeted((*cur));
-									targetSelected = true;
-								}
-							}
-						}
-					}
-
-					if( targetSelected )
-						break;
+					// Target him and begin the process of the attack.
+					this->Targeted( target );
 				}
 			}
 			break;
@@ -368,7 +343,7 @@ void NPCAIMgr::CheckAttacks(SystemEntity *target) {
             effectTargetAttack);    //should get this from somewhere.
         m_npc->ApplyDamageModifiers(d, m_npc);
 
-        target->ApplyDamage(d);
+        target->QueueDamage(d);
     }
 }
 
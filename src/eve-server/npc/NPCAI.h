@@ -27,13 +27,15 @@
 #define __NPCAI_H_INCL__
 
 class NPC;
+class NPCTargetIndex;
 class SystemEntity;
 
 class NPCAIMgr {
 public:
     NPCAIMgr(NPC *who);
 
-    void Process();
+    //called by the system manager once per AI batch.
+    void Process(NPCTargetIndex &targets);
 
     void Targeted(SystemEntity *by_who);
     void TargetLost(SystemEntity *by_who);
@@ -63,7 +65,6 @@ protected:
 
     NPC *const m_npc;
 
-    Timer m_processTimer;
     Timer m_mainAttackTimer;
 
     Timer m_shieldBoosterTimer;
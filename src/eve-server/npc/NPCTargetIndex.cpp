@@ -0,0 +1,151 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-server.h"
+
+#include "Client.h"
+#include "npc/NPC.h"
+#include "npc/NPCTargetIndex.h"
+#include "ship/DestinyManager.h"
+#include "system/BubbleManager.h"
+#include "system/SystemBubble.h"
+#include "system/SystemManager.h"
+
+const double NPCTargetIndex::SPAWN_SPREAD = 100000.0;
+
+NPCTargetIndex::NPCTargetIndex(SystemManager &system)
+: m_system(system),
+  m_built(false),
+  m_grid(BUBBLE_RADIUS_METERS),
+  m_queries(0),
+  m_reuses(0)
+{
+}
+
+void NPCTargetIndex::Invalidate() {
+    m_built = false;
+    m_spawns.clear();
+}
+
+SystemEntity *NPCTargetIndex::FindTarget(const NPC *npc, double range) {
+    if(!m_built)
+        _Build();
+    if(m_grid.size() == 0)
+        return NULL;
+
+    const GPoint &position = npc->GetPosition();
+
+    const SpawnEntry *spawner = npc->GetSpawner();
+    if(spawner == NULL) {
+        //on its own, nobody to share with.
+        m_scratch.clear();
+        m_grid.Query(position, range, m_scratch);
+        m_queries++;
+
+        return _Pick(npc, range, m_scratch);
+    }
+
+    std::map<const SpawnEntry *, Candidates>::iterator res = m_spawns.find(spawner);
+    if(res == m_spawns.end()) {
+        Candidates &c = m_spawns[spawner];
+        c.anchor = position;
+        c.radius = range + SPAWN_SPREAD;
+        m_grid.Query(c.anchor, c.radius, c.list);
+        m_queries++;
+
+        return _Pick(npc, range, c.list);
+    }
+
+    //the shared list covers us only if our range lies within its radius.
+    const Candidates &c = res->second;
+    if(GVector(c.anchor, position).length() + range > c.radius) {
+        m_scratch.clear();
+        m_grid.Query(position, range, m_scratch);
+        m_queries++;
+
+        return _Pick(npc, range, m_scratch);
+    }
+
+    m_reuses++;
+    return _Pick(npc, range, c.list);
+}
+
+void NPCTargetIndex::_Build() {
+    m_grid.Clear();
+    m_spawns.clear();
+
+    const SystemManager::ClientMap &clients = m_system.GetClients();
+
+    SystemManager::ClientMap::const_iterator cur, end;
+    cur = clients.begin();
+    end = clients.end();
+    for(; cur != end; cur++) {
+        Client *c = cur->second;
+
+        //only pilots in space may be shot...
+        if(c->Destiny() == NULL || c->Bubble() == NULL)
+            continue;
+        //...when we can see them...
+        if(c->Destiny()->IsCloaked())
+            continue;
+        //...and they are not in a capsule.
+        if(c->Item()->groupID() == EVEDB::invGroups::Capsule)
+            continue;
+
+        m_grid.Insert(c->GetID(), c->GetPosition());
+    }
+
+    m_grid.Build();
+    m_built = true;
+}
+
+SystemEntity *NPCTargetIndex::_Pick(const NPC *npc, double range, const std::vector<Destiny::SpatialGrid::Neighbor> &list) const {
+    const GPoint &position = npc->GetPosition();
+    const double range2 = range * range;
+    const SystemBubble *bubble = npc->Bubble();
+
+    //shared lists are sorted by distance from the anchor, not from us.
+    SystemEntity *best = NULL;
+    double bestDistance2 = range2;
+
+    std::vector<Destiny::SpatialGrid::Neighbor>::const_iterator cur, end;
+    cur = list.begin();
+    end = list.end();
+    for(; cur != end; cur++) {
+        SystemEntity *se = m_system.get(cur->id);
+        if(se == NULL)
+            continue;
+
+        const double distance2 = GVector(position, se->GetPosition()).lengthSquared();
+        if(distance2 > bestDistance2)
+            continue;
+        if(bubble != NULL && !bubble->InBubble(se->GetPosition()))
+            continue;
+
+        best = se;
+        bestDistance2 = distance2;
+    }
+
+    return best;
+}
@@ -0,0 +1,97 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __NPC_TARGET_INDEX_H__INCL__
+#define __NPC_TARGET_INDEX_H__INCL__
+
+#include "destiny/SpatialGrid.h"
+
+class NPC;
+class SpawnEntry;
+class SystemEntity;
+class SystemManager;
+
+/**
+ * @brief Targets NPCs of one solar system may acquire.
+ *
+ * Once per AI batch the eligible targets (uncloaked pilots
+ * in space, not in capsules) are put into a spatial grid,
+ * lazily on the first lookup. Lookups are answered from the
+ * grid; NPCs of the same spawn share one candidate list per
+ * batch, so a belt full of rats costs a single grid query.
+ */
+class NPCTargetIndex
+{
+public:
+    /** Slack around a spawn's first searcher its candidates cover. */
+    static const double SPAWN_SPREAD;
+
+    NPCTargetIndex(SystemManager &system);
+
+    /**
+     * @brief Drops the index; next lookup rebuilds it.
+     *
+     * Called at the start of each AI batch and whenever
+     * an entity leaves the system.
+     */
+    void Invalidate();
+
+    /**
+     * @brief Finds target for NPC.
+     *
+     * @param[in] npc   NPC looking for a target.
+     * @param[in] range Range the NPC sees within.
+     *
+     * @return Nearest eligible target within range and in the NPC's bubble; NULL if none.
+     */
+    SystemEntity *FindTarget(const NPC *npc, double range);
+
+    /** @return Grid queries made since the last ResetCounters(). */
+    uint32 GetQueryCount() const { return(m_queries); }
+    /** @return Lookups answered from a shared candidate list since the last ResetCounters(). */
+    uint32 GetReuseCount() const { return(m_reuses); }
+    void ResetCounters() { m_queries = m_reuses = 0; }
+
+protected:
+    struct Candidates {
+        GPoint anchor;
+        double radius;
+        std::vector<Destiny::SpatialGrid::Neighbor> list;
+    };
+
+    void _Build();
+    SystemEntity *_Pick(const NPC *npc, double range, const std::vector<Destiny::SpatialGrid::Neighbor> &list) const;
+
+    SystemManager &m_system;    //we do not own this
+
+    bool m_built;
+    Destiny::SpatialGrid m_grid;
+    std::map<const SpawnEntry *, Candidates> m_spawns;
+    std::vector<Destiny::SpatialGrid::Neighbor> m_scratch;
+
+    uint32 m_queries;
+    uint32 m_reuses;
+};
+
+#endif /* !__NPC_TARGET_INDEX_H__INCL__ */
@@ -200,7 +200,7 @@ protected:
     /*
      * Member functions
      */
-    void _ReduceDamage(Damage &d);
+    virtual void _ReduceDamage(Damage &d);
     void ApplyDamageModifiers(Damage &d, SystemEntity *target);
 
     /*
@@ -34,15 +34,22 @@
 
 using namespace Destiny;
 
-const double SPACE_FRICTION = 1.0e+6;        //straight from client. Do not change.
-const double SPACE_FRICTION_SQUARED = SPACE_FRICTION*SPACE_FRICTION;
-const double TIC_DURATION_IN_SECONDS = 1.0;    //straight from client. Do not change.
-
 static const double DESTINY_UPDATE_RANGE = 1.0e8;    //totally made up. a more complex spatial partitioning system is needed.
 static const double FOLLOW_BAND_WIDTH = 100.0f;    //totally made up
 
 uint32 DestinyManager::m_stamp(40000);    //completely arbitrary starting point.
 Timer DestinyManager::m_stampTimer(static_cast<int32>(TIC_DURATION_IN_SECONDS * 1000), true);    //accurate timing is essential.
+PyInt* DestinyManager::m_stampRep(NULL);
+
+PyInt* DestinyManager::GetStampRep() {
+    if(m_stampRep == NULL || m_stampRep->value() != (int32)m_stamp) {
+        PySafeDecRef(m_stampRep);
+        m_stampRep = new PyInt(m_stamp);
+    }
+
+    PyIncRef(m_stampRep);
+    return m_stampRep;
+}
 
 DestinyManager::DestinyManager(SystemEntity *self, SystemManager *system)
 : m_self(self),
@@ -89,12 +96,80 @@ void DestinyManager::Process() {
     ProcessTic();
 }
 
+bool DestinyManager::BeginBatchedTic(Destiny::BallTable &table, size_t &index) {
+    Destiny::BallMotion motion;
+    motion.mode = State;
+
+    switch(State) {
+
+    case DSTBALL_GOTO:
+    case DSTBALL_STOP:
+        //docking needs the scalar path.
+        if(_HasPendingDock())
+            break;
+        _GatherMotion(motion);
+        return table.AddBall(motion, index);
+
+    case DSTBALL_FOLLOW:
+        if(m_targetEntity.second == NULL || _HasPendingDock())
+            break;
+        //fall through
+    case DSTBALL_ORBIT:
+        if(!_CheckTargetEntity())
+            return false;
+
+        _GatherMotion(motion);
+        motion.targetPosition = m_targetEntity.second->GetPosition();
+        motion.desiredDistance =
+            m_radius +
+            m_targetEntity.second->GetRadius() +
+            m_targetDistance;
+        return table.AddBall(motion, index);
+
+    default:
+        break;
+    }
+
+    ProcessTic();
+    return false;
+}
+
+void DestinyManager::EndBatchedTic(const Destiny::BallTable &table, size_t index) {
+    m_position = table.GetPosition(index);
+    m_velocity = table.GetVelocity(index);
+    m_targetPoint = table.GetTarget(index);
+}
+
+void DestinyManager::_GatherMotion(Destiny::BallMotion &motion) const {
+    motion.position = m_position;
+    motion.velocity = m_velocity;
+    motion.targetPoint = m_targetPoint;
+    motion.orbitTics = double(GetStamp()-m_stateStamp);
+
+    motion.maxVelocity = m_maxVelocity;
+    motion.accelerationFactor = m_accelerationFactor;
+    motion.massAgilityFriction = m_mass * m_shipAgility / SPACE_FRICTION;
+    motion.velocityAdjuster = m_velocityAdjuster;
+}
+
 void DestinyManager::SendSingleDestinyUpdate(PyTuple **up, bool self_only) const {
-    std::vector<PyTuple *> updates(1, *up);
-    *up = NULL;
-    std::vector<PyTuple *> events;
-    //consumes updates and events
-    SendDestinyUpdate(updates, events, self_only);
+    //the most common case, so skip the vectors.
+    if(self_only) {
+        _log(DESTINY__TRACE, "[%u] Sending single destiny update to self (%u).", GetStamp(), m_self->GetID());
+
+        m_self->QueueDestinyUpdate(up);
+        PySafeDecRef(*up); //they are not required to consume it.
+        *up = NULL;
+    } else if(m_self->Bubble() != NULL) {
+        _log(DESTINY__TRACE, "[%u] Broadcasting single destiny update", GetStamp());
+
+        m_self->Bubble()->BubblecastDestinyUpdate(up, "destiny");    //consumed
+    } else {
+        _log(DESTINY__ERROR, "[%u] Cannot broadcast single destiny update; entity (%u) is not in any bubble.", GetStamp(), m_self->GetID());
+
+        PyDecRef(*up);
+        *up = NULL;
+    }
 }
 
 void DestinyManager::SendDestinyUpdate(std::vector<PyTuple *> &updates, bool self_only) const {
@@ -143,9 +218,8 @@ void DestinyManager::SendDestinyUpdate( std::vector<PyTuple*>& updates, std::vec
 }
 
 void DestinyManager::_UpdateDerrived() {
-    m_maxVelocity = m_maxShipVelocity * m_activeSpeedFraction;
-    m_velocityAdjuster = exp(- (SPACE_FRICTION * TIC_DURATION_IN_SECONDS) / (m_mass * m_shipAgility));
-    m_accelerationFactor = (SPACE_FRICTION*m_maxVelocity) / (m_mass * m_shipAgility);
+    Destiny::DeriveMotion(m_maxShipVelocity, m_activeSpeedFraction, m_mass, m_shipAgility,
+        m_maxVelocity, m_velocityAdjuster, m_accelerationFactor);
 
     _log(PHYSICS__TRACE, "Entity %u has derrived: maxVelocity=%f, velocityAdjuster=%f, accelerationFactor=%f",
         m_self->GetID(), m_maxVelocity, m_velocityAdjuster, m_accelerationFactor);
@@ -289,69 +363,25 @@ void DestinyManager::_Follow() {
         _UpdateDerrived();
     }*/
 
-    // First check to see if our target has somehow been removed from space
-    // _OR_ the player has left the target ship..
-    // if so, then we need to call DestinyManager::Stop() to stop the ship from
-    // following a non-existent space object or a pilot-less ship,
-    // otherwise, proceed to continue following:
-    Client * targetClient = NULL;
-    if( m_system->get( m_targetEntity.first ) == NULL )
-    {
-        // Our target was removed, so STOP
-        SetSpeedFraction( 0.0, true );
-        Stop( true );
+    if( !_CheckTargetEntity() )
         return;
-    }
-    else
-    {
-        // Our target still exists, so do more checking:
-        if( (targetClient = (m_targetEntity.second->CastToClient())) != NULL )
-        {
-            // We are orbiting a Client object, i.e. a player ship
-            if( m_targetEntity.first != targetClient->GetShipID() )
-            {
-                // The client is no longer in the ship we were targeting, so STOP
-                SetSpeedFraction( 0.0, true );
-                Stop( true );
-                return;
-            }
-        }
-    }
-
-    const GPoint &target_point = m_targetEntity.second->GetPosition();
-
-    GVector them_to_us(target_point, m_position);
-    them_to_us.normalize();
 
     double desired_distance =
         m_radius +
         m_targetEntity.second->GetRadius() +
         m_targetDistance;
 
-    m_targetPoint = target_point + (them_to_us * desired_distance);
+    m_targetPoint = FollowPoint(m_position, m_targetEntity.second->GetPosition(), desired_distance);
 
     _Move();
 }
 
 void DestinyManager::_Move() {
-
-    //CalcAcceleration:
-    GVector vector_to_goal(m_position, m_targetPoint); //m
-    Ga::GaFloat distance_to_goal2 = vector_to_goal.lengthSquared(); //m^2
-//    Ga::GaFloat delta = ((tic_duration_in_seconds * speed_fraction * maxVelocity) + radius); //m
-//    Ga::GaFloat accel = (space_friction*speed_fraction*maxVelocity) / (agility * mass); //fric*m/(s*agi*kg)
-/*  if(delta*delta >= distance_to_goal2) {
-        // we are going to reach our goal
-        Ga::GaFloat tmp = distance_to_goal2/(delta*delta);
-        accel *= tmp*tmp;
-    } else {*/
-        vector_to_goal /= sqrt(distance_to_goal2); //normalize  yeilds unitless
-    //}
     _log(PHYSICS__TRACEPOS, "Accel Magnitude = %.13f", m_accelerationFactor);
-    GVector calc_acceleration = vector_to_goal * m_accelerationFactor;    //fric*m/(s*agi*kg) = m/s^2
+    GVector calc_acceleration = GotoAcceleration(m_position, m_targetPoint, m_accelerationFactor);
 
     // Check to see if we have a pending docking operation and attempt to dock if so:
-    if( m_self->IsClient() && m_self->CastToClient()->GetPendingDockOperation() )
+    if( _HasPendingDock() )
         AttemptDockOperation();
 
     _MoveAccel(calc_acceleration);
@@ -365,23 +395,7 @@ void DestinyManager::_MoveAccel(const GVector &calc_acceleration) {
 
     double mass_agility_friction = m_mass * m_shipAgility / SPACE_FRICTION;
 
-    GVector max_velocity = calc_acceleration * mass_agility_friction;
-
-
-    // position:
-
-    m_position +=
-        max_velocity * TIC_DURATION_IN_SECONDS
-        - (max_velocity - m_velocity) * (1 - m_velocityAdjuster) * mass_agility_friction;
-
-
-    //now on to velocity:
-
-
-
-    //velocity_to_m_us:
-    m_velocity =
-        max_velocity - (max_velocity - m_velocity) * m_velocityAdjuster;
+    MoveAccel(m_position, m_velocity, calc_acceleration, mass_agility_friction, m_velocityAdjuster);
 
 
 
@@ -662,22 +676,35 @@ void DestinyManager::_Warp() {
 
 //this is still under construction. Its not working well right now.
 void DestinyManager::_Orbit() {
-#define PVN(v) _log(PHYSICS__TRACEPOS, "Entity %u: " #v ": (%.15e, %.15e, %.15e)   len=%.15e", \
-            m_self->GetID(), \
-            v.x, v.y, v.z, v.length() )
+    if( !_CheckTargetEntity() )
+        return;
+
+    const GPoint &orbit_point = m_targetEntity.second->GetPosition();
+
+    double desired_distance =
+        m_radius +
+        m_targetEntity.second->GetRadius() +
+        m_targetDistance;
+    _log(PHYSICS__TRACEPOS, "desired_distance = %.15e", desired_distance);
+
+    GVector accel_vector = OrbitAcceleration(m_position, orbit_point, desired_distance,
+        m_maxVelocity, m_accelerationFactor, double(GetStamp()-m_stateStamp), m_targetPoint);
 
+    _MoveAccel(accel_vector);
+}
+
+bool DestinyManager::_CheckTargetEntity() {
     // First check to see if our target has somehow been removed from space
     // _OR_ the player has left the target ship..
     // if so, then we need to call DestinyManager::Stop() to stop the ship from
-    // following a non-existent space object or a pilot-less ship,
-    // otherwise, proceed to continue orbiting:
+    // following a non-existent space object or a pilot-less ship:
     Client * targetClient = NULL;
     if( m_system->get( m_targetEntity.first ) == NULL )
     {
         // Our target was removed, so STOP
         SetSpeedFraction( 0.0, true );
         Stop( true );
-        return;
+        return false;
     }
     else
     {
@@ -690,110 +717,16 @@ void DestinyManager::_Orbit() {
                 // The client is no longer in the ship we were targeting, so STOP
                 SetSpeedFraction( 0.0, true );
                 Stop( true );
-                return;
+                return false;
             }
         }
     }
 
-    const GPoint &orbit_point = m_targetEntity.second->GetPosition();
-
-    GVector delta(m_position, orbit_point);
-    PVN(delta);
-    double current_distance = delta.normalize();
-    PVN(delta);
-
-    double something = 0;
-    double desired_distance =
-        m_radius +
-        m_targetEntity.second->GetRadius() +
-        m_targetDistance;
-    _log(PHYSICS__TRACEPOS, "desired_distance = %.15e", desired_distance);
-    if(desired_distance != 0) {
-        something = (m_maxVelocity * TIC_DURATION_IN_SECONDS * .01) / desired_distance;
-    }
-    _log(PHYSICS__TRACEPOS, "something = %.15e", something);
-
-//this seems to be correct, without rounding error.
-    double v488 = double(GetStamp()-m_stateStamp) * something;
-    _log(PHYSICS__TRACEPOS, "v488 = %.15e", v488);
-
-//this is not quite right... some sort of rounding I think.
-    double coef = (v488 * 0.7f) + 130001409/*entityID*/;
-    _log(PHYSICS__TRACEPOS, "coef = %.15e", coef);
-
-//all of these are wrong due to rounding
-    double cos_coef = cos( coef );
-    double sin_coef = sin( coef );
-    double cos_v488 = cos( v488 );
-    double sin_v488 = sin( v488 );
-    _log(PHYSICS__TRACEPOS, "coef(sin=%.15e, cos=%.15e) v488(sin=%.15e, cos=%.15e)", sin_coef, cos_coef, sin_v488, cos_v488);
-    double v438 = cos_coef * sin_v488;
-    double v3C0 = cos_v488 * cos_coef;
-
-    GPoint pt( v3C0, sin_coef, v438 );    //this is a unit vector naturally
-    PVN(pt);
-
-    GVector tan_vector = pt.crossProduct(delta);
-    tan_vector.normalize();
-    PVN(tan_vector);
-
-    double delta_d2 = current_distance*current_distance - desired_distance*desired_distance;
-    _log(PHYSICS__TRACEPOS, "delta_d2 = %.15e", delta_d2);
-    if(delta_d2 >= 0) {
-        double mag = sqrt(delta_d2) * desired_distance / current_distance;
-        _log(PHYSICS__TRACEPOS, "mag = %.15e", mag);
-        GVector s = tan_vector * mag;
-        PVN(s);
-        GVector d = delta * (delta_d2/current_distance);
-        PVN(d);
-        delta = s + d;
-        delta.normalize();
-        PVN(delta);
-    }
-
-    double d = desired_distance - current_distance;
-    d = exp(d*d / (-40000.0f));
-    _log(PHYSICS__TRACEPOS, "d = %.15e", d);
-
-    GVector negative_delta = delta * -1;
-    PVN(negative_delta);
-
-    double tdn = tan_vector.dotProduct(negative_delta);
-    _log(PHYSICS__TRACEPOS, "tdn = %.15e", tdn);
-    double jjj = ((tdn*tdn - 1.0f) * d * d) + 1;
-    _log(PHYSICS__TRACEPOS, "jjj = %.15e", jjj);
-    double iii;
-    if(jjj < 0) {    //not sure on this condition at all.
-        iii = d * tdn;    //not positive
-    } else {
-        iii = sqrt(jjj) + (d * tdn);
-    }
-
-    if((current_distance - desired_distance) < 0) {
-        iii *= -1;
-    }
-
-    GPoint bliii = delta * iii;
-    PVN(bliii);
-    GPoint vliii = tan_vector * d;
-    PVN(vliii);
-
-    GPoint accel_vector = bliii + vliii;
-    _log(PHYSICS__TRACEPOS, "m_accelerationFactor = %.15e", m_accelerationFactor);
-    accel_vector *=  m_accelerationFactor;
-    PVN(accel_vector);
-
-    //copy delta_position into acceleration for input into movement.
-
-    static const double ten_au = 1.495978707e12;
-    GVector big_delta_position = accel_vector * ten_au;
-    PVN(big_delta_position);
-
-    m_targetPoint = orbit_point + big_delta_position;
-    PVN(m_targetPoint);
-#undef PVN
+    return true;
+}
 
-    _MoveAccel(accel_vector);
+bool DestinyManager::_HasPendingDock() const {
+    return( m_self->IsClient() && m_self->CastToClient()->GetPendingDockOperation() );
 }
 
 //called whenever an entity is going away and can no longer be used as a target
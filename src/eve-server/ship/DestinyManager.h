@@ -27,6 +27,7 @@
 #define __DESTINYMANAGER_H_INCL__
 
 #include "PyCallable.h"
+#include "destiny/BallTable.h"
 #include "destiny/DestinyStructs.h"
 #include "inventory/ItemRef.h"
 #include "system/SystemEntity.h"
@@ -35,14 +36,11 @@ class SystemEntity;
 class SystemManager;
 class InventoryItem;
 class PyRep;
+class PyInt;
 class PyList;
 class PyTuple;
 class SystemBubble;
 
-extern const double SPACE_FRICTION;
-extern const double SPACE_FRICTION_SQUARED;
-extern const double TIC_DURATION_IN_SECONDS;
-
 //this object manages an entity's position in the system.
 //NOTE: we currently have no inertial mass
 class DestinyManager {
@@ -63,6 +61,8 @@ public:
 
 
     static uint32 GetStamp() { return(m_stamp); }
+    //the current stamp as a PyInt, shared by all updates of the tick; returns a new reference.
+    static PyInt* GetStampRep();
     static bool IsTicActive() { return(m_stampTimer.Check(false)); }
     static void TicCompleted() { if(m_stampTimer.Check(true)) m_stamp++; }
     Destiny::BallMode GetState() { return State; }
@@ -71,6 +71,23 @@ public:
     ~DestinyManager();
 
     void Process();
+    /**
+     * @brief Processes tic, deferring integration to ball table if possible.
+     *
+     * @param[in]  table Ball table of our solar system.
+     * @param[out] index Index of our ball in the table.
+     *
+     * @retval true  Ball has been added to the table; call EndBatchedTic once integrated.
+     * @retval false Tic has been processed completely.
+     */
+    bool BeginBatchedTic(Destiny::BallTable &table, size_t &index);
+    /**
+     * @brief Picks up results of batched integration.
+     *
+     * @param[in] table Integrated ball table.
+     * @param[in] index Index returned by BeginBatchedTic.
+     */
+    void EndBatchedTic(const Destiny::BallTable &table, size_t index);
 
     void SendSingleDestinyUpdate(PyTuple **up, bool self_only=false) const;
     void SendDestinyUpdate(std::vector<PyTuple *> &updates, bool self_only) const;
@@ -149,6 +166,7 @@ protected:
 	//Timer m_destinyTimer;
     static uint32 m_stamp;
     static Timer m_stampTimer;
+    static PyInt* m_stampRep;            //we own a reference to this
 	//uint32 m_lastDestinyTime;			//from Timer::GetTimeSeconds()
 
     //the results of our labors:
@@ -192,9 +210,12 @@ protected:
     bool _Turn();						//compare m_targetDirection and m_direction, and turn as needed.
     void _Move();						//apply our velocity and direction to our position for 1 unit of time (a second)
     void _Follow();
+    void _GatherMotion(Destiny::BallMotion &motion) const;  //fills our own part of BallTable::AddBall() input.
     void _Warp();						//carry on our current warp.
     void _MoveAccel(const GVector &calc_acceleration);
     void _Orbit();
+    bool _CheckTargetEntity();			//stops us if our target has gone away.
+    bool _HasPendingDock() const;
 
 private:
 
@@ -28,9 +28,12 @@
 #include "log/Basic_Log.h"
 #include "PyCallable.h"
 #include "EVEServerConfig.h"
+#include "character/Character.h"
 #include "ship/Ship.h"
 #include "ship/ModuleManager.h"
 #include "ship/ShipOperatorInterface.h"
+#include "ship/dgmtypeattributeinfo.h"
+#include "ship/modules/ModuleDB.h"
 #include "ship/modules/ModuleFactory.h"
 #include "ship/Modules/ActiveModules.h"
 #include "system/SystemBubble.h"
@@ -716,7 +719,12 @@ void ModuleContainer::_initializeModuleContainers()
 //////////////////////////////////////////////////////////////////////////////////
 // ModuleManager class definitions
 #pragma region ModuleManagerClass
+std::map<uint32, ModuleManager::ModifierTemplates> ModuleManager::m_TypeModifiers;
+std::map<uint32, ModuleManager::ModifierTemplates> ModuleManager::m_SkillModifiers;
+
 ModuleManager::ModuleManager(Ship *const ship)
+: m_FittingEngine(new FittingEngine),
+  m_PilotID(0)
 {
     // Create ModuleContainer object and initialize with sizes for all slot banks for this ship:
     m_Modules = new ModuleContainer((uint32)ship->GetAttribute(AttrLowSlots).get_int(),
@@ -930,6 +938,9 @@ ModuleManager::~ModuleManager()
     delete m_Modules;
     m_Modules = NULL;
 
+    delete m_FittingEngine;
+    m_FittingEngine = NULL;
+
     //modifier map cleanup is handled in the std::map destructor
     delete m_LocalSubsystemModifierMaps;
     delete m_LocalShipSkillModifierMaps;
@@ -1042,7 +1053,9 @@ void ModuleManager::UnfitModule(uint32 itemID)
     if( mod != NULL )
     {
         mod->Offline();
+        m_FittingEngine->RemoveItem(itemID);
         m_Modules->RemoveModule(itemID);
+        _Recalculate();
     }
 }
 
@@ -1088,6 +1101,12 @@ bool ModuleManager::_fitModule(InventoryItemRef item, EVEItemFlags flag)
     {
         // Fit Module now that all checks have passed:
         m_Modules->AddModule(flag, mod);
+
+        // Apply modifiers of skills and other modules to it, and its own modifiers:
+        m_FittingEngine->RemoveItem(item->itemID());
+        _AddModifiersTo(item);
+        _UpdateModuleModifiers(mod);
+        _Recalculate();
     }
 
     if( verifyFailed )
@@ -1106,12 +1125,15 @@ void ModuleManager::Online(uint32 itemID)
 	{
         mod->Online();
 		m_pLog->Log("ModuleManager::Online()", "Module '%s' going Online", mod->getItem()->itemName().c_str());
+        _UpdateModuleModifiers(mod);
+        _Recalculate();
 	}
 }
 
 void ModuleManager::OnlineAll()
 {
     m_Modules->OnlineAll();
+    _UpdateAllModuleModifiers();
 }
 
 void ModuleManager::Offline(uint32 itemID)
@@ -1121,12 +1143,15 @@ void ModuleManager::Offline(uint32 itemID)
 	{
         mod->Offline();
 		m_pLog->Log("ModuleManager::Offline()", "Module '%s' going Offline", mod->getItem()->itemName().c_str());
+        _UpdateModuleModifiers(mod);
+        _Recalculate();
 	}
 }
 
 void ModuleManager::OfflineAll()
 {
     m_Modules->OfflineAll();
+    _UpdateAllModuleModifiers();
 }
 
 int32 ModuleManager::Activate(uint32 itemID, std::string effectName, uint32 targetID, uint32 repeat)
@@ -1153,6 +1178,9 @@ int32 ModuleManager::Activate(uint32 itemID, std::string effectName, uint32 targ
 			mod->Activate(targetEntity);
 			m_pLog->Log("ModuleManager::Activate()", "Module '%s' Activating...", mod->getItem()->itemName().c_str());
 		}
+
+        _UpdateModuleModifiers(mod);
+        _Recalculate();
     }
 
     return 1;
@@ -1178,12 +1206,16 @@ void ModuleManager::Deactivate(uint32 itemID, std::string effectName)
 			mod->Deactivate();
 			m_pLog->Log("ModuleManager::Deactivate()", "Module '%s' Deactivating...", mod->getItem()->itemName().c_str());
 		}
+
+        _UpdateModuleModifiers(mod);
+        _Recalculate();
     }
 }
 
 void ModuleManager::DeactivateAllModules()
 {
     m_Modules->DeactivateAll();
+    _UpdateAllModuleModifiers();
 }
 
 void ModuleManager::Overload(uint32 itemID)
@@ -1192,6 +1224,8 @@ void ModuleManager::Overload(uint32 itemID)
     if( mod != NULL )
     {
         mod->Overload();
+        _UpdateModuleModifiers(mod);
+        _Recalculate();
     }
 }
 
@@ -1201,6 +1235,8 @@ void ModuleManager::DeOverload(uint32 itemID)
     if( mod != NULL )
     {
         mod->DeOverload();
+        _UpdateModuleModifiers(mod);
+        _Recalculate();
     }
 }
 
@@ -1360,6 +1396,11 @@ void ModuleManager::CharacterLeavingShip()
     sLog.Debug("CharacterLeavingShip","Needs to be implemented");
     //this is complicated and im gonna leave it alone for now until
     //a few things become more clear
+
+    // The pilot's skills no longer apply:
+    _RemovePilotSkills();
+    m_PilotID = 0;
+    _Recalculate();
 }
 
 void ModuleManager::CharacterBoardingShip()
@@ -1369,6 +1410,70 @@ void ModuleManager::CharacterBoardingShip()
     //a few things become more clear
 }
 
+void ModuleManager::UpdateModules()
+{
+    uint32 pilotID = 0;
+    CharacterRef pilot;
+    if( m_Ship->GetOperator() != NULL && m_Ship->GetOperator()->IsClient() )
+    {
+        pilot = m_Ship->GetOperator()->GetChar();
+        if( pilot )
+            pilotID = pilot->itemID();
+    }
+
+    // Skills are only re-read when the pilot changes; UpdateSkill() handles training:
+    if( pilotID == m_PilotID )
+        return;
+
+    _RemovePilotSkills();
+    m_PilotID = pilotID;
+
+    if( pilot )
+    {
+        std::vector<InventoryItemRef> skills;
+        pilot->GetSkillsList( skills );
+
+        std::vector<InventoryItemRef>::iterator cur, end;
+        cur = skills.begin();
+        end = skills.end();
+        for(; cur != end; cur++)
+        {
+            if( _GetSkillModifiers( (*cur)->typeID() ).empty() )
+                continue;
+
+            m_PilotSkills.push_back( *cur );
+            _AddSkillModifiers( *cur, InventoryItemRef() );
+        }
+    }
+
+    _Recalculate();
+}
+
+void ModuleManager::UpdateSkill(InventoryItemRef skill)
+{
+    if( m_PilotID == 0 || skill->ownerID() != m_PilotID )
+        return;
+
+    if( _GetSkillModifiers( skill->typeID() ).empty() )
+        return;
+
+    m_FittingEngine->RemoveModifiers( skill->itemID() );
+
+    std::vector<InventoryItemRef>::iterator cur, end;
+    cur = m_PilotSkills.begin();
+    end = m_PilotSkills.end();
+    for(; cur != end; cur++)
+    {
+        if( (*cur)->itemID() == skill->itemID() )
+            break;
+    }
+    if( cur == end )
+        m_PilotSkills.push_back( skill );
+
+    _AddSkillModifiers( skill, InventoryItemRef() );
+    _Recalculate();
+}
+
 void ModuleManager::ShipWarping()
 {
     sLog.Debug("ShipWarping","Needs to be implemented");
@@ -1711,6 +1816,272 @@ void ModuleManager::_processExternalEffect(SubEffect * s)
 
 }
 
+const ModuleManager::ModifierTemplates &ModuleManager::_GetTypeModifiers(uint32 typeID)
+{
+    std::map<uint32, ModifierTemplates>::iterator cached = m_TypeModifiers.find( typeID );
+    if( cached != m_TypeModifiers.end() )
+        return cached->second;
+
+    ModifierTemplates &templates = m_TypeModifiers[ typeID ];
+
+    DBQueryResult res;
+    ModuleDB::GetDgmTypeEffects( typeID, res );
+
+    DBResultRow row;
+    while( res.GetRow( row ) )
+    {
+        uint32 effectID = row.GetUInt( 0 );
+
+        // slot effects (loPower, hiPower, medPower) carry no modifiers
+        if( effectID == 11 || effectID == 12 || effectID == 13 )
+            continue;
+
+        MEffect * effect = sDGM_Effects_Table.GetEffect( effectID );
+        if( effect == NULL || !effect->IsEffectsInfoLoaded() )
+            continue;
+
+        uint32 i;
+        for(i = 0; i < effect->GetSizeOfAttributeList(); i++)
+        {
+            ModifierTemplate tmpl;
+            tmpl.sourceAttributeID = effect->GetSourceAttributeID( i );
+            tmpl.targetAttributeID = effect->GetTargetAttributeID( i );
+            tmpl.type = (EVECalculationType)effect->GetCalculationType( i );
+            tmpl.penalized = (effect->GetStackingPenaltyApplied( i ) != 0);
+            tmpl.stateMask = effect->GetModuleStateWhenEffectApplied();
+            tmpl.affectedType = effect->GetTargetTypeToWhichEffectApplied( i );
+            tmpl.perLevel = false;
+
+            if( tmpl.sourceAttributeID == 0 || tmpl.targetAttributeID == 0 )
+                continue;
+
+            typeTargetGroupIDlist * targetIDs = effect->GetTargetGroupIDlist( i );
+            if( targetIDs != NULL )
+                tmpl.targetIDs = *targetIDs;
+
+            templates.push_back( tmpl );
+        }
+    }
+
+    return templates;
+}
+
+const ModuleManager::ModifierTemplates &ModuleManager::_GetSkillModifiers(uint32 skillTypeID)
+{
+    std::map<uint32, ModifierTemplates>::iterator cached = m_SkillModifiers.find( skillTypeID );
+    if( cached != m_SkillModifiers.end() )
+        return cached->second;
+
+    ModifierTemplates &templates = m_SkillModifiers[ skillTypeID ];
+
+    SkillBonusModifier * modifier = sDGM_Skill_Bonus_Modifiers_Table.GetSkillModifier( skillTypeID );
+    if( modifier == NULL )
+        return templates;
+
+    uint32 i;
+    for(i = 0; i < modifier->GetSizeOfModifierList(); i++)
+    {
+        ModifierTemplate tmpl;
+        tmpl.sourceAttributeID = modifier->GetSourceAttributeID( i );
+        tmpl.targetAttributeID = modifier->GetTargetAttributeID( i );
+        tmpl.type = (EVECalculationType)modifier->GetCalculationType( i );
+        tmpl.penalized = false;
+        tmpl.stateMask = 0xFF;      // skills apply regardless of module state
+        tmpl.affectedType = modifier->GetTargetTypeToWhichEffectApplied( i );
+        tmpl.perLevel = (modifier->GetAppliedPerLevel( i ) != 0);
+
+        if( tmpl.sourceAttributeID == 0 || tmpl.targetAttributeID == 0 )
+            continue;
+
+        typeTargetGroupIDlist * targetIDs = modifier->GetTargetGroupIDlist( i );
+        if( targetIDs != NULL )
+            tmpl.targetIDs = *targetIDs;
+
+        templates.push_back( tmpl );
+    }
+
+    return templates;
+}
+
+uint32 ModuleManager::_GetStateBits(GenericModule *mod)
+{
+    // bits as used by effectAppliedInState: 1 offline, 2 online, 4 active, 8 overloaded
+    if( mod->isRig() || mod->isSubSystem() )
+        return 2;
+
+    switch( mod->GetModuleState() )
+    {
+        case MOD_ONLINE:        return 2;
+        case MOD_ACTIVATED:     return 2 | 4;
+        case MOD_OVERLOADED:    return 2 | 4 | 8;
+        default:                return 1;
+    }
+}
+
+bool ModuleManager::_IsAffected(const ModifierTemplate &tmpl, InventoryItemRef source, InventoryItemRef target)
+{
+    uint32 id;
+    switch( tmpl.affectedType )
+    {
+        case AFFECTED_SLOT:     return target->itemID() == source->itemID();
+        case AFFECTED_ITEM:     id = target->typeID(); break;
+        case AFFECTED_GROUP:    id = target->groupID(); break;
+        case AFFECTED_CATEGORY: id = target->categoryID(); break;
+        default:                return false;   // market groups, skill requirements etc. are not supported
+    }
+
+    return std::find( tmpl.targetIDs.begin(), tmpl.targetIDs.end(), id ) != tmpl.targetIDs.end();
+}
+
+bool ModuleManager::_AddBaseValue(InventoryItemRef item, uint32 attributeID)
+{
+    if( m_FittingEngine->HasAttribute( item->itemID(), attributeID ) )
+        return true;
+
+    // base values are the unmodified type attributes; the item ones get overwritten by us
+    DgmTypeAttributeSet * attrs = sDgmTypeAttrMgr.GetDmgTypeAttributeSet( item->typeID() );
+    if( attrs == NULL )
+        return false;
+
+    DgmTypeAttributeSet::AttrSetItr cur, end;
+    cur = attrs->begin();
+    end = attrs->end();
+    for(; cur != end; cur++)
+    {
+        if( (*cur)->attributeID == attributeID )
+        {
+            m_FittingEngine->SetBaseValue( item->itemID(), attributeID, (*cur)->number );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ModuleManager::_AddModifiers(InventoryItemRef source, const ModifierTemplates &templates, uint32 stateBits, double level, InventoryItemRef onlyTarget)
+{
+    std::vector<InventoryItemRef> targets;
+    if( onlyTarget )
+        targets.push_back( onlyTarget );
+    else
+    {
+        targets.push_back( InventoryItemRef( m_Ship ) );
+        m_Modules->GetModuleListOfRefs( &targets );
+    }
+
+    ModifierTemplates::const_iterator cur, end;
+    cur = templates.begin();
+    end = templates.end();
+    for(; cur != end; cur++)
+    {
+        if( (cur->stateMask & stateBits) == 0 )
+            continue;
+
+        std::vector<InventoryItemRef>::iterator target = targets.begin();
+        for(; target != targets.end(); target++)
+        {
+            if( !_IsAffected( *cur, source, *target ) )
+                continue;
+
+            if( !_AddBaseValue( source, cur->sourceAttributeID ) || !_AddBaseValue( *target, cur->targetAttributeID ) )
+                continue;
+
+            m_FittingEngine->AddModifier( source->itemID(), source->itemID(), cur->sourceAttributeID,
+                                          (*target)->itemID(), cur->targetAttributeID,
+                                          cur->type, cur->penalized, cur->perLevel ? level : 1.0 );
+        }
+    }
+}
+
+void ModuleManager::_AddSkillModifiers(InventoryItemRef skill, InventoryItemRef onlyTarget)
+{
+    _AddModifiers( skill, _GetSkillModifiers( skill->typeID() ), 0xFF,
+                   skill->GetAttribute( AttrSkillLevel ).get_float(), onlyTarget );
+}
+
+void ModuleManager::_AddModifiersTo(InventoryItemRef item)
+{
+    std::vector<InventoryItemRef>::iterator cur, end;
+    cur = m_PilotSkills.begin();
+    end = m_PilotSkills.end();
+    for(; cur != end; cur++)
+        _AddSkillModifiers( *cur, item );
+
+    std::vector<InventoryItemRef> modules;
+    m_Modules->GetModuleListOfRefs( &modules );
+
+    cur = modules.begin();
+    end = modules.end();
+    for(; cur != end; cur++)
+    {
+        if( (*cur)->itemID() == item->itemID() )
+            continue;
+
+        GenericModule * mod = m_Modules->GetModule( (*cur)->itemID() );
+        if( mod != NULL )
+            _AddModifiers( *cur, _GetTypeModifiers( (*cur)->typeID() ), _GetStateBits( mod ), 1.0, item );
+    }
+}
+
+void ModuleManager::_UpdateModuleModifiers(GenericModule *mod)
+{
+    InventoryItemRef item = mod->getItem();
+
+    m_FittingEngine->RemoveModifiers( item->itemID() );
+    _AddModifiers( item, _GetTypeModifiers( item->typeID() ), _GetStateBits( mod ), 1.0, InventoryItemRef() );
+}
+
+void ModuleManager::_UpdateAllModuleModifiers()
+{
+    std::vector<InventoryItemRef> modules;
+    m_Modules->GetModuleListOfRefs( &modules );
+
+    std::vector<InventoryItemRef>::iterator cur, end;
+    cur = modules.begin();
+    end = modules.end();
+    for(; cur != end; cur++)
+    {
+        GenericModule * mod = m_Modules->GetModule( (*cur)->itemID() );
+        if( mod != NULL )
+            _UpdateModuleModifiers( mod );
+    }
+
+    _Recalculate();
+}
+
+void ModuleManager::_RemovePilotSkills()
+{
+    std::vector<InventoryItemRef>::iterator cur, end;
+    cur = m_PilotSkills.begin();
+    end = m_PilotSkills.end();
+    for(; cur != end; cur++)
+        m_FittingEngine->RemoveItem( (*cur)->itemID() );
+
+    m_PilotSkills.clear();
+}
+
+void ModuleManager::_Recalculate()
+{
+    std::vector<FittingEngine::Change> changes;
+    m_FittingEngine->Recalculate( changes );
+
+    std::vector<FittingEngine::Change>::iterator cur, end;
+    cur = changes.begin();
+    end = changes.end();
+    for(; cur != end; cur++)
+    {
+        if( cur->itemID == m_Ship->itemID() )
+        {
+            m_Ship->SetAttribute( cur->attributeID, cur->value );
+            continue;
+        }
+
+        GenericModule * mod = m_Modules->GetModule( cur->itemID );
+        if( mod != NULL )
+            mod->SetAttribute( cur->attributeID, cur->value );
+    }
+}
+
 ModuleCommand ModuleManager::_translateEffectName(std::string s)
 {
     //slow but it's better to do it once then many times as it gets passed around in modules or w/e
@@ -37,6 +37,8 @@ class Basic_Log;
 
 #include "ship/modules/Modules.h"
 #include "ship/modules/ModuleDefs.h"
+#include "ship/modules/ModuleEffects.h"
+#include "dogma/FittingEngine.h"
 
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -366,6 +368,8 @@ public:
     void UnloadAllModules();
     void CharacterLeavingShip();
     void CharacterBoardingShip();
+    void UpdateModules();
+    void UpdateSkill(InventoryItemRef skill);
     void ShipWarping();
     void ShipJumping();
     void Process();
@@ -408,6 +412,37 @@ private:
     void _SendInfoMessage(const char* fmt, ...);
     void _SendErrorMessage(const char* fmt, ...);
 
+    // Modifier of an effect or a skill, compiled once per typeID:
+    struct ModifierTemplate
+    {
+        uint32 sourceAttributeID;
+        uint32 targetAttributeID;
+        EVECalculationType type;
+        bool penalized;
+        uint32 stateMask;               // effectAppliedInState bits, see _GetStateBits()
+        uint32 affectedType;            // EffectAffectedTypes
+        typeTargetGroupIDlist targetIDs;
+        bool perLevel;                  // value is multiplied by skill level
+    };
+    typedef std::vector<ModifierTemplate> ModifierTemplates;
+
+    static const ModifierTemplates &_GetTypeModifiers(uint32 typeID);
+    static const ModifierTemplates &_GetSkillModifiers(uint32 skillTypeID);
+    static uint32 _GetStateBits(GenericModule *mod);
+    static bool _IsAffected(const ModifierTemplate &tmpl, InventoryItemRef source, InventoryItemRef target);
+
+    bool _AddBaseValue(InventoryItemRef item, uint32 attributeID);
+    void _AddModifiers(InventoryItemRef source, const ModifierTemplates &templates, uint32 stateBits, double level, InventoryItemRef onlyTarget);
+    void _AddSkillModifiers(InventoryItemRef skill, InventoryItemRef onlyTarget);
+    void _AddModifiersTo(InventoryItemRef item);
+    void _UpdateModuleModifiers(GenericModule *mod);
+    void _UpdateAllModuleModifiers();
+    void _RemovePilotSkills();
+    void _Recalculate();
+
+    static std::map<uint32, ModifierTemplates> m_TypeModifiers;
+    static std::map<uint32, ModifierTemplates> m_SkillModifiers;
+
     //access to the ship its system entity that owns us.  We do not own these
     Ship * m_Ship;
 
@@ -421,6 +456,11 @@ private:
     ModifierMaps * m_LocalImplantModifierMaps;      // Holds std::map<> maps of Modifiers for attributes applied by IMPLANTS
     ModifierMaps * m_RemoteModifierMaps;            // Holds std::map<> maps of Modifiers for attributes applied by EXTERNAL ENTITY MODULES
 
+    //attribute dependency graph of ship, modules and pilot skills, we own this
+    FittingEngine * m_FittingEngine;
+    uint32 m_PilotID;
+    std::vector<InventoryItemRef> m_PilotSkills;   // skills of pilot which have modifiers
+
 	Basic_Log * m_pLog;
 };
 
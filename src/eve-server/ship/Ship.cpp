@@ -717,8 +717,16 @@ void Ship::UpdateModules()
 	// InventoryBound::_ExecAdd()		- things have been added or removed, recheck all modules for... some reason
 	// Client::MoveItem()				- something has been moved into or out of the ship, recheck all modules for... some reason
 
-	sLog.Error( "Ship::UpdateModules()", "We are currently not checking for modules that need to go online, or skill checking character for any modules of a newly boarded ship, or updating module states based on things being moved into or off the ship!" );
-	sLog.Error( "Ship::UpdateModules()", "This should really be a simple call to a function ModuleManager::UpdateModules() and the code put inside there." );
+	// TODO: put modules online that are recorded as being online and skill check them; for now only
+	// the pilot's skill modifiers are (re)applied to ship and modules when the pilot changes.
+	if( m_ModuleManager != NULL )
+		m_ModuleManager->UpdateModules();
+}
+
+void Ship::UpdateSkill(InventoryItemRef skill)
+{
+	if( m_ModuleManager != NULL )
+		m_ModuleManager->UpdateSkill(skill);
 }
 
 void Ship::UnloadModule(uint32 itemID)
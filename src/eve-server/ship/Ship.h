@@ -227,6 +227,7 @@ public:
     uint32 AddItem( EVEItemFlags flag, InventoryItemRef item);
     void RemoveItem( InventoryItemRef item, uint32 inventoryID, EVEItemFlags flag );
     void UpdateModules();
+    void UpdateSkill(InventoryItemRef skill);
     void UnloadModule(uint32 itemID);
     void UnloadAllModules();
     void RepairModules();
@@ -376,7 +377,7 @@ protected:
     /*
      * Member functions
      */
-    void _ReduceDamage(Damage &d);
+    virtual void _ReduceDamage(Damage &d);
     void ApplyDamageModifiers(Damage &d, SystemEntity *target);
     void _DropLoot(SystemEntity *owner);
 
@@ -328,46 +328,44 @@ SystemEntity *TargetManager::GetTarget(uint32 targetID, bool need_locked) const
 void TargetManager::QueueTBDestinyEvent( PyTuple** up_in ) const
 {
     PyTuple* up = *up_in;
-    *up_in = NULL;    //could optimize out one of the Clones in here...
-
-    PyTuple* up_dup = NULL;
+    *up_in = NULL;
 
     std::map<SystemEntity*, TargetedByEntry*>::const_iterator cur, end;
     cur = m_targetedBy.begin();
     end = m_targetedBy.end();
     for(; cur != end; ++cur)
     {
-        if( NULL == up_dup )
-            up_dup = new PyTuple( *up );
+        //everybody shares the same copy.
+        PyTuple* up_ref = up;
+        PyIncRef( up_ref );
 
-        cur->first->QueueDestinyEvent( &up_dup );
-        //they may not have consumed it (NPCs for example), so dont re-dup it in that case.
+        cur->first->QueueDestinyEvent( &up_ref );
+        //they may not have consumed it (NPCs for example).
+        PySafeDecRef( up_ref );
     }
 
-    PySafeDecRef( up_dup );
     PyDecRef( up );
 }
 
 void TargetManager::QueueTBDestinyUpdate( PyTuple** up_in ) const
 {
     PyTuple* up = *up_in;
-    *up_in = NULL;    //could optimize out one of the Clones in here...
-
-    PyTuple* up_dup = NULL;
+    *up_in = NULL;
 
     std::map<SystemEntity*, TargetedByEntry*>::const_iterator cur, end;
     cur = m_targetedBy.begin();
     end = m_targetedBy.end();
     for(; cur != end; ++cur)
     {
-        if( NULL == up_dup )
-            up_dup = new PyTuple( *up );
+        //everybody shares the same copy.
+        PyTuple* up_ref = up;
+        PyIncRef( up_ref );
 
-        cur->first->QueueDestinyUpdate( &up_dup );
-        //they may not have consumed it (NPCs for example), so dont re-dup it in that case.
+        cur->first->QueueDestinyUpdate( &up_ref );
+        //they may not have consumed it (NPCs for example).
+        PySafeDecRef( up_ref );
     }
 
-    PySafeDecRef( up_dup );
     PyDecRef( up );
 }
 
@@ -25,10 +25,41 @@
 
 #include "eve-server.h"
 
+#include "inventory/StaticDataMgr.h"
 #include "ship/dgmtypeattributeinfo.h"
 
 dgmtypeattributemgr::dgmtypeattributemgr()
 {
+    if( sStaticData.IsLoaded() )
+    {
+        // the snapshot has them grouped by type already
+        const StaticDataSnapshot& snapshot = sStaticData.snapshot();
+        for( uint32 typeID = 0; typeID < snapshot.GetTypeIDLimit(); ++typeID )
+        {
+            const StaticDataSnapshot::TypeRecord* type = snapshot.GetType( typeID );
+            if( NULL == type || 0 == type->attributeCount )
+                continue;
+
+            DgmTypeAttributeSet * entry = new DgmTypeAttributeSet;
+
+            const StaticDataSnapshot::AttributeRecord* attrs = snapshot.GetAttributes( *type );
+            for( uint32 i = 0; i < type->attributeCount; i++ )
+            {
+                DmgTypeAttribute * attr_entry = new DmgTypeAttribute();
+                attr_entry->attributeID = attrs[ i ].attributeID;
+                if( attrs[ i ].isInt )
+                    attr_entry->number = EvilNumber( attrs[ i ].valueInt );
+                else
+                    attr_entry->number = EvilNumber( attrs[ i ].valueFloat );
+
+                entry->attributeset.push_back( attr_entry );
+            }
+
+            mDgmTypeAttrInfo.insert( std::make_pair( typeID, entry ) );
+        }
+        return;
+    }
+
     // load shit from db
     DBQueryResult res;
 
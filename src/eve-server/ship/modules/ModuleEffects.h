@@ -75,7 +75,7 @@ public:
     uint32 GetTargetAttributeID(uint32 index)                    { return ((m_EffectID == 0) || (!m_EffectsInfoLoaded)) ? 0 : m_TargetAttributeIDs[index]; }
     EVECalculationType GetCalculationType(uint32 index)            { return ((m_EffectID == 0) || (!m_EffectsInfoLoaded)) ? (EVECalculationType)0 : (EVECalculationType)m_CalculationTypeIDs[index];}
 	EVECalculationType GetReverseCalculationType(uint32 index)    { return ((m_EffectID == 0) || (!m_EffectsInfoLoaded)) ? (EVECalculationType)0 : (EVECalculationType)m_ReverseCalculationTypeIDs[index];}
-    typeTargetGroupIDlist * GetTargetGroupIDlist(uint32 index)    { return ((m_EffectID == 0) || (!m_EffectsInfoLoaded)) ? 0 : m_TargetGroupIDlists.find(index)->second; }
+    typeTargetGroupIDlist * GetTargetGroupIDlist(uint32 index)    { return ((m_EffectID == 0) || (!m_EffectsInfoLoaded) || (m_TargetGroupIDlists.count(index) == 0)) ? 0 : m_TargetGroupIDlists[index]; }
     uint32 GetStackingPenaltyApplied(uint32 index)              { return ((m_EffectID == 0) || (!m_EffectsInfoLoaded)) ? 0 : m_StackingPenaltyAppliedIDs[index]; }
     uint32 GetModuleStateWhenEffectApplied()                    { return ((m_EffectID == 0) || (!m_EffectsInfoLoaded)) ? 0 : m_EffectAppliedInStateIDs[0]; }
     uint32 GetAffectingID()										{ return ((m_EffectID == 0) || (!m_EffectsInfoLoaded)) ? 0 : m_AffectingIDs[0]; }
@@ -150,7 +150,7 @@ public:
     uint32 GetTargetAttributeID(uint32 index)                    { return ((m_SkillID == 0) || (!m_ModifierLoaded)) ? 0 : m_TargetAttributeIDs[index]; }
     EVECalculationType GetCalculationType(uint32 index)            { return ((m_SkillID == 0) || (!m_ModifierLoaded)) ? (EVECalculationType)0 : (EVECalculationType)m_CalculationTypeIDs[index];}
 	EVECalculationType GetReverseCalculationType(uint32 index)    { return ((m_SkillID == 0) || (!m_ModifierLoaded)) ? (EVECalculationType)0 : (EVECalculationType)m_ReverseCalculationTypeIDs[index];}
-    typeTargetGroupIDlist * GetTargetGroupIDlist(uint32 index)    { return ((m_SkillID == 0) || (!m_ModifierLoaded)) ? 0 : m_TargetGroupIDlists.find(index)->second; }
+    typeTargetGroupIDlist * GetTargetGroupIDlist(uint32 index)    { return ((m_SkillID == 0) || (!m_ModifierLoaded) || (m_TargetGroupIDlists.count(index) == 0)) ? 0 : m_TargetGroupIDlists[index]; }
     uint32 GetTargetChargeSize(uint32 index)					{ return ((m_SkillID == 0) || (!m_ModifierLoaded)) ? 0 : m_TargetChargeSizes[index]; }
     uint32 GetAppliedPerLevel(uint32 index)                    { return ((m_SkillID == 0) || (!m_ModifierLoaded)) ? 0 : m_AppliedPerLevelList[index]; }
 	uint32 GetTargetTypeToWhichEffectApplied(uint32 index)        { return ((m_SkillID == 0) || (!m_ModifierLoaded)) ? 0 : m_AffectedTypes[index]; }
@@ -196,7 +196,7 @@ public:
     uint32 GetTargetAttributeID(uint32 index)                    { return ((m_ShipID == 0) || (!m_ModifierLoaded)) ? 0 : m_TargetAttributeIDs[index]; }
     EVECalculationType GetCalculationType(uint32 index)            { return ((m_ShipID == 0) || (!m_ModifierLoaded)) ? (EVECalculationType)0 : (EVECalculationType)m_CalculationTypeIDs[index];}
 	EVECalculationType GetReverseCalculationType(uint32 index)    { return ((m_ShipID == 0) || (!m_ModifierLoaded)) ? (EVECalculationType)0 : (EVECalculationType)m_ReverseCalculationTypeIDs[index];}
-    typeTargetGroupIDlist * GetTargetGroupIDlist(uint32 index)    { return ((m_ShipID == 0) || (!m_ModifierLoaded)) ? 0 : m_TargetGroupIDlists.find(index)->second; }
+    typeTargetGroupIDlist * GetTargetGroupIDlist(uint32 index)    { return ((m_ShipID == 0) || (!m_ModifierLoaded) || (m_TargetGroupIDlists.count(index) == 0)) ? 0 : m_TargetGroupIDlists[index]; }
     uint32 GetAppliedPerLevel(uint32 index)                    { return ((m_ShipID == 0) || (!m_ModifierLoaded)) ? 0 : m_AppliedPerLevelList[index]; }
 	uint32 GetTargetTypeToWhichEffectApplied(uint32 index)        { return ((m_ShipID == 0) || (!m_ModifierLoaded)) ? 0 : m_AffectedTypes[index]; }
     uint32 GetEffectApplicationType(uint32 index)               { return ((m_ShipID == 0) || (!m_ModifierLoaded)) ? 0 : m_AffectingTypes[index]; }
@@ -81,6 +81,7 @@ public:
     virtual EVEItemFlags flag()                                    { return m_Item->flag(); }
     virtual uint32 typeID()                                        { return m_Item->typeID(); }
     virtual bool isOnline()                                        { return (m_Item->GetAttribute(AttrIsOnline) == 1); }
+    ModuleStates GetModuleState()                                { return m_Module_State; }
     virtual bool isHighPower()                                    { return m_Effects->isHighSlot(); }
     virtual bool isMediumPower()                                { return m_Effects->isMediumSlot(); }
     virtual bool isLowPower()                                    { return m_Effects->isLowSlot(); }
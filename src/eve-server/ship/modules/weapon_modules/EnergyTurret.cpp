@@ -252,6 +252,6 @@ void EnergyTurret::DoCycle()
 			effectTargetAttack		// from EVEEffectID::
 		);
 		
-		m_targetEntity->ApplyDamage( damageDealt );
+		m_targetEntity->QueueDamage( damageDealt );
 	}
 }
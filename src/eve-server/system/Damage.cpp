@@ -142,6 +142,24 @@ Damage::~Damage()
 {
 }
 
+DamageResonances::DamageResonances(InventoryItemRef self)
+{
+    shield.kinetic = self->GetAttribute(AttrShieldKineticDamageResonance).get_float();
+    shield.thermal = self->GetAttribute(AttrShieldThermalDamageResonance).get_float();
+    shield.em = self->GetAttribute(AttrShieldEmDamageResonance).get_float();
+    shield.explosive = self->GetAttribute(AttrShieldExplosiveDamageResonance).get_float();
+
+    armor.kinetic = self->GetAttribute(AttrArmorKineticDamageResonance).get_float();
+    armor.thermal = self->GetAttribute(AttrArmorThermalDamageResonance).get_float();
+    armor.em = self->GetAttribute(AttrArmorEmDamageResonance).get_float();
+    armor.explosive = self->GetAttribute(AttrArmorExplosiveDamageResonance).get_float();
+
+    hull.kinetic = self->GetAttribute(AttrHullKineticDamageResonance).get_float();
+    hull.thermal = self->GetAttribute(AttrHullThermalDamageResonance).get_float();
+    hull.em = self->GetAttribute(AttrHullEmDamageResonance).get_float();
+    hull.explosive = self->GetAttribute(AttrHullExplosiveDamageResonance).get_float();
+}
+
 static const char *DamageMessageIDs_Self[6] = {
     "AttackHit1R",    //barely scratches
     "AttackHit2R",    //lightly hits
@@ -189,9 +207,64 @@ void ItemSystemEntity::ApplyDamageModifiers(Damage &d, SystemEntity *target) {
 
 }
 
+void SystemEntity::QueueDamage(const Damage &d) {
+    SystemManager *system = System();
+    if(system == NULL) {
+        //nobody to batch it for us.
+        Damage copy(d);
+        ApplyDamage(copy);
+        return;
+    }
+
+    system->QueueDamage(GetID(), d);
+}
+
+//default implementation knows nothing better than applying them one by one.
+void SystemEntity::ApplyVolleys(std::list<Damage> &volleys) {
+    std::list<Damage>::iterator cur, end;
+    cur = volleys.begin();
+    end = volleys.end();
+    for(; cur != end; cur++) {
+        if(ApplyDamage(*cur))
+            break;
+    }
+}
+
+bool ItemSystemEntity::ApplyDamage(Damage &d) {
+    const DamageResonances resonances(m_self);
+
+    bool killed = _ApplyDamage(d, resonances);
+    if(!killed)
+        _SendDamageStateChanged();
+
+    return(killed);
+}
+
+void ItemSystemEntity::ApplyVolleys(std::list<Damage> &volleys) {
+    if(volleys.empty())
+        return;
+
+    //nothing which changes resists may happen in the middle of a tick.
+    const DamageResonances resonances(m_self);
+
+    std::list<Damage>::iterator cur, end;
+    cur = volleys.begin();
+    end = volleys.end();
+    for(; cur != end; cur++) {
+        _ReduceDamage(*cur);
+
+        //remaining volleys hit the wreck.
+        if(_ApplyDamage(*cur, resonances))
+            return;
+    }
+
+    //one damage state for the whole tick.
+    _SendDamageStateChanged();
+}
+
 //default implementation bases everything directly on our item.
 //the notifications which this puts out probably needs some work.
-bool ItemSystemEntity::ApplyDamage(Damage &d) {
+bool ItemSystemEntity::_ApplyDamage(Damage &d, const DamageResonances &resonances) {
     _log(ITEM__TRACE, "%s(%u): Applying %.1f total damage from %u", GetName(), GetID(), d.GetTotal(), d.source->GetID());
 
     double total_damage = 0;
@@ -214,12 +287,7 @@ bool ItemSystemEntity::ApplyDamage(Damage &d) {
 
 
     double available_shield = m_self->GetAttribute(AttrShieldCharge).get_float();
-    Damage shield_damage = d.MultiplyDup(
-        m_self->GetAttribute(AttrShieldKineticDamageResonance).get_float(),
-        m_self->GetAttribute(AttrShieldThermalDamageResonance).get_float(),
-        m_self->GetAttribute(AttrShieldEmDamageResonance).get_float(),
-        m_self->GetAttribute(AttrShieldExplosiveDamageResonance).get_float()
-        );
+    Damage shield_damage = d.MultiplyDup( resonances.shield );
 
 
     //other:
@@ -284,12 +352,7 @@ bool ItemSystemEntity::ApplyDamage(Damage &d) {
 
         //Armor:
         double available_armor = m_self->GetAttribute(AttrArmorHP).get_float() - m_self->GetAttribute(AttrArmorDamage).get_float();
-        Damage armor_damage = d.MultiplyDup(
-            m_self->GetAttribute(AttrArmorKineticDamageResonance).get_float(),
-            m_self->GetAttribute(AttrArmorThermalDamageResonance).get_float(),
-            m_self->GetAttribute(AttrArmorEmDamageResonance).get_float(),
-            m_self->GetAttribute(AttrArmorExplosiveDamageResonance).get_float()
-        );
+        Damage armor_damage = d.MultiplyDup( resonances.armor );
         //other:
         //activeEmResistanceBonus
         //activeExplosiveResistanceBonus
@@ -339,12 +402,7 @@ bool ItemSystemEntity::ApplyDamage(Damage &d) {
 
             //The base hp and damage attributes represent structure.
             double available_hull = m_self->GetAttribute(AttrHp).get_float() - m_self->GetAttribute(AttrDamage).get_float();
-            Damage hull_damage = d.MultiplyDup(
-                m_self->GetAttribute(AttrHullKineticDamageResonance).get_float(),
-                m_self->GetAttribute(AttrHullThermalDamageResonance).get_float(),
-                m_self->GetAttribute(AttrHullEmDamageResonance).get_float(),
-                m_self->GetAttribute(AttrHullExplosiveDamageResonance).get_float()
-            );
+            Damage hull_damage = d.MultiplyDup( resonances.hull );
             //other:
             //passiveEmDamageResonanceMultiplier
             //passiveThermalDamageResonanceMultiplier
@@ -442,10 +500,6 @@ bool ItemSystemEntity::ApplyDamage(Damage &d) {
     {
         Killed(d);
     }
-    else
-    {
-        _SendDamageStateChanged();
-    }
 
     return(killed);
 }
@@ -474,7 +528,7 @@ bool Client::ApplyDamage(Damage &d) {
 }
 
 // This is a NPC implementation of damage system (incomplete)
-bool NPC::ApplyDamage(Damage &d) {
+bool NPC::_ApplyDamage(Damage &d, const DamageResonances &resonances) {
     _log(ITEM__TRACE, "%u: Applying %.1f total damage from %u", GetID(), d.GetTotal(), d.source->GetID());
 
     double total_damage = 0;
@@ -487,12 +541,7 @@ bool NPC::ApplyDamage(Damage &d) {
 
     //Shield:
     double available_shield = m_shieldCharge;
-    Damage shield_damage = d.MultiplyDup(
-        m_self->GetAttribute(AttrShieldKineticDamageResonance).get_float(),
-        m_self->GetAttribute(AttrShieldThermalDamageResonance).get_float(),
-        m_self->GetAttribute(AttrShieldEmDamageResonance).get_float(),
-        m_self->GetAttribute(AttrShieldExplosiveDamageResonance).get_float()
-    );
+    Damage shield_damage = d.MultiplyDup( resonances.shield );
     //other:
     //emDamageResistanceBonus
     //explosiveDamageResistanceBonus
@@ -556,12 +605,7 @@ bool NPC::ApplyDamage(Damage &d) {
 
         //Armor:
         double available_armor = m_self->GetAttribute(AttrArmorHP).get_float() - m_armorDamage;
-        Damage armor_damage = d.MultiplyDup(
-            m_self->GetAttribute(AttrArmorKineticDamageResonance).get_float(),
-            m_self->GetAttribute(AttrArmorThermalDamageResonance).get_float(),
-            m_self->GetAttribute(AttrArmorEmDamageResonance).get_float(),
-            m_self->GetAttribute(AttrArmorExplosiveDamageResonance).get_float()
-        );
+        Damage armor_damage = d.MultiplyDup( resonances.armor );
         //other:
         //activeEmResistanceBonus
         //activeExplosiveResistanceBonus
@@ -611,12 +655,7 @@ bool NPC::ApplyDamage(Damage &d) {
 
             //The base hp and damage attributes represent structure.
             double available_hull = m_self->GetAttribute(AttrHp).get_float() - m_hullDamage;
-            Damage hull_damage = d.MultiplyDup(
-                m_self->GetAttribute(AttrHullKineticDamageResonance).get_float(),
-                m_self->GetAttribute(AttrHullThermalDamageResonance).get_float(),
-                m_self->GetAttribute(AttrHullEmDamageResonance).get_float(),
-                m_self->GetAttribute(AttrHullExplosiveDamageResonance).get_float()
-            );
+            Damage hull_damage = d.MultiplyDup( resonances.hull );
             //other:
             //passiveEmDamageResonanceMultiplier
             //passiveThermalDamageResonanceMultiplier
@@ -707,29 +746,11 @@ bool NPC::ApplyDamage(Damage &d) {
     {
         Killed(d);
     }
-    else
-    {
-        _SendDamageStateChanged();
-    }
 
     return(killed);
 
 }
 
-void NPC::_SendDamageStateChanged() const
-{
-    DoDestinyDamageState state;
-    MakeDamageState(state);
-
-    DoDestiny_OnDamageStateChange ddsc;
-    ddsc.entityID = GetID();
-    ddsc.state = state.Encode();
-
-    PyTuple *up;
-    up = ddsc.Encode();
-    targets.QueueTBDestinyUpdate(&up);
-}
-
 void ItemSystemEntity::_SendDamageStateChanged() const {
     DoDestinyDamageState state;
     MakeDamageState(state);
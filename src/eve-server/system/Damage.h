@@ -30,6 +30,25 @@ class InventoryItem;
 
 #include "system/SystemEntity.h"
 
+//damage multipliers of one layer (shield, armor or hull)
+struct DamageResonance {
+    double kinetic;
+    double thermal;
+    double em;
+    double explosive;
+};
+
+//resonances of all layers of an entity, read once per tick and shared by
+//every volley resolved against it in that tick.
+class DamageResonances {
+public:
+    DamageResonances(InventoryItemRef self);
+
+    DamageResonance shield;
+    DamageResonance armor;
+    DamageResonance hull;
+};
+
 class Damage {
 public:
     Damage( SystemEntity *_source,
@@ -64,6 +83,11 @@ public:
                        effect );
     }
 
+    Damage MultiplyDup( const DamageResonance &resonance ) const
+    {
+        return MultiplyDup( resonance.kinetic, resonance.thermal, resonance.em, resonance.explosive );
+    }
+
     void ReduceTo(double total_amount)
     {
         *this *= ( total_amount / GetTotal() );
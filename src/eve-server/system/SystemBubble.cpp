@@ -75,24 +75,23 @@ void SystemBubble::BubblecastDestiny(std::vector<PyTuple *> &updates, std::vecto
 void SystemBubble::BubblecastDestinyUpdate( PyTuple** payload, const char* desc ) const
 {
     PyTuple* up = *payload;
-    *payload = NULL;    //could optimize out one of the Clones in here...
-
-    PyTuple* up_dup = NULL;
+    *payload = NULL;
 
     std::set<SystemEntity*>::const_iterator cur, end, tmp;
     cur = m_dynamicEntities.begin();
     end = m_dynamicEntities.end();
     for(; cur != end; ++cur)
     {
-        if( NULL == up_dup )
-            up_dup = new PyTuple( *up );
+        //queued updates are never modified, so everybody shares the same one.
+        PyTuple* up_ref = up;
+        PyIncRef( up_ref );
 
         _log( DESTINY__BUBBLE_TRACE, "Bubblecast %s update to %s (%u)", desc, (*cur)->GetName(), (*cur)->GetID() );
-        (*cur)->QueueDestinyUpdate( &up_dup );
-        //they may not have consumed it (NPCs for example), so dont re-dup it in that case.
+        (*cur)->QueueDestinyUpdate( &up_ref );
+        //they may not have consumed it (NPCs for example).
+        PySafeDecRef( up_ref );
     }
 
-    PySafeDecRef( up_dup );
     PyDecRef( up );
 }
 
@@ -101,9 +100,7 @@ void SystemBubble::BubblecastDestinyUpdate( PyTuple** payload, const char* desc
 void SystemBubble::BubblecastDestinyUpdateExclusive( PyTuple** payload, const char* desc, SystemEntity *ent ) const
 {
     PyTuple* up = *payload;
-    *payload = NULL;    //could optimize out one of the Clones in here...
-
-    PyTuple* up_dup = NULL;
+    *payload = NULL;
 
     std::set<SystemEntity*>::const_iterator cur, end, tmp;
     cur = m_dynamicEntities.begin();
@@ -114,16 +111,16 @@ void SystemBubble::BubblecastDestinyUpdateExclusive( PyTuple** payload, const ch
 		// (this is an update to all SystemEntity objects in the bubble EXCLUDING 'ent')
 		if( (*cur)->GetID() != ent->GetID() )
 		{
-			if( NULL == up_dup )
-				up_dup = new PyTuple( *up );
+			PyTuple* up_ref = up;
+			PyIncRef( up_ref );
 
 			_log( DESTINY__BUBBLE_TRACE, "Bubblecast %s update to %s (%u)", desc, (*cur)->GetName(), (*cur)->GetID() );
-			(*cur)->QueueDestinyUpdate( &up_dup );
-			//they may not have consumed it (NPCs for example), so dont re-dup it in that case.
+			(*cur)->QueueDestinyUpdate( &up_ref );
+			//they may not have consumed it (NPCs for example).
+			PySafeDecRef( up_ref );
 		}
     }
 
-    PySafeDecRef( up_dup );
     PyDecRef( up );
 }
 
@@ -132,24 +129,23 @@ void SystemBubble::BubblecastDestinyUpdateExclusive( PyTuple** payload, const ch
 void SystemBubble::BubblecastDestinyEvent( PyTuple** payload, const char* desc ) const
 {
     PyTuple* up = *payload;
-    *payload = NULL;    //could optimize out one of the Clones in here...
-
-    PyTuple* up_dup = NULL;
+    *payload = NULL;
 
     std::set<SystemEntity *>::const_iterator cur, end, tmp;
     cur = m_dynamicEntities.begin();
     end = m_dynamicEntities.end();
     for(; cur != end; ++cur)
     {
-        if( NULL == up_dup )
-            up_dup = new PyTuple( *up );
+        //shared events are never merged into (see Client::_MergeAttributeChange).
+        PyTuple* up_ref = up;
+        PyIncRef( up_ref );
 
         _log( DESTINY__BUBBLE_TRACE, "Bubblecast %s event to %s (%u)", desc, (*cur)->GetName(), (*cur)->GetID() );
-        (*cur)->QueueDestinyEvent( &up_dup );
-        //they may not have consumed it (NPCs for example), so dont re-dup it in that case.
+        (*cur)->QueueDestinyEvent( &up_ref );
+        //they may not have consumed it (NPCs for example).
+        PySafeDecRef( up_ref );
     }
 
-    PySafeDecRef( up_dup );
     PyDecRef( up );
 }
 
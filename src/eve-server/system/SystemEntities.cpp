@@ -25,6 +25,7 @@
 
 #include "eve-server.h"
 
+#include "map/UniverseMgr.h"
 #include "mining/AsteroidBeltManager.h"
 #include "system/SystemEntities.h"
 
@@ -173,6 +174,22 @@ bool SystemStargateEntity::LoadExtras(SystemDB *db) {
     if(!SystemStationEntity::LoadExtras(db))
         return false;
 
+    //the universe graph has the destination; the database is left for gates it doesn't know
+    uint32 toStargateID, toSystemID;
+    if(sUniverse.GetStargateJump(GetID(), toStargateID, toSystemID)) {
+        util_Rowset rs;
+        rs.header.push_back("toCelestialID");
+        rs.header.push_back("locationID");
+
+        PyList *line = new PyList;
+        line->AddItemInt(toStargateID);
+        line->AddItemInt(toSystemID);
+        rs.lines->AddItem(line);
+
+        m_jumps = rs.Encode();
+        return true;
+    }
+
     m_jumps = db->ListJumps(GetID());
     if(m_jumps == NULL)
         return false;
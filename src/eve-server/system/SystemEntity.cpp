@@ -153,6 +153,17 @@ void DynamicSystemEntity::ProcessDestiny() {
         m_destiny->Process();
 }
 
+bool DynamicSystemEntity::ProcessDestinyBatched(Destiny::BallTable &table, size_t &index) {
+    if(m_destiny == NULL)
+        return false;
+    return(m_destiny->BeginBatchedTic(table, index));
+}
+
+void DynamicSystemEntity::FinishDestinyBatched(const Destiny::BallTable &table, size_t index) {
+    if(m_destiny != NULL)
+        m_destiny->EndBatchedTic(table, index);
+}
+
 const GPoint &DynamicSystemEntity::GetPosition() const {
     if(m_destiny == NULL)
         return(ItemSystemEntity::GetPosition());
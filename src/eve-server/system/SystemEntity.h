@@ -40,11 +40,13 @@ class InventoryItem;
 class SystemDB;
 class GPoint;
 class Damage;
+class DamageResonances;
 class SystemBubble;
 class SystemManager;
 
 class Client;
 class NPC;
+namespace Destiny { class BallTable; }
 
 
 class SystemEntity {
@@ -71,6 +73,9 @@ public:
 
     virtual void Process();
     virtual void ProcessDestiny() = 0;
+    //batched variant; returns true if our ball was added to the table and awaits FinishDestinyBatched.
+    virtual bool ProcessDestinyBatched(Destiny::BallTable &table, size_t &index) { ProcessDestiny(); return false; }
+    virtual void FinishDestinyBatched(const Destiny::BallTable &table, size_t index) {}
 
     //this is a bit crude, but I prefer this over RTTI.
     virtual EntityClass GetClass() const { return(ecOther); }
@@ -126,6 +131,10 @@ public:
     virtual void ApplyDamageModifiers(Damage &d, SystemEntity *target) = 0;
     //process incoming damage, returns true on death.
     virtual bool ApplyDamage(Damage &d) = 0;
+    //process all volleys which hit us this tick, in order, until we die.
+    virtual void ApplyVolleys(std::list<Damage> &volleys);
+    //queue incoming damage to be applied with the other volleys of this tick.
+    void QueueDamage(const Damage &d);
     //handles death.
     virtual void Killed(Damage &fatal_blow);
 
@@ -155,10 +164,16 @@ public:
     virtual void ApplyDamageModifiers(Damage &d, SystemEntity *target);
     //process incoming damage, returns true on death.
     virtual bool ApplyDamage(Damage &d);
+    //resists are read once for all volleys, damage state is sent once.
+    virtual void ApplyVolleys(std::list<Damage> &volleys);
 
 protected:
     InventoryItemRef m_self;
 
+    //lets the entity reduce incoming damage before it is applied; does nothing by default.
+    virtual void _ReduceDamage(Damage &d) {}
+    //applies one volley and sends the hit notifications, but not the damage state.
+    virtual bool _ApplyDamage(Damage &d, const DamageResonances &resonances);
     void _SendDamageStateChanged() const;
     void _SetSelf(InventoryItemRef self);
 };
@@ -173,6 +188,8 @@ public:
 
     //partial implementation of SystemEntity interface:
     virtual void ProcessDestiny();
+    virtual bool ProcessDestinyBatched(Destiny::BallTable &table, size_t &index);
+    virtual void FinishDestinyBatched(const Destiny::BallTable &table, size_t index);
     virtual const GPoint &GetPosition() const;
     virtual const GVector &GetVelocity() const;
     virtual void EncodeDestiny( Buffer& into ) const;
@@ -26,9 +26,11 @@
 #include "eve-server.h"
 
 #include "Client.h"
+#include "EVEServerConfig.h"
 #include "chat/LSCService.h"
 #include "mining/Asteroid.h"
 #include "npc/NPC.h"
+#include "npc/NPCAI.h"
 #include "npc/SpawnManager.h"
 #include "pos/Structure.h"
 #include "ship/Drone.h"
@@ -48,7 +50,10 @@ SystemManager::SystemManager(uint32 systemID, PyServiceMgr &svc)//, ItemData ida
   m_systemName(""),
   m_services(svc),
   m_spawnManager(new SpawnManager(*this, m_services)),
-  m_entityChanged(false)//,
+  m_entityChanged(false),
+  m_aiTimer(50),    //arbitrary.
+  m_npcChanged(false),
+  m_npcTargets(*this)//,
 //  InventoryItem( svc.item_factory, systemID, *(svc.item_factory.GetType( 5 )), idata )
 {
     m_db.GetSystemInfo(GetID(), NULL, NULL, &m_systemName, &m_systemSecurity);
@@ -82,6 +87,8 @@ SystemManager::~SystemManager() {
     delete m_spawnManager;
 
     bubbles.clear();
+
+    _InvalidateSetStatePrefix();
 }
 
 static const int num_hack_sentry_locs = 8;
@@ -652,14 +659,116 @@ bool SystemManager::Process() {
 
     bubbles.Process();
 
+    if(m_aiTimer.Check())
+        _ProcessNPCAI();
+
+    _ProcessDamage();
+
     return true;
 }
 
+void SystemManager::QueueDamage(uint32 targetID, const Damage &d) {
+    //the source may be gone by the end of the tick; remember it by ID.
+    m_pendingDamage[targetID].push_back(std::make_pair(d.source->GetID(), d));
+}
+
+void SystemManager::_ProcessDamage() {
+    if(m_pendingDamage.empty())
+        return;
+
+    //anything queued while resolving (e.g. from Killed()) waits for the next tick.
+    std::map<uint32, std::list<std::pair<uint32, Damage> > > pending;
+    pending.swap(m_pendingDamage);
+
+    std::map<uint32, std::list<std::pair<uint32, Damage> > >::iterator cur, end;
+    cur = pending.begin();
+    end = pending.end();
+    for(; cur != end; cur++) {
+        SystemEntity *target = get(cur->first);
+        if(target == NULL)
+            continue;    //left the system or died this tick.
+
+        //volleys of sources which have died or left since firing are dropped.
+        std::list<Damage> volleys;
+        std::list<std::pair<uint32, Damage> >::const_iterator v, vend;
+        v = cur->second.begin();
+        vend = cur->second.end();
+        for(; v != vend; v++) {
+            if(get(v->first) == v->second.source)
+                volleys.push_back(v->second);
+        }
+
+        target->ApplyVolleys(volleys);
+    }
+}
+
+void SystemManager::_ProcessNPCAI() {
+    if(m_npcs.empty())
+        return;
+
+    const uint64 start = GetTimeUSec();
+
+    //targets are looked up against positions as of this batch.
+    m_npcTargets.Invalidate();
+    m_npcChanged = false;
+
+    uint32 count = 0;
+    std::map<uint32, NPC *>::const_iterator cur, end;
+    cur = m_npcs.begin();
+    end = m_npcs.end();
+    while(cur != end) {
+        const uint32 npcID = cur->first;
+        cur->second->AI()->Process(m_npcTargets);
+        count++;
+
+        if(m_npcChanged) {
+            //somebody changed the NPC list, resume after the one we just did.
+            m_npcChanged = false;
+
+            cur = m_npcs.upper_bound(npcID);
+            end = m_npcs.end();
+        } else {
+            cur++;
+        }
+    }
+
+    const uint64 elapsed = GetTimeUSec() - start;
+
+    m_aiStats.npcs = count;
+    m_aiStats.batches++;
+    m_aiStats.usec += elapsed;
+    if(elapsed > m_aiStats.peakUSec)
+        m_aiStats.peakUSec = elapsed;
+}
+
+void SystemManager::_RotateAIStats() {
+    m_aiStats.queries = m_npcTargets.GetQueryCount();
+    m_aiStats.reuses = m_npcTargets.GetReuseCount();
+    m_npcTargets.ResetCounters();
+
+    if(m_aiStats.batches > 0) {
+        _log(NPC__AI_STATS, "System %u: %u NPCs, %u batches, %.3f ms total, %.3f ms peak, %u target queries, %u shared.",
+            m_systemID, m_aiStats.npcs, m_aiStats.batches, m_aiStats.usec / 1000.0, m_aiStats.peakUSec / 1000.0,
+            m_aiStats.queries, m_aiStats.reuses);
+    }
+
+    m_lastAIStats = m_aiStats;
+    m_aiStats = AIStats();
+}
+
 //called once per second.
 void SystemManager::ProcessDestiny() {
     //this is here so it isnt called so frequently.
     m_spawnManager->Process();
 
+    _RotateAIStats();
+
+    if( sConfig.world.batchDestiny )
+    {
+        _ProcessDestinyBatched();
+        return;
+    }
+
     m_entityChanged = false;
 
     std::map<uint32, SystemEntity *>::const_iterator cur, end;
@@ -687,6 +796,54 @@ void SystemManager::ProcessDestiny() {
     }
 }
 
+void SystemManager::_ProcessDestinyBatched() {
+    m_balls.Clear();
+    m_ballOwners.clear();
+
+    m_entityChanged = false;
+
+    std::map<uint32, SystemEntity *>::iterator cur, end;
+    cur = m_entities.begin();
+    end = m_entities.end();
+    while(cur != end) {
+        const uint32 entityID = cur->first;
+        SystemEntity *se = cur->second;
+
+        if(se == NULL) {
+            sLog.Error("SystemManager::_ProcessDestinyBatched()", "ERROR! Somehow the SystemEntity * for entityID '%u' was deleted without being removed from the SystemManager's m_entities map!", entityID);
+            m_entities.erase(cur++);
+            continue;
+        }
+
+        size_t index;
+        if(se->ProcessDestinyBatched(m_balls, index)) {
+            BallOwner owner = { entityID, se, index };
+            m_ballOwners.push_back(owner);
+        }
+
+        if(m_entityChanged) {
+            //somebody changed the entity list, carry on after the entity we just processed.
+            m_entityChanged = false;
+
+            cur = m_entities.upper_bound(entityID);
+            end = m_entities.end();
+        } else {
+            cur++;
+        }
+    }
+
+    m_balls.Integrate();
+
+    for(size_t i = 0; i < m_ballOwners.size(); i++) {
+        //skip entities which went away during this tic.
+        const BallOwner &owner = m_ballOwners[i];
+        if(get(owner.entityID) != owner.entity)
+            continue;
+
+        owner.entity->FinishDestinyBatched(m_balls, owner.index);
+    }
+}
+
 bool SystemManager::BuildDynamicEntity(Client *who, const DBSystemDynamicEntity &entity)
 {
     SystemEntity *se = DynamicEntityFactory::BuildEntity(*this, m_services.item_factory, entity );
@@ -700,6 +857,8 @@ bool SystemManager::BuildDynamicEntity(Client *who, const DBSystemDynamicEntity
     m_entities[se->GetID()] = se;
     bubbles.Add(se, false);
     m_entityChanged = true;
+    if(se->IsVisibleSystemWide() && se->IsStaticEntity())
+        _InvalidateSetStatePrefix();
 
     return true;
 }
@@ -745,6 +904,14 @@ void SystemManager::RemoveNPC(NPC *who) {
 void SystemManager::AddEntity(SystemEntity *who) {
     m_entities[who->GetID()] = who;
     m_entityChanged = true;
+    if(who->IsClient())
+        m_clients[who->GetID()] = who->CastToClient();
+    else if(who->IsNPC()) {
+        m_npcs[who->GetID()] = who->CastToNPC();
+        m_npcChanged = true;
+    }
+    if(who->IsVisibleSystemWide() && who->IsStaticEntity())
+        _InvalidateSetStatePrefix();
     bubbles.Add(who, false);
 
     // Add Entity's Item Ref to Solar System Dynamic Inventory:
@@ -759,8 +926,16 @@ void SystemManager::RemoveEntity(SystemEntity *who) {
     } else
         _log(SERVICE__ERROR, "Entity %u not found is system %u to be deleted.", who->GetID(), GetID());
 
+    if(m_clients.erase(who->GetID()) > 0)
+        m_npcTargets.Invalidate();
+    if(m_npcs.erase(who->GetID()) > 0)
+        m_npcChanged = true;
+
     bubbles.Remove(who, false);
 
+    if(m_setStatePrefix.entities.find(who->GetID()) != m_setStatePrefix.entities.end())
+        _InvalidateSetStatePrefix();
+
     // Remove Entity's Item Ref from Solar System Dynamic Inventory:
     RemoveItemFromInventory( this->itemFactory().GetItem( who->GetID() ) );
 }
@@ -788,20 +963,47 @@ double SystemManager::GetWarpSpeed() const {
 
 void SystemManager::MakeSetState(const SystemBubble *bubble, DoDestiny_SetState &ss) const
 {
+    if( !m_setStatePrefix.valid )
+        _BuildSetStatePrefix();
+
     Buffer* stateBuffer = new Buffer;
+    stateBuffer->Reserve<uint8>( sizeof( AddBall_header ) + m_setStatePrefix.destiny.size() );
 
     AddBall_header head;
     head.packet_type = 0;
     head.sequence = ss.stamp;
     stateBuffer->Append( head );
 
+    //system-wide static part, shared between all bubbles
+    stateBuffer->AppendSeq( m_setStatePrefix.destiny.begin<uint8>(),
+                            m_setStatePrefix.destiny.end<uint8>() );
+
+    PySafeDecRef( ss.slims );
+    ss.slims = new PyList;
 
-    //I am not thrilled with this mechanism, but I cant think of a better
-    //way to deal with it right now. The issue is that we need to send out
-    // info for all system-wide entities (celestials, etc), as well as all
-    // entities in our current bubble. Well, it is likely that some things
-    // in our bubble are system-wide, and we would be sending out duplciates.
-    // so, we use a set to enforce uniqueness.
+    {
+        std::map<int32, PyRep*>::const_iterator cur, end;
+        cur = m_setStatePrefix.damageState.begin();
+        end = m_setStatePrefix.damageState.end();
+        for(; cur != end; ++cur)
+        {
+            PyIncRef( cur->second );
+            ss.damageState[ cur->first ] = cur->second;
+        }
+    }
+    {
+        std::vector<PyRep*>::const_iterator cur, end;
+        cur = m_setStatePrefix.slims.begin();
+        end = m_setStatePrefix.slims.end();
+        for(; cur != end; ++cur)
+        {
+            PyIncRef( *cur );
+            ss.slims->AddItem( *cur );
+        }
+    }
+
+    //the rest of system-wide entities and everything in our bubble;
+    //things in our bubble may be system-wide too, hence the set.
     std::set<SystemEntity*> visibleEntities;
     {
         std::map<uint32, SystemEntity*>::const_iterator cur, end;
@@ -809,23 +1011,14 @@ void SystemManager::MakeSetState(const SystemBubble *bubble, DoDestiny_SetState
         end = m_entities.end();
         for(; cur != end; ++cur)
         {
-            if( !cur->second->IsVisibleSystemWide() )
-            {
-                //_log(COMMON__WARNING, "%u is not visible!", cur->first);
-                continue;
-            }
-
-            //_log(COMMON__WARNING, "%u is system wide visible!", cur->first);
-            visibleEntities.insert( cur->second );
+            if( cur->second->IsVisibleSystemWide() && !cur->second->IsStaticEntity() )
+                visibleEntities.insert( cur->second );
         }
     }
 
     //bubble is null??? why???
     bubble->GetEntities( visibleEntities );
 
-    PySafeDecRef( ss.slims );
-    ss.slims = new PyList;
-
     //go through all entities and gather the info we need...
     std::set<SystemEntity*>::const_iterator cur, end;
     cur = visibleEntities.begin();
@@ -833,6 +1026,9 @@ void SystemManager::MakeSetState(const SystemBubble *bubble, DoDestiny_SetState
     for(; cur != end; ++cur)
     {
         SystemEntity* ent = *cur;
+        if( m_setStatePrefix.entities.find( ent->GetID() ) != m_setStatePrefix.entities.end() )
+            continue;
+
         _log(COMMON__WARNING, "Encoding entity %u", ent->GetID());
 
         //ss.damageState
@@ -862,12 +1058,8 @@ void SystemManager::MakeSetState(const SystemBubble *bubble, DoDestiny_SetState
     }
 
     //ss.solItem
-    ss.solItem = m_db.GetSolRow( m_systemID );
-    if( NULL == ss.solItem )
-    {
-        _log( CLIENT__ERROR, "Unable to query solarsystem entity for destiny update in system %u!", m_systemID );
-        ss.solItem = new PyNone;
-    }
+    PyIncRef( m_setStatePrefix.solItem );
+    ss.solItem = m_setStatePrefix.solItem;
 
     //ss.effectStates
     ss.effectStates = new PyList;
@@ -888,6 +1080,68 @@ void SystemManager::MakeSetState(const SystemBubble *bubble, DoDestiny_SetState
                                          ss.destiny_state->content().size() );
 }
 
+void SystemManager::_BuildSetStatePrefix() const
+{
+    SetStatePrefix& prefix = m_setStatePrefix;
+
+    std::map<uint32, SystemEntity*>::const_iterator cur, end;
+    cur = m_entities.begin();
+    end = m_entities.end();
+    for(; cur != end; ++cur)
+    {
+        SystemEntity* ent = cur->second;
+        //only things which never change may be shared
+        if( !ent->IsVisibleSystemWide() || !ent->IsStaticEntity() )
+            continue;
+
+        _log(COMMON__WARNING, "Encoding entity %u", ent->GetID());
+
+        prefix.entities.insert( ent->GetID() );
+        prefix.damageState[ ent->GetID() ] = ent->MakeDamageState();
+        prefix.slims.push_back( new PyObject( "foo.SlimItem", ent->MakeSlimItem() ) );
+        ent->EncodeDestiny( prefix.destiny );
+    }
+
+    prefix.solItem = m_db.GetSolRow( m_systemID );
+    if( NULL == prefix.solItem )
+    {
+        _log( CLIENT__ERROR, "Unable to query solarsystem entity for destiny update in system %u!", m_systemID );
+        prefix.solItem = new PyNone;
+    }
+
+    prefix.valid = true;
+}
+
+void SystemManager::_InvalidateSetStatePrefix()
+{
+    SetStatePrefix& prefix = m_setStatePrefix;
+    if( !prefix.valid )
+        return;
+
+    {
+        std::map<int32, PyRep*>::iterator cur, end;
+        cur = prefix.damageState.begin();
+        end = prefix.damageState.end();
+        for(; cur != end; ++cur)
+            PyDecRef( cur->second );
+    }
+    {
+        std::vector<PyRep*>::iterator cur, end;
+        cur = prefix.slims.begin();
+        end = prefix.slims.end();
+        for(; cur != end; ++cur)
+            PyDecRef( *cur );
+    }
+    PySafeDecRef( prefix.solItem );
+
+    prefix.entities.clear();
+    prefix.damageState.clear();
+    prefix.slims.clear();
+    prefix.destiny = Buffer();
+
+    prefix.valid = false;
+}
+
 ItemFactory& SystemManager::itemFactory() const
 {
     return m_services.item_factory;
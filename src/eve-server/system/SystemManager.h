@@ -26,7 +26,10 @@
 #ifndef __SYSTEMMANAGER_H_INCL__
 #define __SYSTEMMANAGER_H_INCL__
 
+#include "destiny/BallTable.h"
+#include "npc/NPCTargetIndex.h"
 #include "system/BubbleManager.h"
+#include "system/Damage.h"
 #include "system/SystemDB.h"
 
 //#define ONE_AU_IN_METERS 1.495978707e11     // 1 astronomical unit in meters
@@ -68,6 +71,22 @@ public:
     bool Process();
     void ProcessDestiny();    //called once for each destiny second.
 
+    //cost of NPC AI over the last destiny second.
+    struct AIStats {
+        AIStats() : npcs(0), batches(0), usec(0), peakUSec(0), queries(0), reuses(0) {}
+
+        uint32 npcs;        //NPCs processed by the last batch
+        uint32 batches;
+        uint64 usec;        //time spent in all batches
+        uint64 peakUSec;    //time spent in the slowest batch
+        uint32 queries;     //target grid queries
+        uint32 reuses;      //target lookups served by a spawn's shared list
+    };
+    const AIStats &GetAIStats() const { return(m_lastAIStats); }
+
+    typedef std::map<uint32, Client *> ClientMap;
+    const ClientMap &GetClients() const { return(m_clients); }
+
     bool BuildDynamicEntity(Client *who, const DBSystemDynamicEntity &entity);
 
     void AddClient(Client *who);
@@ -82,6 +101,9 @@ public:
 
     SystemEntity *get(uint32 entityID) const;
 
+    //volleys are resolved per target at the end of the tick.
+    void QueueDamage(uint32 targetID, const Damage &d);
+
     void MakeSetState(const SystemBubble *bubble, DoDestiny_SetState &into) const;
 
     SystemDB *GetSystemDB() { return(&m_db); }
@@ -106,6 +128,12 @@ protected:
 
     bool _LoadSystemCelestials();
     bool _LoadSystemDynamics();
+    void _ProcessDestinyBatched();
+    void _ProcessNPCAI();
+    void _ProcessDamage();
+    void _RotateAIStats();
+    void _BuildSetStatePrefix() const;
+    void _InvalidateSetStatePrefix();
 
     const uint32 m_systemID;
     std::string m_systemName;
@@ -118,6 +146,41 @@ protected:
     //overall system entity lists:
     bool m_entityChanged;
     std::map<uint32, SystemEntity *> m_entities;    //we own these, but they are also referenced in m_bubbles
+    ClientMap m_clients;    //subset of m_entities
+    std::map<uint32, NPC *> m_npcs;    //subset of m_entities
+
+    //NPC AI runs for the whole system in one batch:
+    Timer m_aiTimer;
+    bool m_npcChanged;
+    NPCTargetIndex m_npcTargets;
+    AIStats m_aiStats;
+    AIStats m_lastAIStats;
+
+    //volleys fired this tick with the ID of their source, by target ID:
+    std::map<uint32, std::list<std::pair<uint32, Damage> > > m_pendingDamage;
+
+    //static system-wide part of SetState (celestials, stations, gates, solItem),
+    //encoded once and shared by every SetState we make:
+    struct SetStatePrefix {
+        SetStatePrefix() : valid(false), solItem(NULL) {}
+
+        bool valid;
+        std::set<uint32> entities;
+        Buffer destiny;
+        std::map<int32, PyRep *> damageState;
+        std::vector<PyRep *> slims;
+        PyRep *solItem;
+    };
+    mutable SetStatePrefix m_setStatePrefix;
+
+    //balls integrated together each destiny tic, with their owners:
+    struct BallOwner {
+        uint32 entityID;
+        SystemEntity *entity;
+        size_t index;    //row in m_balls
+    };
+    Destiny::BallTable m_balls;
+    std::vector<BallOwner> m_ballOwners;
 };
 
 
@@ -25,6 +25,7 @@
 
 #include "eve-server.h"
 
+#include "inventory/StaticDataMgr.h"
 #include "system/WrecksAndLoot.h"
 #include "system/SystemDB.h"
 
@@ -48,6 +49,10 @@ int DGM_Types_to_Wrecks_Table::Initialize()
 
 void DGM_Types_to_Wrecks_Table::_Populate()
 {
+    // served from the static data snapshot instead
+    if( sStaticData.IsLoaded() )
+        return;
+
     uint32 wreckID, typeID;
 
     //first get list of all effects from dgmEffects table
@@ -74,6 +79,10 @@ void DGM_Types_to_Wrecks_Table::_Populate()
 
 uint32 DGM_Types_to_Wrecks_Table::GetWreckID(uint32 typeID)
 {
+    uint32 wreckID;
+    if( sStaticData.GetWreckID( typeID, wreckID ) )
+        return wreckID;
+
     std::map<uint32, uint32>::iterator mWrecksMapIterator;
 
     if( (mWrecksMapIterator = m_WrecksToTypesMap.find(typeID)) == m_WrecksToTypesMap.end() )
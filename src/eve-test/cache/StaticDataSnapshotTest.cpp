@@ -0,0 +1,143 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    const char* SNAPSHOT_PATH = "StaticDataSnapshotTest.bin";
+    const uint32 SNAPSHOT_STAMP = 0x5EED1234;
+
+    StaticDataSnapshot::TypeRecord MakeType( uint32 groupID, double mass )
+    {
+        StaticDataSnapshot::TypeRecord type;
+        memset( &type, 0, sizeof( type ) );
+
+        type.groupID = groupID;
+        type.mass = mass;
+        type.portionSize = 1;
+        type.published = 1;
+
+        return type;
+    }
+
+    bool Corrupt( long offset, uint8 value )
+    {
+        FILE* file = fopen( SNAPSHOT_PATH, "r+b" );
+        if( NULL == file )
+            return false;
+
+        fseek( file, offset, SEEK_SET );
+        fwrite( &value, 1, 1, file );
+        fclose( file );
+
+        return true;
+    }
+}
+
+int cache_StaticDataSnapshotTest( int argc, char* argv[] )
+{
+    StaticDataBuilder builder;
+    builder.AddCategory( 6, "Ship", "", true );
+    builder.AddGroup( 25, 6, "Frigate", "Small ships.", StaticDataSnapshot::GROUP_PUBLISHED | StaticDataSnapshot::GROUP_ANCHORABLE );
+    builder.AddType( 587, MakeType( 25, 1.0e6 ), "Rifter", "A Minmatar frigate." );
+    builder.AddType( 602, MakeType( 25, 1.1e6 ), "Kestrel", "" );
+    builder.AddTypeAttribute( 587, 4, 1.0e6 );
+    builder.AddTypeAttribute( 587, 12, (int32)3 );
+    builder.AddTypeEffect( 587, 11 );
+    builder.AddTypeEffect( 587, 12 );
+    builder.SetWreckType( 587, 26483 );
+
+    if( !builder.Write( SNAPSHOT_PATH, SNAPSHOT_STAMP ) )
+    {
+        ::printf( "Failed to write the snapshot.\n" );
+        return EXIT_FAILURE;
+    }
+
+    StaticDataSnapshot snapshot;
+    if( snapshot.Open( SNAPSHOT_PATH, SNAPSHOT_STAMP + 1 ) )
+    {
+        ::printf( "Opened a snapshot with a wrong stamp.\n" );
+        return EXIT_FAILURE;
+    }
+    if( !snapshot.Open( SNAPSHOT_PATH, SNAPSHOT_STAMP ) )
+    {
+        ::printf( "Failed to open the snapshot.\n" );
+        return EXIT_FAILURE;
+    }
+
+    const StaticDataSnapshot::CategoryRecord* category = snapshot.GetCategory( 6 );
+    const StaticDataSnapshot::GroupRecord* group = snapshot.GetGroup( 25 );
+    if( NULL == category || NULL == group || NULL != snapshot.GetCategory( 5 ) || NULL != snapshot.GetGroup( 1000 )
+        || 0 != strcmp( "Ship", snapshot.GetString( category->name ) ) || 6 != group->categoryID
+        || 0 != strcmp( "Small ships.", snapshot.GetString( group->description ) )
+        || ( StaticDataSnapshot::GROUP_PUBLISHED | StaticDataSnapshot::GROUP_ANCHORABLE ) != group->flags )
+    {
+        ::printf( "Category or group mismatch.\n" );
+        return EXIT_FAILURE;
+    }
+
+    const StaticDataSnapshot::TypeRecord* rifter = snapshot.GetType( 587 );
+    const StaticDataSnapshot::TypeRecord* kestrel = snapshot.GetType( 602 );
+    if( NULL == rifter || NULL == kestrel || NULL != snapshot.GetType( 588 ) || NULL != snapshot.GetType( 100000 )
+        || 0 != strcmp( "Rifter", snapshot.GetString( rifter->name ) )
+        || 0 != strcmp( "", snapshot.GetString( kestrel->description ) )
+        || 1.1e6 != kestrel->mass || 26483 != rifter->wreckTypeID || 0 != kestrel->wreckTypeID )
+    {
+        ::printf( "Type mismatch.\n" );
+        return EXIT_FAILURE;
+    }
+
+    const StaticDataSnapshot::AttributeRecord* attributes = snapshot.GetAttributes( *rifter );
+    const uint32* effects = snapshot.GetEffects( *rifter );
+    if( 2 != rifter->attributeCount || 0 != kestrel->attributeCount
+        || 4 != attributes[ 0 ].attributeID || attributes[ 0 ].isInt || 1.0e6 != attributes[ 0 ].valueFloat
+        || 12 != attributes[ 1 ].attributeID || !attributes[ 1 ].isInt || 3 != attributes[ 1 ].valueInt
+        || 2 != rifter->effectCount || 11 != effects[ 0 ] || 12 != effects[ 1 ] )
+    {
+        ::printf( "Attribute or effect mismatch.\n" );
+        return EXIT_FAILURE;
+    }
+    snapshot.Close();
+
+    // point the type index past the types
+    const long typeIndexOffset = offsetof( StaticDataSnapshot::Header, sections )
+                               + StaticDataSnapshot::SECTION_TYPE_INDEX * sizeof( StaticDataSnapshot::SectionEntry );
+    FILE* file = fopen( SNAPSHOT_PATH, "rb" );
+    uint32 indexOffset = 0;
+    fseek( file, typeIndexOffset, SEEK_SET );
+    fread( &indexOffset, sizeof( indexOffset ), 1, file );
+    fclose( file );
+
+    if( !Corrupt( indexOffset + 587 * sizeof( uint32 ), 0x7F ) || snapshot.Open( SNAPSHOT_PATH, SNAPSHOT_STAMP ) )
+    {
+        ::printf( "Opened a corrupted snapshot.\n" );
+        return EXIT_FAILURE;
+    }
+
+    remove( SNAPSHOT_PATH );
+
+    ::printf( "Static data snapshot matched.\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    struct TestBall
+    {
+        Destiny::BallMode mode;
+        GPoint position;
+        GVector velocity;
+        GPoint target;
+        double desiredDistance;
+        double maxVelocity;
+        double accelerationFactor;
+        double massAgilityFriction;
+        double velocityAdjuster;
+    };
+
+    /* deterministic, so that failures are reproducible */
+    uint32 gSeed = 0x2545F491;
+
+    double Random( double min, double max )
+    {
+        gSeed = gSeed * 1103515245 + 12345;
+        return min + ( max - min ) * ( ( gSeed >> 8 ) / double( 1 << 24 ) );
+    }
+
+    GPoint RandomPoint( double range )
+    {
+        return GPoint( Random( -range, range ), Random( -range, range ), Random( -range, range ) );
+    }
+
+    TestBall MakeBall( Destiny::BallMode mode )
+    {
+        const double mass = Random( 1.0e6, 1.0e8 );
+        const double agility = Random( 0.3, 3.0 );
+
+        TestBall ball;
+        ball.mode = mode;
+        ball.position = RandomPoint( 1.0e5 );
+        ball.velocity = RandomPoint( 300.0 );
+        ball.target = RandomPoint( 1.0e5 );
+        ball.desiredDistance = Random( 500.0, 2.0e4 );
+        ball.maxVelocity = Random( 100.0, 1000.0 );
+        ball.accelerationFactor = SPACE_FRICTION * ball.maxVelocity / ( mass * agility );
+        ball.massAgilityFriction = mass * agility / SPACE_FRICTION;
+        ball.velocityAdjuster = exp( -( SPACE_FRICTION * TIC_DURATION_IN_SECONDS ) / ( mass * agility ) );
+
+        return ball;
+    }
+
+    /* mirrors DestinyManager::ProcessTic() */
+    void ScalarTic( TestBall& ball, double orbitTics )
+    {
+        GVector accel;
+        switch( ball.mode )
+        {
+        case Destiny::DSTBALL_STOP:
+            ball.velocity.y *= 0.93 / 1.07;
+            // fall through
+        case Destiny::DSTBALL_GOTO:
+            accel = Destiny::GotoAcceleration( ball.position, ball.target, ball.accelerationFactor );
+            break;
+        default:
+            GPoint targetPoint;
+            accel = Destiny::OrbitAcceleration( ball.position, ball.target, ball.desiredDistance, ball.maxVelocity,
+                                                ball.accelerationFactor, orbitTics, targetPoint );
+            break;
+        }
+
+        Destiny::MoveAccel( ball.position, ball.velocity, accel, ball.massAgilityFriction, ball.velocityAdjuster );
+    }
+
+    bool Matches( const GPoint& a, const GPoint& b )
+    {
+        static const double TOLERANCE = 1.0e-9;
+
+        const double scale = std::max( 1.0, a.length() );
+        return GVector( a, b ).length() <= TOLERANCE * scale;
+    }
+}
+
+int destiny_BallTableTest( int argc, char* argv[] )
+{
+    static const size_t BALL_COUNT = 301;
+    static const size_t TIC_COUNT = 100;
+
+    std::vector<TestBall> scalar;
+    for( size_t i = 0; i < BALL_COUNT; ++i )
+    {
+        static const Destiny::BallMode modes[] = { Destiny::DSTBALL_GOTO, Destiny::DSTBALL_STOP, Destiny::DSTBALL_ORBIT };
+        scalar.push_back( MakeBall( modes[ i % 3 ] ) );
+    }
+    // a ball sitting at its goal must not blow up
+    scalar[ 0 ].target = scalar[ 0 ].position;
+    scalar[ 0 ].velocity = GVector( 0, 0, 0 );
+
+    std::vector<TestBall> batched( scalar );
+    Destiny::BallTable table;
+
+    for( size_t tic = 0; tic < TIC_COUNT; ++tic )
+    {
+        const double orbitTics = double( tic );
+
+        table.Clear();
+        for( size_t i = 0; i < BALL_COUNT; ++i )
+        {
+            TestBall& ball = batched[ i ];
+
+            if( Destiny::DSTBALL_ORBIT == ball.mode )
+            {
+                table.AddOrbit( ball.position, ball.velocity, ball.target, ball.desiredDistance, ball.maxVelocity,
+                                orbitTics, ball.accelerationFactor, ball.massAgilityFriction, ball.velocityAdjuster );
+            }
+            else
+            {
+                if( Destiny::DSTBALL_STOP == ball.mode )
+                    ball.velocity.y *= 0.93 / 1.07;
+
+                table.AddGoto( ball.position, ball.velocity, ball.target,
+                               ball.accelerationFactor, ball.massAgilityFriction, ball.velocityAdjuster );
+            }
+        }
+        table.Integrate();
+
+        for( size_t i = 0; i < BALL_COUNT; ++i )
+        {
+            batched[ i ].position = table.GetPosition( i );
+            batched[ i ].velocity = table.GetVelocity( i );
+
+            ScalarTic( scalar[ i ], orbitTics );
+
+            if( !Matches( scalar[ i ].position, batched[ i ].position )
+                || !Matches( scalar[ i ].velocity, batched[ i ].velocity ) )
+            {
+                ::printf( "Ball %lu (mode %d) diverged at tic %lu:\n"
+                          "  scalar  pos (%.6f, %.6f, %.6f) vel (%.6f, %.6f, %.6f)\n"
+                          "  batched pos (%.6f, %.6f, %.6f) vel (%.6f, %.6f, %.6f)\n",
+                          i, scalar[ i ].mode, tic,
+                          scalar[ i ].position.x, scalar[ i ].position.y, scalar[ i ].position.z,
+                          scalar[ i ].velocity.x, scalar[ i ].velocity.y, scalar[ i ].velocity.z,
+                          batched[ i ].position.x, batched[ i ].position.y, batched[ i ].position.z,
+                          batched[ i ].velocity.x, batched[ i ].velocity.y, batched[ i ].velocity.z );
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    if( scalar[ 0 ].position.x != scalar[ 0 ].position.x )
+    {
+        ::printf( "Ball at its goal has NaN position.\n" );
+        return EXIT_FAILURE;
+    }
+
+    ::printf( "%lu balls matched the scalar path over %lu tics.\n", BALL_COUNT, TIC_COUNT );
+    return EXIT_SUCCESS;
+}
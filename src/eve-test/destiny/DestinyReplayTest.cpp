@@ -0,0 +1,187 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    Destiny::ScenarioBall MakeBall( uint32 id, const GPoint& position, const GVector& velocity )
+    {
+        Destiny::ScenarioBall ball;
+        ball.id = id;
+        ball.mass = 1.2e6;
+        ball.agility = 3.0;
+        ball.maxVelocity = 400.0;
+        ball.radius = 40.0;
+        ball.position = position;
+        ball.velocity = velocity;
+
+        return ball;
+    }
+
+    Destiny::ScenarioCommand MakeCommand( Destiny::ScenarioCommand::Type type, uint32 stamp, uint32 ballID,
+                                          uint32 targetID = 0, double value = 0 )
+    {
+        Destiny::ScenarioCommand cmd;
+        cmd.type = type;
+        cmd.stamp = stamp;
+        cmd.ballID = ballID;
+        cmd.targetID = targetID;
+        cmd.point = GPoint( 1.0e6, 0, 0 );
+        cmd.value = value;
+
+        return cmd;
+    }
+
+    bool Same( const GPoint& a, const GPoint& b )
+    {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    double Distance( const Destiny::Replay& replay, size_t a, size_t b )
+    {
+        return GVector( replay.GetPosition( a ), replay.GetPosition( b ) ).length();
+    }
+}
+
+int destiny_DestinyReplayTest( int argc, char* argv[] )
+{
+    static const uint32 TIC_COUNT = 300;
+    static const double ORBIT_DISTANCE = 5000.0;
+    static const double FOLLOW_DISTANCE = 1000.0;
+
+    Destiny::Scenario scenario;
+    scenario.SetTics( TIC_COUNT );
+
+    // 1 sits still, 2 goes to a point, 3 stops, 4 orbits 1, 5 follows 1
+    scenario.AddBall( MakeBall( 1, GPoint( 0, 0, 0 ), GVector( 0, 0, 0 ) ) );
+    scenario.AddBall( MakeBall( 2, GPoint( 0, 0, 0 ), GVector( 0, 0, 0 ) ) );
+    scenario.AddBall( MakeBall( 3, GPoint( 0, 1.0e4, 0 ), GVector( 0, 300.0, 200.0 ) ) );
+    scenario.AddBall( MakeBall( 4, GPoint( 2.0e4, 0, 0 ), GVector( 0, 0, 0 ) ) );
+    scenario.AddBall( MakeBall( 5, GPoint( 0, 0, 3.0e4 ), GVector( 0, 0, 0 ) ) );
+
+    if( scenario.AddBall( MakeBall( 5, GPoint( 0, 0, 0 ), GVector( 0, 0, 0 ) ) )
+        || scenario.AddCommand( MakeCommand( Destiny::ScenarioCommand::CMD_STOP, 0, 6 ) )
+        || scenario.AddCommand( MakeCommand( Destiny::ScenarioCommand::CMD_FOLLOW, 0, 5, 6, 0 ) ) )
+    {
+        ::printf( "Duplicate ball or command for unknown ball accepted.\n" );
+        return EXIT_FAILURE;
+    }
+
+    // added out of order on purpose
+    scenario.AddCommand( MakeCommand( Destiny::ScenarioCommand::CMD_FOLLOW, 10, 5, 1, FOLLOW_DISTANCE ) );
+    scenario.AddCommand( MakeCommand( Destiny::ScenarioCommand::CMD_GOTO, 0, 2 ) );
+    scenario.AddCommand( MakeCommand( Destiny::ScenarioCommand::CMD_SPEED, 0, 4, 0, 1.0 ) );
+    scenario.AddCommand( MakeCommand( Destiny::ScenarioCommand::CMD_ORBIT, 0, 4, 1, ORBIT_DISTANCE ) );
+
+    const std::vector<Destiny::ScenarioCommand>& commands = scenario.commands();
+    for( size_t i = 1; i < commands.size(); ++i )
+    {
+        if( commands[ i ].stamp < commands[ i - 1 ].stamp )
+        {
+            ::printf( "Commands are not ordered by stamp.\n" );
+            return EXIT_FAILURE;
+        }
+    }
+    if( Destiny::ScenarioCommand::CMD_SPEED != commands[ 1 ].type )
+    {
+        ::printf( "Commands of the same stamp were reordered.\n" );
+        return EXIT_FAILURE;
+    }
+
+    // ball 2 against the kernels, tic by tic
+    const Destiny::ScenarioBall& b2 = scenario.balls()[ 1 ];
+    const double accelerationFactor = SPACE_FRICTION * b2.maxVelocity / ( b2.mass * b2.agility );
+    const double massAgilityFriction = b2.mass * b2.agility / SPACE_FRICTION;
+    const double velocityAdjuster = exp( -( SPACE_FRICTION * TIC_DURATION_IN_SECONDS ) / ( b2.mass * b2.agility ) );
+    GPoint position( b2.position );
+    GVector velocity( b2.velocity );
+
+    Destiny::Replay replay( scenario );
+    while( !replay.IsDone() )
+    {
+        replay.Tic();
+
+        const GVector accel = Destiny::GotoAcceleration( position, commands[ 0 ].point, accelerationFactor );
+        Destiny::MoveAccel( position, velocity, accel, massAgilityFriction, velocityAdjuster );
+
+        if( GVector( position, replay.GetPosition( 1 ) ).length() > 1.0e-6 )
+        {
+            ::printf( "Goto ball diverged from the kernels at tic %u.\n", replay.GetStamp() );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if( TIC_COUNT != replay.GetStamp() )
+    {
+        ::printf( "Replayed %u tics instead of %u.\n", replay.GetStamp(), TIC_COUNT );
+        return EXIT_FAILURE;
+    }
+    if( !Same( replay.GetPosition( 0 ), scenario.balls()[ 0 ].position ) )
+    {
+        ::printf( "Idle ball moved.\n" );
+        return EXIT_FAILURE;
+    }
+    if( Destiny::DSTBALL_STOP != replay.GetMode( 2 ) || 1.0 < replay.GetVelocity( 2 ).length() )
+    {
+        ::printf( "Stopping ball still moves at %.3f m/s.\n", replay.GetVelocity( 2 ).length() );
+        return EXIT_FAILURE;
+    }
+
+    const double orbit = Distance( replay, 3, 0 ) - 2 * b2.radius;
+    if( Destiny::DSTBALL_ORBIT != replay.GetMode( 3 ) || fabs( orbit - ORBIT_DISTANCE ) > 0.1 * ORBIT_DISTANCE )
+    {
+        ::printf( "Orbiting ball is %.1f m away instead of %.1f m.\n", orbit, ORBIT_DISTANCE );
+        return EXIT_FAILURE;
+    }
+
+    const double follow = Distance( replay, 4, 0 ) - 2 * b2.radius;
+    if( Destiny::DSTBALL_FOLLOW != replay.GetMode( 4 ) || fabs( follow - FOLLOW_DISTANCE ) > 0.1 * FOLLOW_DISTANCE )
+    {
+        ::printf( "Following ball is %.1f m away instead of %.1f m.\n", follow, FOLLOW_DISTANCE );
+        return EXIT_FAILURE;
+    }
+
+    // rewinding must reproduce the run exactly
+    std::vector<GPoint> first;
+    for( size_t i = 0; i < replay.GetBallCount(); ++i )
+        first.push_back( replay.GetPosition( i ) );
+
+    replay.Rewind();
+    while( !replay.IsDone() )
+        replay.Tic();
+
+    for( size_t i = 0; i < replay.GetBallCount(); ++i )
+    {
+        if( !Same( first[ i ], replay.GetPosition( i ) ) )
+        {
+            ::printf( "Ball %u differs after rewind.\n", replay.GetBallID( i ) );
+            return EXIT_FAILURE;
+        }
+    }
+
+    ::printf( "%lu balls replayed for %u tics, %" PRIu64 " us total.\n",
+              replay.GetBallCount(), replay.GetStamp(), replay.GetTotalUSec() );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    std::vector<Destiny::SpatialGrid::Neighbor> BruteForce( const std::vector<GPoint>& points, const GPoint& center, double radius )
+    {
+        std::vector<Destiny::SpatialGrid::Neighbor> result;
+        for( size_t i = 0; i < points.size(); i++ )
+        {
+            const GVector d( center, points[ i ] );
+
+            Destiny::SpatialGrid::Neighbor n;
+            n.id = static_cast<uint32>( i );
+            n.distance2 = d.lengthSquared();
+            if( n.distance2 <= radius * radius )
+                result.push_back( n );
+        }
+
+        std::sort( result.begin(), result.end() );
+        return result;
+    }
+
+    bool SameIDs( std::vector<Destiny::SpatialGrid::Neighbor> a, std::vector<Destiny::SpatialGrid::Neighbor> b )
+    {
+        if( a.size() != b.size() )
+            return false;
+
+        std::vector<uint32> ia, ib;
+        for( size_t i = 0; i < a.size(); i++ )
+        {
+            ia.push_back( a[ i ].id );
+            ib.push_back( b[ i ].id );
+
+            // nearest first
+            if( 0 < i && a[ i ].distance2 < a[ i - 1 ].distance2 )
+                return false;
+        }
+
+        std::sort( ia.begin(), ia.end() );
+        std::sort( ib.begin(), ib.end() );
+        return ia == ib;
+    }
+}
+
+int destiny_SpatialGridTest( int argc, char* argv[] )
+{
+    const double CELL_SIZE = 250000.0;
+    const double SPREAD = 5000000.0;
+
+    Destiny::SpatialGrid grid( CELL_SIZE );
+    std::vector<GPoint> points;
+
+    srand( 1 );
+    for( uint32 i = 0; i < 2000; i++ )
+    {
+        GPoint p( ( rand() / (double)RAND_MAX - 0.5 ) * SPREAD,
+                  ( rand() / (double)RAND_MAX - 0.5 ) * SPREAD,
+                  ( rand() / (double)RAND_MAX - 0.5 ) * SPREAD );
+        points.push_back( p );
+    }
+
+    // a point whose cell key collides with the origin cell
+    points.push_back( GPoint( CELL_SIZE * 2097152.0 + 10.0, 10.0, 10.0 ) );
+
+    for( size_t i = 0; i < points.size(); i++ )
+        grid.Insert( static_cast<uint32>( i ), points[ i ] );
+    grid.Build();
+
+    if( points.size() != grid.size() )
+    {
+        ::printf( "Expected %lu points, got %lu.\n", (unsigned long)points.size(), (unsigned long)grid.size() );
+        return EXIT_FAILURE;
+    }
+
+    const double radii[] = { 0.0, 1000.0, 100000.0, 500000.0, 1200000.0, 10.0 * SPREAD };
+    for( size_t r = 0; r < sizeof( radii ) / sizeof( radii[ 0 ] ); r++ )
+    {
+        for( uint32 q = 0; q < 50; q++ )
+        {
+            // query at points too, so small radii find something
+            const GPoint center = ( 0 == q % 2 ) ? points[ q * 37 ]
+                                                 : GPoint( ( rand() / (double)RAND_MAX - 0.5 ) * SPREAD,
+                                                           ( rand() / (double)RAND_MAX - 0.5 ) * SPREAD,
+                                                           ( rand() / (double)RAND_MAX - 0.5 ) * SPREAD );
+
+            std::vector<Destiny::SpatialGrid::Neighbor> found;
+            grid.Query( center, radii[ r ], found );
+
+            if( !SameIDs( found, BruteForce( points, center, radii[ r ] ) ) )
+            {
+                ::printf( "Query %u with radius %.0f differs from brute force.\n", q, radii[ r ] );
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // results are appended
+    std::vector<Destiny::SpatialGrid::Neighbor> found( 3 );
+    if( 1 != grid.Query( points[ 0 ], 0.0, found ) || 4 != found.size() || 0 != found[ 3 ].id )
+    {
+        ::printf( "Query did not append its result.\n" );
+        return EXIT_FAILURE;
+    }
+
+    grid.Clear();
+    grid.Build();
+    found.clear();
+    if( 0 != grid.size() || 0 != grid.Query( GPoint( 0, 0, 0 ), SPREAD, found ) )
+    {
+        ::printf( "Cleared grid is not empty.\n" );
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
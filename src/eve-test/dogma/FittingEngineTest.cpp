@@ -0,0 +1,187 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    const uint32 SHIP = 1000, MODULE = 2000, DRONE = 3000, BOOSTER = 4000;
+    const uint32 VELOCITY = 37, BONUS = 10, SPEED = 11, SIGNATURE = 552, SIGNATURE_BONUS = 554;
+
+    double Value( const FittingEngine& engine, uint32 itemID, uint32 attributeID )
+    {
+        EvilNumber value;
+        if( !engine.GetValue( itemID, attributeID, value ) )
+            return -1.0;
+
+        return value.get_float();
+    }
+
+    bool Near( double a, double b )
+    {
+        return fabs( a - b ) <= 1e-9 * std::max( 1.0, fabs( b ) );
+    }
+}
+
+int dogma_FittingEngineTest( int argc, char* argv[] )
+{
+    /*
+     * Stacking: an unpenalized percentage and an addition apply
+     * before the penalty group, which is sorted by strength no
+     * matter the order the modifiers were added in.
+     */
+    FittingEngine stacking;
+    stacking.SetBaseValue( SHIP, SIGNATURE, EvilNumber( 100.0 ) );
+
+    const double bonuses[] = { 10.0, 30.0, -15.0, 20.0 };
+    for( uint32 i = 0; i < 4; ++i )
+    {
+        stacking.SetBaseValue( MODULE + i, SIGNATURE_BONUS, EvilNumber( bonuses[ i ] ) );
+        stacking.AddModifier( MODULE + i, MODULE + i, SIGNATURE_BONUS, SHIP, SIGNATURE, CALC_PERCENTAGE, true );
+    }
+    stacking.SetBaseValue( SHIP, SIGNATURE_BONUS, EvilNumber( 5.0 ) );
+    stacking.AddModifier( SHIP, SHIP, SIGNATURE_BONUS, SHIP, SIGNATURE, CALC_PERCENTAGE, false );
+    stacking.SetBaseValue( DRONE, SIGNATURE_BONUS, EvilNumber( 50.0 ) );
+    stacking.AddModifier( DRONE, DRONE, SIGNATURE_BONUS, SHIP, SIGNATURE, CALC_ADDITION, false );
+
+    std::vector<FittingEngine::Change> changes;
+    stacking.Recalculate( changes );
+
+    const double second = exp( -1.0 / 7.1289 ), third = exp( -4.0 / 7.1289 );
+    const double stacked = ( 100.0 + 50.0 ) * 1.05
+                         * ( 1.0 + 0.30 ) * ( 1.0 + 0.20 * second ) * ( 1.0 + 0.10 * third )
+                         * ( 1.0 - 0.15 );
+    if( 1 != changes.size() || !Near( stacked, Value( stacking, SHIP, SIGNATURE ) ) )
+    {
+        ::printf( "Stacking: expected %f, got %f.\n", stacked, Value( stacking, SHIP, SIGNATURE ) );
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Partial recalculation:
+     *   module bonus -> ship velocity -> drone speed
+     *   module signature bonus -> ship signature
+     */
+    FittingEngine engine;
+    engine.SetBaseValue( MODULE, BONUS, EvilNumber( 20.0 ) );
+    engine.SetBaseValue( MODULE, SIGNATURE_BONUS, EvilNumber( 5.0 ) );
+    engine.SetBaseValue( SHIP, VELOCITY, EvilNumber( 100.0 ) );
+    engine.SetBaseValue( SHIP, SIGNATURE, EvilNumber( 50.0 ) );
+    engine.SetBaseValue( DRONE, SPEED, EvilNumber( 0.0 ) );
+    engine.AddModifier( MODULE, MODULE, BONUS, SHIP, VELOCITY, CALC_PERCENTAGE, false );
+    engine.AddModifier( SHIP, SHIP, VELOCITY, DRONE, SPEED, CALC_ADDITION, false );
+    engine.AddModifier( MODULE, MODULE, SIGNATURE_BONUS, SHIP, SIGNATURE, CALC_ADDITION, false );
+
+    changes.clear();
+    engine.Recalculate( changes );
+    if( 3 != changes.size() || !Near( 120.0, Value( engine, DRONE, SPEED ) ) || !Near( 55.0, Value( engine, SHIP, SIGNATURE ) ) )
+    {
+        ::printf( "Initial calculation: %lu changes, drone speed %f.\n", (unsigned long)changes.size(), Value( engine, DRONE, SPEED ) );
+        return EXIT_FAILURE;
+    }
+
+    engine.SetBaseValue( MODULE, BONUS, EvilNumber( 50.0 ) );
+    changes.clear();
+    engine.Recalculate( changes );
+    // the module attribute itself, then ship velocity before drone speed; signature untouched
+    if( 3 != changes.size()
+        || MODULE != changes[ 0 ].itemID
+        || SHIP != changes[ 1 ].itemID || VELOCITY != changes[ 1 ].attributeID
+        || DRONE != changes[ 2 ].itemID || !Near( 150.0, changes[ 2 ].value.get_float() ) )
+    {
+        ::printf( "Partial recalculation reported %lu changes out of order.\n", (unsigned long)changes.size() );
+        return EXIT_FAILURE;
+    }
+
+    changes.clear();
+    engine.SetBaseValue( MODULE, BONUS, EvilNumber( 50.0 ) );
+    engine.Recalculate( changes );
+    if( !changes.empty() )
+    {
+        ::printf( "Unchanged base value caused %lu changes.\n", (unsigned long)changes.size() );
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Add/remove symmetry.
+     */
+    const size_t attributes = engine.GetAttributeCount(), modifiers = engine.GetModifierCount();
+
+    engine.SetBaseValue( BOOSTER, BONUS, EvilNumber( 25.0 ) );
+    engine.AddModifier( BOOSTER, BOOSTER, BONUS, SHIP, VELOCITY, CALC_PERCENTAGE, true );
+    changes.clear();
+    engine.Recalculate( changes );
+    if( !Near( 150.0 * 1.25, Value( engine, DRONE, SPEED ) ) )
+    {
+        ::printf( "Booster not applied: drone speed %f.\n", Value( engine, DRONE, SPEED ) );
+        return EXIT_FAILURE;
+    }
+
+    engine.RemoveModifiers( BOOSTER );
+    engine.RemoveItem( BOOSTER );
+    changes.clear();
+    engine.Recalculate( changes );
+    if( attributes != engine.GetAttributeCount() || modifiers != engine.GetModifierCount()
+        || !Near( 150.0, Value( engine, SHIP, VELOCITY ) ) || !Near( 150.0, Value( engine, DRONE, SPEED ) ) )
+    {
+        ::printf( "Removing booster did not restore the graph.\n" );
+        return EXIT_FAILURE;
+    }
+
+    // removing the module drops its modifiers and its attributes
+    engine.RemoveItem( MODULE );
+    changes.clear();
+    engine.Recalculate( changes );
+    if( engine.HasAttribute( MODULE, BONUS ) || 1 != engine.GetModifierCount()
+        || !Near( 100.0, Value( engine, DRONE, SPEED ) ) || !Near( 50.0, Value( engine, SHIP, SIGNATURE ) ) )
+    {
+        ::printf( "Removing module: %lu modifiers left, drone speed %f.\n",
+                  (unsigned long)engine.GetModifierCount(), Value( engine, DRONE, SPEED ) );
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * A cycle is cut instead of recursing forever.
+     */
+    engine.AddModifier( DRONE, DRONE, SPEED, SHIP, VELOCITY, CALC_ADDITION, false );
+    changes.clear();
+    engine.Recalculate( changes );
+    if( changes.empty() || 2 != engine.GetModifierCount() )
+    {
+        ::printf( "Cycle not recalculated.\n" );
+        return EXIT_FAILURE;
+    }
+
+    engine.RemoveModifiers( DRONE );
+    changes.clear();
+    engine.Recalculate( changes );
+    if( !Near( 100.0, Value( engine, SHIP, VELOCITY ) ) || !Near( 100.0, Value( engine, DRONE, SPEED ) ) )
+    {
+        ::printf( "Removing the cycle did not restore values.\n" );
+        return EXIT_FAILURE;
+    }
+
+    ::printf( "Fitting engine calculations matched.\n" );
+    return EXIT_SUCCESS;
+}
@@ -38,12 +38,35 @@
 
 // auth
 #include "auth/PasswordModule.h"
+// cache
+#include "cache/StaticDataSnapshot.h"
+// destiny
+#include "destiny/BallTable.h"
+#include "destiny/DestinyReplay.h"
+#include "destiny/SpatialGrid.h"
+// dogma
+#include "dogma/FittingEngine.h"
+// log
+#include "log/AsyncLog.h"
+// map
+#include "map/UniverseGraph.h"
 // marshal
 #include "marshal/EVEMarshal.h"
 #include "marshal/EVEUnmarshal.h"
+// packets
+#include "packets/Destiny.h"
+#include "packets/DogmaIM.h"
+#include "packets/General.h"
+#include "packets/Manufacturing.h"
+#include "packets/Market.h"
+// python
+#include "python/PyPacket.h"
 // python/classes
 #include "python/classes/PyDatabase.h"
+// threading
+#include "threading/WorkerPool.h"
 // utils
 #include "utils/EvilNumber.h"
+#include "utils/TickProfiler.h"
 
 #endif /* !__EVE_TEST_H__INCL__ */
@@ -0,0 +1,111 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    /* captures the arguments and formats them back, as the writer thread does */
+    bool Replay( char* out, size_t size, const char* fmt, ... )
+    {
+        uint8 args[ 0x800 ];
+        size_t len;
+
+        va_list ap;
+        va_start( ap, fmt );
+        const bool captured = AsyncLog::CaptureArgs( fmt, ap, args, sizeof( args ), len );
+        va_end( ap );
+
+        if( captured )
+            AsyncLog::FormatArgs( fmt, args, len, out, size );
+        return captured;
+    }
+
+    bool Expect( const char* fmt, const char* expected, const char* replayed )
+    {
+        if( 0 == strcmp( expected, replayed ) )
+            return true;
+
+        ::printf( "Format '%s' mismatch:\n  expected '%s'\n  replayed '%s'\n", fmt, expected, replayed );
+        return false;
+    }
+}
+
+#define CHECK_REPLAY( fmt, ... )                                                    \
+    do                                                                              \
+    {                                                                               \
+        char expected[ 0x400 ], replayed[ 0x400 ];                                  \
+        snprintf( expected, sizeof( expected ), fmt, __VA_ARGS__ );                 \
+        if( !Replay( replayed, sizeof( replayed ), fmt, __VA_ARGS__ ) )             \
+        {                                                                           \
+            ::printf( "Format '%s' was not captured.\n", fmt );                     \
+            return EXIT_FAILURE;                                                    \
+        }                                                                           \
+        if( !Expect( fmt, expected, replayed ) )                                    \
+            return EXIT_FAILURE;                                                    \
+        ++checked;                                                                  \
+    } while( 0 )
+
+int log_AsyncLogTest( int argc, char* argv[] )
+{
+    size_t checked = 0;
+
+    std::string temporary( "gone by the time it is written" );
+    const char unterminated[ 4 ] = { 'a', 'b', 'c', 'd' };
+
+    CHECK_REPLAY( "%s: %d items, %u left (%x)", "Client", -12, 7u, 0xBEEFu );
+    CHECK_REPLAY( "%s", temporary.c_str() );
+    CHECK_REPLAY( "%.3s|%.*s|%-8s|", unterminated, 2, unterminated, "pad" );
+    CHECK_REPLAY( "%5.2f %e %g %Lf", 3.14159, 1.0e-9, 2.5, (long double)1.25 );
+    CHECK_REPLAY( "%*d|%-*.*f|%%|%c", 6, 42, 10, 3, 0.5, 'x' );
+    CHECK_REPLAY( "%hd %hhu %ld %lu %lld %llu", (short)-3, (unsigned char)200, -100000L, 100000UL, -5000000000LL, 5000000000ULL );
+    CHECK_REPLAY( "%zu %jd %td", (size_t)123, (intmax_t)-9, (ptrdiff_t)77 );
+    CHECK_REPLAY( "%" PRIu64 " %" PRId64 " %p", (uint64)18000000000000000000ULL, (int64)-1, (void*)&checked );
+    CHECK_REPLAY( "%s ends with a spec %d", "text", 1 );
+
+    // truncation of the output
+    {
+        char out[ 8 ];
+
+        const char* fmt = "%s and more";
+        if( !Replay( out, sizeof( out ), fmt, "longer than eight" )
+            || !Expect( fmt, "longer ", out ) )
+            return EXIT_FAILURE;
+        ++checked;
+    }
+
+    // conversions which must be formatted by the caller
+    {
+        char out[ 0x40 ];
+        if( Replay( out, sizeof( out ), "%ls", L"wide" ) )
+        {
+            ::printf( "Wide string conversion was captured.\n" );
+            return EXIT_FAILURE;
+        }
+        ++checked;
+    }
+
+    ::printf( "%lu formats replayed identically.\n", checked );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    void AddGate( UniverseGraph& graph, uint32 a, uint32 b )
+    {
+        graph.AddJump( a, b );
+        graph.AddJump( b, a );
+    }
+
+    bool RouteIs( const std::vector<uint32>& route, const uint32* expected, size_t count )
+    {
+        return route.size() == count && std::equal( route.begin(), route.end(), expected );
+    }
+}
+
+int map_UniverseGraphTest( int argc, char* argv[] )
+{
+    /*
+     * 1 - 2 - 3 - 4 -> 6
+     *  \         /
+     *   --- 5 ---
+     *
+     * 5 is low security, 6 can't be left.
+     */
+    UniverseGraph graph( 2 );
+    graph.AddSystem( 1, 100, 1000, 1.0 );
+    graph.AddSystem( 2, 100, 1000, 0.9 );
+    graph.AddSystem( 3, 100, 1000, 0.8 );
+    graph.AddSystem( 4, 101, 1000, 0.7 );
+    graph.AddSystem( 5, 102, 1001, 0.1 );
+    graph.AddSystem( 6, 101, 1000, 0.5 );
+    AddGate( graph, 1, 2 );
+    AddGate( graph, 2, 3 );
+    AddGate( graph, 3, 4 );
+    AddGate( graph, 1, 5 );
+    AddGate( graph, 5, 4 );
+    graph.AddJump( 4, 6 );
+    graph.AddJump( 4, 6 );  // duplicate
+    graph.AddJump( 4, 7 );  // unknown system
+    graph.AddStargate( 50000001, 50000002, 2 );
+    graph.AddStargate( 50000002, 50000001, 1 );
+
+    if( 11 != graph.Build() )
+    {
+        ::printf( "Expected 11 jumps, got %lu.\n", (unsigned long)graph.GetJumpCount() );
+        return EXIT_FAILURE;
+    }
+
+    if( 101 != graph.GetConstellationID( 4 ) || 1001 != graph.GetRegionID( 5 )
+        || 0 != graph.GetRegionID( 7 ) || graph.HasSystem( 7 ) )
+    {
+        ::printf( "Membership lookup failed.\n" );
+        return EXIT_FAILURE;
+    }
+
+    uint32 toStargateID = 0, toSystemID = 0;
+    if( 2 != graph.GetStargateCount() || !graph.GetStargateJump( 50000002, toStargateID, toSystemID )
+        || 50000001 != toStargateID || 1 != toSystemID || graph.GetStargateJump( 50000003, toStargateID, toSystemID ) )
+    {
+        ::printf( "Stargate lookup failed.\n" );
+        return EXIT_FAILURE;
+    }
+
+    if( 2 != graph.GetJumps( 1, 4 ) || 3 != graph.GetJumps( 1, 6 ) || 0 != graph.GetJumps( 3, 3 )
+        || UniverseGraph::NO_ROUTE != graph.GetJumps( 6, 1 ) || UniverseGraph::NO_ROUTE != graph.GetJumps( 1, 7 ) )
+    {
+        ::printf( "Jump distance mismatch.\n" );
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint32> route;
+    const uint32 shortest[] = { 1, 5, 4, 6 };
+    if( !graph.GetRoute( 1, 6, UniverseGraph::ROUTE_SHORTEST, route ) || !RouteIs( route, shortest, 4 ) )
+    {
+        ::printf( "Shortest route mismatch.\n" );
+        return EXIT_FAILURE;
+    }
+
+    route.clear();
+    const uint32 safest[] = { 1, 2, 3, 4, 6 };
+    if( !graph.GetRoute( 1, 6, UniverseGraph::ROUTE_SAFEST, route ) || !RouteIs( route, safest, 5 ) )
+    {
+        ::printf( "Safest route mismatch.\n" );
+        return EXIT_FAILURE;
+    }
+
+    route.clear();
+    if( graph.GetRoute( 6, 1, UniverseGraph::ROUTE_SHORTEST, route )
+        || graph.GetRoute( 6, 1, UniverseGraph::ROUTE_SAFEST, route ) || !route.empty() )
+    {
+        ::printf( "Found a route out of a dead end.\n" );
+        return EXIT_FAILURE;
+    }
+
+    // a station range buy order in 60000001 is not filled from another station of the same system
+    if( graph.IsInOrderRange( UniverseGraph::ORDER_RANGE_STATION, 60000001, 1, 60000002, 1 )
+        || !graph.IsInOrderRange( UniverseGraph::ORDER_RANGE_STATION, 60000001, 1, 60000001, 1 )
+        || !graph.IsInOrderRange( UniverseGraph::ORDER_RANGE_SYSTEM, 60000001, 1, 60000002, 1 )
+        || graph.IsInOrderRange( UniverseGraph::ORDER_RANGE_SYSTEM, 60000001, 1, 60000003, 2 )
+        || !graph.IsInOrderRange( 1, 60000001, 1, 60000003, 2 ) || graph.IsInOrderRange( 1, 60000001, 1, 60000004, 3 )
+        || !graph.IsInOrderRange( UniverseGraph::ORDER_RANGE_REGION, 60000001, 1, 60000004, 3 ) )
+    {
+        ::printf( "Order range mismatch.\n" );
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint32> nearby;
+    graph.GetSystemsWithinJumps( 1, 1, nearby );
+    std::sort( nearby.begin(), nearby.end() );
+    const uint32 within[] = { 1, 2, 5 };
+    if( !RouteIs( nearby, within, 3 ) || !graph.IsWithinJumps( 2, 5, 2 ) || graph.IsWithinJumps( 2, 6, 2 ) )
+    {
+        ::printf( "Within-jumps query mismatch.\n" );
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * A grid, where the distance is known, queried from more
+     * sources than the cache holds.
+     */
+    static const uint32 SIDE = 20;
+
+    UniverseGraph grid( 4 );
+    for( uint32 y = 0; y < SIDE; ++y )
+        for( uint32 x = 0; x < SIDE; ++x )
+            grid.AddSystem( 30000000 + y * SIDE + x, 0, 0, 1.0 );
+    for( uint32 y = 0; y < SIDE; ++y )
+        for( uint32 x = 0; x < SIDE; ++x )
+        {
+            const uint32 id = 30000000 + y * SIDE + x;
+            if( x + 1 < SIDE )
+                AddGate( grid, id, id + 1 );
+            if( y + 1 < SIDE )
+                AddGate( grid, id, id + SIDE );
+        }
+    grid.Build();
+
+    for( uint32 pass = 0; pass < 2; ++pass )
+        for( uint32 from = 0; from < SIDE * SIDE; from += 7 )
+            for( uint32 to = 0; to < SIDE * SIDE; to += 13 )
+            {
+                const int32 expected = abs( (int32)( from % SIDE ) - (int32)( to % SIDE ) )
+                                     + abs( (int32)( from / SIDE ) - (int32)( to / SIDE ) );
+                const int32 jumps = grid.GetJumps( 30000000 + from, 30000000 + to );
+                if( expected != jumps )
+                {
+                    ::printf( "Grid distance %u -> %u: expected %d, got %d.\n", from, to, expected, jumps );
+                    return EXIT_FAILURE;
+                }
+
+                route.clear();
+                grid.GetRoute( 30000000 + from, 30000000 + to, UniverseGraph::ROUTE_SHORTEST, route );
+                if( route.size() != (size_t)expected + 1 )
+                {
+                    ::printf( "Grid route %u -> %u has %lu systems.\n", from, to, (unsigned long)route.size() );
+                    return EXIT_FAILURE;
+                }
+            }
+
+    ::printf( "Universe graph queries matched.\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,357 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    bool Equal( const Buffer& a, const Buffer& b )
+    {
+        if( a.size() != b.size() )
+            return false;
+
+        for( size_t i = 0; i < a.size(); ++i )
+            if( a[ i ] != b[ i ] )
+                return false;
+
+        return true;
+    }
+
+    /* Re-encodes the packet, so the decoded packets can be compared. */
+    template< typename T >
+    bool Reencode( const T& packet, Buffer& into )
+    {
+        PyRep* rep = packet.Encode();
+        const bool res = Marshal( rep, into );
+        PyDecRef( rep );
+
+        return res;
+    }
+
+    /* Decodes the marshaled rep both from the tree and the stream and compares the results. */
+    template< typename T >
+    bool Compare( const char* name, PyRep* rep )
+    {
+        Buffer data;
+        const bool marshaled = Marshal( rep, data );
+        PyDecRef( rep );
+
+        if( !marshaled )
+        {
+            ::printf( "%s: failed to marshal.\n", name );
+            return false;
+        }
+
+        T tree;
+        PyRep* loaded = Unmarshal( data );
+        if( NULL == loaded || !tree.Decode( &loaded ) )
+        {
+            ::printf( "%s: failed to decode the tree.\n", name );
+            return false;
+        }
+
+        T direct;
+        UnmarshalStream v;
+        if( !v.BeginStream( data ) || !direct.DecodeFrom( v ) )
+        {
+            ::printf( "%s: failed to decode the stream.\n", name );
+            return false;
+        }
+        v.EndStream();
+
+        Buffer treeData, directData;
+        if( !Reencode( tree, treeData ) || !Reencode( direct, directData ) )
+        {
+            ::printf( "%s: failed to re-encode.\n", name );
+            return false;
+        }
+
+        if( !Equal( treeData, directData ) )
+        {
+            ::printf( "%s: decoded packets differ.\n", name );
+            return false;
+        }
+
+        return true;
+    }
+
+    PyTuple* MakePlaceCharOrder( PyRep* price, PyRep* bid, PyRep* itemID )
+    {
+        PyTuple* t = new PyTuple( 11 );
+        t->SetItem( 0, new PyInt( 60003760 ) );
+        t->SetItem( 1, new PyInt( 34 ) );
+        t->SetItem( 2, price );
+        t->SetItem( 3, new PyInt( 40000 ) );
+        t->SetItem( 4, bid );
+        t->SetItem( 5, new PyInt( -1 ) );
+        t->SetItem( 6, itemID );
+        t->SetItem( 7, new PyInt( 1 ) );
+        t->SetItem( 8, new PyInt( 0 ) );
+        t->SetItem( 9, new PyBool( false ) );
+        t->SetItem( 10, new PyBool( true ) );
+
+        return t;
+    }
+
+    PyList* MakeLocation( int32 locationID, int32 groupID )
+    {
+        PyList* l = new PyList;
+        l->AddItemInt( locationID );
+        l->AddItemInt( groupID );
+
+        return l;
+    }
+
+    PyTuple* MakeInstallJob()
+    {
+        PyList* path = new PyList;
+        path->AddItem( MakeLocation( 60003760, 15 ) );
+
+        PyList* installation = new PyList;
+        installation->AddItem( MakeLocation( 60003760, 15 ) );
+        installation->AddItem( new PyList );
+        installation->AddItem( MakeLocation( 60003760, 100005 ) );
+
+        PyList* itemSpec = new PyList;
+        itemSpec->AddItemInt( 140000123 );
+
+        PyList* installed = new PyList;
+        installed->AddItem( MakeLocation( 60003760, 15 ) );
+        installed->AddItem( path );
+        installed->AddItem( itemSpec );
+
+        PyList* bom = new PyList;
+        bom->AddItem( MakeLocation( 60003760, 15 ) );
+        bom->AddItem( path->Clone() );
+        bom->AddItem( new PyList );
+
+        PyTuple* t = new PyTuple( 9 );
+        t->SetItem( 0, installation );
+        t->SetItem( 1, installed );
+        t->SetItem( 2, bom );
+        t->SetItem( 3, new PyInt( 4 ) );
+        t->SetItem( 4, new PyInt( 10 ) );
+        t->SetItem( 5, new PyInt( 1 ) );
+        t->SetItem( 6, new PyInt( 0 ) );
+        t->SetItem( 7, new PyBool( false ) );
+        t->SetItem( 8, new PyString( "" ) );
+
+        return t;
+    }
+
+    PyTuple* MakeOne( PyRep* arg )
+    {
+        PyTuple* t = new PyTuple( 1 );
+        t->SetItem( 0, arg );
+
+        return t;
+    }
+
+    /* Marshal stream holding a one-tuple; the integer or the tuple is saved. */
+    void MakeSavedStream( bool saveTuple, int32 value, Buffer& into )
+    {
+        into.Append<uint8>( 0x7E );
+        into.Append<uint32>( 1 );
+        into.Append<uint8>( 0x25 | ( saveTuple ? 0x40 : 0 ) );
+        into.Append<uint8>( 0x04 | ( saveTuple ? 0 : 0x40 ) );
+        into.Append<int32>( value );
+        into.Append<uint32>( 1 );
+    }
+
+    /* Call request payload as received, with the call substream marshaled. */
+    PyTuple* MakeCallPayload( PyTuple* args )
+    {
+        PyCallStream call;
+        call.remoteObjectStr = "N=700000:12";
+        call.method = "CmdOrbit";
+        call.arg_tuple = args;
+        call.arg_dict = new PyDict;
+        call.arg_dict->SetItemString( "machoVersion", new PyInt( 1 ) );
+
+        PyTuple* encoded = call.Encode();
+        PyTuple* payload = new PyTuple( 1 );
+        payload->SetItem( 0, encoded->GetItem( 0 ) );
+        PyIncRef( encoded->GetItem( 0 ) );
+        PyDecRef( encoded );
+
+        Buffer data;
+        const bool marshaled = Marshal( payload, data );
+        PyDecRef( payload );
+        if( !marshaled )
+            return NULL;
+
+        PyRep* loaded = Unmarshal( data );
+        if( NULL == loaded || !loaded->IsTuple() )
+        {
+            PySafeDecRef( loaded );
+            return NULL;
+        }
+
+        return loaded->AsTuple();
+    }
+
+    /* Decodes the call header directly, then its arguments both ways. */
+    bool CompareCall()
+    {
+        PyTuple* orbit = new PyTuple( 2 );
+        orbit->SetItem( 0, new PyInt( 140000123 ) );
+        orbit->SetItem( 1, new PyFloat( 2500.5 ) );
+
+        PyTuple* payload = MakeCallPayload( orbit );
+        if( NULL == payload )
+        {
+            ::puts( "Call stream: failed to build the payload." );
+            return false;
+        }
+
+        PyCallStream call;
+        if( !call.Decode( "macho.CallReq", payload ) )
+        {
+            ::puts( "Call stream: failed to decode." );
+            return false;
+        }
+
+        if( NULL != call.arg_tuple || NULL == call.call_stream
+            || "N=700000:12" != call.remoteObjectStr || "CmdOrbit" != call.method )
+        {
+            ::puts( "Call stream: header not decoded directly." );
+            return false;
+        }
+
+        /* arguments, skipping remote object and method like PyCallArgs does */
+        Call_Orbit direct;
+        UnmarshalStream v;
+        uint32 count;
+        if( !v.BeginStream( call.call_stream->data()->content() )
+            || !v.PullTupleHeader( count ) || 4 != count
+            || NULL == v.PullRep() || NULL == v.PullRep()
+            || !direct.DecodeFrom( v ) )
+        {
+            ::puts( "Call stream: failed to decode the arguments directly." );
+            return false;
+        }
+        PyRep* named = v.PullRep();
+        const bool namedOk = ( NULL != named && named->IsDict() && 1 == named->AsDict()->size() );
+        v.EndStream();
+
+        if( !namedOk )
+        {
+            ::puts( "Call stream: named arguments don't follow the arguments." );
+            return false;
+        }
+
+        Call_Orbit tree;
+        if( !call.DecodeArgs() || NULL == call.arg_dict || !tree.Decode( call.arg_tuple ) )
+        {
+            ::puts( "Call stream: failed to decode the arguments tree." );
+            return false;
+        }
+
+        if( tree.entityID != direct.entityID )
+        {
+            ::puts( "Call stream: decoded arguments differ." );
+            return false;
+        }
+
+        return true;
+    }
+
+    const int32 sInts[] = { 0, 1, -1, 127, 128, -128, -129, 32767, 40000, -40000, 0x7FFFFFFF };
+    const size_t sIntCount = sizeof( sInts ) / sizeof( *sInts );
+}
+
+int marshal_DirectDecodeTest( int argc, char* argv[] )
+{
+    bool ok = true;
+
+    for( size_t i = 0; i < sIntCount; ++i )
+    {
+        ok &= Compare< Call_SingleIntegerArg >( "Call_SingleIntegerArg", MakeOne( new PyInt( sInts[ i ] ) ) );
+
+        PyTuple* two = new PyTuple( 2 );
+        two->SetItem( 0, new PyInt( sInts[ i ] ) );
+        two->SetItem( 1, new PyInt( -sInts[ i ] ) );
+        ok &= Compare< Call_TwoIntegerArgs >( "Call_TwoIntegerArgs", two );
+
+        PyTuple* orbit = new PyTuple( 2 );
+        orbit->SetItem( 0, new PyInt( sInts[ i ] ) );
+        orbit->SetItem( 1, ( 0 == i % 2 ? (PyRep*)new PyInt( 2500 ) : (PyRep*)new PyFloat( 2500.5 ) ) );
+        ok &= Compare< Call_Orbit >( "Call_Orbit", orbit );
+    }
+
+    PyTuple* point = new PyTuple( 3 );
+    point->SetItem( 0, new PyFloat( 0.0 ) );
+    point->SetItem( 1, new PyFloat( -1.5e12 ) );
+    point->SetItem( 2, new PyFloat( 3.25 ) );
+    ok &= Compare< Call_PointArg >( "Call_PointArg", point );
+
+    /* soft bools as ints, none markers */
+    ok &= Compare< Call_PlaceCharOrder >( "Call_PlaceCharOrder",
+        MakePlaceCharOrder( new PyFloat( 5.5 ), new PyInt( 1 ), new PyNone ) );
+    ok &= Compare< Call_PlaceCharOrder >( "Call_PlaceCharOrder",
+        MakePlaceCharOrder( new PyFloat( 0.0 ), new PyBool( false ), new PyInt( 140000123 ) ) );
+
+    /* soft wide strings may be plain */
+    ok &= Compare< Call_SingleWStringSoftArg >( "Call_SingleWStringSoftArg", MakeOne( new PyWString( std::string( "Caldari Navy" ) ) ) );
+    ok &= Compare< Call_SingleWStringSoftArg >( "Call_SingleWStringSoftArg", MakeOne( new PyString( "Caldari Navy" ) ) );
+    ok &= Compare< Call_SingleWStringSoftArg >( "Call_SingleWStringSoftArg", MakeOne( new PyString( "" ) ) );
+
+    PyList* ints = new PyList;
+    ok &= Compare< Call_SingleIntList >( "Call_SingleIntList", MakeOne( ints->Clone() ) );
+    for( size_t i = 0; i < sIntCount; ++i )
+        ints->AddItemInt( sInts[ i ] );
+    ok &= Compare< Call_SingleIntList >( "Call_SingleIntList", MakeOne( ints ) );
+
+    /* nested lists and untyped members */
+    ok &= Compare< Call_InstallJob >( "Call_InstallJob", MakeInstallJob() );
+
+    /* saved scalars are pulled through the tree loader */
+    Buffer savedInt;
+    MakeSavedStream( false, 42, savedInt );
+
+    Call_SingleIntegerArg arg;
+    UnmarshalStream v;
+    if( !v.BeginStream( savedInt ) || !arg.DecodeFrom( v ) || 42 != arg.arg )
+    {
+        ::puts( "Saved integer: failed to decode the stream." );
+        ok = false;
+    }
+    v.EndStream();
+
+    /* saved containers fall back to the tree */
+    Buffer savedTuple;
+    MakeSavedStream( true, 7, savedTuple );
+
+    if( !UnmarshalDirect( savedTuple, arg ) || 7 != arg.arg )
+    {
+        ::puts( "Saved tuple: failed to decode." );
+        ok = false;
+    }
+
+    ok &= CompareCall();
+
+    ::puts( ok ? "Direct decoding matches the tree decoding." : "Direct decoding mismatch." );
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,201 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    /* Marshals the packet both through its PyRep tree and directly and compares the bytes. */
+    template< typename T >
+    bool Compare( const char* name, const T& packet )
+    {
+        Buffer tree, direct;
+
+        PyRep* rep = packet.Encode();
+        bool res = Marshal( rep, tree );
+        PyDecRef( rep );
+
+        if( !res )
+        {
+            ::printf( "%s: failed to marshal the tree.\n", name );
+            return false;
+        }
+
+        if( !MarshalDirect( packet, direct ) )
+        {
+            ::printf( "%s: failed to marshal directly.\n", name );
+            return false;
+        }
+
+        if( tree.size() != direct.size() )
+        {
+            ::printf( "%s: size mismatch, tree %lu bytes, direct %lu bytes.\n",
+                      name, (unsigned long)tree.size(), (unsigned long)direct.size() );
+            return false;
+        }
+
+        for( size_t i = 0; i < tree.size(); ++i )
+        {
+            if( tree[ i ] != direct[ i ] )
+            {
+                ::printf( "%s: byte %lu differs, tree 0x%02X, direct 0x%02X.\n",
+                          name, (unsigned long)i, tree[ i ], direct[ i ] );
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* Marshals a whole notification with its arguments as tree and as direct substream and compares the bytes. */
+    template< typename T >
+    bool CompareNotification( const char* name, const T& args )
+    {
+        EVENotificationStream notify;
+        notify.args = args.Encode();
+
+        Buffer tree, direct;
+
+        PyTuple* rep = notify.Encode();
+        bool res = Marshal( rep, tree );
+        PyDecRef( rep );
+
+        rep = EVENotificationStream::Encode( EVENotificationStream::EncodeArgs( args ) );
+        res &= Marshal( rep, direct );
+        PyDecRef( rep );
+
+        if( !res || tree.size() != direct.size() || 0 != memcmp( &tree[ 0 ], &direct[ 0 ], tree.size() ) )
+        {
+            ::printf( "%s: notification differs, tree %lu bytes, direct %lu bytes.\n",
+                      name, (unsigned long)tree.size(), (unsigned long)direct.size() );
+            return false;
+        }
+
+        return true;
+    }
+
+    const int32 sInts[] = { 0, 1, -1, 127, 128, -128, -129, 32767, 40000, -40000, 0x7FFFFFFF };
+    const size_t sIntCount = sizeof( sInts ) / sizeof( *sInts );
+
+    const int64 sLongs[] = { 0, 1, -1, 40000, 0x7FFFFFFFLL, 0x80000000LL, 129041261000000000LL, -129041261000000000LL };
+    const size_t sLongCount = sizeof( sLongs ) / sizeof( *sLongs );
+
+    /* empty, single char, string table entry, plain and a long one */
+    const char* const sStrings[] = { "", "a", "effects.Laser", "justSomeString",
+                                     "a string well past the short string encodings, to force the long form "
+                                     "which carries its length as a variable sized integer" };
+    const size_t sStringCount = sizeof( sStrings ) / sizeof( *sStrings );
+}
+
+int marshal_DirectEncodeTest( int argc, char* argv[] )
+{
+    bool ok = true;
+
+    for( size_t i = 0; i < sIntCount; ++i )
+    {
+        const int32 v = sInts[ i ];
+
+        DoDestiny_GotoPoint gp;
+        gp.entityID = v;
+        gp.x = v * 1.5;
+        gp.y = -v;
+        gp.z = 0.0;
+        ok &= Compare( "DoDestiny_GotoPoint", gp );
+
+        DoDestinyAction da;
+        da.update_id = v;
+        da.update = gp.Encode();
+        ok &= Compare( "DoDestinyAction", da );
+
+        /* none_marker fields switch between None and the value */
+        DoDestiny_OnSpecialFX13 fx;
+        fx.entityID = v;
+        fx.moduleID = v;
+        fx.moduleTypeID = ( 0 == i % 2 ? 0 : v );
+        fx.targetID = -v;
+        fx.otherTypeID = v;
+        for( size_t j = 0; j < i; ++j )
+            fx.area.push_back( sInts[ j ] );
+        fx.effect_type = sStrings[ i % sStringCount ];
+        fx.isOffensive = ( v & 1 );
+        fx.start = 1;
+        fx.active = 0;
+        fx.duration_ms = ( 0 == i % 3 ? 0.0 : v / 3.0 );
+        fx.repeat = v;
+        fx.startTime = sLongs[ i % sLongCount ];
+        ok &= Compare( "DoDestiny_OnSpecialFX13", fx );
+
+        Notify_OnTarget ot;
+        ot.mode = sStrings[ ( i + 1 ) % sStringCount ];
+        ot.targetID = v;
+        ot.reason = sStrings[ i % sStringCount ];
+        ok &= Compare( "Notify_OnTarget", ot );
+    }
+
+    for( size_t i = 0; i < sLongCount; ++i )
+    {
+        Notify_OnModuleAttributeChange mac;
+        mac.ownerID = sInts[ i % sIntCount ];
+        mac.itemKey = 140000000 + i;
+        mac.attributeID = 9;
+        mac.time = sLongs[ i ];
+        mac.newValue = new PyFloat( 1.5 * i );
+        mac.oldValue = new PyInt( sInts[ i % sIntCount ] );
+        ok &= Compare( "Notify_OnModuleAttributeChange", mac );
+    }
+
+    /* list members, missing, empty and populated */
+    DoDestinyUpdateMain dum;
+    dum.waitForBubble = false;
+    ok &= Compare( "DoDestinyUpdateMain", dum );
+
+    dum.updates = new PyList;
+    dum.events = new PyList;
+    ok &= Compare( "DoDestinyUpdateMain", dum );
+
+    dum.waitForBubble = true;
+    for( size_t i = 0; i < sIntCount; ++i )
+    {
+        DoDestinyAction da;
+        da.update_id = sInts[ i ];
+        da.update = new PyString( sStrings[ i % sStringCount ] );
+        dum.updates->AddItem( da.Encode() );
+        dum.events->AddItem( new PyLong( sLongs[ i % sLongCount ] ) );
+    }
+    ok &= Compare( "DoDestinyUpdateMain", dum );
+
+    Notify_OnMultiEvent me;
+    ok &= Compare( "Notify_OnMultiEvent", me );
+
+    me.events = new PyList;
+    me.events->AddItem( dum.Encode() );
+    me.events->AddItem( new PyNone );
+    ok &= Compare( "Notify_OnMultiEvent", me );
+    ok &= CompareNotification( "Notify_OnMultiEvent", me );
+    ok &= CompareNotification( "DoDestinyUpdateMain", dum );
+
+    ::puts( ok ? "Direct encoding matches the tree encoding." : "Direct encoding mismatch." );
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,135 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    /* a key type whose instances all share the same hash */
+    class CollidingKey : public PyInt
+    {
+    public:
+        CollidingKey( int32 i ) : PyInt( i ) {}
+
+        int32 hash() const { return 7; }
+    };
+}
+
+int python_PyDictTest( int argc, char* argv[] )
+{
+    const int32 COUNT = 1000;
+
+    PyDict* dict = new PyDict;
+
+    // grow well past the linear-scan size
+    for( int32 i = 0; i < COUNT; ++i )
+        dict->SetItem( new PyInt( i ), new PyInt( i * 2 ) );
+    // replace every other value
+    for( int32 i = 0; i < COUNT; i += 2 )
+        dict->SetItem( new PyInt( i ), new PyInt( -i ) );
+
+    if( COUNT != (int32)dict->size() )
+    {
+        ::printf( "Expected %d entries, got %lu.\n", COUNT, dict->size() );
+        return EXIT_FAILURE;
+    }
+
+    int32 expectedKey = 0;
+    PyDict::const_iterator cur, end;
+    cur = dict->begin();
+    end = dict->end();
+    for(; cur != end; cur++, expectedKey++)
+    {
+        const int32 expected = ( expectedKey % 2 ? expectedKey * 2 : -expectedKey );
+        if( cur->first->AsInt()->value() != expectedKey || cur->second->AsInt()->value() != expected )
+        {
+            ::printf( "Entry %d is out of order or has a wrong value.\n", expectedKey );
+            return EXIT_FAILURE;
+        }
+    }
+
+    PyInt* probe = new PyInt( 777 );
+    PyRep* found = dict->GetItem( probe );
+
+    if( NULL == found || 777 * 2 != found->AsInt()->value() )
+    {
+        ::printf( "Lookup of key 777 failed.\n" );
+        return EXIT_FAILURE;
+    }
+
+    // equal hashes no longer mean equal keys
+    PyDict* colliding = new PyDict;
+    for( int32 i = 0; i < 20; ++i )
+        colliding->SetItem( new CollidingKey( i ), new PyInt( i ) );
+
+    if( 20 != colliding->size() )
+    {
+        ::printf( "Colliding keys were merged: %lu entries.\n", colliding->size() );
+        return EXIT_FAILURE;
+    }
+    for( int32 i = 0; i < 20; ++i )
+    {
+        CollidingKey* key = new CollidingKey( i );
+        PyRep* value = colliding->GetItem( key );
+        PyDecRef( key );
+
+        if( NULL == value || i != value->AsInt()->value() )
+        {
+            ::printf( "Colliding key %d maps to a wrong value.\n", i );
+            return EXIT_FAILURE;
+        }
+    }
+
+    // string keys, looked up without a temporary PyString
+    PyDict* strings = new PyDict;
+    strings->SetItemString( "charID", new PyInt( 1 ) );
+    strings->SetItem( new PyWString( "shipID", 6 ), new PyInt( 2 ) );
+
+    PyRep* charID = strings->GetItemString( "charID" );
+    PyRep* shipID = strings->GetItemString( "shipID" );
+    if( NULL == charID || 1 != charID->AsInt()->value()
+        || NULL == shipID || 2 != shipID->AsInt()->value()
+        || NULL != strings->GetItemString( "corpID" ) )
+    {
+        ::printf( "String key lookup failed.\n" );
+        return EXIT_FAILURE;
+    }
+
+    PyDict* copy = new PyDict( *dict );
+    found = copy->GetItem( probe );
+    if( copy->size() != dict->size() || NULL == found || 777 * 2 != found->AsInt()->value() )
+    {
+        ::printf( "Copy differs from the original.\n" );
+        return EXIT_FAILURE;
+    }
+
+    PyDecRef( copy );
+    PyDecRef( probe );
+    PyDecRef( strings );
+    PyDecRef( colliding );
+    PyDecRef( dict );
+
+    ::printf( "%d entries stored and looked up correctly.\n", COUNT );
+    return EXIT_SUCCESS;
+}
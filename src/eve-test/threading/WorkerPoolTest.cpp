@@ -0,0 +1,130 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    class SumJob
+    : public WorkerPool::Job
+    {
+    public:
+        SumJob( uint32 n ) : mN( n ), mSum( 0 ) {}
+
+        void Run()
+        {
+            for( uint32 i = 1; i <= mN; ++i )
+                mSum += i;
+        }
+
+        uint32 n() const { return mN; }
+        uint64 sum() const { return mSum; }
+
+    protected:
+        const uint32 mN;
+        uint64 mSum;
+    };
+
+    /* Pops all completed jobs, checking their results. */
+    bool PopAll( WorkerPool& pool, size_t& popped )
+    {
+        WorkerPool::Job* job;
+        while( NULL != ( job = pool.PopCompleted() ) )
+        {
+            SumJob* sum = static_cast< SumJob* >( job );
+            const bool ok = ( (uint64)sum->n() * ( sum->n() + 1 ) / 2 == sum->sum() );
+            delete sum;
+
+            if( !ok )
+                return false;
+            ++popped;
+        }
+
+        return true;
+    }
+}
+
+int threading_WorkerPoolTest( int argc, char* argv[] )
+{
+    const size_t JOB_COUNT = 500;
+
+    // not started: jobs run on push
+    {
+        WorkerPool pool;
+        pool.Push( new SumJob( 10 ) );
+
+        size_t popped = 0;
+        if( !PopAll( pool, popped ) || 1 != popped )
+        {
+            ::printf( "Job of stopped pool did not run on push.\n" );
+            return EXIT_FAILURE;
+        }
+    }
+
+    // started: all jobs come back
+    {
+        WorkerPool pool;
+        if( !pool.Start( 4 ) )
+        {
+            ::printf( "Failed to start worker threads.\n" );
+            return EXIT_FAILURE;
+        }
+
+        for( size_t i = 0; i < JOB_COUNT; ++i )
+            pool.Push( new SumJob( static_cast< uint32 >( i * 100 ) ) );
+
+        size_t popped = 0;
+        for( uint32 waited = 0; popped < JOB_COUNT && waited < 10000; waited += 10 )
+        {
+            if( !PopAll( pool, popped ) )
+            {
+                ::printf( "Job produced a wrong result.\n" );
+                return EXIT_FAILURE;
+            }
+
+            if( popped < JOB_COUNT )
+                Sleep( 10 );
+        }
+
+        if( JOB_COUNT != popped || 0 != pool.GetJobCount() )
+        {
+            ::printf( "Expected %lu jobs, got %lu.\n", (unsigned long)JOB_COUNT, (unsigned long)popped );
+            return EXIT_FAILURE;
+        }
+
+        // stopping runs what is left
+        for( size_t i = 0; i < JOB_COUNT; ++i )
+            pool.Push( new SumJob( 1000 ) );
+        pool.Stop();
+
+        popped = 0;
+        if( pool.IsRunning() || !PopAll( pool, popped ) || JOB_COUNT != popped )
+        {
+            ::printf( "Stop lost jobs (%lu of %lu).\n", (unsigned long)popped, (unsigned long)JOB_COUNT );
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-test.h"
+
+namespace
+{
+    const char* const PHASE_NET = "net";
+    const char* const PHASE_SYSTEMS = "systems";
+    const char* const KIND_SYSTEM = "system";
+
+    bool Check( bool condition, const char* what )
+    {
+        if( !condition )
+            ::printf( "Check failed: %s\n", what );
+        return condition;
+    }
+}
+
+#define CHECK( condition )                      \
+    do                                          \
+    {                                           \
+        if( !Check( ( condition ), #condition ) ) \
+            return EXIT_FAILURE;                \
+    } while( 0 )
+
+int utils_TickProfilerTest( int argc, char* argv[] )
+{
+    // budget 10 ms, slow above 50 ms, 2 offenders, window of 4 ticks, 2 reports
+    TickProfiler profiler( 10000, 50000, 2, 4, 2 );
+
+    // a fast tick
+    profiler.BeginTick();
+    profiler.AddPhase( PHASE_NET, 300 );
+    profiler.AddPhase( PHASE_SYSTEMS, 500 );
+    profiler.AddSample( KIND_SYSTEM, 30000142, 500 );
+    CHECK( !profiler.EndTick( 800 ) );
+
+    CHECK( 1 == profiler.GetTickCount() );
+    CHECK( 0 == profiler.GetOverBudgetCount() );
+    CHECK( 1 == profiler.GetHistogram( 0 ) );
+    CHECK( profiler.GetSlowTicks().empty() );
+
+    // over budget, but not slow; phases entered twice add up
+    profiler.BeginTick();
+    profiler.AddPhase( PHASE_SYSTEMS, 7000 );
+    profiler.AddPhase( PHASE_NET, 1000 );
+    profiler.AddPhase( PHASE_SYSTEMS, 4000 );
+    CHECK( !profiler.EndTick( 12000 ) );
+
+    CHECK( 1 == profiler.GetOverBudgetCount() );
+    CHECK( 1 == profiler.GetHistogram( 4 ) );    // <= 20 ms
+
+    const std::vector<TickProfiler::PhaseStats>& stats = profiler.GetPhaseStats();
+    CHECK( 2 == stats.size() );
+    CHECK( PHASE_NET == stats[ 0 ].name && 1300 == stats[ 0 ].totalUSec && 1000 == stats[ 0 ].peakUSec );
+    CHECK( PHASE_SYSTEMS == stats[ 1 ].name && 11500 == stats[ 1 ].totalUSec && 11000 == stats[ 1 ].peakUSec );
+
+    // a slow tick keeps its phases and the slowest samples only
+    profiler.BeginTick();
+    profiler.AddPhase( PHASE_SYSTEMS, 70000 );
+    profiler.AddSample( KIND_SYSTEM, 1, 1000 );
+    profiler.AddSample( KIND_SYSTEM, 2, 60000 );
+    profiler.AddSample( KIND_SYSTEM, 3, 9000 );
+    profiler.AddSample( KIND_SYSTEM, 4, 500 );
+    CHECK( profiler.EndTick( 75000 ) );
+
+    CHECK( 1 == profiler.GetSlowTicks().size() );
+    const TickProfiler::SlowTick& slow = profiler.GetSlowTicks().back();
+    CHECK( 3 == slow.tick && 75000 == slow.usec );
+    CHECK( 1 == slow.phases.size() && 70000 == slow.phases[ 0 ].usec );
+    CHECK( 2 == slow.offenders.size() );
+    CHECK( 2 == slow.offenders[ 0 ].id && 3 == slow.offenders[ 1 ].id );
+
+    std::string report;
+    TickProfiler::FormatSlowTick( slow, report );
+    CHECK( std::string::npos != report.find( "system 2 60000 us" ) );
+
+    // the window drops the oldest ticks from the histogram
+    CHECK( !profiler.EndTick( 900 ) );
+    CHECK( !profiler.EndTick( 900 ) );
+    CHECK( 4 == profiler.GetWindowCount() );
+    CHECK( 2 == profiler.GetHistogram( 0 ) );    // the first tick is gone
+    CHECK( 1 == profiler.GetHistogram( 4 ) );
+    CHECK( 1 == profiler.GetHistogram( 6 ) );    // <= 100 ms
+
+    // only the last reports are kept
+    CHECK( profiler.EndTick( 2000000 ) );
+    CHECK( profiler.EndTick( 60000 ) );
+    CHECK( 2 == profiler.GetSlowTicks().size() );
+    CHECK( 6 == profiler.GetSlowTicks().front().tick );
+    CHECK( profiler.GetSlowTicks().front().phases.empty() );
+    CHECK( 1 == profiler.GetHistogram( TickProfiler::HISTOGRAM_BUCKETS - 1 ) );
+
+    std::string summary;
+    profiler.FormatSummary( summary );
+    CHECK( std::string::npos != summary.find( "7 ticks, 4 over" ) );
+
+    profiler.Reset();
+    CHECK( 0 == profiler.GetTickCount() && 0 == profiler.GetWindowCount() );
+    CHECK( profiler.GetPhaseStats().empty() && profiler.GetSlowTicks().empty() );
+
+    ::printf( "Tick profiler bookkeeping verified.\n" );
+    return EXIT_SUCCESS;
+}
@@ -36,6 +36,7 @@ void ExitProgram( const Seperator& cmd );
 void PrintHelp( const Seperator& cmd );
 void ObjectToSQL( const Seperator& cmd );
 void PrintTimeNow( const Seperator& cmd );
+void ReplayDestiny( const Seperator& cmd );
 void LoadScript( const Seperator& cmd );
 void TimeToString( const Seperator& cmd );
 void TriToOBJ( const Seperator& cmd );
@@ -53,6 +54,7 @@ const EVEToolCommand EVETOOL_COMMANDS[] =
     { "help",      &PrintHelp,          "Lists available commands or prints help about specified one."    },
     { "now",       &PrintTimeNow,       "Prints current time in Win32 time format."                       },
     { "obj2sql",   &ObjectToSQL,        "Converts specified cache object into an SQL update."             },
+    { "replay",    &ReplayDestiny,      "Replays specified destiny scenario and reports tic timings."     },
     { "script",    &LoadScript,         "Loads input from specified file(s)."                             },
     { "time",      &TimeToString,       "Interprets given integer as Win32 time."                         },
     { "tri2obj",   &TriToOBJ,           "Dumps specified TRI file."                                       },
@@ -237,6 +239,60 @@ void ObjectToSQL( const Seperator& cmd )
     SafeDelete( obj );
 }
 
+void ReplayDestiny( const Seperator& cmd )
+{
+    const char* cmdName = cmd.arg( 0 ).c_str();
+
+    if( 2 != cmd.argCount() && 3 != cmd.argCount() )
+    {
+        sLog.Error( cmdName, "Usage: %s [scenario] [csvout]", cmdName );
+        return;
+    }
+    const std::string& scenarioFile = cmd.arg( 1 );
+
+    Destiny::Scenario scenario;
+    if( !scenario.Load( scenarioFile.c_str() ) )
+    {
+        sLog.Error( cmdName, "Failed to load scenario '%s'.", scenarioFile.c_str() );
+        return;
+    }
+
+    FILE* out = NULL;
+    if( 3 == cmd.argCount() )
+    {
+        const std::string& csvFile = cmd.arg( 2 );
+
+        out = fopen( csvFile.c_str(), "w" );
+        if( NULL == out )
+        {
+            sLog.Error( cmdName, "Unable to open '%s' for writing.", csvFile.c_str() );
+            return;
+        }
+    }
+
+    Destiny::Replay replay( scenario );
+    if( NULL != out )
+    {
+        Destiny::Replay::WriteHeader( out );
+        replay.WriteState( out );
+    }
+
+    while( !replay.IsDone() )
+    {
+        replay.Tic();
+        if( NULL != out )
+            replay.WriteState( out );
+    }
+
+    if( NULL != out )
+        fclose( out );
+
+    const uint32 tics = replay.GetStamp();
+    sLog.Success( cmdName, "Replayed %lu balls for %u tics: %" PRIu64 " us total, %.1f us mean, %" PRIu64 " us peak.",
+                  replay.GetBallCount(), tics, replay.GetTotalUSec(),
+                  ( tics > 0 ? replay.GetTotalUSec() / double( tics ) : 0.0 ), replay.GetPeakUSec() );
+}
+
 void LoadScript( const Seperator& cmd )
 {
     const char* cmdName = cmd.arg( 0 ).c_str();
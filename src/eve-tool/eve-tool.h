@@ -60,6 +60,7 @@
 #include "database/RowsetToSQL.h"
 // destiny
 #include "destiny/DestinyBinDump.h"
+#include "destiny/DestinyReplay.h"
 // marshal
 #include "marshal/EVEUnmarshal.h"
 // network
@@ -0,0 +1,626 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#include "eve-xmlpktgen.h"
+
+#include "DecodeFromGenerator.h"
+
+ClassDecodeFromGenerator::ClassDecodeFromGenerator( FILE* outputFile )
+: ClassDecodeGenerator( outputFile ),
+  mTreeDepth( 0 )
+{
+}
+
+bool ClassDecodeFromGenerator::ProcessElementDef( const TiXmlElement* field )
+{
+    //only elements which asked for it
+    if( !IsDirectDecoded( field ) )
+        return true;
+
+    mName = field->Attribute( "name" );
+    if( mName == NULL )
+    {
+        _log( COMMON__ERROR, "<element> at line %d is missing the name attribute, skipping.", field->Row() );
+        return false;
+    }
+
+    const TiXmlElement* main = field->FirstChildElement();
+    if( main->NextSiblingElement() != NULL )
+    {
+        _log( COMMON__ERROR, "<element> at line %d contains more than one root element. skipping.", field->Row() );
+        return false;
+    }
+
+    fprintf( mOutputFile,
+        "bool %s::DecodeFrom( UnmarshalStream& from )\n"
+        "{\n",
+        mName
+    );
+
+    mItemNumber = 0;
+    mTreeDepth = 0;
+
+    if( !ParseElement( main ) )
+        return false;
+
+    fprintf( mOutputFile,
+        "    return true;\n"
+        "}\n"
+        "\n"
+    );
+
+    return true;
+}
+
+bool ClassDecodeFromGenerator::ProcessElement( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessElement( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessElementPtr( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessElementPtr( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessRaw( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessRaw( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessInt( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessInt( field );
+
+    return ProcessScalar( field, "PullInt", "an int", false );
+}
+
+bool ClassDecodeFromGenerator::ProcessLong( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessLong( field );
+
+    return ProcessScalar( field, "PullLong", "a long int", false );
+}
+
+bool ClassDecodeFromGenerator::ProcessReal( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessReal( field );
+
+    return ProcessScalar( field, "PullReal", "a real", false );
+}
+
+bool ClassDecodeFromGenerator::ProcessBool( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessBool( field );
+
+    const char* name = field->Attribute( "name" );
+    if( name == NULL )
+    {
+        _log( COMMON__ERROR, "field at line %d is missing the name attribute, skipping.", field->Row() );
+        return false;
+    }
+
+    bool soft = false;
+    const char* soft_str = field->Attribute( "soft" );
+    if( soft_str != NULL )
+        soft = str2<bool>( soft_str );
+
+    if( !soft )
+        return ProcessScalar( field, "PullBool", "a boolean", false );
+
+    const char* none_marker = field->Attribute( "none_marker" );
+    if( none_marker != NULL )
+        fprintf( mOutputFile,
+            "    if( from.PullNone() )\n"
+            "        %s = %s;\n"
+            "    else\n",
+            name, none_marker
+        );
+
+    char iname[16];
+    snprintf( iname, sizeof( iname ), "int_%u", mItemNumber++ );
+
+    //soft booleans may come as integers too
+    fprintf( mOutputFile,
+        "    if( !from.PullBool( %s ) )\n"
+        "    {\n"
+        "        int32 %s;\n"
+        "        if( !from.PullInt( %s ) )\n"
+        "        {\n"
+        "            _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: %s is not a boolean\" );\n"
+        "\n"
+        "            return false;\n"
+        "        }\n"
+        "\n"
+        "        %s = ( %s != 0 );\n"
+        "    }\n"
+        "\n",
+        name,
+            iname,
+            iname,
+                mName, name,
+            name, iname
+    );
+
+    return true;
+}
+
+bool ClassDecodeFromGenerator::ProcessNone( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessNone( field );
+
+    fprintf( mOutputFile,
+        "    if( !from.PullNone() )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: expecting a None\" );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n",
+            mName
+    );
+
+    return true;
+}
+
+bool ClassDecodeFromGenerator::ProcessBuffer( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessBuffer( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessString( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessString( field );
+
+    return ProcessScalar( field, "PullString", "a string", true );
+}
+
+bool ClassDecodeFromGenerator::ProcessStringInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessStringInline( field );
+
+    return ProcessConstantInline( field, "PullString", "string" );
+}
+
+bool ClassDecodeFromGenerator::ProcessWString( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessWString( field );
+
+    const char* name = field->Attribute( "name" );
+    if( name == NULL )
+    {
+        _log( COMMON__ERROR, "field at line %d is missing the name attribute, skipping.", field->Row() );
+        return false;
+    }
+
+    bool soft = false;
+    const char* soft_str = field->Attribute( "soft" );
+    if( soft_str != NULL )
+        soft = str2<bool>( soft_str );
+
+    if( !soft )
+        return ProcessScalar( field, "PullWString", "a wide string", true );
+
+    const char* none_marker = field->Attribute( "none_marker" );
+    if( none_marker != NULL )
+        fprintf( mOutputFile,
+            "    if( from.PullNone() )\n"
+            "        %s = \"%s\";\n"
+            "    else\n",
+            name, none_marker
+        );
+
+    //soft wide strings may come as plain strings too
+    fprintf( mOutputFile,
+        "    if( !from.PullWString( %s ) && !from.PullString( %s ) )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: %s is not a wide string\" );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n",
+        name, name,
+            mName, name
+    );
+
+    return true;
+}
+
+bool ClassDecodeFromGenerator::ProcessWStringInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessWStringInline( field );
+
+    return ProcessConstantInline( field, "PullWString", "wstring" );
+}
+
+bool ClassDecodeFromGenerator::ProcessToken( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessToken( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessTokenInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessTokenInline( field );
+
+    return ProcessConstantInline( field, "PullToken", "token" );
+}
+
+bool ClassDecodeFromGenerator::ProcessObject( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessObject( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessObjectInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessObjectInline( field );
+
+    fprintf( mOutputFile,
+        "    if( !from.PullObjectHeader() )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: expecting an object\" );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n",
+            mName
+    );
+
+    //type and arguments
+    return ParseElementChildren( field, 2 );
+}
+
+bool ClassDecodeFromGenerator::ProcessObjectEx( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessObjectEx( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessTuple( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessTuple( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessTupleInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessTupleInline( field );
+
+    return ProcessContainerInline( field, "PullTupleHeader", "tuple" );
+}
+
+bool ClassDecodeFromGenerator::ProcessList( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessList( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessListInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessListInline( field );
+
+    return ProcessContainerInline( field, "PullListHeader", "list" );
+}
+
+bool ClassDecodeFromGenerator::ProcessListInt( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessListInt( field );
+
+    return ProcessScalarList( field, "PullInt", "an integer" );
+}
+
+bool ClassDecodeFromGenerator::ProcessListLong( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessListLong( field );
+
+    return ProcessScalarList( field, "PullLong", "a long integer" );
+}
+
+bool ClassDecodeFromGenerator::ProcessListStr( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessListStr( field );
+
+    return ProcessScalarList( field, "PullString", "a string" );
+}
+
+bool ClassDecodeFromGenerator::ProcessDict( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessDict( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessDictInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessDictInline( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessDictRaw( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessDictRaw( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessDictInt( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessDictInt( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessDictStr( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessDictStr( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessSubStreamInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessSubStreamInline( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessSubStructInline( const TiXmlElement* field )
+{
+    if( 0 < mTreeDepth )
+        return ClassDecodeGenerator::ProcessSubStructInline( field );
+
+    return ProcessTreeMember( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessTreeMember( const TiXmlElement* field )
+{
+    char rname[16];
+    snprintf( rname, sizeof( rname ), "rep_%u", mItemNumber++ );
+
+    //owned by the stream, so the tree decoder may bail out at will
+    fprintf( mOutputFile,
+        "    PyRep* %s = from.PullRep();\n"
+        "    if( NULL == %s )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: unable to load %s\" );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n",
+        rname,
+        rname,
+            mName, rname
+    );
+
+    push( rname );
+
+    ++mTreeDepth;
+    const bool res = ParseElement( field );
+    --mTreeDepth;
+
+    return res;
+}
+
+bool ClassDecodeFromGenerator::ProcessScalar( const TiXmlElement* field, const char* pull, const char* what, bool quoteMarker )
+{
+    const char* name = field->Attribute( "name" );
+    if( name == NULL )
+    {
+        _log( COMMON__ERROR, "field at line %d is missing the name attribute, skipping.", field->Row() );
+        return false;
+    }
+
+    const char* none_marker = field->Attribute( "none_marker" );
+    if( none_marker != NULL )
+        fprintf( mOutputFile,
+            "    if( from.PullNone() )\n"
+            "        %s = %s%s%s;\n"
+            "    else\n",
+            name, ( quoteMarker ? "\"" : "" ), none_marker, ( quoteMarker ? "\"" : "" )
+        );
+
+    fprintf( mOutputFile,
+        "    if( !from.%s( %s ) )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: %s is not %s\" );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n",
+        pull, name,
+            mName, name, what
+    );
+
+    return true;
+}
+
+bool ClassDecodeFromGenerator::ProcessScalarList( const TiXmlElement* field, const char* pull, const char* what )
+{
+    const char* name = field->Attribute( "name" );
+    if( name == NULL )
+    {
+        _log( COMMON__ERROR, "field at line %d is missing the name attribute, skipping.", field->Row() );
+        return false;
+    }
+
+    char iname[16];
+    snprintf( iname, sizeof( iname ), "list_%u", mItemNumber++ );
+
+    fprintf( mOutputFile,
+        "    uint32 %s_size;\n"
+        "    if( !from.PullListHeader( %s_size ) )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: %s is not a list\" );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n"
+        "    %s.clear();\n"
+        "    %s.resize( %s_size );\n"
+        "    for( uint32 %s_index = 0; %s_index < %s_size; %s_index++ )\n"
+        "    {\n"
+        "        if( !from.%s( %s[ %s_index ] ) )\n"
+        "        {\n"
+        "            _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: Element %%u in list %s is not %s\", %s_index );\n"
+        "\n"
+        "            return false;\n"
+        "        }\n"
+        "    }\n"
+        "\n",
+        iname,
+        iname,
+            mName, name,
+        name,
+        name, iname,
+        iname, iname, iname, iname,
+            pull, name, iname,
+                mName, name, what, iname
+    );
+
+    return true;
+}
+
+bool ClassDecodeFromGenerator::ProcessContainerInline( const TiXmlElement* field, const char* pull, const char* what )
+{
+    //first, we need to know how many elements this container has:
+    const TiXmlNode* i = NULL;
+    uint32 count = 0;
+    while( ( i = field->IterateChildren( i ) ) )
+    {
+        if( i->Type() == TiXmlNode::TINYXML_ELEMENT )
+            count++;
+    }
+
+    char iname[16];
+    snprintf( iname, sizeof( iname ), "%s%u", what, mItemNumber++ );
+
+    fprintf( mOutputFile,
+        "    uint32 %s_size;\n"
+        "    if( !from.%s( %s_size ) )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: %s is not a %s\" );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n"
+        "    if( %s_size != %u )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: %s is the wrong size: expected %u, but got %%u\", %s_size );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n",
+        iname,
+        pull, iname,
+            mName, iname, what,
+        iname, count,
+            mName, iname, count, iname
+    );
+
+    //the items follow in order
+    return ParseElementChildren( field );
+}
+
+bool ClassDecodeFromGenerator::ProcessConstantInline( const TiXmlElement* field, const char* pull, const char* what )
+{
+    const char* value = field->Attribute( "value" );
+    if( NULL == value )
+    {
+        _log( COMMON__ERROR, "%s element at line %d has no value attribute.", field->Value(), field->Row() );
+        return false;
+    }
+
+    char iname[16];
+    snprintf( iname, sizeof( iname ), "%s_%u", what, mItemNumber++ );
+
+    fprintf( mOutputFile,
+        "    std::string %s;\n"
+        "    if( !from.%s( %s ) )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: %s is not a %s\" );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n"
+        "    if( %s != \"%s\" )\n"
+        "    {\n"
+        "        _log( NET__PACKET_WARNING, \"DecodeFrom %s failed: expected %s to be '%s', but it's '%%s'\", %s.c_str() );\n"
+        "\n"
+        "        return false;\n"
+        "    }\n"
+        "\n",
+        iname,
+        pull, iname,
+            mName, iname, what,
+        iname, value,
+            mName, iname, value, iname
+    );
+
+    return true;
+}
@@ -0,0 +1,101 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2011 The EVEmu Team
+    For the latest information visit http://evemu.org
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+*/
+
+#ifndef __DECODEFROMGENERATOR_H_INCL__
+#define __DECODEFROMGENERATOR_H_INCL__
+
+#include "DecodeGenerator.h"
+
+/**
+ * @brief Generates streaming decoders.
+ *
+ * For elements marked with decode="direct", generates
+ * DecodeFrom( UnmarshalStream& ) methods which pull the typed
+ * fields straight from the marshal stream. Members without
+ * a type of their own (raw, dicts, nested elements, ...) are
+ * loaded as PyRep and decoded the way Decode() does.
+ */
+class ClassDecodeFromGenerator
+: public ClassDecodeGenerator
+{
+public:
+    ClassDecodeFromGenerator( FILE* outputFile = NULL );
+
+protected:
+    bool ProcessElementDef( const TiXmlElement* field );
+    bool ProcessElement( const TiXmlElement* field );
+    bool ProcessElementPtr( const TiXmlElement* field );
+
+    bool ProcessRaw( const TiXmlElement* field );
+    bool ProcessInt( const TiXmlElement* field );
+    bool ProcessLong( const TiXmlElement* field );
+    bool ProcessReal( const TiXmlElement* field );
+    bool ProcessBool( const TiXmlElement* field );
+    bool ProcessNone( const TiXmlElement* field );
+    bool ProcessBuffer( const TiXmlElement* field );
+
+    bool ProcessString( const TiXmlElement* field );
+    bool ProcessStringInline( const TiXmlElement* field );
+    bool ProcessWString( const TiXmlElement* field );
+    bool ProcessWStringInline( const TiXmlElement* field );
+    bool ProcessToken( const TiXmlElement* field );
+    bool ProcessTokenInline( const TiXmlElement* field );
+
+    bool ProcessObject( const TiXmlElement* field );
+    bool ProcessObjectInline( const TiXmlElement* field );
+    bool ProcessObjectEx( const TiXmlElement* field );
+
+    bool ProcessTuple( const TiXmlElement* field );
+    bool ProcessTupleInline( const TiXmlElement* field );
+    bool ProcessList( const TiXmlElement* field );
+    bool ProcessListInline( const TiXmlElement* field );
+    bool ProcessListInt( const TiXmlElement* field );
+    bool ProcessListLong( const TiXmlElement* field );
+    bool ProcessListStr( const TiXmlElement* field );
+    bool ProcessDict( const TiXmlElement* field );
+    bool ProcessDictInline( const TiXmlElement* field );
+    bool ProcessDictRaw( const TiXmlElement* field );
+    bool ProcessDictInt( const TiXmlElement* field );
+    bool ProcessDictStr( const TiXmlElement* field );
+
+    bool ProcessSubStreamInline( const TiXmlElement* field );
+    bool ProcessSubStructInline( const TiXmlElement* field );
+
+private:
+    /** Loads the member as PyRep and lets ClassDecodeGenerator decode it. */
+    bool ProcessTreeMember( const TiXmlElement* field );
+    /** Pulls a scalar member with @a pull, honoring its none_marker. */
+    bool ProcessScalar( const TiXmlElement* field, const char* pull, const char* what, bool quoteMarker );
+    /** Pulls a list of scalars with @a pull into a vector member. */
+    bool ProcessScalarList( const TiXmlElement* field, const char* pull, const char* what );
+    /** Pulls a container header with @a pull and then its children. */
+    bool ProcessContainerInline( const TiXmlElement* field, const char* pull, const char* what );
+    /** Pulls an inline constant with @a pull and checks its value. */
+    bool ProcessConstantInline( const TiXmlElement* field, const char* pull, const char* what );
+
+    /** Nesting depth of members decoded through ClassDecodeGenerator; 0 when streaming. */
+    uint32 mTreeDepth;
+};
+
+#endif /* !__DECODEFROMGENERATOR_H_INCL__ */
@@ -78,10 +78,11 @@ protected:
     bool ProcessSubStreamInline( const TiXmlElement* field );
     bool ProcessSubStructInline( const TiXmlElement* field );
 
-private:
     const char* mName;
-    std::stack<std::string> mVariableStack;
     uint32 mItemNumber;
+
+private:
+    std::stack<std::string> mVariableStack;
 };
 
 
@@ -90,6 +90,24 @@ const char* Generator::GetEncodeType( const TiXmlElement* element )
     return res->second.c_str();
 }
 
+bool Generator::IsDirectEncoded( const TiXmlElement* elementDef )
+{
+    const char* encode = elementDef->Attribute( "encode" );
+    if( encode == NULL )
+        return false;
+
+    return ( strcmp( encode, "direct" ) == 0 );
+}
+
+bool Generator::IsDirectDecoded( const TiXmlElement* elementDef )
+{
+    const char* decode = elementDef->Attribute( "decode" );
+    if( decode == NULL )
+        return false;
+
+    return ( strcmp( decode, "direct" ) == 0 );
+}
+
 void Generator::LoadEncTypes()
 {
     if( !smEncTypesLoaded )
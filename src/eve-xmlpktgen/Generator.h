@@ -103,6 +103,24 @@ protected:
      * @return The encode type of element.
      */
     static const char* GetEncodeType( const TiXmlElement* element );
+    /**
+     * @brief Checks whether given element wants direct encoding.
+     *
+     * @param[in] elementDef The element definition to be examined.
+     *
+     * @retval true  Element has encode="direct"; EncodeTo is generated.
+     * @retval false Element is encoded through PyRep tree only.
+     */
+    static bool IsDirectEncoded( const TiXmlElement* elementDef );
+    /**
+     * @brief Checks whether given element wants direct decoding.
+     *
+     * @param[in] elementDef The element definition to be examined.
+     *
+     * @retval true  Element has decode="direct"; DecodeFrom is generated.
+     * @retval false Element is decoded from PyRep tree only.
+     */
+    static bool IsDirectDecoded( const TiXmlElement* elementDef );
 
     /** The current output file. */
     FILE* mOutputFile;
@@ -104,6 +104,18 @@ bool ClassHeaderGenerator::ProcessElementDef( const TiXmlElement* field )
         name, name
     );
 
+    if( IsDirectEncoded( field ) )
+        fprintf( mOutputFile,
+            "    bool EncodeTo( MarshalStream& into ) const;\n"
+            "\n"
+        );
+
+    if( IsDirectDecoded( field ) )
+        fprintf( mOutputFile,
+            "    bool DecodeFrom( UnmarshalStream& from );\n"
+            "\n"
+        );
+
     if( !ParseElement( main ) )
         return false;
 
@@ -93,6 +93,9 @@ bool XMLPacketGen::ParseElements( const TiXmlElement* field )
         "\n"
         "#include \"python/PyVisitor.h\"\n"
         "#include \"python/PyRep.h\"\n"
+        "\n"
+        "class MarshalStream;\n"
+        "class UnmarshalStream;\n"
         "\n",
         smGenFileComment,
         def.c_str(),
@@ -103,6 +106,8 @@ bool XMLPacketGen::ParseElements( const TiXmlElement* field )
         "\n"
         "#include \"eve-common.h\"\n"
         "\n"
+        "#include \"marshal/EVEMarshal.h\"\n"
+        "#include \"marshal/EVEUnmarshal.h\"\n"
         "#include \"%s\"\n"
         "\n",
         smGenFileComment,
@@ -144,9 +149,11 @@ bool XMLPacketGen::ParseElementDef( const TiXmlElement* field )
     bool res = ( mClone.ParseElement( field )
                  && mConstruct.ParseElement( field )
                  && mDecode.ParseElement( field )
+                 && mDecodeFrom.ParseElement( field )
                  && mDestruct.ParseElement( field )
                  && mDump.ParseElement( field )
                  && mEncode.ParseElement( field )
+                 && mEncodeTo.ParseElement( field )
                  && mHeader.ParseElement( field ) );
 
     return res;
@@ -182,9 +189,11 @@ void XMLPacketGen::SetSourceFile( const char* source )
             mClone.SetOutputFile( NULL );
             mConstruct.SetOutputFile( NULL );
             mDecode.SetOutputFile( NULL );
+            mDecodeFrom.SetOutputFile( NULL );
             mDestruct.SetOutputFile( NULL );
             mDump.SetOutputFile( NULL );
             mEncode.SetOutputFile( NULL );
+            mEncodeTo.SetOutputFile( NULL );
         }
 
         mSourceFileName = source;
@@ -220,9 +229,11 @@ bool XMLPacketGen::OpenFiles()
             mClone.SetOutputFile( mSourceFile );
             mConstruct.SetOutputFile( mSourceFile );
             mDecode.SetOutputFile( mSourceFile );
+            mDecodeFrom.SetOutputFile( mSourceFile );
             mDestruct.SetOutputFile( mSourceFile );
             mDump.SetOutputFile( mSourceFile );
             mEncode.SetOutputFile( mSourceFile );
+            mEncodeTo.SetOutputFile( mSourceFile );
         }
     }
 
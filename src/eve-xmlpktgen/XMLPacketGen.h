@@ -31,6 +31,8 @@
 #include "DestructGenerator.h"
 #include "DumpGenerator.h"
 #include "EncodeGenerator.h"
+#include "DecodeFromGenerator.h"
+#include "EncodeToGenerator.h"
 #include "DecodeGenerator.h"
 #include "CloneGenerator.h"
 
@@ -93,9 +95,11 @@ private:
     ClassCloneGenerator        mClone;
     ClassConstructGenerator    mConstruct;
     ClassDecodeGenerator    mDecode;
+    ClassDecodeFromGenerator    mDecodeFrom;
     ClassDestructGenerator    mDestruct;
     ClassDumpGenerator        mDump;
     ClassEncodeGenerator    mEncode;
+    ClassEncodeToGenerator    mEncodeTo;
     ClassHeaderGenerator    mHeader;
 
     static std::string FNameToDef( const char* buf );